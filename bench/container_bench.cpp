@@ -0,0 +1,432 @@
+/**
+ * @file container_bench.cpp
+ * @brief 比较 tiny_stl 与标准库的 vector、deque、list、shared_ptr 常用操作的耗时，结果以 JSON 输出。
+ *
+ * 所有输入都由固定种子生成，每一项先预热一次，再重复测量 repetitions 次，报告中位数、最小值与最大值，
+ * 使不同版本之间的结果可以直接比较。JSON 中同时记录编译器、标准库与构建方式。
+ *
+ * 用法：bench [--repetitions N] [--filter 子串] [--output 文件]
+ * 不指定 --output 时 JSON 写到标准输出。
+ */
+
+#include <deque.hpp>
+#include <list.hpp>
+#include <shared_ptr.hpp>
+#include <vector.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <list>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    constexpr uint64_t seed = 20240601;
+
+    volatile size_t sink; /**< 防止被测代码的结果被优化掉 */
+
+    /**
+     * @brief 标准库实现的名称
+     */
+    const char* std_name() {
+#if defined(__GLIBCXX__)
+        return "libstdc++";
+#elif defined(_LIBCPP_VERSION)
+        return "libc++";
+#elif defined(_MSC_VER)
+        return "msvc-stl";
+#else
+        return "std";
+#endif
+    }
+
+    template <typename Function>
+    double measure_ns(Function&& f) {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        auto stop = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(stop - start).count();
+    }
+
+    std::vector<int> random_ints(size_t n) {
+        std::mt19937_64 rng(seed);
+        std::vector<int> values(n);
+        for (int& v : values) {
+            v = static_cast<int>(rng() >> 33);
+        }
+        return values;
+    }
+
+    // ==================== vector ====================
+
+    template <typename Vector>
+    double vector_push_back(size_t n) {
+        Vector v;
+        double ns = measure_ns([&] {
+            for (size_t i = 0; i < n; ++i) {
+                v.push_back(static_cast<int>(i));
+            }
+        });
+        sink = sink + v.size();
+        return ns;
+    }
+
+    template <typename Vector>
+    double vector_push_back_reserved(size_t n) {
+        Vector v;
+        double ns = measure_ns([&] {
+            v.reserve(n);
+            for (size_t i = 0; i < n; ++i) {
+                v.push_back(static_cast<int>(i));
+            }
+        });
+        sink = sink + v.size();
+        return ns;
+    }
+
+    template <typename Vector>
+    double vector_push_back_string(size_t n) {
+        const std::string value(32, 'x');
+        Vector v;
+        double ns = measure_ns([&] {
+            for (size_t i = 0; i < n; ++i) {
+                v.push_back(value);
+            }
+        });
+        sink = sink + v.size();
+        return ns;
+    }
+
+    template <typename Vector>
+    double vector_insert_middle(size_t n) {
+        Vector v;
+        double ns = measure_ns([&] {
+            for (size_t i = 0; i < n; ++i) {
+                v.insert(v.begin() + v.size() / 2, static_cast<int>(i));
+            }
+        });
+        sink = sink + v.size();
+        return ns;
+    }
+
+    // ==================== deque ====================
+
+    template <typename Deque>
+    double deque_push_pop_back(size_t n) {
+        Deque d;
+        double ns = measure_ns([&] {
+            for (size_t i = 0; i < n; ++i) {
+                d.push_back(static_cast<int>(i));
+            }
+            for (size_t i = 0; i < n; ++i) {
+                d.pop_back();
+            }
+        });
+        sink = sink + d.size();
+        return ns;
+    }
+
+    template <typename Deque>
+    double deque_push_pop_front(size_t n) {
+        Deque d;
+        double ns = measure_ns([&] {
+            for (size_t i = 0; i < n; ++i) {
+                d.push_front(static_cast<int>(i));
+            }
+            for (size_t i = 0; i < n; ++i) {
+                d.pop_front();
+            }
+        });
+        sink = sink + d.size();
+        return ns;
+    }
+
+    template <typename Deque>
+    double deque_iterate(size_t n) {
+        constexpr int passes = 10;
+        Deque d;
+        for (size_t i = 0; i < n; ++i) {
+            d.push_back(static_cast<int>(i));
+        }
+        long long sum = 0;
+        double ns = measure_ns([&] {
+            for (int pass = 0; pass < passes; ++pass) {
+                for (auto it = d.begin(); it != d.end(); ++it) {
+                    sum += *it;
+                }
+            }
+        });
+        sink = sink + static_cast<size_t>(sum);
+        return ns / passes;
+    }
+
+    // ==================== list ====================
+
+    template <typename List>
+    double list_sort(size_t n) {
+        std::vector<int> values = random_ints(n);
+        List l;
+        for (int v : values) {
+            l.push_back(v);
+        }
+        double ns = measure_ns([&] { l.sort(); });
+        sink = sink + static_cast<size_t>(l.front());
+        return ns;
+    }
+
+    /**
+     * @brief 把 n 个节点逐个从一个 list 移到另一个 list 的开头，再整体移回
+     */
+    template <typename List>
+    double list_splice(size_t n) {
+        List from, to;
+        for (size_t i = 0; i < n; ++i) {
+            from.push_back(static_cast<int>(i));
+        }
+        double ns = measure_ns([&] {
+            for (size_t i = 0; i < n; ++i) {
+                to.splice(to.begin(), from, from.begin());
+            }
+            from.splice(from.end(), to);
+        });
+        sink = sink + from.size();
+        return ns;
+    }
+
+    // ==================== shared_ptr ====================
+
+    /**
+     * @brief threads 个线程同时反复拷贝并销毁同一个 shared_ptr，计时从所有线程就绪后开始
+     */
+    template <template <typename> class SharedPtr>
+    double shared_ptr_copy_contended(size_t copies_per_thread, unsigned threads) {
+        SharedPtr<int> source(new int(42));
+        std::atomic<unsigned> ready(0);
+        std::atomic<bool> go(false);
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < threads; ++t) {
+            workers.emplace_back([&] {
+                size_t local = 0;
+                ready.fetch_add(1);
+                while (!go.load(std::memory_order_acquire)) {
+                    std::this_thread::yield();
+                }
+                for (size_t i = 0; i < copies_per_thread; ++i) {
+                    SharedPtr<int> copy(source);
+                    local += static_cast<size_t>(*copy);
+                }
+                sink = sink + local;
+            });
+        }
+        while (ready.load() != threads) {
+            std::this_thread::yield();
+        }
+        return measure_ns([&] {
+            go.store(true, std::memory_order_release);
+            for (std::thread& w : workers) {
+                w.join();
+            }
+        });
+    }
+
+    // ==================== 运行与输出 ====================
+
+    struct options {
+        int repetitions = 7;
+        std::string filter;
+        std::string output;
+    };
+
+    struct result {
+        std::string name;
+        const char* implementation;
+        size_t ops;
+        double median_ns;
+        double min_ns;
+        double max_ns;
+    };
+
+    class suite {
+    public:
+        explicit suite(const options& opts) : _opts(opts) { }
+
+        /**
+         * @brief 预热一次后重复运行 f，f 返回一次运行中被测部分的耗时（纳秒）
+         * @param name 基准的名称，例如 "vector/push_back"
+         * @param implementation 实现的名称
+         * @param ops 一次运行包含的操作数，用于计算每次操作的耗时
+         */
+        template <typename Function>
+        void run(const std::string& name, const char* implementation, size_t ops, Function f) {
+            if (!_opts.filter.empty() && name.find(_opts.filter) == std::string::npos) {
+                return;
+            }
+            f();
+            std::vector<double> samples;
+            for (int i = 0; i < _opts.repetitions; ++i) {
+                samples.push_back(f());
+            }
+            std::sort(samples.begin(), samples.end());
+            _results.push_back({name, implementation, ops, samples[samples.size() / 2], samples.front(), samples.back()});
+            std::fprintf(stderr, "%-36s %-10s %12.2f ns/op\n", name.c_str(), implementation,
+                         _results.back().median_ns / static_cast<double>(ops));
+        }
+
+        /**
+         * @brief 同时运行 tiny_stl 与标准库的版本
+         */
+        template <typename TinyFunction, typename StdFunction>
+        void compare(const std::string& name, size_t ops, TinyFunction tiny, StdFunction std_version) {
+            run(name, "tiny_stl", ops, tiny);
+            run(name, std_name(), ops, std_version);
+        }
+
+        void write_json(std::FILE* out, unsigned threads) const {
+            std::fprintf(out, "{\n");
+            std::fprintf(out, "  \"schema_version\": 1,\n");
+            std::fprintf(out, "  \"context\": {\n");
+            std::fprintf(out, "    \"compiler\": \"%s\",\n", json_escape(compiler()).c_str());
+            std::fprintf(out, "    \"cplusplus\": %ld,\n", static_cast<long>(__cplusplus));
+            std::fprintf(out, "    \"standard_library\": \"%s\",\n", std_name());
+#if defined(__OPTIMIZE__)
+            std::fprintf(out, "    \"optimized\": true,\n");
+#else
+            std::fprintf(out, "    \"optimized\": false,\n");
+#endif
+#if defined(NDEBUG)
+            std::fprintf(out, "    \"assertions\": false,\n");
+#else
+            std::fprintf(out, "    \"assertions\": true,\n");
+#endif
+            std::fprintf(out, "    \"seed\": %llu,\n", static_cast<unsigned long long>(seed));
+            std::fprintf(out, "    \"repetitions\": %d,\n", _opts.repetitions);
+            std::fprintf(out, "    \"threads\": %u\n", threads);
+            std::fprintf(out, "  },\n");
+            std::fprintf(out, "  \"benchmarks\": [");
+            for (size_t i = 0; i < _results.size(); ++i) {
+                const result& r = _results[i];
+                std::fprintf(out, "%s\n    {\"name\": \"%s\", \"implementation\": \"%s\", \"ops\": %zu, "
+                                  "\"median_ns\": %.0f, \"min_ns\": %.0f, \"max_ns\": %.0f, \"ns_per_op\": %.3f}",
+                             i ? "," : "", json_escape(r.name).c_str(), r.implementation, r.ops,
+                             r.median_ns, r.min_ns, r.max_ns, r.median_ns / static_cast<double>(r.ops));
+            }
+            std::fprintf(out, "\n  ]\n}\n");
+        }
+
+    private:
+        const options& _opts;
+        std::vector<result> _results;
+
+        static std::string compiler() {
+#if defined(__clang__)
+            return std::string("clang ") + __clang_version__;
+#elif defined(__GNUC__)
+            return std::string("gcc ") + __VERSION__;
+#elif defined(_MSC_VER)
+            return "msvc " + std::to_string(_MSC_VER);
+#else
+            return "unknown";
+#endif
+        }
+
+        static std::string json_escape(const std::string& s) {
+            std::string escaped;
+            for (char c : s) {
+                if (c == '"' || c == '\\') {
+                    escaped += '\\';
+                }
+                escaped += c;
+            }
+            return escaped;
+        }
+    };
+
+    bool parse_options(int argc, char** argv, options& opts) {
+        for (int i = 1; i < argc; ++i) {
+            bool has_value = i + 1 < argc;
+            if (std::strcmp(argv[i], "--repetitions") == 0 && has_value) {
+                opts.repetitions = std::max(1, std::atoi(argv[++i]));
+            } else if (std::strcmp(argv[i], "--filter") == 0 && has_value) {
+                opts.filter = argv[++i];
+            } else if (std::strcmp(argv[i], "--output") == 0 && has_value) {
+                opts.output = argv[++i];
+            } else {
+                std::fprintf(stderr, "usage: %s [--repetitions N] [--filter substring] [--output file]\n", argv[0]);
+                return false;
+            }
+        }
+        return true;
+    }
+
+}
+
+int main(int argc, char** argv) {
+    options opts;
+    if (!parse_options(argc, argv, opts)) {
+        return 2;
+    }
+    suite s(opts);
+    const unsigned threads = std::max(2u, std::thread::hardware_concurrency());
+
+    constexpr size_t push_n = 1000000;
+    s.compare("vector/push_back", push_n,
+              [] { return vector_push_back<tiny_stl::vector<int>>(push_n); },
+              [] { return vector_push_back<std::vector<int>>(push_n); });
+    s.compare("vector/push_back_reserved", push_n,
+              [] { return vector_push_back_reserved<tiny_stl::vector<int>>(push_n); },
+              [] { return vector_push_back_reserved<std::vector<int>>(push_n); });
+    constexpr size_t string_n = 200000;
+    s.compare("vector/push_back_string", string_n,
+              [] { return vector_push_back_string<tiny_stl::vector<std::string>>(string_n); },
+              [] { return vector_push_back_string<std::vector<std::string>>(string_n); });
+    constexpr size_t insert_n = 20000;
+    s.compare("vector/insert_middle", insert_n,
+              [] { return vector_insert_middle<tiny_stl::vector<int>>(insert_n); },
+              [] { return vector_insert_middle<std::vector<int>>(insert_n); });
+
+    s.compare("deque/push_pop_back", 2 * push_n,
+              [] { return deque_push_pop_back<tiny_stl::deque<int>>(push_n); },
+              [] { return deque_push_pop_back<std::deque<int>>(push_n); });
+    s.compare("deque/push_pop_front", 2 * push_n,
+              [] { return deque_push_pop_front<tiny_stl::deque<int>>(push_n); },
+              [] { return deque_push_pop_front<std::deque<int>>(push_n); });
+    s.compare("deque/iterate", push_n,
+              [] { return deque_iterate<tiny_stl::deque<int>>(push_n); },
+              [] { return deque_iterate<std::deque<int>>(push_n); });
+
+    constexpr size_t list_n = 200000;
+    s.compare("list/sort", list_n,
+              [] { return list_sort<tiny_stl::list<int>>(list_n); },
+              [] { return list_sort<std::list<int>>(list_n); });
+    s.compare("list/splice", list_n + 1,
+              [] { return list_splice<tiny_stl::list<int>>(list_n); },
+              [] { return list_splice<std::list<int>>(list_n); });
+
+    constexpr size_t copies = 200000;
+    s.compare("shared_ptr/copy_contended", copies * threads,
+              [threads] { return shared_ptr_copy_contended<tiny_stl::shared_ptr>(copies, threads); },
+              [threads] { return shared_ptr_copy_contended<std::shared_ptr>(copies, threads); });
+
+    std::FILE* out = stdout;
+    if (!opts.output.empty()) {
+        out = std::fopen(opts.output.c_str(), "w");
+        if (!out) {
+            std::perror(opts.output.c_str());
+            return 1;
+        }
+    }
+    s.write_json(out, threads);
+    if (out != stdout) {
+        std::fclose(out);
+    }
+    return 0;
+}
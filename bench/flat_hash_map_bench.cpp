@@ -0,0 +1,78 @@
+/**
+ * @file flat_hash_map_bench.cpp
+ * @brief 比较 tiny_stl::flat_hash_map 与 std::unordered_map 的插入、查找与删除耗时。
+ */
+
+#include <flat_hash_map.hpp>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+    template <typename Function>
+    double measure_ms(Function&& f) {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        auto stop = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::milli>(stop - start).count();
+    }
+
+    /**
+     * @brief 依次测量插入 keys、查找 keys（全部命中）、查找 misses（全部未命中）、删除 keys 的耗时
+     */
+    template <typename Map, typename Key>
+    void run(const char* name, const std::vector<Key>& keys, const std::vector<Key>& misses) {
+        Map map;
+        size_t sink = 0;
+        double insert = measure_ms([&] {
+            for (size_t i = 0; i < keys.size(); ++i) {
+                map[keys[i]] = i;
+            }
+        });
+        double hit = measure_ms([&] {
+            for (const Key& k : keys) {
+                sink += map.find(k)->second;
+            }
+        });
+        double miss = measure_ms([&] {
+            for (const Key& k : misses) {
+                sink += map.find(k) == map.end();
+            }
+        });
+        double erase = measure_ms([&] {
+            for (const Key& k : keys) {
+                sink += map.erase(k);
+            }
+        });
+        std::printf("%-34s insert %8.2f ms  find-hit %8.2f ms  find-miss %8.2f ms  erase %8.2f ms  (%zu)\n",
+                    name, insert, hit, miss, erase, sink);
+    }
+
+}
+
+int main() {
+    constexpr size_t n = 1000000;
+    std::mt19937_64 rng(20240601);
+
+    std::vector<uint64_t> int_keys(n), int_misses(n);
+    for (size_t i = 0; i < n; ++i) {
+        int_keys[i] = rng() | 1;
+        int_misses[i] = rng() & ~uint64_t(1);
+    }
+    run<std::unordered_map<uint64_t, size_t>>("std::unordered_map<uint64_t>", int_keys, int_misses);
+    run<tiny_stl::flat_hash_map<uint64_t, size_t>>("tiny_stl::flat_hash_map<uint64_t>", int_keys, int_misses);
+
+    std::vector<std::string> str_keys(n), str_misses(n);
+    for (size_t i = 0; i < n; ++i) {
+        str_keys[i] = "key-" + std::to_string(int_keys[i]);
+        str_misses[i] = "key-" + std::to_string(int_misses[i]);
+    }
+    run<std::unordered_map<std::string, size_t>>("std::unordered_map<string>", str_keys, str_misses);
+    run<tiny_stl::flat_hash_map<std::string, size_t>>("tiny_stl::flat_hash_map<string>", str_keys, str_misses);
+    return 0;
+}
@@ -0,0 +1,1820 @@
+/**
+ * @file algorithm.hpp
+ * @brief 此文件定义了 tiny_stl 命名空间下的通用算法，例如 copy、fill、find、for_each 等。
+ *
+ * 对于分段迭代器（例如 deque 的迭代器，元素存放在若干块连续的缓冲区中），
+ * 算法按缓冲区拆成若干个连续的 [first, last) 指针区间分别处理，
+ * 内层循环只是简单的指针循环，编译器可以自动向量化，也可以直接使用 memmove。
+ *
+ * 元素为整数的连续区间上，find、count、min_element / max_element / minmax_element 直接用 SSE2
+ * 每次处理 16 字节（定义 TINY_STL_NO_SIMD 可以关闭），equal 使用 memcmp。
+ * sort 是 pattern-defeating quicksort：对算术类型和内置比较函数使用无分支的分块划分。
+ */
+
+#pragma once
+
+#ifdef __GNUC__
+#   pragma GCC system_header
+#endif
+#if defined(_MSC_VER) && _MSC_VER >= 1920
+#   pragma system_header
+#endif
+
+#include <iterator.hpp>
+#include <memory.hpp>
+#include <utility.hpp>
+#include <functional.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+#if !defined(TINY_STL_NO_SIMD)
+#   if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#       define TINY_STL_ALGORITHM_SSE2 1
+#       include <emmintrin.h>
+#   endif
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#   include <intrin.h>
+#endif
+
+namespace tiny_stl {
+
+    /**
+     * @struct __segmented_iterator_traits
+     * @brief 分段迭代器的特性。默认不是分段迭代器。
+     *
+     * 分段迭代器的容器通过特化此模板提供以下成员：
+     * - `is_segmented`：为 true；
+     * - `segment_iterator`：遍历各个段的迭代器类型；
+     * - `local_iterator`：段内的迭代器类型（通常是指针）；
+     * - `segment(it)`、`local(it)`：取得迭代器所在的段与段内位置；
+     * - `begin(seg)`、`end(seg)`：段的起止位置；
+     * - `compose(seg, local)`：由段与段内位置重新组合出迭代器。
+     *
+     * @tparam Iterator 迭代器类型。
+     */
+    template <typename Iterator>
+    struct __segmented_iterator_traits {
+        static constexpr bool is_segmented = false; /**< 是否为分段迭代器 */
+    };
+
+    /**
+     * @brief 判断迭代器是否为分段迭代器。
+     * @tparam Iterator 迭代器类型。
+     */
+    template <typename Iterator>
+    constexpr bool __is_segmented_iterator_v = __segmented_iterator_traits<Iterator>::is_segmented;
+
+    /**
+     * @brief 对分段迭代器范围 [first, last) 中的每个连续区间调用 fn(local_first, local_last)。
+     * @tparam SegmentedIterator 分段迭代器类型。
+     * @tparam Function 区间处理函数的类型。
+     * @param first 起始迭代器。
+     * @param last 结束迭代器。
+     * @param fn 区间处理函数。
+     */
+    template <typename SegmentedIterator, typename Function>
+    void __for_each_segment(SegmentedIterator first, SegmentedIterator last, Function&& fn) {
+        using traits = __segmented_iterator_traits<SegmentedIterator>;
+        auto sfirst = traits::segment(first);
+        auto slast = traits::segment(last);
+        if (sfirst == slast) {
+            fn(traits::local(first), traits::local(last));
+            return;
+        }
+        fn(traits::local(first), traits::end(sfirst));
+        for (++sfirst; sfirst != slast; ++sfirst) {
+            fn(traits::begin(sfirst), traits::end(sfirst));
+        }
+        fn(traits::begin(slast), traits::local(last));
+    }
+
+    /**
+     * @brief 对 [first, last) 中的每个元素调用 f。分段迭代器按缓冲区逐段处理。
+     * @tparam InputIterator 输入迭代器类型。
+     * @tparam Function 函数对象类型。
+     * @param first 起始迭代器。
+     * @param last 结束迭代器。
+     * @param f 函数对象。
+     * @return f。
+     */
+    template <typename InputIterator, typename Function>
+    Function for_each(InputIterator first, InputIterator last, Function f) {
+        if constexpr (__is_segmented_iterator_v<InputIterator>) {
+            __for_each_segment(first, last, [&f](auto lfirst, auto llast) {
+                for (; lfirst != llast; ++lfirst) {
+                    f(*lfirst);
+                }
+            });
+        } else {
+            for (; first != last; ++first) {
+                f(*first);
+            }
+        }
+        return f;
+    }
+
+    /**
+     * @brief 把 [first, last) 中的每个元素赋值为 value。分段迭代器按缓冲区逐段处理。
+     * @tparam ForwardIterator 前向迭代器类型。
+     * @tparam T 值的类型。
+     * @param first 起始迭代器。
+     * @param last 结束迭代器。
+     * @param value 要赋的值。
+     */
+    template <typename ForwardIterator, typename T>
+    void fill(ForwardIterator first, ForwardIterator last, const T& value) {
+        if constexpr (__is_segmented_iterator_v<ForwardIterator>) {
+            __for_each_segment(first, last, [&value](auto lfirst, auto llast) {
+                tiny_stl::fill(lfirst, llast, value);
+            });
+        } else {
+            for (; first != last; ++first) {
+                *first = value;
+            }
+        }
+    }
+
+    // ==================== 位运算与 SIMD 基础操作 ====================
+
+    /**
+     * @brief 计算 64 位整数末尾 0 的个数
+     * @param x 非零整数
+     * @return 末尾 0 的个数
+     */
+    inline unsigned __countr_zero(uint64_t x) noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long index;
+        _BitScanForward64(&index, x);
+        return static_cast<unsigned>(index);
+#else
+        return static_cast<unsigned>(__builtin_ctzll(x));
+#endif
+    }
+
+    /**
+     * @brief 计算 64 位整数开头 0 的个数
+     * @param x 非零整数
+     * @return 开头 0 的个数
+     */
+    inline unsigned __countl_zero(uint64_t x) noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long index;
+        _BitScanReverse64(&index, x);
+        return 63 - static_cast<unsigned>(index);
+#else
+        return static_cast<unsigned>(__builtin_clzll(x));
+#endif
+    }
+
+#if defined(TINY_STL_ALGORITHM_SSE2)
+
+    /**
+     * @brief 判断以 E 为元素的连续区间能否按位用 SSE2 比较：宽度不超过 8 字节、不是 bool 的整数类型。
+     * bool 没有对应的 make_unsigned，也不能用来构造无符号比较的符号位，交给标量循环处理
+     */
+    template <typename E>
+    constexpr bool __simd_integral_v = std::is_integral<E>::value && !std::is_same<std::remove_cv_t<E>, bool>::value &&
+        sizeof(E) <= 8;
+
+    template <typename E>
+    __m128i __simd_load(const E* p) noexcept {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    }
+
+    /**
+     * @brief 把 value 复制到寄存器的每个 sizeof(E) 字节的通道
+     */
+    template <typename E>
+    __m128i __simd_broadcast(E value) noexcept {
+        if constexpr (sizeof(E) == 1) {
+            return _mm_set1_epi8(static_cast<char>(value));
+        } else if constexpr (sizeof(E) == 2) {
+            return _mm_set1_epi16(static_cast<short>(value));
+        } else if constexpr (sizeof(E) == 4) {
+            return _mm_set1_epi32(static_cast<int>(value));
+        } else {
+            return _mm_set1_epi64x(static_cast<long long>(value));
+        }
+    }
+
+    /**
+     * @brief 逐通道比较相等，相等的通道全 1。SSE2 没有 64 位比较，用 32 位比较再把相邻两半相与
+     */
+    template <typename E>
+    __m128i __simd_cmpeq(__m128i a, __m128i b) noexcept {
+        if constexpr (sizeof(E) == 1) {
+            return _mm_cmpeq_epi8(a, b);
+        } else if constexpr (sizeof(E) == 2) {
+            return _mm_cmpeq_epi16(a, b);
+        } else if constexpr (sizeof(E) == 4) {
+            return _mm_cmpeq_epi32(a, b);
+        } else {
+            __m128i eq = _mm_cmpeq_epi32(a, b);
+            return _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+        }
+    }
+
+    /**
+     * @brief 逐通道相减，用来累加比较结果（相等的通道为 -1）
+     */
+    template <typename E>
+    __m128i __simd_sub(__m128i a, __m128i b) noexcept {
+        if constexpr (sizeof(E) == 1) {
+            return _mm_sub_epi8(a, b);
+        } else if constexpr (sizeof(E) == 2) {
+            return _mm_sub_epi16(a, b);
+        } else if constexpr (sizeof(E) == 4) {
+            return _mm_sub_epi32(a, b);
+        } else {
+            return _mm_sub_epi64(a, b);
+        }
+    }
+
+    /**
+     * @brief 逐通道比较 a > b（仅支持 1、2、4 字节）。SSE2 只有有符号比较，无符号数先翻转符号位
+     */
+    template <typename E>
+    __m128i __simd_cmpgt(__m128i a, __m128i b) noexcept {
+        if constexpr (std::is_unsigned<E>::value) {
+            const __m128i bias = __simd_broadcast<E>(static_cast<E>(E(1) << (sizeof(E) * 8 - 1)));
+            a = _mm_xor_si128(a, bias);
+            b = _mm_xor_si128(b, bias);
+        }
+        if constexpr (sizeof(E) == 1) {
+            return _mm_cmpgt_epi8(a, b);
+        } else if constexpr (sizeof(E) == 2) {
+            return _mm_cmpgt_epi16(a, b);
+        } else {
+            return _mm_cmpgt_epi32(a, b);
+        }
+    }
+
+    /**
+     * @brief 按掩码选择：mask 为全 1 的通道取 a，否则取 b
+     */
+    inline __m128i __simd_select(__m128i mask, __m128i a, __m128i b) noexcept {
+        return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+    }
+
+    /**
+     * @brief 在连续区间中查找第一个按位等于 value 的元素，每次迭代比较 64 字节
+     * @return 指向找到的元素的指针，找不到时返回 last
+     */
+    template <typename E>
+    E* __simd_find(E* first, E* last, std::remove_cv_t<E> value) noexcept {
+        constexpr ptrdiff_t lanes = 16 / sizeof(E);
+        const __m128i needle = __simd_broadcast(value);
+        for (; last - first >= 4 * lanes; first += 4 * lanes) {
+            __m128i e0 = __simd_cmpeq<E>(__simd_load(first), needle);
+            __m128i e1 = __simd_cmpeq<E>(__simd_load(first + lanes), needle);
+            __m128i e2 = __simd_cmpeq<E>(__simd_load(first + 2 * lanes), needle);
+            __m128i e3 = __simd_cmpeq<E>(__simd_load(first + 3 * lanes), needle);
+            if (_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(e0, e1), _mm_or_si128(e2, e3)))) {
+                uint64_t mask = static_cast<uint64_t>(static_cast<unsigned>(_mm_movemask_epi8(e0)))
+                              | static_cast<uint64_t>(static_cast<unsigned>(_mm_movemask_epi8(e1))) << 16
+                              | static_cast<uint64_t>(static_cast<unsigned>(_mm_movemask_epi8(e2))) << 32
+                              | static_cast<uint64_t>(static_cast<unsigned>(_mm_movemask_epi8(e3))) << 48;
+                return first + __countr_zero(mask) / sizeof(E);
+            }
+        }
+        for (; last - first >= lanes; first += lanes) {
+            unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(__simd_cmpeq<E>(__simd_load(first), needle)));
+            if (mask) {
+                return first + __countr_zero(mask) / sizeof(E);
+            }
+        }
+        for (; first != last && !(*first == value); ++first) { }
+        return first;
+    }
+
+    /**
+     * @brief 在连续区间中查找最后一个按位等于 value 的元素
+     * @return 指向找到的元素的指针，找不到时返回 last
+     */
+    template <typename E>
+    E* __simd_find_last(E* first, E* last, std::remove_cv_t<E> value) noexcept {
+        constexpr ptrdiff_t lanes = 16 / sizeof(E);
+        const __m128i needle = __simd_broadcast(value);
+        E* p = last;
+        for (; p - first >= lanes;) {
+            p -= lanes;
+            unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(__simd_cmpeq<E>(__simd_load(p), needle)));
+            if (mask) {
+                return p + (63 - __countl_zero(mask)) / sizeof(E);
+            }
+        }
+        while (p != first) {
+            if (*--p == value) {
+                return p;
+            }
+        }
+        return last;
+    }
+
+    /**
+     * @brief 统计连续区间中按位等于 value 的元素个数
+     * 每个通道用减法累加比较结果，在通道计数溢出之前把它们加到总数里
+     */
+    template <typename E>
+    size_t __simd_count(const E* first, const E* last, E value) noexcept {
+        using lane_type = std::make_unsigned_t<E>;
+        constexpr ptrdiff_t lanes = 16 / sizeof(E);
+        constexpr ptrdiff_t max_blocks = sizeof(E) == 1 ? 0xFF : (sizeof(E) == 2 ? 0xFFFF : PTRDIFF_MAX);
+        const __m128i needle = __simd_broadcast(value);
+        size_t total = 0;
+        while (last - first >= lanes) {
+            ptrdiff_t blocks = (last - first) / lanes;
+            if (blocks > max_blocks) {
+                blocks = max_blocks;
+            }
+            __m128i acc = _mm_setzero_si128();
+            for (; blocks > 0; --blocks, first += lanes) {
+                acc = __simd_sub<E>(acc, __simd_cmpeq<E>(__simd_load(first), needle));
+            }
+            alignas(16) lane_type parts[lanes];
+            _mm_store_si128(reinterpret_cast<__m128i*>(parts), acc);
+            for (ptrdiff_t i = 0; i < lanes; ++i) {
+                total += parts[i];
+            }
+        }
+        for (; first != last; ++first) {
+            total += *first == value ? 1 : 0;
+        }
+        return total;
+    }
+
+    /**
+     * @brief 求非空连续区间中的最小值与最大值（仅支持 1、2、4 字节的整数）
+     */
+    template <typename E>
+    void __simd_minmax(const E* first, const E* last, E& min_value, E& max_value) noexcept {
+        constexpr ptrdiff_t lanes = 16 / sizeof(E);
+        min_value = max_value = *first;
+        if (last - first >= lanes) {
+            __m128i vmin = __simd_load(first);
+            __m128i vmax = vmin;
+            for (first += lanes; last - first >= lanes; first += lanes) {
+                __m128i v = __simd_load(first);
+                vmin = __simd_select(__simd_cmpgt<E>(vmin, v), v, vmin);
+                vmax = __simd_select(__simd_cmpgt<E>(v, vmax), v, vmax);
+            }
+            alignas(16) E mins[lanes];
+            alignas(16) E maxs[lanes];
+            _mm_store_si128(reinterpret_cast<__m128i*>(mins), vmin);
+            _mm_store_si128(reinterpret_cast<__m128i*>(maxs), vmax);
+            for (ptrdiff_t i = 0; i < lanes; ++i) {
+                min_value = mins[i] < min_value ? mins[i] : min_value;
+                max_value = max_value < maxs[i] ? maxs[i] : max_value;
+            }
+        }
+        for (; first != last; ++first) {
+            min_value = *first < min_value ? *first : min_value;
+            max_value = max_value < *first ? *first : max_value;
+        }
+    }
+
+#endif
+
+    /**
+     * @brief 判断在元素为 E 的连续区间中查找 T 类型的值能否逐字节比较
+     * @tparam Iterator 迭代器类型，必须是指针
+     * @tparam T 要查找的值的类型
+     */
+    template <typename Iterator, typename T>
+    constexpr bool __simd_searchable_v = false;
+
+#if defined(TINY_STL_ALGORITHM_SSE2)
+    template <typename E, typename T>
+    constexpr bool __simd_searchable_v<E*, T> = __simd_integral_v<std::remove_cv_t<E>> && std::is_integral<T>::value;
+#endif
+
+    /**
+     * @brief 把 op 作用于 [first, last) 中的每个元素，结果依次写到 d_first 开始的位置。
+     * @tparam InputIterator 输入迭代器类型。
+     * @tparam OutputIterator 输出迭代器类型。
+     * @tparam UnaryOperation 一元操作的类型。
+     * @param first 起始迭代器。
+     * @param last 结束迭代器。
+     * @param d_first 目标起始迭代器。
+     * @param op 一元操作。
+     * @return 目标范围的结束迭代器。
+     */
+    template <typename InputIterator, typename OutputIterator, typename UnaryOperation>
+    OutputIterator transform(InputIterator first, InputIterator last, OutputIterator d_first, UnaryOperation op) {
+        for (; first != last; ++first, ++d_first) {
+            *d_first = op(*first);
+        }
+        return d_first;
+    }
+
+    /**
+     * @brief 把 op 作用于 [first1, last1) 与从 first2 开始的范围中对应的元素，结果依次写到 d_first 开始的位置。
+     * @tparam InputIterator1 第一个输入迭代器类型。
+     * @tparam InputIterator2 第二个输入迭代器类型。
+     * @tparam OutputIterator 输出迭代器类型。
+     * @tparam BinaryOperation 二元操作的类型。
+     * @param first1 第一个范围的起始迭代器。
+     * @param last1 第一个范围的结束迭代器。
+     * @param first2 第二个范围的起始迭代器。
+     * @param d_first 目标起始迭代器。
+     * @param op 二元操作。
+     * @return 目标范围的结束迭代器。
+     */
+    template <typename InputIterator1, typename InputIterator2, typename OutputIterator, typename BinaryOperation>
+    OutputIterator transform(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2,
+                             OutputIterator d_first, BinaryOperation op) {
+        for (; first1 != last1; ++first1, ++first2, ++d_first) {
+            *d_first = op(*first1, *first2);
+        }
+        return d_first;
+    }
+
+    /**
+     * @brief 在分段迭代器范围 [first, last) 中逐段调用 find_local(local_first, local_last) 查找，
+     * 返回第一个段内找到的位置。
+     * @tparam SegmentedIterator 分段迭代器类型。
+     * @tparam LocalFind 段内查找函数的类型，找不到时返回 local_last。
+     */
+    template <typename SegmentedIterator, typename LocalFind>
+    SegmentedIterator __find_segmented(SegmentedIterator first, SegmentedIterator last, LocalFind&& find_local) {
+        using traits = __segmented_iterator_traits<SegmentedIterator>;
+        if (first == last) {
+            return last;
+        }
+        auto sfirst = traits::segment(first);
+        auto slast = traits::segment(last);
+        if (sfirst == slast) {
+            return traits::compose(sfirst, find_local(traits::local(first), traits::local(last)));
+        }
+        auto lend = traits::end(sfirst);
+        auto found = find_local(traits::local(first), lend);
+        if (found != lend) {
+            return traits::compose(sfirst, found);
+        }
+        for (++sfirst; sfirst != slast; ++sfirst) {
+            lend = traits::end(sfirst);
+            found = find_local(traits::begin(sfirst), lend);
+            if (found != lend) {
+                return traits::compose(sfirst, found);
+            }
+        }
+        return traits::compose(slast, find_local(traits::begin(slast), traits::local(last)));
+    }
+
+    /**
+     * @brief 在 [first, last) 中查找第一个满足 pred 的元素。分段迭代器按缓冲区逐段查找。
+     * @tparam InputIterator 输入迭代器类型。
+     * @tparam Predicate 谓词类型。
+     * @param first 起始迭代器。
+     * @param last 结束迭代器。
+     * @param pred 谓词。
+     * @return 指向找到的元素的迭代器，找不到时返回 last。
+     */
+    template <typename InputIterator, typename Predicate>
+    InputIterator find_if(InputIterator first, InputIterator last, Predicate pred) {
+        if constexpr (__is_segmented_iterator_v<InputIterator>) {
+            return tiny_stl::__find_segmented(first, last, [&pred](auto lfirst, auto llast) {
+                return tiny_stl::find_if(lfirst, llast, pred);
+            });
+        } else {
+            for (; first != last; ++first) {
+                if (pred(*first)) {
+                    break;
+                }
+            }
+            return first;
+        }
+    }
+
+    /**
+     * @brief 在 [first, last) 中查找第一个等于 value 的元素。
+     * 元素为整数的连续区间（指针、vector、array 以及 deque 的每个缓冲区）用 SIMD 每次比较 16 字节。
+     * @tparam InputIterator 输入迭代器类型。
+     * @tparam T 值的类型。
+     * @param first 起始迭代器。
+     * @param last 结束迭代器。
+     * @param value 要查找的值。
+     * @return 指向找到的元素的迭代器，找不到时返回 last。
+     */
+    template <typename InputIterator, typename T>
+    InputIterator find(InputIterator first, InputIterator last, const T& value) {
+#if defined(TINY_STL_ALGORITHM_SSE2)
+        if constexpr (__simd_searchable_v<InputIterator, T>) {
+            using element_type = std::remove_cv_t<std::remove_pointer_t<InputIterator>>;
+            // 整数提升之后 == 是单射，因此只有 element_type(value) 可能等于 value
+            if (!(static_cast<element_type>(value) == value)) {
+                return last;
+            }
+            return tiny_stl::__simd_find(first, last, static_cast<element_type>(value));
+        }
+#endif
+        if constexpr (__is_segmented_iterator_v<InputIterator>) {
+            return tiny_stl::__find_segmented(first, last, [&value](auto lfirst, auto llast) {
+                return tiny_stl::find(lfirst, llast, value);
+            });
+        } else {
+            return tiny_stl::find_if(first, last, [&value](const auto& x) { return x == value; });
+        }
+    }
+
+    /**
+     * @brief 统计 [first, last) 中满足 pred 的元素个数。分段迭代器按缓冲区逐段统计。
+     * @tparam InputIterator 输入迭代器类型。
+     * @tparam Predicate 谓词类型。
+     * @param first 起始迭代器。
+     * @param last 结束迭代器。
+     * @param pred 谓词。
+     * @return 满足 pred 的元素个数。
+     */
+    template <typename InputIterator, typename Predicate>
+    typename iterator_traits<InputIterator>::difference_type
+    count_if(InputIterator first, InputIterator last, Predicate pred) {
+        typename iterator_traits<InputIterator>::difference_type n = 0;
+        if constexpr (__is_segmented_iterator_v<InputIterator>) {
+            __for_each_segment(first, last, [&n, &pred](auto lfirst, auto llast) {
+                n += tiny_stl::count_if(lfirst, llast, pred);
+            });
+        } else {
+            for (; first != last; ++first) {
+                if (pred(*first)) {
+                    ++n;
+                }
+            }
+        }
+        return n;
+    }
+
+    /**
+     * @brief 统计 [first, last) 中等于 value 的元素个数。元素为整数的连续区间用 SIMD 统计。
+     * @tparam InputIterator 输入迭代器类型。
+     * @tparam T 值的类型。
+     * @param first 起始迭代器。
+     * @param last 结束迭代器。
+     * @param value 要统计的值。
+     * @return 等于 value 的元素个数。
+     */
+    template <typename InputIterator, typename T>
+    typename iterator_traits<InputIterator>::difference_type
+    count(InputIterator first, InputIterator last, const T& value) {
+        using difference_type = typename iterator_traits<InputIterator>::difference_type;
+#if defined(TINY_STL_ALGORITHM_SSE2)
+        if constexpr (__simd_searchable_v<InputIterator, T>) {
+            using element_type = std::remove_cv_t<std::remove_pointer_t<InputIterator>>;
+            if (!(static_cast<element_type>(value) == value)) {
+                return 0;
+            }
+            return static_cast<difference_type>(tiny_stl::__simd_count(first, last, static_cast<element_type>(value)));
+        }
+#endif
+        if constexpr (__is_segmented_iterator_v<InputIterator>) {
+            difference_type n = 0;
+            __for_each_segment(first, last, [&n, &value](auto lfirst, auto llast) {
+                n += tiny_stl::count(lfirst, llast, value);
+            });
+            return n;
+        } else {
+            return tiny_stl::count_if(first, last, [&value](const auto& x) { return x == value; });
+        }
+    }
+
+    /**
+     * @struct __is_bitwise_assignable
+     * @brief 判断从 `InputIt` 到 `OutputIt` 的逐个赋值能否用 `memmove` 完成。
+     * 要求两者都是指向同一（忽略 const）平凡可复制类型的指针，且对应的赋值是平凡的。
+     * @tparam InputIt 源迭代器类型
+     * @tparam OutputIt 目标迭代器类型
+     */
+    template <typename InputIt, typename OutputIt>
+    struct __is_bitwise_assignable : std::false_type { };
+
+    template <typename T, typename U>
+    struct __is_bitwise_assignable<T*, U*> : std::integral_constant<bool,
+        std::is_same<std::remove_const_t<T>, U>::value &&
+        std::is_trivially_copyable<U>::value &&
+        std::is_trivially_assignable<U&, T&>::value> { };
+
+    /**
+     * @brief 把连续区间 [first, last) 复制到 d_first 开始的位置，目标可以是分段迭代器。
+     * 目标为分段迭代器时按目标的缓冲区拆分，每一段都是指针到指针的复制。
+     * @tparam Pointer 源指针类型。
+     * @tparam OutputIterator 目标迭代器类型。
+     * @param first 源区间的起始指针。
+     * @param last 源区间的结束指针。
+     * @param d_first 目标起始迭代器。
+     * @return 目标范围的结束迭代器。
+     */
+    template <typename Pointer, typename OutputIterator>
+    OutputIterator __copy_contiguous(Pointer first, Pointer last, OutputIterator d_first) {
+        if constexpr (__is_segmented_iterator_v<OutputIterator>) {
+            using traits = __segmented_iterator_traits<OutputIterator>;
+            while (first != last) {
+                auto seg = traits::segment(d_first);
+                auto lfirst = traits::local(d_first);
+                ptrdiff_t room = traits::end(seg) - lfirst;
+                ptrdiff_t n = last - first < room ? last - first : room;
+                __copy_contiguous(first, first + n, lfirst);
+                first += n;
+                d_first += n;
+            }
+            return d_first;
+        } else if constexpr (__is_bitwise_assignable<Pointer, OutputIterator>::value) {
+            size_t n = static_cast<size_t>(last - first);
+            if (n != 0) {
+                std::memmove(static_cast<void*>(d_first), static_cast<const void*>(first), n * sizeof(*first));
+            }
+            return d_first + n;
+        } else {
+            for (; first != last; ++first, (void)++d_first) {
+                *d_first = *first;
+            }
+            return d_first;
+        }
+    }
+
+    /**
+     * @brief 把 [first, last) 复制到 d_first 开始的位置，d_first 不能位于 [first, last) 内。
+     *
+     * 源或目标为分段迭代器时按缓冲区逐段复制；两端都是指向平凡可复制类型的指针时使用 memmove。
+     *
+     * @tparam InputIterator 输入迭代器类型。
+     * @tparam OutputIterator 输出迭代器类型。
+     * @param first 源范围的起始迭代器。
+     * @param last 源范围的结束迭代器。
+     * @param d_first 目标起始迭代器。
+     * @return 目标范围的结束迭代器。
+     */
+    template <typename InputIterator, typename OutputIterator>
+    OutputIterator copy(InputIterator first, InputIterator last, OutputIterator d_first) {
+        if constexpr (__is_segmented_iterator_v<InputIterator>) {
+            __for_each_segment(first, last, [&d_first](auto lfirst, auto llast) {
+                d_first = __copy_contiguous(lfirst, llast, d_first);
+            });
+            return d_first;
+        } else if constexpr (std::is_pointer<InputIterator>::value) {
+            return __copy_contiguous(first, last, d_first);
+        } else {
+            for (; first != last; ++first, (void)++d_first) {
+                *d_first = *first;
+            }
+            return d_first;
+        }
+    }
+
+    /**
+     * @brief 把 [first, last) 从后往前复制到以 d_last 结尾的位置，d_last 不能位于 (first, last] 内。
+     * 两端都是指向平凡可复制类型的指针时使用 memmove。
+     * @tparam BidirectionalIterator1 源迭代器类型。
+     * @tparam BidirectionalIterator2 目标迭代器类型。
+     * @param first 源范围的起始迭代器。
+     * @param last 源范围的结束迭代器。
+     * @param d_last 目标范围的结束迭代器。
+     * @return 目标范围的起始迭代器。
+     */
+    template <typename BidirectionalIterator1, typename BidirectionalIterator2>
+    BidirectionalIterator2 copy_backward(BidirectionalIterator1 first, BidirectionalIterator1 last,
+                                         BidirectionalIterator2 d_last) {
+        if constexpr (__is_bitwise_assignable<BidirectionalIterator1, BidirectionalIterator2>::value) {
+            size_t n = static_cast<size_t>(last - first);
+            d_last -= n;
+            if (n != 0) {
+                std::memmove(static_cast<void*>(d_last), static_cast<const void*>(first), n * sizeof(*first));
+            }
+            return d_last;
+        } else {
+            while (first != last) {
+                *--d_last = *--last;
+            }
+            return d_last;
+        }
+    }
+
+    /**
+     * @brief 返回两个值中较小的一个，相等时返回 a。
+     * @tparam T 值的类型。
+     * @param a 第一个值。
+     * @param b 第二个值。
+     * @return 较小的值。
+     */
+    template <typename T>
+    constexpr const T& min(const T& a, const T& b) {
+        return b < a ? b : a;
+    }
+
+    /**
+     * @brief 返回两个值中较大的一个，相等时返回 a。
+     * @tparam T 值的类型。
+     * @param a 第一个值。
+     * @param b 第二个值。
+     * @return 较大的值。
+     */
+    template <typename T>
+    constexpr const T& max(const T& a, const T& b) {
+        return a < b ? b : a;
+    }
+
+    /**
+     * @struct __is_bitwise_comparable
+     * @brief 判断 `InputIt1` 与 `InputIt2` 指向的元素能否用 `memcmp` 比较相等：
+     * 两者都是指向同一（忽略 const）整数或指针类型的指针，这些类型的 == 与逐字节相等一致。
+     * @tparam InputIt1 第一个迭代器类型
+     * @tparam InputIt2 第二个迭代器类型
+     */
+    template <typename InputIt1, typename InputIt2>
+    struct __is_bitwise_comparable : std::false_type { };
+
+    template <typename T, typename U>
+    struct __is_bitwise_comparable<T*, U*> : std::integral_constant<bool,
+        std::is_same<std::remove_cv_t<T>, std::remove_cv_t<U>>::value &&
+        (std::is_integral<std::remove_cv_t<T>>::value || std::is_pointer<std::remove_cv_t<T>>::value)> { };
+
+    /**
+     * @brief 判断 [first1, last1) 与从 first2 开始的等长范围是否逐个满足 pred。
+     * @tparam InputIt1 第一个范围的迭代器类型。
+     * @tparam InputIt2 第二个范围的迭代器类型。
+     * @tparam BinaryPredicate 谓词类型。
+     * @param first1 第一个范围的起始迭代器。
+     * @param last1 第一个范围的结束迭代器。
+     * @param first2 第二个范围的起始迭代器。
+     * @param pred 谓词。
+     * @return 所有元素都满足 pred 时返回 true。
+     */
+    template <typename InputIt1, typename InputIt2, typename BinaryPredicate>
+    constexpr bool equal(InputIt1 first1, InputIt1 last1, InputIt2 first2, BinaryPredicate pred) {
+        for (; first1 != last1; ++first1, ++first2) {
+            if (!pred(*first1, *first2)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief 判断 [first1, last1) 与从 first2 开始的等长范围是否逐个相等。
+     * 整数或指针的连续区间用 memcmp 比较，它按机器字长或 SIMD 寄存器宽度一次比较多个字节；
+     * 常量求值时逐个比较。
+     * @tparam InputIt1 第一个范围的迭代器类型。
+     * @tparam InputIt2 第二个范围的迭代器类型。
+     * @param first1 第一个范围的起始迭代器。
+     * @param last1 第一个范围的结束迭代器。
+     * @param first2 第二个范围的起始迭代器。
+     * @return 所有元素都相等时返回 true。
+     */
+    template <typename InputIt1, typename InputIt2>
+    constexpr bool equal(InputIt1 first1, InputIt1 last1, InputIt2 first2) {
+        if constexpr (__is_bitwise_comparable<InputIt1, InputIt2>::value) {
+            if (!tiny_stl::__is_constant_evaluated()) {
+                size_t n = static_cast<size_t>(last1 - first1);
+                return n == 0 || std::memcmp(first1, first2, n * sizeof(*first1)) == 0;
+            }
+        }
+        return tiny_stl::equal(first1, last1, first2, [](const auto& a, const auto& b) { return a == b; });
+    }
+
+    /**
+     * @brief 返回两个长度为 n 的字节序列中第一个不相等的字节的下标，全部相等时返回 n。
+     * 启用 SSE2 时每次迭代比较 64 字节，否则每次比较一个 8 字节的字，最后逐字节找到不相等的位置。
+     */
+    inline size_t __mismatch_bytes(const unsigned char* a, const unsigned char* b, size_t n) noexcept {
+        size_t i = 0;
+#if defined(TINY_STL_ALGORITHM_SSE2)
+        for (; n - i >= 64; i += 64) {
+            __m128i e0 = _mm_cmpeq_epi8(__simd_load(a + i), __simd_load(b + i));
+            __m128i e1 = _mm_cmpeq_epi8(__simd_load(a + i + 16), __simd_load(b + i + 16));
+            __m128i e2 = _mm_cmpeq_epi8(__simd_load(a + i + 32), __simd_load(b + i + 32));
+            __m128i e3 = _mm_cmpeq_epi8(__simd_load(a + i + 48), __simd_load(b + i + 48));
+            if (_mm_movemask_epi8(_mm_and_si128(_mm_and_si128(e0, e1), _mm_and_si128(e2, e3))) != 0xFFFF) {
+                uint64_t mask = static_cast<uint64_t>(static_cast<unsigned>(_mm_movemask_epi8(e0)))
+                              | static_cast<uint64_t>(static_cast<unsigned>(_mm_movemask_epi8(e1))) << 16
+                              | static_cast<uint64_t>(static_cast<unsigned>(_mm_movemask_epi8(e2))) << 32
+                              | static_cast<uint64_t>(static_cast<unsigned>(_mm_movemask_epi8(e3))) << 48;
+                return i + __countr_zero(~mask);
+            }
+        }
+        for (; n - i >= 16; i += 16) {
+            unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(__simd_load(a + i), __simd_load(b + i))));
+            if (mask != 0xFFFF) {
+                return i + __countr_zero(~mask & 0xFFFFu);
+            }
+        }
+#else
+        for (; n - i >= 8; i += 8) {
+            uint64_t x, y;
+            std::memcpy(&x, a + i, 8);
+            std::memcpy(&y, b + i, 8);
+            if (x != y) {
+                break;
+            }
+        }
+#endif
+        for (; i < n && a[i] == b[i]; ++i) { }
+        return i;
+    }
+
+    /**
+     * @brief 查找 [first1, last1) 与从 first2 开始的等长范围中第一对不满足 pred 的元素。
+     * @tparam InputIt1 第一个范围的迭代器类型。
+     * @tparam InputIt2 第二个范围的迭代器类型。
+     * @tparam BinaryPredicate 谓词类型。
+     * @param first1 第一个范围的起始迭代器。
+     * @param last1 第一个范围的结束迭代器。
+     * @param first2 第二个范围的起始迭代器。
+     * @param pred 谓词。
+     * @return 指向这对元素的两个迭代器，都满足时第一个为 last1。
+     */
+    template <typename InputIt1, typename InputIt2, typename BinaryPredicate>
+    constexpr pair<InputIt1, InputIt2> mismatch(InputIt1 first1, InputIt1 last1, InputIt2 first2, BinaryPredicate pred) {
+        for (; first1 != last1 && pred(*first1, *first2); ++first1, ++first2) { }
+        return pair<InputIt1, InputIt2>(first1, first2);
+    }
+
+    /**
+     * @brief 查找 [first1, last1) 与从 first2 开始的等长范围中第一对不相等的元素。
+     * 整数或指针的连续区间按字节查找第一个不相等的字节，它所在的元素就是第一个不相等的元素；常量求值时逐个比较。
+     * @return 指向这对元素的两个迭代器，都相等时第一个为 last1。
+     */
+    template <typename InputIt1, typename InputIt2>
+    constexpr pair<InputIt1, InputIt2> mismatch(InputIt1 first1, InputIt1 last1, InputIt2 first2) {
+        if constexpr (__is_bitwise_comparable<InputIt1, InputIt2>::value) {
+            if (!tiny_stl::__is_constant_evaluated()) {
+                size_t n = static_cast<size_t>(last1 - first1);
+                size_t k = tiny_stl::__mismatch_bytes(reinterpret_cast<const unsigned char*>(first1),
+                                                      reinterpret_cast<const unsigned char*>(first2),
+                                                      n * sizeof(*first1)) / sizeof(*first1);
+                return pair<InputIt1, InputIt2>(first1 + k, first2 + k);
+            }
+        }
+        return tiny_stl::mismatch(first1, last1, first2, [](const auto& a, const auto& b) { return a == b; });
+    }
+
+    /**
+     * @brief 按字典序比较 [first1, last1) 与 [first2, last2)。
+     * @tparam InputIt1 第一个范围的迭代器类型。
+     * @tparam InputIt2 第二个范围的迭代器类型。
+     * @tparam Compare 比较函数的类型。
+     * @param first1 第一个范围的起始迭代器。
+     * @param last1 第一个范围的结束迭代器。
+     * @param first2 第二个范围的起始迭代器。
+     * @param last2 第二个范围的结束迭代器。
+     * @param comp 比较函数。
+     * @return 第一个范围小于第二个范围时返回 true。
+     */
+    template <typename InputIt1, typename InputIt2, typename Compare>
+    constexpr bool lexicographical_compare(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2, Compare comp) {
+        for (; first1 != last1 && first2 != last2; ++first1, ++first2) {
+            if (comp(*first1, *first2)) {
+                return true;
+            }
+            if (comp(*first2, *first1)) {
+                return false;
+            }
+        }
+        return first1 == last1 && first2 != last2;
+    }
+
+    /**
+     * @brief 按字典序比较两个整数或指针的连续区间的快速路径，见 lexicographical_compare。
+     */
+    template <typename T>
+    bool __lexicographical_compare_bytes(const T* first1, const T* last1, const T* first2, const T* last2) noexcept {
+        using element_type = std::remove_cv_t<T>;
+        size_t n1 = static_cast<size_t>(last1 - first1);
+        size_t n2 = static_cast<size_t>(last2 - first2);
+        size_t n = n1 < n2 ? n1 : n2;
+        if constexpr (sizeof(element_type) == 1 && std::is_unsigned<element_type>::value) {
+            int r = n == 0 ? 0 : std::memcmp(first1, first2, n);
+            if (r != 0) {
+                return r < 0;
+            }
+        } else {
+            size_t k = tiny_stl::__mismatch_bytes(reinterpret_cast<const unsigned char*>(first1),
+                                                  reinterpret_cast<const unsigned char*>(first2),
+                                                  n * sizeof(element_type)) / sizeof(element_type);
+            if (k < n) {
+                return first1[k] < first2[k];
+            }
+        }
+        return n1 < n2;
+    }
+
+    /**
+     * @brief 按字典序用 operator< 比较 [first1, last1) 与 [first2, last2)。
+     * 整数或指针的连续区间先按字节找到第一个不相等的元素，只比较这一对；
+     * 单字节的无符号整数的大小与 memcmp 的字节序一致，直接用 memcmp 比较。常量求值时逐个比较。
+     * @return 第一个范围小于第二个范围时返回 true。
+     */
+    template <typename InputIt1, typename InputIt2>
+    constexpr bool lexicographical_compare(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2) {
+        if constexpr (__is_bitwise_comparable<InputIt1, InputIt2>::value) {
+            if (!tiny_stl::__is_constant_evaluated()) {
+                return tiny_stl::__lexicographical_compare_bytes(first1, last1, first2, last2);
+            }
+        }
+        return tiny_stl::lexicographical_compare(first1, last1, first2, last2,
+                                                 [](const auto& a, const auto& b) { return a < b; });
+    }
+
+    /**
+     * @brief 判断能否用 SIMD 求 [first, last) 的最值：元素为 1、2、4 字节整数（bool 除外）的指针，比较函数为 `less`。
+     */
+    template <typename Iterator, typename Compare>
+    constexpr bool __simd_minmax_v = false;
+
+#if defined(TINY_STL_ALGORITHM_SSE2)
+    template <typename E, typename Compare>
+    constexpr bool __simd_minmax_v<E*, Compare> = __simd_integral_v<std::remove_cv_t<E>> && sizeof(E) <= 4 &&
+        std::is_same<Compare, less<std::remove_cv_t<E>>>::value;
+#endif
+
+    /**
+     * @brief 查找 [first, last) 中第一个最小的元素。
+     * 元素为整数的连续区间先用 SIMD 求出最小值，再用 SIMD 查找它第一次出现的位置。
+     * @tparam ForwardIt 前向迭代器类型。
+     * @tparam Compare 比较函数的类型。
+     * @param first 起始迭代器。
+     * @param last 结束迭代器。
+     * @param comp 比较函数，默认为 `less`。
+     * @return 指向最小元素的迭代器，范围为空时返回 last。
+     */
+    template <typename ForwardIt, typename Compare>
+    ForwardIt min_element(ForwardIt first, ForwardIt last, Compare comp) {
+        if (first == last) {
+            return last;
+        }
+#if defined(TINY_STL_ALGORITHM_SSE2)
+        if constexpr (__simd_minmax_v<ForwardIt, Compare>) {
+            std::remove_cv_t<std::remove_pointer_t<ForwardIt>> min_value, max_value;
+            tiny_stl::__simd_minmax(first, last, min_value, max_value);
+            return tiny_stl::__simd_find(first, last, min_value);
+        }
+#endif
+        ForwardIt result = first;
+        while (++first != last) {
+            if (comp(*first, *result)) {
+                result = first;
+            }
+        }
+        return result;
+    }
+
+    template <typename ForwardIt>
+    ForwardIt min_element(ForwardIt first, ForwardIt last) {
+        return tiny_stl::min_element(first, last, less<typename iterator_traits<ForwardIt>::value_type>());
+    }
+
+    /**
+     * @brief 查找 [first, last) 中第一个最大的元素。
+     * @tparam ForwardIt 前向迭代器类型。
+     * @tparam Compare 比较函数的类型。
+     * @param first 起始迭代器。
+     * @param last 结束迭代器。
+     * @param comp 比较函数，默认为 `less`。
+     * @return 指向最大元素的迭代器，范围为空时返回 last。
+     */
+    template <typename ForwardIt, typename Compare>
+    ForwardIt max_element(ForwardIt first, ForwardIt last, Compare comp) {
+        if (first == last) {
+            return last;
+        }
+#if defined(TINY_STL_ALGORITHM_SSE2)
+        if constexpr (__simd_minmax_v<ForwardIt, Compare>) {
+            std::remove_cv_t<std::remove_pointer_t<ForwardIt>> min_value, max_value;
+            tiny_stl::__simd_minmax(first, last, min_value, max_value);
+            return tiny_stl::__simd_find(first, last, max_value);
+        }
+#endif
+        ForwardIt result = first;
+        while (++first != last) {
+            if (comp(*result, *first)) {
+                result = first;
+            }
+        }
+        return result;
+    }
+
+    template <typename ForwardIt>
+    ForwardIt max_element(ForwardIt first, ForwardIt last) {
+        return tiny_stl::max_element(first, last, less<typename iterator_traits<ForwardIt>::value_type>());
+    }
+
+    /**
+     * @brief 同时查找 [first, last) 中第一个最小的元素与最后一个最大的元素。
+     * 通用版本每两个元素只比较三次；元素为整数的连续区间用 SIMD 一趟求出两个最值，
+     * 再分别从前、从后查找它们的位置。
+     * @tparam ForwardIt 前向迭代器类型。
+     * @tparam Compare 比较函数的类型。
+     * @param first 起始迭代器。
+     * @param last 结束迭代器。
+     * @param comp 比较函数，默认为 `less`。
+     * @return 指向最小元素与最大元素的迭代器，范围为空时均为 last。
+     */
+    template <typename ForwardIt, typename Compare>
+    pair<ForwardIt, ForwardIt> minmax_element(ForwardIt first, ForwardIt last, Compare comp) {
+        pair<ForwardIt, ForwardIt> result(first, first);
+        if (first == last) {
+            return result;
+        }
+#if defined(TINY_STL_ALGORITHM_SSE2)
+        if constexpr (__simd_minmax_v<ForwardIt, Compare>) {
+            std::remove_cv_t<std::remove_pointer_t<ForwardIt>> min_value, max_value;
+            tiny_stl::__simd_minmax(first, last, min_value, max_value);
+            result.first = tiny_stl::__simd_find(first, last, min_value);
+            result.second = tiny_stl::__simd_find_last(first, last, max_value);
+            return result;
+        }
+#endif
+        while (++first != last) {
+            ForwardIt i = first;
+            if (++first == last) {
+                if (comp(*i, *result.first)) {
+                    result.first = i;
+                } else if (!comp(*i, *result.second)) {
+                    result.second = i;
+                }
+                break;
+            }
+            if (comp(*first, *i)) {
+                if (comp(*first, *result.first)) {
+                    result.first = first;
+                }
+                if (!comp(*i, *result.second)) {
+                    result.second = i;
+                }
+            } else {
+                if (comp(*i, *result.first)) {
+                    result.first = i;
+                }
+                if (!comp(*first, *result.second)) {
+                    result.second = first;
+                }
+            }
+        }
+        return result;
+    }
+
+    template <typename ForwardIt>
+    pair<ForwardIt, ForwardIt> minmax_element(ForwardIt first, ForwardIt last) {
+        return tiny_stl::minmax_element(first, last, less<typename iterator_traits<ForwardIt>::value_type>());
+    }
+
+    // ==================== 排序与二分查找 ====================
+
+    /**
+     * @brief 对 [first, last) 做插入排序，相等的元素保持原有的相对顺序。
+     * @tparam RandomIt 随机访问迭代器类型。
+     * @tparam Compare 比较函数的类型。
+     * @param first 起始迭代器。
+     * @param last 结束迭代器。
+     * @param comp 比较函数。
+     */
+    template <typename RandomIt, typename Compare>
+    void __insertion_sort(RandomIt first, RandomIt last, Compare& comp) {
+        if (first == last) {
+            return;
+        }
+        for (RandomIt i = first + 1; i != last; ++i) {
+            if (!comp(*i, *(i - 1))) {
+                continue;
+            }
+            auto value = tiny_stl::move(*i);
+            RandomIt j = i;
+            do {
+                *j = tiny_stl::move(*(j - 1));
+                --j;
+            } while (j != first && comp(value, *(j - 1)));
+            *j = tiny_stl::move(value);
+        }
+    }
+
+    /**
+     * @brief 把两个有序区间归并到 out，相等时先取第一个区间的元素。
+     * @return 输出的结束位置。
+     */
+    template <typename InputIt1, typename InputIt2, typename OutputIt, typename Compare>
+    OutputIt __move_merge(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2,
+                          OutputIt out, Compare& comp) {
+        while (first1 != last1 && first2 != last2) {
+            if (comp(*first2, *first1)) {
+                *out = tiny_stl::move(*first2);
+                ++first2;
+            } else {
+                *out = tiny_stl::move(*first1);
+                ++first1;
+            }
+            ++out;
+        }
+        for (; first1 != last1; ++first1, ++out) {
+            *out = tiny_stl::move(*first1);
+        }
+        for (; first2 != last2; ++first2, ++out) {
+            *out = tiny_stl::move(*first2);
+        }
+        return out;
+    }
+
+    /**
+     * @brief 把 src 中每两个长度为 step 的相邻有序段归并到 dst 的相同位置。
+     */
+    template <typename SourceIt, typename DestIt, typename Compare>
+    void __merge_pass(SourceIt src, DestIt dst, ptrdiff_t n, ptrdiff_t step, Compare& comp) {
+        for (ptrdiff_t i = 0; i < n; i += 2 * step) {
+            ptrdiff_t mid = i + step < n ? i + step : n;
+            ptrdiff_t end = i + 2 * step < n ? i + 2 * step : n;
+            tiny_stl::__move_merge(src + i, src + mid, src + mid, src + end, dst + i, comp);
+        }
+    }
+
+    /**
+     * @brief 稳定排序：相等的元素保持原有的相对顺序。
+     *
+     * 自底向上的归并排序：先对每 32 个元素做插入排序，再在原区间与一块同样大小的缓冲区之间
+     * 来回归并，每一趟都是顺序读写，时间复杂度 O(n log n)，额外空间 O(n)。
+     * 比较或移动抛出异常时缓冲区被释放，区间中的元素有效但顺序未指定。
+     *
+     * @tparam RandomIt 随机访问迭代器类型。
+     * @tparam Compare 比较函数的类型。
+     * @param first 起始迭代器。
+     * @param last 结束迭代器。
+     * @param comp 比较函数，默认为 `<`。
+     */
+    template <typename RandomIt, typename Compare>
+    void stable_sort(RandomIt first, RandomIt last, Compare comp) {
+        using value_type = typename iterator_traits<RandomIt>::value_type;
+        constexpr ptrdiff_t chunk = 32;
+        ptrdiff_t n = last - first;
+        for (ptrdiff_t i = 0; i < n; i += chunk) {
+            tiny_stl::__insertion_sort(first + i, first + (i + chunk < n ? i + chunk : n), comp);
+        }
+        if (n <= chunk) {
+            return;
+        }
+        __temporary_buffer<value_type> temp(static_cast<size_t>(n));
+        value_type* buffer = temp.data();
+        tiny_stl::uninitialized_move(first, last, buffer);
+        temp.set_size(static_cast<size_t>(n));
+        bool in_buffer = true;
+        for (ptrdiff_t step = chunk; step < n; step *= 2, in_buffer = !in_buffer) {
+            if (in_buffer) {
+                tiny_stl::__merge_pass(buffer, first, n, step, comp);
+            } else {
+                tiny_stl::__merge_pass(first, buffer, n, step, comp);
+            }
+        }
+        if (in_buffer) {
+            for (ptrdiff_t i = 0; i < n; ++i) {
+                first[i] = tiny_stl::move(buffer[i]);
+            }
+        }
+    }
+
+    /**
+     * @brief 稳定排序，使用 `<` 比较元素。
+     */
+    template <typename RandomIt>
+    void stable_sort(RandomIt first, RandomIt last) {
+        tiny_stl::stable_sort(first, last, [](const auto& a, const auto& b) { return a < b; });
+    }
+
+    constexpr ptrdiff_t __sort_insertion_threshold = 24; /**< 短于此长度的区间用插入排序 */
+    constexpr ptrdiff_t __sort_ninther_threshold = 128; /**< 长于此长度的区间用九数取中选择枢轴 */
+    constexpr ptrdiff_t __sort_partial_insertion_limit = 8; /**< 试探性插入排序最多移动的元素数 */
+    constexpr ptrdiff_t __sort_block_size = 64; /**< 无分支划分每块的元素数 */
+
+    /**
+     * @brief 判断 Compare 是否为 T 的内置比较函数（`less` 或 `greater`）：
+     * 比较本身没有副作用也很便宜，可以不根据比较结果跳转，而是把结果当作整数参与运算。
+     */
+    template <typename Compare, typename T>
+    struct __is_builtin_compare : std::false_type { };
+
+    template <typename T>
+    struct __is_builtin_compare<less<T>, T> : std::true_type { };
+
+    template <typename T>
+    struct __is_builtin_compare<greater<T>, T> : std::true_type { };
+
+    template <typename RandomIt, typename Compare>
+    void __sort2(RandomIt a, RandomIt b, Compare& comp) {
+        if (comp(*b, *a)) {
+            tiny_stl::swap(*a, *b);
+        }
+    }
+
+    /**
+     * @brief 把 *a、*b、*c 排成有序
+     */
+    template <typename RandomIt, typename Compare>
+    void __sort3(RandomIt a, RandomIt b, RandomIt c, Compare& comp) {
+        tiny_stl::__sort2(a, b, comp);
+        tiny_stl::__sort2(b, c, comp);
+        tiny_stl::__sort2(a, b, comp);
+    }
+
+    /**
+     * @brief 插入排序，要求 first 之前的元素不大于区间内的任何元素，内层循环因此不必检查边界。
+     */
+    template <typename RandomIt, typename Compare>
+    void __unguarded_insertion_sort(RandomIt first, RandomIt last, Compare& comp) {
+        if (first == last) {
+            return;
+        }
+        for (RandomIt i = first + 1; i != last; ++i) {
+            if (!comp(*i, *(i - 1))) {
+                continue;
+            }
+            auto value = tiny_stl::move(*i);
+            RandomIt j = i;
+            do {
+                *j = tiny_stl::move(*(j - 1));
+                --j;
+            } while (comp(value, *(j - 1)));
+            *j = tiny_stl::move(value);
+        }
+    }
+
+    /**
+     * @brief 试探性的插入排序：移动的元素超过 __sort_partial_insertion_limit 个时放弃。
+     * @return 区间是否已经排好序。
+     */
+    template <typename RandomIt, typename Compare>
+    bool __partial_insertion_sort(RandomIt first, RandomIt last, Compare& comp) {
+        if (first == last) {
+            return true;
+        }
+        ptrdiff_t moved = 0;
+        for (RandomIt i = first + 1; i != last; ++i) {
+            if (!comp(*i, *(i - 1))) {
+                continue;
+            }
+            auto value = tiny_stl::move(*i);
+            RandomIt j = i;
+            do {
+                *j = tiny_stl::move(*(j - 1));
+                --j;
+            } while (j != first && comp(value, *(j - 1)));
+            *j = tiny_stl::move(value);
+            moved += i - j;
+            if (moved > __sort_partial_insertion_limit) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief 堆的下滤：把 first[hole] 沿较大的子节点下移到合适的位置。
+     */
+    template <typename RandomIt, typename Compare>
+    void __sift_down(RandomIt first, ptrdiff_t len, ptrdiff_t hole, Compare& comp) {
+        auto value = tiny_stl::move(first[hole]);
+        for (ptrdiff_t child; (child = 2 * hole + 1) < len; hole = child) {
+            if (child + 1 < len && comp(first[child], first[child + 1])) {
+                ++child;
+            }
+            if (!comp(value, first[child])) {
+                break;
+            }
+            first[hole] = tiny_stl::move(first[child]);
+        }
+        first[hole] = tiny_stl::move(value);
+    }
+
+    /**
+     * @brief 堆排序，最坏 O(n log n)。快速排序的划分连续失衡时改用它。
+     */
+    template <typename RandomIt, typename Compare>
+    void __heap_sort(RandomIt first, RandomIt last, Compare& comp) {
+        ptrdiff_t n = last - first;
+        for (ptrdiff_t i = n / 2 - 1; i >= 0; --i) {
+            tiny_stl::__sift_down(first, n, i, comp);
+        }
+        for (ptrdiff_t end = n - 1; end > 0; --end) {
+            tiny_stl::swap(first[0], first[end]);
+            tiny_stl::__sift_down(first, end, 0, comp);
+        }
+    }
+
+    /**
+     * @brief 选出枢轴放到 *first：一般取首、中、尾三数的中位数，长区间取九数取中（三组三数中位数的中位数）。
+     * 返回后 *(last - 1) 不小于枢轴，可以作为划分时向右扫描的哨兵。
+     */
+    template <typename RandomIt, typename Compare>
+    void __sort_choose_pivot(RandomIt first, RandomIt last, Compare& comp) {
+        ptrdiff_t n = last - first;
+        ptrdiff_t half = n / 2;
+        if (n > __sort_ninther_threshold) {
+            tiny_stl::__sort3(first, first + half, last - 1, comp);
+            tiny_stl::__sort3(first + 1, first + (half - 1), last - 2, comp);
+            tiny_stl::__sort3(first + 2, first + (half + 1), last - 3, comp);
+            tiny_stl::__sort3(first + (half - 1), first + half, first + (half + 1), comp);
+            tiny_stl::swap(*first, *(first + half));
+        } else {
+            tiny_stl::__sort3(first + half, first, last - 1, comp);
+        }
+    }
+
+    /**
+     * @brief 以 *first 为枢轴划分：小于枢轴的元素在左，其余在右，枢轴放到两部分之间。
+     * @return 枢轴的最终位置，以及划分前区间是否本来就已经划分好（没有交换任何元素）。
+     */
+    template <typename RandomIt, typename Compare>
+    pair<RandomIt, bool> __partition_right(RandomIt first, RandomIt last, Compare& comp) {
+        auto pivot = tiny_stl::move(*first);
+        RandomIt left = first;
+        RandomIt right = last;
+        while (comp(*++left, pivot)) { }
+        // 左边没有小于枢轴的元素时，右边的扫描没有哨兵，需要检查边界
+        if (left - 1 == first) {
+            while (left < right && !comp(*--right, pivot)) { }
+        } else {
+            while (!comp(*--right, pivot)) { }
+        }
+        bool already_partitioned = left >= right;
+        while (left < right) {
+            tiny_stl::swap(*left, *right);
+            while (comp(*++left, pivot)) { }
+            while (!comp(*--right, pivot)) { }
+        }
+        RandomIt pivot_pos = left - 1;
+        *first = tiny_stl::move(*pivot_pos);
+        *pivot_pos = tiny_stl::move(pivot);
+        return pair<RandomIt, bool>(pivot_pos, already_partitioned);
+    }
+
+    /**
+     * @brief 按两组偏移量交换左右两块中放错位置的元素。
+     * 两组数量相等时逐对交换；否则沿 左、右、左、右…… 轮转，每个元素只移动一次。
+     */
+    template <typename RandomIt>
+    void __swap_offsets(RandomIt first, RandomIt last, const unsigned char* offsets_l,
+                        const unsigned char* offsets_r, size_t num, bool use_swaps) {
+        if (use_swaps) {
+            for (size_t i = 0; i < num; ++i) {
+                tiny_stl::swap(*(first + offsets_l[i]), *(last - offsets_r[i]));
+            }
+        } else if (num > 0) {
+            RandomIt l = first + offsets_l[0];
+            RandomIt r = last - offsets_r[0];
+            auto tmp = tiny_stl::move(*l);
+            *l = tiny_stl::move(*r);
+            for (size_t i = 1; i < num; ++i) {
+                l = first + offsets_l[i];
+                *r = tiny_stl::move(*l);
+                r = last - offsets_r[i];
+                *l = tiny_stl::move(*r);
+            }
+            *r = tiny_stl::move(tmp);
+        }
+    }
+
+    /**
+     * @brief 与 __partition_right 相同的划分，但不根据比较结果跳转。
+     *
+     * 左右两端各取一块 __sort_block_size 个元素，先把比较结果当作 0/1 累加，
+     * 记下放错位置的元素的偏移量，再成对交换。随机数据下比较结果无法预测，
+     * 分支版本大约每两次比较就有一次预测失败，这里的内层循环则完全没有条件跳转。
+     */
+    template <typename RandomIt, typename Compare>
+    pair<RandomIt, bool> __partition_right_branchless(RandomIt first, RandomIt last, Compare& comp) {
+        auto pivot = tiny_stl::move(*first);
+        RandomIt left = first;
+        RandomIt right = last;
+        while (comp(*++left, pivot)) { }
+        if (left - 1 == first) {
+            while (left < right && !comp(*--right, pivot)) { }
+        } else {
+            while (!comp(*--right, pivot)) { }
+        }
+        bool already_partitioned = left >= right;
+        if (!already_partitioned) {
+            tiny_stl::swap(*left, *right);
+            ++left;
+
+            alignas(64) unsigned char offsets_l[__sort_block_size];
+            alignas(64) unsigned char offsets_r[__sort_block_size];
+            size_t num_l = 0, num_r = 0, start_l = 0, start_r = 0;
+            // [left, right) 是尚未划分的元素
+            while (right - left > 2 * __sort_block_size) {
+                if (num_l == 0) {
+                    start_l = 0;
+                    RandomIt it = left;
+                    for (unsigned char i = 0; i < __sort_block_size; ++i, ++it) {
+                        offsets_l[num_l] = i;
+                        num_l += !comp(*it, pivot);
+                    }
+                }
+                if (num_r == 0) {
+                    start_r = 0;
+                    RandomIt it = right;
+                    for (unsigned char i = 0; i < __sort_block_size;) {
+                        offsets_r[num_r] = ++i;
+                        num_r += comp(*--it, pivot);
+                    }
+                }
+                size_t num = num_l < num_r ? num_l : num_r;
+                tiny_stl::__swap_offsets(left, right, offsets_l + start_l, offsets_r + start_r, num, num_l == num_r);
+                num_l -= num;
+                num_r -= num;
+                start_l += num;
+                start_r += num;
+                if (num_l == 0) {
+                    left += __sort_block_size;
+                }
+                if (num_r == 0) {
+                    right -= __sort_block_size;
+                }
+            }
+
+            // 最后不足两块的部分：还有待交换偏移量的一侧保留整块，另一侧取剩下的元素
+            size_t l_size = 0, r_size = 0;
+            size_t unknown = static_cast<size_t>(right - left) - ((num_r || num_l) ? __sort_block_size : 0);
+            if (num_r) {
+                l_size = unknown;
+                r_size = __sort_block_size;
+            } else if (num_l) {
+                l_size = __sort_block_size;
+                r_size = unknown;
+            } else {
+                l_size = unknown / 2;
+                r_size = unknown - l_size;
+            }
+            if (unknown && num_l == 0) {
+                start_l = 0;
+                RandomIt it = left;
+                for (unsigned char i = 0; i < l_size; ++i, ++it) {
+                    offsets_l[num_l] = i;
+                    num_l += !comp(*it, pivot);
+                }
+            }
+            if (unknown && num_r == 0) {
+                start_r = 0;
+                RandomIt it = right;
+                for (unsigned char i = 0; i < r_size;) {
+                    offsets_r[num_r] = ++i;
+                    num_r += comp(*--it, pivot);
+                }
+            }
+            size_t num = num_l < num_r ? num_l : num_r;
+            tiny_stl::__swap_offsets(left, right, offsets_l + start_l, offsets_r + start_r, num, num_l == num_r);
+            num_l -= num;
+            num_r -= num;
+            start_l += num;
+            start_r += num;
+            if (num_l == 0) {
+                left += l_size;
+            }
+            if (num_r == 0) {
+                right -= r_size;
+            }
+
+            // 只剩一侧还有放错位置的元素，从远端开始把它们换到另一侧的边界上
+            if (num_l) {
+                while (num_l--) {
+                    tiny_stl::swap(*(left + offsets_l[start_l + num_l]), *--right);
+                }
+                left = right;
+            }
+            if (num_r) {
+                while (num_r--) {
+                    tiny_stl::swap(*(right - offsets_r[start_r + num_r]), *left);
+                    ++left;
+                }
+                right = left;
+            }
+        }
+        RandomIt pivot_pos = left - 1;
+        *first = tiny_stl::move(*pivot_pos);
+        *pivot_pos = tiny_stl::move(pivot);
+        return pair<RandomIt, bool>(pivot_pos, already_partitioned);
+    }
+
+    /**
+     * @brief 以 *first 为枢轴划分：不大于枢轴的元素在左，大于枢轴的在右。
+     * 用于区间内所有元素都不小于枢轴的情形（枢轴等于左边界之前的元素），等于枢轴的元素全部集中到左边。
+     * @return 枢轴的最终位置。
+     */
+    template <typename RandomIt, typename Compare>
+    RandomIt __partition_left(RandomIt first, RandomIt last, Compare& comp) {
+        auto pivot = tiny_stl::move(*first);
+        RandomIt left = first;
+        RandomIt right = last;
+        while (comp(pivot, *--right)) { }
+        if (right + 1 == last) {
+            while (left < right && !comp(pivot, *++left)) { }
+        } else {
+            while (!comp(pivot, *++left)) { }
+        }
+        while (left < right) {
+            tiny_stl::swap(*left, *right);
+            while (comp(pivot, *--right)) { }
+            while (!comp(pivot, *++left)) { }
+        }
+        RandomIt pivot_pos = right;
+        *first = tiny_stl::move(*pivot_pos);
+        *pivot_pos = tiny_stl::move(pivot);
+        return pivot_pos;
+    }
+
+    inline int __sort_log2(ptrdiff_t n) {
+        int log = 0;
+        while (n >>= 1) {
+            ++log;
+        }
+        return log;
+    }
+
+    /**
+     * @brief pattern-defeating quicksort 的主循环，对右半部分循环、对左半部分递归。
+     * @tparam Branchless 是否使用无分支的分块划分
+     * @param bad_allowed 还允许多少次严重失衡的划分，用完后改用堆排序
+     * @param leftmost 区间是否位于最左边；否则 *(first - 1) 不大于区间内的任何元素
+     */
+    template <bool Branchless, typename RandomIt, typename Compare>
+    void __pdqsort_loop(RandomIt first, RandomIt last, Compare& comp, int bad_allowed, bool leftmost) {
+        for (;;) {
+            ptrdiff_t n = last - first;
+            if (n < __sort_insertion_threshold) {
+                if (leftmost) {
+                    tiny_stl::__insertion_sort(first, last, comp);
+                } else {
+                    tiny_stl::__unguarded_insertion_sort(first, last, comp);
+                }
+                return;
+            }
+            tiny_stl::__sort_choose_pivot(first, last, comp);
+
+            // 枢轴等于左边界之前的元素：区间里有大量相等的元素，把它们一次归到左边，不再处理
+            if (!leftmost && !comp(*(first - 1), *first)) {
+                first = tiny_stl::__partition_left(first, last, comp) + 1;
+                continue;
+            }
+
+            pair<RandomIt, bool> part;
+            if constexpr (Branchless) {
+                part = tiny_stl::__partition_right_branchless(first, last, comp);
+            } else {
+                part = tiny_stl::__partition_right(first, last, comp);
+            }
+            RandomIt pivot_pos = part.first;
+            ptrdiff_t l_size = pivot_pos - first;
+            ptrdiff_t r_size = last - (pivot_pos + 1);
+
+            if (l_size < n / 8 || r_size < n / 8) {
+                // 划分严重失衡：次数过多就改用堆排序保证 O(n log n)，否则打乱几个元素破坏造成失衡的模式
+                if (--bad_allowed == 0) {
+                    tiny_stl::__heap_sort(first, last, comp);
+                    return;
+                }
+                if (l_size >= __sort_insertion_threshold) {
+                    tiny_stl::swap(*first, *(first + l_size / 4));
+                    tiny_stl::swap(*(pivot_pos - 1), *(pivot_pos - l_size / 4));
+                    if (l_size > __sort_ninther_threshold) {
+                        tiny_stl::swap(*(first + 1), *(first + (l_size / 4 + 1)));
+                        tiny_stl::swap(*(first + 2), *(first + (l_size / 4 + 2)));
+                        tiny_stl::swap(*(pivot_pos - 2), *(pivot_pos - (l_size / 4 + 1)));
+                        tiny_stl::swap(*(pivot_pos - 3), *(pivot_pos - (l_size / 4 + 2)));
+                    }
+                }
+                if (r_size >= __sort_insertion_threshold) {
+                    tiny_stl::swap(*(pivot_pos + 1), *(pivot_pos + (1 + r_size / 4)));
+                    tiny_stl::swap(*(last - 1), *(last - r_size / 4));
+                    if (r_size > __sort_ninther_threshold) {
+                        tiny_stl::swap(*(pivot_pos + 2), *(pivot_pos + (2 + r_size / 4)));
+                        tiny_stl::swap(*(pivot_pos + 3), *(pivot_pos + (3 + r_size / 4)));
+                        tiny_stl::swap(*(last - 2), *(last - (1 + r_size / 4)));
+                        tiny_stl::swap(*(last - 3), *(last - (2 + r_size / 4)));
+                    }
+                }
+            } else if (part.second && tiny_stl::__partial_insertion_sort(first, pivot_pos, comp) &&
+                       tiny_stl::__partial_insertion_sort(pivot_pos + 1, last, comp)) {
+                // 划分时一个元素都没有交换，说明区间可能已经基本有序，试探性的插入排序成功就结束了
+                return;
+            }
+
+            tiny_stl::__pdqsort_loop<Branchless>(first, pivot_pos, comp, bad_allowed, leftmost);
+            first = pivot_pos + 1;
+            leftmost = false;
+        }
+    }
+
+    /**
+     * @brief 排序（不稳定）：pattern-defeating quicksort。
+     *
+     * - 短区间用插入排序，枢轴取三数或九数中位数；
+     * - 用不到交换的划分说明区间基本有序，先试探插入排序，有序、逆序等输入可以做到 O(n)；
+     * - 枢轴等于左边界之前的元素时把所有相等的元素一次划到左边，大量重复元素也是 O(n log n)；
+     * - 划分严重失衡时打乱几个元素，失衡次数超过 log n 次改用堆排序，最坏 O(n log n)；
+     * - 算术类型配合 `less` / `greater` 时使用无分支的分块划分。
+     *
+     * @tparam RandomIt 随机访问迭代器类型。
+     * @tparam Compare 比较函数的类型。
+     * @param first 起始迭代器。
+     * @param last 结束迭代器。
+     * @param comp 比较函数，默认为 `less`。
+     */
+    template <typename RandomIt, typename Compare>
+    void sort(RandomIt first, RandomIt last, Compare comp) {
+        static_assert(__is_iterator_of<RandomIt, random_access_iterator_tag>::value,
+                      "tiny_stl::sort requires random access iterators");
+        using value_type = typename iterator_traits<RandomIt>::value_type;
+        if (last - first < 2) {
+            return;
+        }
+        constexpr bool branchless = std::is_arithmetic<value_type>::value && __is_builtin_compare<Compare, value_type>::value;
+        tiny_stl::__pdqsort_loop<branchless>(first, last, comp, tiny_stl::__sort_log2(last - first), true);
+    }
+
+    template <typename RandomIt>
+    void sort(RandomIt first, RandomIt last) {
+        tiny_stl::sort(first, last, less<typename iterator_traits<RandomIt>::value_type>());
+    }
+
+    /**
+     * @brief 部分排序：使 *nth 成为排序后位于该位置的元素，其左边的元素都不大于它，右边的都不小于它。
+     *
+     * 与 sort 使用相同的枢轴选择与划分，只继续处理包含 nth 的一侧，平均 O(n)；
+     * 严重失衡的划分过多时对剩余区间改用堆排序。
+     *
+     * @tparam RandomIt 随机访问迭代器类型。
+     * @tparam Compare 比较函数的类型。
+     * @param first 起始迭代器。
+     * @param nth 要确定的位置。
+     * @param last 结束迭代器。
+     * @param comp 比较函数，默认为 `less`。
+     */
+    template <typename RandomIt, typename Compare>
+    void nth_element(RandomIt first, RandomIt nth, RandomIt last, Compare comp) {
+        static_assert(__is_iterator_of<RandomIt, random_access_iterator_tag>::value,
+                      "tiny_stl::nth_element requires random access iterators");
+        using value_type = typename iterator_traits<RandomIt>::value_type;
+        constexpr bool branchless = std::is_arithmetic<value_type>::value && __is_builtin_compare<Compare, value_type>::value;
+        if (nth == last) {
+            return;
+        }
+        RandomIt begin = first;
+        int bad_allowed = tiny_stl::__sort_log2(last - first);
+        while (last - first >= __sort_insertion_threshold) {
+            ptrdiff_t n = last - first;
+            tiny_stl::__sort_choose_pivot(first, last, comp);
+            RandomIt pivot_pos;
+            if (first != begin && !comp(*(first - 1), *first)) {
+                // 与左边界之前的元素相等的都归到左边，它们已经在最终位置上
+                pivot_pos = tiny_stl::__partition_left(first, last, comp);
+                if (nth <= pivot_pos) {
+                    return;
+                }
+                first = pivot_pos + 1;
+                continue;
+            }
+            if constexpr (branchless) {
+                pivot_pos = tiny_stl::__partition_right_branchless(first, last, comp).first;
+            } else {
+                pivot_pos = tiny_stl::__partition_right(first, last, comp).first;
+            }
+            if (pivot_pos == nth) {
+                return;
+            }
+            ptrdiff_t l_size = pivot_pos - first;
+            if ((l_size < n / 8 || n - l_size - 1 < n / 8) && --bad_allowed == 0) {
+                tiny_stl::__heap_sort(first, last, comp);
+                return;
+            }
+            if (nth < pivot_pos) {
+                last = pivot_pos;
+            } else {
+                first = pivot_pos + 1;
+            }
+        }
+        tiny_stl::__insertion_sort(first, last, comp);
+    }
+
+    template <typename RandomIt>
+    void nth_element(RandomIt first, RandomIt nth, RandomIt last) {
+        tiny_stl::nth_element(first, nth, last, less<typename iterator_traits<RandomIt>::value_type>());
+    }
+
+    /**
+     * @brief 在有序数组中查找第一个不小于 key 的位置，循环中没有分支。
+     *
+     * 每一步把区间缩小一半，但不根据比较结果跳转，而是用掩码选择下一半的起点，
+     * 循环次数只与 n 有关，不会因为分支预测失败而清空流水线。
+     *
+     * @tparam T 元素类型。
+     * @tparam K 键的类型。
+     * @tparam Compare 比较函数的类型。
+     * @param first 数组的起始地址。
+     * @param n 元素数量。
+     * @param key 要查找的键。
+     * @param comp 比较函数。
+     * @return 第一个不满足 comp(*p, key) 的位置，不存在时为 first + n。
+     */
+    template <typename T, typename K, typename Compare>
+    const T* __branchless_lower_bound(const T* first, size_t n, const K& key, Compare& comp) {
+        if (n == 0) {
+            return first;
+        }
+        while (n > 1) {
+            size_t half = n / 2;
+            // 用比较结果生成全 0 或全 1 的掩码，GCC 对三目运算符仍可能生成条件跳转
+            first += half & (size_t(0) - size_t(comp(first[half - 1], key)));
+            n -= half;
+        }
+        return first + (comp(*first, key) ? 1 : 0);
+    }
+
+    /**
+     * @brief lower_bound 的前向迭代器版本：每次用 advance 走到区间中点。
+     */
+    template <typename ForwardIt, typename T, typename Compare>
+    ForwardIt __lower_bound_aux(ForwardIt first, ForwardIt last, const T& value, Compare& comp, forward_iterator_tag) {
+        auto n = tiny_stl::distance(first, last);
+        while (n > 0) {
+            auto half = n / 2;
+            ForwardIt mid = first;
+            tiny_stl::advance(mid, half);
+            if (comp(*mid, value)) {
+                first = ++mid;
+                n -= half + 1;
+            } else {
+                n = half;
+            }
+        }
+        return first;
+    }
+
+    /**
+     * @brief lower_bound 的随机访问迭代器版本：与 __branchless_lower_bound 相同，用掩码代替分支。
+     */
+    template <typename RandomIt, typename T, typename Compare>
+    RandomIt __lower_bound_aux(RandomIt first, RandomIt last, const T& value, Compare& comp, random_access_iterator_tag) {
+        using difference_type = typename iterator_traits<RandomIt>::difference_type;
+        difference_type n = last - first;
+        if (n == 0) {
+            return first;
+        }
+        while (n > 1) {
+            difference_type half = n / 2;
+            first += half & -static_cast<difference_type>(comp(first[half - 1], value));
+            n -= half;
+        }
+        return first + (comp(*first, value) ? 1 : 0);
+    }
+
+    /**
+     * @brief 在有序范围 [first, last) 中查找第一个不小于 value 的元素。
+     * 按迭代器类别分派：随机访问迭代器使用无分支的二分查找。
+     * @tparam ForwardIt 前向迭代器类型。
+     * @tparam T 值的类型。
+     * @tparam Compare 比较函数的类型。
+     * @param first 起始迭代器。
+     * @param last 结束迭代器。
+     * @param value 要查找的值。
+     * @param comp 比较函数，默认为 `<`。
+     * @return 第一个不满足 comp(*it, value) 的位置，不存在时为 last。
+     */
+    template <typename ForwardIt, typename T, typename Compare>
+    ForwardIt lower_bound(ForwardIt first, ForwardIt last, const T& value, Compare comp) {
+        typename iterator_traits<ForwardIt>::iterator_category category;
+        return tiny_stl::__lower_bound_aux(first, last, value, comp, category);
+    }
+
+    template <typename ForwardIt, typename T>
+    ForwardIt lower_bound(ForwardIt first, ForwardIt last, const T& value) {
+        return tiny_stl::lower_bound(first, last, value, [](const auto& a, const auto& b) { return a < b; });
+    }
+
+    /**
+     * @brief 在有序范围 [first, last) 中查找第一个大于 value 的元素。
+     * @return 第一个满足 comp(value, *it) 的位置，不存在时为 last。
+     */
+    template <typename ForwardIt, typename T, typename Compare>
+    ForwardIt upper_bound(ForwardIt first, ForwardIt last, const T& value, Compare comp) {
+        auto not_greater = [&comp](const auto& element, const T& v) { return !comp(v, element); };
+        typename iterator_traits<ForwardIt>::iterator_category category;
+        return tiny_stl::__lower_bound_aux(first, last, value, not_greater, category);
+    }
+
+    template <typename ForwardIt, typename T>
+    ForwardIt upper_bound(ForwardIt first, ForwardIt last, const T& value) {
+        return tiny_stl::upper_bound(first, last, value, [](const auto& a, const auto& b) { return a < b; });
+    }
+
+    /**
+     * @brief 判断有序范围 [first, last) 中是否存在与 value 等价的元素。
+     */
+    template <typename ForwardIt, typename T, typename Compare>
+    bool binary_search(ForwardIt first, ForwardIt last, const T& value, Compare comp) {
+        first = tiny_stl::lower_bound(first, last, value, comp);
+        return first != last && !comp(value, *first);
+    }
+
+    template <typename ForwardIt, typename T>
+    bool binary_search(ForwardIt first, ForwardIt last, const T& value) {
+        return tiny_stl::binary_search(first, last, value, [](const auto& a, const auto& b) { return a < b; });
+    }
+
+}
@@ -18,6 +18,7 @@
 #include <cstddef>
 #include <new>
 #include <cassert>
+#include <type_traits>
 
 namespace tiny_stl {
 
@@ -61,6 +62,10 @@ namespace tiny_stl {
          * @brief 表示两个指针之间差值的类型。
          */
         using difference_type = ptrdiff_t;
+        /**
+         * @brief 所有 `allocator` 实例都相等，容器之间可以直接交换内存。
+         */
+        using is_always_equal = std::true_type;
 
     public:
         
@@ -167,17 +172,19 @@ namespace tiny_stl {
         /**
          * @brief 在已分配的内存上构造对象。
          *
-         * 在给定的内存位置构造一个 `value_type` 对象。
+         * 在给定的内存位置构造一个 `value_type` 对象，构造参数被完美转发给构造函数。
          *
+         * @tparam Args 构造函数参数的类型包。
          * @param p 指向已分配内存的指针。
-         * @param n 用于构造对象的值。
+         * @param args 用于构造对象的参数。
          * @return 指向构造好的对象的指针。
          * @pre `p` 必须指向足够大的未初始化内存。
          */
-        pointer construct(pointer p, value_type n) {
+        template <typename... Args>
+        pointer construct(pointer p, Args&&... args) {
             assert(p != nullptr);
             // 使用 placement new 构造对象
-            return new (p) value_type(n);
+            return ::new (static_cast<void*>(p)) value_type(static_cast<Args&&>(args)...);
         }
 
         /**
@@ -238,4 +245,38 @@ namespace tiny_stl {
         return false;
     }
 
+    /**
+     * @struct __allocator_always_equal
+     * @brief 判断分配器类型的所有实例是否总是相等。
+     *
+     * 分配器定义了 `is_always_equal` 时以它为准，否则空类型的分配器视为总是相等。
+     * 对于总是相等的分配器，容器在移动赋值时可以直接接管内存而无需比较分配器。
+     *
+     * @tparam Alloc 分配器类型。
+     */
+    template <typename Alloc, typename = void>
+    struct __allocator_always_equal : std::is_empty<Alloc> { };
+
+    template <typename Alloc>
+    struct __allocator_always_equal<Alloc, std::void_t<typename Alloc::is_always_equal>>
+        : Alloc::is_always_equal { };
+
+    /**
+     * @brief 判断两个分配器能否互相释放对方分配的内存。
+     * @tparam Alloc 分配器类型。
+     * @param lhs 第一个分配器。
+     * @param rhs 第二个分配器。
+     * @return 总是相等的分配器直接返回 `true`，否则返回 `lhs == rhs`。
+     */
+    template <typename Alloc>
+    bool __allocator_equal(const Alloc& lhs, const Alloc& rhs) noexcept {
+        if constexpr (__allocator_always_equal<Alloc>::value) {
+            (void)lhs;
+            (void)rhs;
+            return true;
+        } else {
+            return lhs == rhs;
+        }
+    }
+
 }
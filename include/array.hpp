@@ -16,10 +16,13 @@
 #endif
 
 #include <cstddef>
+#include <algorithm.hpp>
 #include <iterator.hpp>
 #include <utility.hpp>
 #include <memory.hpp>
 #include <initializer_list>
+#include <stdexcept>
+#include <type_traits>
 
 namespace tiny_stl {
     
@@ -29,6 +32,8 @@ namespace tiny_stl {
      *
      * `array` 类模板表示一个固定大小的数组容器，其大小在编译时确定。
      * 它提供了随机访问功能，并且可以使用迭代器进行遍历。
+     * 所有成员函数都是 constexpr，可以在编译期构造查找表（例如 CRC 表、状态机），
+     * 以 constexpr 变量保存时表格直接放在只读数据段中，不需要在启动时初始化。
      *
      * @tparam T 数组中元素的类型。
      * @tparam n 数组的大小，必须大于 0。
@@ -87,7 +92,7 @@ namespace tiny_stl {
          *
          * 初始化数组的每个元素为默认值。
          */
-        array() {
+        constexpr array() : _data() {
             for (size_type i = 0; i < n; i++) {
                 _data[i] = T();
             }
@@ -100,7 +105,7 @@ namespace tiny_stl {
          *
          * @param other 要复制的 `array` 对象。
          */
-        array(const array& other) {
+        constexpr array(const array& other) : _data() {
             for (size_type i = 0; i < n; i++) {
                 _data[i] = other._data[i];
             }
@@ -114,7 +119,7 @@ namespace tiny_stl {
          * @param other 要复制的 `array` 对象。
          * @return 对当前对象的引用。
          */
-        array& operator=(const array& other) {
+        constexpr array& operator=(const array& other) {
             if (this != &other) {
                 for (size_type i = 0; i < n; i++) {
                     _data[i] = other._data[i];
@@ -132,7 +137,7 @@ namespace tiny_stl {
          * @return 对当前对象的引用。
          * @throws std::out_of_range 如果初始化列表的长度不等于数组的大小。
          */
-        array& operator=(std::initializer_list<value_type> list) {
+        constexpr array& operator=(std::initializer_list<value_type> list) {
             if (list.size() != n) { throw std::out_of_range("list长度不等于数组长度"); }
             size_type i = 0;
             for (auto&& v : list) {
@@ -148,7 +153,7 @@ namespace tiny_stl {
          *
          * @param other 要移动的 `array` 对象。
          */
-        array(array&& other) noexcept {
+        constexpr array(array&& other) noexcept : _data() {
             for (size_type i = 0; i < n; i++) {
                 _data[i] = tiny_stl::move(other._data[i]);
             }
@@ -162,7 +167,7 @@ namespace tiny_stl {
          * @param list 初始化列表，其长度必须等于数组的大小。
          * @throws std::out_of_range 如果初始化列表的长度不等于数组的大小。
          */
-        array(std::initializer_list<value_type> list) {
+        constexpr array(std::initializer_list<value_type> list) : _data() {
             if (list.size() != n) { throw std::out_of_range("list长度不等于数组长度"); }
             size_type i = 0;
             for (auto&& v : list) {
@@ -178,7 +183,7 @@ namespace tiny_stl {
          * @param index 元素的索引。
          * @return 指定位置元素的引用。
          */
-        reference operator[](size_type index) {
+        constexpr reference operator[](size_type index) {
             return _data[index];
         }
 
@@ -190,7 +195,7 @@ namespace tiny_stl {
          * @param index 元素的索引。
          * @return 指定位置常量元素的引用。
          */
-        const_reference operator[](size_type index) const {
+        constexpr const_reference operator[](size_type index) const {
             return _data[index];
         }
 
@@ -203,7 +208,7 @@ namespace tiny_stl {
          * @return 指定位置元素的引用。
          * @throws std::out_of_range 如果索引超出数组范围。
          */
-        reference at(size_type index) {
+        constexpr reference at(size_type index) {
             if (index >= n) {
                 throw std::out_of_range("数组越界");
             }
@@ -219,7 +224,7 @@ namespace tiny_stl {
          * @return 指定位置常量元素的引用。
          * @throws std::out_of_range 如果索引超出数组范围。
          */
-        const_reference at(size_type index) const {
+        constexpr const_reference at(size_type index) const {
             if (index >= n) {
                 throw std::out_of_range("数组越界");
             }
@@ -231,7 +236,7 @@ namespace tiny_stl {
          *
          * @return 数组的第一个元素的引用。
          */
-        reference front() {
+        constexpr reference front() {
             return _data[0];
         }
 
@@ -240,7 +245,7 @@ namespace tiny_stl {
          *
          * @return 数组的第一个元素的常量引用。
          */
-        const_reference front() const {
+        constexpr const_reference front() const {
             return _data[0];
         }
 
@@ -249,7 +254,7 @@ namespace tiny_stl {
          *
          * @return 数组的最后一个元素的引用。
          */
-        reference back() {
+        constexpr reference back() {
             return _data[n - 1];
         }
 
@@ -258,7 +263,7 @@ namespace tiny_stl {
          *
          * @return 数组的最后一个元素的常量引用。
          */
-        const_reference back() const {
+        constexpr const_reference back() const {
             return _data[n - 1];
         }
 
@@ -267,7 +272,7 @@ namespace tiny_stl {
          *
          * @return 指向数组数据的指针。
          */
-        pointer data() noexcept {
+        constexpr pointer data() noexcept {
             return _data;
         }
 
@@ -276,7 +281,7 @@ namespace tiny_stl {
          *
          * @return 指向常量数组数据的指针。
          */
-        const_pointer data() const noexcept {
+        constexpr const_pointer data() const noexcept {
             return _data;
         }
 
@@ -285,7 +290,7 @@ namespace tiny_stl {
          *
          * @return 指向数组第一个元素的迭代器。
          */
-        iterator begin() noexcept {
+        constexpr iterator begin() noexcept {
             return _data;
         }
 
@@ -294,17 +299,26 @@ namespace tiny_stl {
          *
          * @return 指向常量数组第一个元素的迭代器。
          */
-        const_iterator begin() const noexcept {
+        constexpr const_iterator begin() const noexcept {
             return _data;
         }
 
         /**
-         * @brief 返回指向数组最后一个元素之后的反向迭代器。
+         * @brief 返回指向数组最后一个元素的反向迭代器。
          *
-         * @return 指向数组最后一个元素之后的反向迭代器。
+         * @return 指向数组最后一个元素的反向迭代器。
          */
-        reverse_iterator rbegin() const noexcept {
-            return reverse_iterator{ _data };
+        constexpr reverse_iterator rbegin() noexcept {
+            return reverse_iterator(end());
+        }
+
+        /**
+         * @brief 返回指向常量数组最后一个元素的反向迭代器。
+         *
+         * @return 指向常量数组最后一个元素的反向迭代器。
+         */
+        constexpr const_reverse_iterator rbegin() const noexcept {
+            return const_reverse_iterator(end());
         }
 
         /**
@@ -312,7 +326,7 @@ namespace tiny_stl {
          *
          * @return 指向数组最后一个元素之后的迭代器。
          */
-        iterator end() noexcept {
+        constexpr iterator end() noexcept {
             return _data + n;
         }
 
@@ -321,7 +335,7 @@ namespace tiny_stl {
          *
          * @return 指向常量数组最后一个元素之后的迭代器。
          */
-        const_iterator end() const noexcept {
+        constexpr const_iterator end() const noexcept {
             return _data + n;
         }
 
@@ -330,8 +344,17 @@ namespace tiny_stl {
          *
          * @return 指向数组第一个元素之前的反向迭代器。
          */
-        reverse_iterator rend() const noexcept {
-            return reverse_iterator{ _data + n };
+        constexpr reverse_iterator rend() noexcept {
+            return reverse_iterator(begin());
+        }
+
+        /**
+         * @brief 返回指向常量数组第一个元素之前的反向迭代器。
+         *
+         * @return 指向常量数组第一个元素之前的反向迭代器。
+         */
+        constexpr const_reverse_iterator rend() const noexcept {
+            return const_reverse_iterator(begin());
         }
 
         /**
@@ -339,7 +362,7 @@ namespace tiny_stl {
          *
          * @return 数组的大小。
          */
-        size_type size() const noexcept {
+        constexpr size_type size() const noexcept {
             return n;
         }
 
@@ -350,7 +373,7 @@ namespace tiny_stl {
          *
          * @return 数组的最大大小。
          */
-        size_type max_size() const noexcept {
+        constexpr size_type max_size() const noexcept {
             return n;
         }
 
@@ -361,7 +384,7 @@ namespace tiny_stl {
          *
          * @param value 要填充的值。
          */
-        void fill(const T& value) {
+        constexpr void fill(const T& value) {
             for (size_type i = 0; i < n; i++) {
                 _data[i] = value;
             }
@@ -374,11 +397,75 @@ namespace tiny_stl {
          *
          * @param other 要交换的另一个数组。
          */
-        void swap(array& other) noexcept {
+        constexpr void swap(array& other) noexcept {
             for (size_type i = 0; i < n; i++) {
                 tiny_stl::swap(_data[i], other._data[i]);
             }
         }
+
+        /**
+         * @brief 判断两个数组是否相等。
+         *
+         * 整数或指针元素用 memcmp 比较，见 equal。
+         *
+         * @param other 要比较的数组。
+         * @return 如果对应元素都相等，返回 true；否则返回 false。
+         */
+        constexpr bool operator==(const array& other) const {
+            return tiny_stl::equal(_data, _data + n, other._data);
+        }
+
+        /**
+         * @brief 判断两个数组是否不相等。
+         *
+         * @param other 要比较的数组。
+         * @return 如果两个数组不相等，返回 true；否则返回 false。
+         */
+        constexpr bool operator!=(const array& other) const {
+            return !(*this == other);
+        }
+
+        /**
+         * @brief 按字典序判断当前数组是否小于另一个数组。
+         *
+         * 整数或指针元素用 memcmp 或 SIMD 按字节找到第一个不同的元素，见 lexicographical_compare。
+         *
+         * @param other 要比较的数组。
+         * @return 如果当前数组小于另一个数组，返回 true；否则返回 false。
+         */
+        constexpr bool operator<(const array& other) const {
+            return tiny_stl::lexicographical_compare(_data, _data + n, other._data, other._data + n);
+        }
+
+        /**
+         * @brief 判断当前数组是否小于等于另一个数组。
+         *
+         * @param other 要比较的数组。
+         * @return 如果当前数组小于等于另一个数组，返回 true；否则返回 false。
+         */
+        constexpr bool operator<=(const array& other) const {
+            return !(other < *this);
+        }
+
+        /**
+         * @brief 判断当前数组是否大于另一个数组。
+         *
+         * @param other 要比较的数组。
+         * @return 如果当前数组大于另一个数组，返回 true；否则返回 false。
+         */
+        constexpr bool operator>(const array& other) const {
+            return other < *this;
+        }
+
+        /**
+         * @brief 判断当前数组是否大于等于另一个数组。
+         *
+         * @param other 要比较的数组。
+         * @return 如果当前数组大于等于另一个数组，返回 true；否则返回 false。
+         */
+        constexpr bool operator>=(const array& other) const {
+            return !(*this < other);
+        }
     private:
         /**
          * @brief 存储数组元素的底层数组。
@@ -386,4 +473,38 @@ namespace tiny_stl {
         T _data[n]; 
     };
 
+    /**
+     * @brief 由内置数组复制构造 `array`。
+     *
+     * @tparam T 内置数组的元素类型，结果的元素类型去掉其 cv 限定。
+     * @tparam n 内置数组的大小。
+     * @param a 要复制的内置数组。
+     * @return 元素与 a 相同的 `array`。
+     */
+    template <typename T, size_t n>
+    constexpr array<std::remove_cv_t<T>, n> to_array(T (&a)[n]) {
+        array<std::remove_cv_t<T>, n> result;
+        for (size_t i = 0; i < n; i++) {
+            result[i] = a[i];
+        }
+        return result;
+    }
+
+    /**
+     * @brief 由内置数组移动构造 `array`。
+     *
+     * @tparam T 内置数组的元素类型。
+     * @tparam n 内置数组的大小。
+     * @param a 要移动的内置数组。
+     * @return 元素从 a 移动而来的 `array`。
+     */
+    template <typename T, size_t n>
+    constexpr array<std::remove_cv_t<T>, n> to_array(T (&&a)[n]) {
+        array<std::remove_cv_t<T>, n> result;
+        for (size_t i = 0; i < n; i++) {
+            result[i] = tiny_stl::move(a[i]);
+        }
+        return result;
+    }
+
 }
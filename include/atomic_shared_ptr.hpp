@@ -0,0 +1,331 @@
+/**
+ * @file atomic_shared_ptr.hpp
+ * @brief 该文件实现了 `tiny_stl` 命名空间下的 `atomic_shared_ptr`，可被多个线程不加锁地并发读写的 `shared_ptr`。
+ * 实现采用分离引用计数（split reference count）：控制块指针与一个本地计数打包在同一个原子字中，
+ * 读取只需对该原子字做一次 CAS，写入时再把本地计数归并到控制块的全局计数中。
+ */
+
+#pragma once
+
+#ifdef __GNUC__
+#   pragma GCC system_header
+#endif
+#if defined(_MSC_VER) && _MSC_VER >= 1920
+#   pragma system_header
+#endif
+
+#include <shared_ptr.hpp>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+
+namespace tiny_stl {
+
+    /**
+     * @class atomic_shared_ptr
+     * @brief 原子 `shared_ptr`，支持 `load`、`store`、`exchange` 与 `compare_exchange`。
+     *
+     * 内部的原子字低 48 位存放控制块指针，高 16 位存放本地计数。
+     * 每次装入控制块时预先向全局计数存入 `batch` 个强引用，读者通过 CAS 把本地计数加 1
+     * 来领取其中一个。CAS 同时校验控制块指针与本地计数，因此读取路径与并发的 `release()`
+     * 之间不存在竞态，也不受 ABA 影响：读者只会领取到仍在原子字中的控制块所预存的引用。
+     * 领取到最后一个预存引用的读者负责补充下一批，其余读者在补充完成前短暂自旋。
+     * 控制块被换出时，写者根据本地计数归还未被领取的预存引用。
+     *
+     * @note 要求 64 位平台且用户态地址不超过 48 位（x86-64、AArch64 的常见配置）；
+     * 启用 5 级页表或指针高位标签时地址会超出这一范围，调试版本中 `acquire_word` 的断言会报告。
+     * @note 控制块装在原子字中期间，尚未被读者领取的预存引用也计入强引用计数，
+     * 因此共享该控制块的 `shared_ptr`、`weak_ptr` 的 `use_count()` 比实际持有者的数量多出
+     * 1 到 `batch` 之间的某个值，不能据此判断是否唯一持有（例如 `use_count() == 1`）。
+     * `expired()` 不受影响；控制块被换出或 `atomic_shared_ptr` 析构后，计数恢复为实际持有者的数量。
+     * @tparam T 管理对象的类型，也可以是数组类型 `U[]`。
+     */
+    template <typename T>
+    class atomic_shared_ptr {
+    public:
+        using value_type = shared_ptr<T>; /**< 存放的值的类型 */
+
+        static constexpr size_t batch = size_t(1) << 14; /**< 每批预存的强引用数量 */
+
+    private:
+        using element_type = std::remove_extent_t<T>; /**< 元素类型 */
+        using block_type = control_block; /**< 控制块类型 */
+
+        static_assert(sizeof(void*) == 8, "atomic_shared_ptr 需要 64 位平台");
+
+        static constexpr unsigned count_shift = 48; /**< 本地计数在原子字中的偏移 */
+        static constexpr uintptr_t pointer_mask = (uintptr_t(1) << count_shift) - 1; /**< 控制块指针掩码 */
+        static constexpr uintptr_t count_one = uintptr_t(1) << count_shift; /**< 本地计数加 1 对应的增量 */
+        mutable std::atomic<uintptr_t> state_; /**< 控制块指针与本地计数打包后的原子字 */
+
+        /**
+         * @brief 从原子字中取出控制块指针。
+         * @param word 原子字的值。
+         * @return 控制块指针。
+         */
+        static block_type* block_of(uintptr_t word) noexcept {
+            return reinterpret_cast<block_type*>(word & pointer_mask);
+        }
+
+        /**
+         * @brief 从原子字中取出本地计数。
+         * @param word 原子字的值。
+         * @return 本地计数。
+         */
+        static size_t count_of(uintptr_t word) noexcept {
+            return static_cast<size_t>(word >> count_shift);
+        }
+
+        /**
+         * @brief 接管 `desired` 持有的强引用，并为装入原子字预存一批强引用。
+         * @param desired 要装入的 `shared_ptr`，调用后变为空。
+         * @return 本地计数为 0 的原子字。
+         */
+        static uintptr_t acquire_word(shared_ptr<T>& desired) noexcept {
+            block_type* block = desired.ctrl_block_;
+            // 高 16 位不为 0 的地址（5 级页表、带标签的指针）放入原子字后会被截断
+            assert((reinterpret_cast<uintptr_t>(block) & ~pointer_mask) == 0 &&
+                   "atomic_shared_ptr 需要控制块地址不超过 48 位");
+            if (block) {
+                block->increment(batch - 1);
+                desired.ctrl_block_ = nullptr;
+                desired.ptr_ = nullptr;
+            }
+            return reinterpret_cast<uintptr_t>(block);
+        }
+
+        /**
+         * @brief 归还被换出的原子字所预存的强引用。
+         * 本地计数记录了读者已领取的数量，剩余部分由写者释放。
+         * @param word 被换出的原子字。
+         */
+        static void release_word(uintptr_t word) noexcept {
+            block_type* block = block_of(word);
+            size_t taken = count_of(word);
+            if (block && taken < batch) {
+                block->release_shared(batch - taken);
+            }
+        }
+
+        /**
+         * @brief 由控制块构造 `shared_ptr`，接管调用者已经取得的一个强引用。
+         * @param block 控制块指针，可以为空。
+         * @return 持有该强引用的 `shared_ptr`。
+         */
+        static shared_ptr<T> adopt(block_type* block) noexcept {
+            shared_ptr<T> result;
+            if (block) {
+                result.ctrl_block_ = block;
+                result.ptr_ = static_cast<element_type*>(block->get_pointer());
+            }
+            return result;
+        }
+
+        /**
+         * @brief 为当前装入的控制块补充下一批预存引用。
+         * 由领取到最后一个预存引用的读者调用，此时它持有一个强引用，控制块必然存活。
+         * 先向全局计数存入 `batch` 个引用，再把本地计数清零；
+         * 若控制块已被换出（本地计数已由写者结算），则撤销刚存入的引用。
+         * @param block 需要补充的控制块。
+         */
+        void refill(block_type* block) const noexcept {
+            block->increment(batch);
+            uintptr_t cur = state_.load(std::memory_order_relaxed);
+            while (block_of(cur) == block && count_of(cur) == batch) {
+                if (state_.compare_exchange_weak(cur, cur - batch * count_one,
+                        std::memory_order_relaxed, std::memory_order_relaxed)) {
+                    return;
+                }
+            }
+            block->release_shared(batch);
+        }
+
+    public:
+        /**
+         * @brief 默认构造函数，初始化为空。
+         */
+        atomic_shared_ptr() noexcept : state_(0) {}
+
+        /**
+         * @brief 构造函数，以给定的 `shared_ptr` 初始化。
+         * @param desired 初始值。
+         */
+        atomic_shared_ptr(shared_ptr<T> desired) noexcept : state_(acquire_word(desired)) {}
+
+        atomic_shared_ptr(const atomic_shared_ptr&) = delete;
+        atomic_shared_ptr& operator=(const atomic_shared_ptr&) = delete;
+
+        /**
+         * @brief 析构函数，归还当前控制块的预存引用。
+         */
+        ~atomic_shared_ptr() {
+            release_word(state_.load(std::memory_order_acquire));
+        }
+
+        /**
+         * @brief 判断该类型是否无锁。
+         * 读取路径不使用互斥量，但一批预存引用领完后，其他读者要自旋等待领取最后一个引用的读者补充；
+         * 该读者在补充前被挂起时其他读者都无法前进，因此不满足无锁的定义。
+         * 自旋等待的读者不能代为补充：它尚未持有任何引用，控制块可能已被换出并释放。
+         * @return 总是返回 `false`。
+         */
+        bool is_lock_free() const noexcept {
+            return false;
+        }
+
+        /**
+         * @brief 原子地读取当前值。
+         * 无竞争时读取路径只包含一次原子读与一次 CAS，不触碰控制块中的计数；
+         * 每 `batch` 次读取才有一次需要补充预存引用。
+         * @param order 内存顺序。
+         * @return 当前值的副本。
+         */
+        shared_ptr<T> load(std::memory_order order = std::memory_order_seq_cst) const noexcept {
+            uintptr_t cur = state_.load(std::memory_order_relaxed);
+            while (true) {
+                block_type* block = block_of(cur);
+                if (!block) {
+                    return shared_ptr<T>();
+                }
+                size_t taken = count_of(cur);
+                if (taken == batch) {
+                    // 预存引用已领完，等待领取最后一个引用的读者补充
+                    cur = state_.load(std::memory_order_relaxed);
+                    continue;
+                }
+                if (state_.compare_exchange_weak(cur, cur + count_one, order, std::memory_order_relaxed)) {
+                    if (taken + 1 == batch) {
+                        refill(block);
+                    }
+                    return adopt(block);
+                }
+            }
+        }
+
+        /**
+         * @brief 原子地写入新值。
+         * @param desired 新值。
+         * @param order 内存顺序。
+         */
+        void store(shared_ptr<T> desired, std::memory_order order = std::memory_order_seq_cst) noexcept {
+            release_word(state_.exchange(acquire_word(desired), order));
+        }
+
+        /**
+         * @brief 原子地替换为新值并返回旧值。
+         * @param desired 新值。
+         * @param order 内存顺序。
+         * @return 旧值。
+         */
+        shared_ptr<T> exchange(shared_ptr<T> desired, std::memory_order order = std::memory_order_seq_cst) noexcept {
+            uintptr_t old = state_.exchange(acquire_word(desired), order);
+            block_type* block = block_of(old);
+            if (block) {
+                block->increment();
+            }
+            release_word(old);
+            return adopt(block);
+        }
+
+        /**
+         * @brief 比较并交换。
+         * 若当前值与 `expected` 管理同一个控制块，则替换为 `desired` 并返回 `true`；
+         * 否则把当前值写入 `expected` 并返回 `false`。不会伪失败。
+         * @param expected 期望值，失败时被更新为当前值。
+         * @param desired 新值。
+         * @param success 成功时的内存顺序。
+         * @param failure 失败时的内存顺序。
+         * @return 是否交换成功。
+         */
+        bool compare_exchange_strong(shared_ptr<T>& expected, shared_ptr<T> desired,
+                                     std::memory_order success, std::memory_order failure) noexcept {
+            uintptr_t word = acquire_word(desired);
+            uintptr_t cur = state_.load(std::memory_order_relaxed);
+            while (true) {
+                if (block_of(cur) == expected.ctrl_block_) {
+                    if (state_.compare_exchange_weak(cur, word, success, std::memory_order_relaxed)) {
+                        release_word(cur);
+                        return true;
+                    }
+                    continue;
+                }
+                shared_ptr<T> current = load(failure);
+                if (current.ctrl_block_ == expected.ctrl_block_) {
+                    cur = state_.load(std::memory_order_relaxed);
+                    continue;
+                }
+                release_word(word);
+                expected = tiny_stl::move(current);
+                return false;
+            }
+        }
+
+        /**
+         * @brief 比较并交换，成功与失败使用同一内存顺序。
+         * @param expected 期望值，失败时被更新为当前值。
+         * @param desired 新值。
+         * @param order 内存顺序。
+         * @return 是否交换成功。
+         */
+        bool compare_exchange_strong(shared_ptr<T>& expected, shared_ptr<T> desired,
+                                     std::memory_order order = std::memory_order_seq_cst) noexcept {
+            return compare_exchange_strong(expected, tiny_stl::move(desired), order, failure_order(order));
+        }
+
+        /**
+         * @brief 比较并交换（弱版本）。本实现不会伪失败，与强版本等价。
+         * @param expected 期望值，失败时被更新为当前值。
+         * @param desired 新值。
+         * @param success 成功时的内存顺序。
+         * @param failure 失败时的内存顺序。
+         * @return 是否交换成功。
+         */
+        bool compare_exchange_weak(shared_ptr<T>& expected, shared_ptr<T> desired,
+                                   std::memory_order success, std::memory_order failure) noexcept {
+            return compare_exchange_strong(expected, tiny_stl::move(desired), success, failure);
+        }
+
+        /**
+         * @brief 比较并交换（弱版本），成功与失败使用同一内存顺序。
+         * @param expected 期望值，失败时被更新为当前值。
+         * @param desired 新值。
+         * @param order 内存顺序。
+         * @return 是否交换成功。
+         */
+        bool compare_exchange_weak(shared_ptr<T>& expected, shared_ptr<T> desired,
+                                   std::memory_order order = std::memory_order_seq_cst) noexcept {
+            return compare_exchange_strong(expected, tiny_stl::move(desired), order, failure_order(order));
+        }
+
+        /**
+         * @brief 赋值运算符，等价于 `store(desired)`。
+         * @param desired 新值。
+         * @return 引用自身。
+         */
+        atomic_shared_ptr& operator=(shared_ptr<T> desired) noexcept {
+            store(tiny_stl::move(desired));
+            return *this;
+        }
+
+        /**
+         * @brief 类型转换运算符，等价于 `load()`。
+         * @return 当前值的副本。
+         */
+        operator shared_ptr<T>() const noexcept {
+            return load();
+        }
+
+    private:
+        /**
+         * @brief 根据成功时的内存顺序推导失败时可用的内存顺序。
+         * @param order 成功时的内存顺序。
+         * @return 失败时的内存顺序（去掉 release 语义）。
+         */
+        static constexpr std::memory_order failure_order(std::memory_order order) noexcept {
+            return order == std::memory_order_acq_rel ? std::memory_order_acquire
+                : order == std::memory_order_release ? std::memory_order_relaxed
+                : order;
+        }
+    };
+
+}
@@ -0,0 +1,1189 @@
+/**
+ * @file btree_map.hpp
+ * @brief 此文件定义了 tiny_stl 命名空间下基于 B 树的有序关联容器 `btree_map` 与 `btree_set`。
+ *
+ * 红黑树的每个元素单独占用一个节点：每次插入都要分配内存，查找时每向下一层都是一次缓存未命中。
+ * B 树的一个节点连续存放几十个元素（叶节点约 256 字节，内部节点再加上子节点指针，约 512 字节），
+ * 查找时在节点内对连续的元素做二分查找，树高只有 log_{m}(n)，范围扫描基本上是顺序读取内存。
+ * 代价是插入与删除会在节点之间移动元素，因此会使迭代器、指针和引用失效。
+ */
+
+#pragma once
+
+#ifdef __GNUC__
+#   pragma GCC system_header
+#endif
+#if defined(_MSC_VER) && _MSC_VER >= 1920
+#   pragma system_header
+#endif
+
+#include <algorithm.hpp>
+#include <allocator.hpp>
+#include <functional.hpp>
+#include <iterator.hpp>
+#include <utility.hpp>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+
+namespace tiny_stl {
+
+    template <typename Value, size_t Slots>
+    struct __btree_internal_node;
+
+    /**
+     * @struct __btree_node
+     * @brief B 树的节点。叶节点只有这些成员，内部节点在其后追加子节点指针数组
+     * @tparam Value 元素类型
+     * @tparam Slots 每个节点最多容纳的元素数量
+     */
+    template <typename Value, size_t Slots>
+    struct __btree_node {
+        using value_type = Value;
+
+        __btree_node* parent; /**< 父节点，根节点为空 */
+        unsigned short position; /**< 在父节点中的子节点下标 */
+        unsigned short count; /**< 元素数量 */
+        bool leaf; /**< 是否为叶节点 */
+        alignas(Value) unsigned char storage[Slots * sizeof(Value)]; /**< 元素，前 count 个已构造 */
+
+        /**
+         * @brief 第 i 个槽位的地址，槽位上不一定有对象
+         */
+        Value* slot(size_t i) noexcept { return reinterpret_cast<Value*>(storage) + i; }
+
+        Value& value(size_t i) noexcept { return *std::launder(slot(i)); }
+
+        const Value& value(size_t i) const noexcept {
+            return *std::launder(reinterpret_cast<const Value*>(storage) + i);
+        }
+
+        /**
+         * @brief 第 i 个子节点，只能对内部节点调用
+         */
+        __btree_node* child(size_t i) const noexcept {
+            return static_cast<const __btree_internal_node<Value, Slots>*>(this)->children[i];
+        }
+
+        /**
+         * @brief 把 c 设置为第 i 个子节点，同时更新 c 的父节点与下标
+         */
+        void set_child(size_t i, __btree_node* c) noexcept {
+            static_cast<__btree_internal_node<Value, Slots>*>(this)->children[i] = c;
+            c->parent = this;
+            c->position = static_cast<unsigned short>(i);
+        }
+    };
+
+    /**
+     * @struct __btree_internal_node
+     * @brief B 树的内部节点：第 i 个子树中的元素都在第 i - 1 个与第 i 个元素之间
+     */
+    template <typename Value, size_t Slots>
+    struct __btree_internal_node : __btree_node<Value, Slots> {
+        __btree_node<Value, Slots>* children[Slots + 1]; /**< 子节点，前 count + 1 个有效 */
+    };
+
+    /**
+     * @brief 叶节点的目标大小（字节）
+     */
+    constexpr size_t __btree_target_node_size = 256;
+
+    /**
+     * @brief 计算每个节点容纳的元素数量：使叶节点约为 __btree_target_node_size 字节，至少 3 个，至多 255 个
+     * @tparam Value 元素类型
+     */
+    template <typename Value>
+    constexpr size_t __btree_node_slots() {
+        constexpr size_t header = sizeof(void*) * 2;
+        constexpr size_t n = (__btree_target_node_size - header) / sizeof(Value);
+        return n < 3 ? 3 : (n > 255 ? 255 : n);
+    }
+
+    /**
+     * @class __btree_iterator
+     * @brief B 树的双向迭代器：节点与节点内的下标，按中序遍历
+     * @tparam Node 节点类型
+     * @tparam Ref 引用类型
+     * @tparam Ptr 指针类型
+     */
+    template <typename Node, typename Ref, typename Ptr>
+    class __btree_iterator {
+        template <typename, typename, typename> friend class __btree;
+        template <typename, typename, typename> friend class __btree_iterator;
+    public:
+        using iterator_category = bidirectional_iterator_tag; /**< 迭代器类别 */
+        using value_type = typename Node::value_type; /**< 元素类型 */
+        using difference_type = ptrdiff_t; /**< 距离类型 */
+        using pointer = Ptr; /**< 指针类型 */
+        using reference = Ref; /**< 引用类型 */
+
+        __btree_iterator() noexcept : _node(nullptr), _position(0) { }
+
+        /**
+         * @brief 从非常量迭代器转换
+         */
+        template <typename R, typename P,
+                  typename = std::enable_if_t<std::is_convertible<P, Ptr>::value && !std::is_same<P, Ptr>::value>>
+        __btree_iterator(const __btree_iterator<Node, R, P>& other) noexcept
+            : _node(other._node), _position(other._position) { }
+
+        reference operator*() const noexcept { return _node->value(_position); }
+        pointer operator->() const noexcept { return &_node->value(_position); }
+
+        __btree_iterator& operator++() noexcept { increment(); return *this; }
+        __btree_iterator operator++(int) noexcept { __btree_iterator tmp = *this; increment(); return tmp; }
+        __btree_iterator& operator--() noexcept { decrement(); return *this; }
+        __btree_iterator operator--(int) noexcept { __btree_iterator tmp = *this; decrement(); return tmp; }
+
+        template <typename R, typename P>
+        bool operator==(const __btree_iterator<Node, R, P>& other) const noexcept {
+            return _node == other._node && _position == other._position;
+        }
+
+        template <typename R, typename P>
+        bool operator!=(const __btree_iterator<Node, R, P>& other) const noexcept {
+            return !(*this == other);
+        }
+
+    private:
+        Node* _node; /**< 所在的节点，空树时为空 */
+        int _position; /**< 节点内的下标；end() 为最右叶节点的 count */
+
+        __btree_iterator(Node* node, int position) noexcept : _node(node), _position(position) { }
+
+        /**
+         * @brief 移动到中序的下一个元素：内部节点下移到右子树的最左叶节点，叶节点用完后上移到父节点；
+         * 已经是最后一个元素时停在最右叶节点的末尾，即 end()
+         */
+        void increment() noexcept {
+            if (!_node->leaf) {
+                _node = _node->child(_position + 1);
+                while (!_node->leaf) {
+                    _node = _node->child(0);
+                }
+                _position = 0;
+                return;
+            }
+            if (++_position < _node->count) {
+                return;
+            }
+            __btree_iterator save = *this;
+            while (_position == _node->count && _node->parent) {
+                _position = _node->position;
+                _node = _node->parent;
+            }
+            if (_position == _node->count) {
+                *this = save;
+            }
+        }
+
+        /**
+         * @brief 移动到中序的上一个元素
+         */
+        void decrement() noexcept {
+            if (!_node->leaf) {
+                _node = _node->child(_position);
+                while (!_node->leaf) {
+                    _node = _node->child(_node->count);
+                }
+                _position = _node->count - 1;
+                return;
+            }
+            if (--_position >= 0) {
+                return;
+            }
+            __btree_iterator save = *this;
+            while (_position < 0 && _node->parent) {
+                _position = _node->position - 1;
+                _node = _node->parent;
+            }
+            if (_position < 0) {
+                *this = save;
+            }
+        }
+    };
+
+    /**
+     * @brief `btree_set` 的元素策略：元素就是键
+     */
+    template <typename Key>
+    struct __btree_set_params {
+        using key_type = Key;
+        using value_type = Key;
+        static constexpr bool constant_iterators = true; /**< 元素决定了它在树中的位置，不能通过迭代器修改 */
+
+        static const key_type& key(const value_type& v) noexcept { return v; }
+
+        template <typename Alloc>
+        static void construct_move(Alloc& alloc, value_type* p, value_type& v) {
+            alloc.construct(p, tiny_stl::move(v));
+        }
+
+        /**
+         * @brief 把 src 处的元素搬到 dst 处，并销毁 src 处的元素
+         */
+        template <typename Alloc>
+        static void transfer(Alloc& alloc, value_type* dst, value_type* src) {
+            alloc.construct(dst, tiny_stl::move(*src));
+            alloc.destroy(src);
+        }
+    };
+
+    /**
+     * @brief `btree_map` 的元素策略：元素是 `pair<const Key, T>`
+     */
+    template <typename Key, typename T>
+    struct __btree_map_params {
+        using key_type = Key;
+        using value_type = pair<const Key, T>;
+        static constexpr bool constant_iterators = false;
+
+        static const key_type& key(const value_type& v) noexcept { return v.first; }
+
+        /**
+         * @brief 在 p 处构造元素：键不能从 const 的 first 中移出，只能复制，值则移动过来
+         */
+        template <typename Alloc>
+        static void construct_move(Alloc& alloc, value_type* p, value_type& v) {
+            alloc.construct(p, v.first, tiny_stl::move(v.second));
+        }
+
+        /**
+         * @brief 把 src 处的元素搬到 dst 处，并销毁 src 处的元素
+         * src 处的元素随后就被销毁，不会再有人观察它的键，因此这里去掉 const 把键也移动过去
+         */
+        template <typename Alloc>
+        static void transfer(Alloc& alloc, value_type* dst, value_type* src) {
+            alloc.construct(dst, tiny_stl::move(const_cast<Key&>(src->first)), tiny_stl::move(src->second));
+            alloc.destroy(src);
+        }
+    };
+
+    /**
+     * @class __btree
+     * @brief `btree_map` 与 `btree_set` 共用的 B 树
+     *
+     * - 元素存放在所有节点中（不只是叶节点），每个节点最多 max_count 个元素；
+     * - 插入总发生在叶节点。节点已满时先把它分裂成两个，中间的元素上移到父节点。
+     *   在末尾插入时（例如按顺序批量加载）分裂点取在最右边，左节点保持满载，顺序插入得到的节点几乎都是满的；
+     * - 删除内部节点的元素时用它的前驱（左子树中最大的元素，位于叶节点）替换，再从叶节点删除；
+     *   节点的元素少于 max_count / 2 时，从相邻的兄弟节点借一个，兄弟也不富余时与之合并。
+     *
+     * 在节点之间移动元素时要求元素的移动构造不抛出异常。
+     *
+     * @tparam Params 元素策略，规定元素类型以及如何从元素取得键
+     * @tparam Compare 键的比较函数类型
+     * @tparam Alloc 分配器类型，通过 `rebind` 得到元素、叶节点与内部节点的分配器
+     */
+    template <typename Params, typename Compare, typename Alloc>
+    class __btree {
+    public:
+        using key_type = typename Params::key_type; /**< 键类型 */
+        using value_type = typename Params::value_type; /**< 元素类型 */
+        using size_type = size_t; /**< 大小类型 */
+        using difference_type = ptrdiff_t; /**< 距离类型 */
+        using key_compare = Compare; /**< 键的比较函数类型 */
+        using allocator_type = Alloc; /**< 分配器类型 */
+        using reference = value_type&; /**< 引用类型 */
+        using const_reference = const value_type&; /**< 常量引用类型 */
+        using pointer = value_type*; /**< 指针类型 */
+        using const_pointer = const value_type*; /**< 常量指针类型 */
+
+        static constexpr size_t node_slots = __btree_node_slots<value_type>(); /**< 每个节点最多容纳的元素数量 */
+
+    protected:
+        using node_type = __btree_node<value_type, node_slots>; /**< 节点类型 */
+        using internal_node_type = __btree_internal_node<value_type, node_slots>; /**< 内部节点类型 */
+        using value_allocator = typename Alloc::template rebind<value_type>::other; /**< 元素的分配器类型 */
+        using leaf_allocator = typename Alloc::template rebind<node_type>::other; /**< 叶节点的分配器类型 */
+        using internal_allocator = typename Alloc::template rebind<internal_node_type>::other; /**< 内部节点的分配器类型 */
+        static constexpr int max_count = static_cast<int>(node_slots); /**< 节点的最大元素数量 */
+        static constexpr int min_count = max_count / 2; /**< 非根节点在删除后至少保留的元素数量 */
+
+    public:
+        using const_iterator = __btree_iterator<node_type, const value_type&, const value_type*>; /**< 常量迭代器类型 */
+        using iterator = std::conditional_t<Params::constant_iterators, const_iterator,
+                                            __btree_iterator<node_type, value_type&, value_type*>>; /**< 迭代器类型 */
+        using reverse_iterator = tiny_stl::reverse_iterator<iterator>; /**< 反向迭代器类型 */
+        using const_reverse_iterator = tiny_stl::reverse_iterator<const_iterator>; /**< 常量反向迭代器类型 */
+
+        /**
+         * @brief 默认构造函数，不分配内存
+         */
+        __btree() : __btree(Compare()) { }
+
+        /**
+         * @brief 构造一棵空树
+         * @param comp 比较函数
+         * @param alloc 分配器
+         */
+        explicit __btree(const Compare& comp, const allocator_type& alloc = allocator_type())
+            : _root(nullptr), _leftmost(nullptr), _rightmost(nullptr), _size(0), _comp(comp), _alloc(alloc) { }
+
+        /**
+         * @brief 构造一棵使用指定分配器的空树
+         */
+        explicit __btree(const allocator_type& alloc) : __btree(Compare(), alloc) { }
+
+        /**
+         * @brief 用迭代器范围内的元素构造，重复的键只保留第一个；输入有序时每个元素直接追加到最右叶节点
+         */
+        template <typename InputIterator, __enable_if_input_iterator_t<InputIterator> = 0>
+        __btree(InputIterator first, InputIterator last, const Compare& comp = Compare(),
+                const allocator_type& alloc = allocator_type())
+            : __btree(comp, alloc) {
+            try {
+                insert(first, last);
+            } catch (...) {
+                clear();
+                throw;
+            }
+        }
+
+        /**
+         * @brief 批量加载按键严格递增的元素，不做查找，每个元素直接追加到最右叶节点
+         */
+        template <typename InputIterator, __enable_if_input_iterator_t<InputIterator> = 0>
+        __btree(sorted_unique_t, InputIterator first, InputIterator last, const Compare& comp = Compare(),
+                const allocator_type& alloc = allocator_type())
+            : __btree(comp, alloc) {
+            try {
+                for (; first != last; ++first) {
+                    append_back([&](value_type* p) { _alloc.construct(p, *first); });
+                    assert(last_two_ordered());
+                }
+            } catch (...) {
+                clear();
+                throw;
+            }
+        }
+
+        /**
+         * @brief 用初始化列表中的元素构造，重复的键只保留第一个
+         */
+        __btree(std::initializer_list<value_type> il, const Compare& comp = Compare(),
+                const allocator_type& alloc = allocator_type())
+            : __btree(il.begin(), il.end(), comp, alloc) { }
+
+        /**
+         * @brief 拷贝构造函数，新树使用 other 分配器的副本；元素按顺序追加，得到的节点几乎都是满的
+         */
+        __btree(const __btree& other) : __btree(other._comp, other._alloc) {
+            try {
+                copy_from(other);
+            } catch (...) {
+                clear();
+                throw;
+            }
+        }
+
+        /**
+         * @brief 移动构造函数，接管 other 的节点，other 变为空树
+         */
+        __btree(__btree&& other) noexcept
+            : _root(other._root), _leftmost(other._leftmost), _rightmost(other._rightmost), _size(other._size),
+              _comp(other._comp), _alloc(other._alloc) {
+            other.reset_to_empty();
+        }
+
+        ~__btree() {
+            clear();
+        }
+
+        /**
+         * @brief 拷贝赋值运算符，保留自身的分配器
+         */
+        __btree& operator=(const __btree& other) {
+            if (this != &other) {
+                clear();
+                _comp = other._comp;
+                copy_from(other);
+            }
+            return *this;
+        }
+
+        /**
+         * @brief 移动赋值运算符，保留自身的分配器
+         * 两者的分配器相等时接管 other 的节点，否则逐个移动元素
+         */
+        __btree& operator=(__btree&& other) noexcept(__allocator_always_equal<value_allocator>::value) {
+            if (this == &other) {
+                return *this;
+            }
+            clear();
+            _comp = other._comp;
+            if (__allocator_equal(_alloc, other._alloc)) {
+                _root = other._root;
+                _leftmost = other._leftmost;
+                _rightmost = other._rightmost;
+                _size = other._size;
+                other.reset_to_empty();
+            } else {
+                for (value_type& v : other) {
+                    append_back([&](value_type* p) { Params::construct_move(_alloc, p, v); });
+                }
+                other.clear();
+            }
+            return *this;
+        }
+
+        /**
+         * @brief 用初始化列表中的元素替换树中的内容
+         */
+        __btree& operator=(std::initializer_list<value_type> il) {
+            clear();
+            insert(il);
+            return *this;
+        }
+
+        iterator begin() noexcept { return iterator(_leftmost, 0); }
+        const_iterator begin() const noexcept { return const_iterator(_leftmost, 0); }
+        const_iterator cbegin() const noexcept { return begin(); }
+        iterator end() noexcept { return iterator(_rightmost, _rightmost ? _rightmost->count : 0); }
+        const_iterator end() const noexcept { return const_iterator(_rightmost, _rightmost ? _rightmost->count : 0); }
+        const_iterator cend() const noexcept { return end(); }
+        reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+        const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+        reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+        const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+        bool empty() const noexcept { return _size == 0; }
+        size_type size() const noexcept { return _size; }
+        key_compare key_comp() const { return _comp; }
+        allocator_type get_allocator() const { return allocator_type(_alloc); }
+
+        /**
+         * @brief 获取树的高度，空树为 0
+         */
+        size_type height() const noexcept {
+            size_type h = 0;
+            for (const node_type* n = _root; n; n = n->leaf ? nullptr : n->child(0)) {
+                ++h;
+            }
+            return h;
+        }
+
+        /**
+         * @brief 销毁所有元素并释放所有节点
+         */
+        void clear() noexcept {
+            if (_root) {
+                destroy_subtree(_root);
+            }
+            reset_to_empty();
+        }
+
+        /**
+         * @brief 插入元素的副本，键已存在时不做任何事
+         * @return 指向具有该键的元素的迭代器，以及是否插入了新元素
+         */
+        pair<iterator, bool> insert(const value_type& value) {
+            return insert_unique(Params::key(value), [&](value_type* p) { _alloc.construct(p, value); });
+        }
+
+        pair<iterator, bool> insert(value_type&& value) {
+            return insert_unique(Params::key(value), [&](value_type* p) { Params::construct_move(_alloc, p, value); });
+        }
+
+        /**
+         * @brief 插入迭代器范围内的元素；比最右元素大的元素直接追加，因此有序输入不需要从根开始查找
+         */
+        template <typename InputIterator, __enable_if_input_iterator_t<InputIterator> = 0>
+        void insert(InputIterator first, InputIterator last) {
+            for (; first != last; ++first) {
+                insert(*first);
+            }
+        }
+
+        void insert(std::initializer_list<value_type> il) {
+            insert(il.begin(), il.end());
+        }
+
+        /**
+         * @brief 第一个键不小于 key 的元素
+         */
+        iterator lower_bound(const key_type& key) { return to_iterator(search_lower_bound(key)); }
+        const_iterator lower_bound(const key_type& key) const { return search_lower_bound(key); }
+
+        /**
+         * @brief 第一个键大于 key 的元素
+         */
+        iterator upper_bound(const key_type& key) { return to_iterator(search_upper_bound(key)); }
+        const_iterator upper_bound(const key_type& key) const { return search_upper_bound(key); }
+
+        pair<iterator, iterator> equal_range(const key_type& key) {
+            return pair<iterator, iterator>(lower_bound(key), upper_bound(key));
+        }
+
+        pair<const_iterator, const_iterator> equal_range(const key_type& key) const {
+            return pair<const_iterator, const_iterator>(lower_bound(key), upper_bound(key));
+        }
+
+        /**
+         * @brief 查找具有给定键的元素
+         * @return 指向该元素的迭代器，不存在时返回 end()
+         */
+        iterator find(const key_type& key) { return to_iterator(search_find(key)); }
+        const_iterator find(const key_type& key) const { return search_find(key); }
+
+        bool contains(const key_type& key) const { return search_find(key) != end(); }
+
+        size_type count(const key_type& key) const { return contains(key) ? 1 : 0; }
+
+        /**
+         * @brief 删除迭代器指向的元素
+         * @param pos 指向要删除元素的迭代器
+         * @return 指向下一个元素的迭代器
+         */
+        iterator erase(const_iterator pos) {
+            node_type* n = pos._node;
+            int p = pos._position;
+            node_type* leaf;
+            node_type* next_node;
+            int next_pos;
+            _alloc.destroy(&n->value(p));
+            if (!n->leaf) {
+                // 用前驱（左子树中最大的元素）填补空位，空位随之转移到叶节点的末尾
+                const_iterator pred = pos;
+                --pred;
+                leaf = pred._node;
+                Params::transfer(_alloc, n->slot(p), &leaf->value(pred._position));
+                --leaf->count;
+                const_iterator next(n, p);
+                ++next;
+                next_node = next._node;
+                next_pos = next._position;
+            } else {
+                for (int i = p + 1; i < n->count; ++i) {
+                    Params::transfer(_alloc, n->slot(i - 1), &n->value(i));
+                }
+                --n->count;
+                leaf = n;
+                next_node = n;
+                next_pos = p;
+                while (next_pos == next_node->count && next_node->parent) {
+                    next_pos = next_node->position;
+                    next_node = next_node->parent;
+                }
+                if (next_pos == next_node->count) {
+                    next_node = nullptr;
+                }
+            }
+            --_size;
+            rebalance_after_erase(leaf, next_node, next_pos);
+            return next_node ? iterator(next_node, next_pos) : end();
+        }
+
+        /**
+         * @brief 删除范围 [first, last) 内的元素
+         * 删除会在节点之间移动元素使 last 失效，因此先数出元素个数
+         * @return 指向被删除元素之后的元素的迭代器
+         */
+        iterator erase(const_iterator first, const_iterator last) {
+            difference_type n = tiny_stl::distance(first, last);
+            iterator it(first._node, first._position);
+            while (n-- > 0) {
+                it = erase(it);
+            }
+            return it;
+        }
+
+        /**
+         * @brief 删除具有给定键的元素
+         * @return 删除的元素数量（0 或 1）
+         */
+        size_type erase(const key_type& key) {
+            const_iterator it = search_find(key);
+            if (it == end()) {
+                return 0;
+            }
+            erase(it);
+            return 1;
+        }
+
+        /**
+         * @brief 交换两棵树的内容，包括分配器
+         */
+        void swap(__btree& other) noexcept {
+            tiny_stl::swap(_root, other._root);
+            tiny_stl::swap(_leftmost, other._leftmost);
+            tiny_stl::swap(_rightmost, other._rightmost);
+            tiny_stl::swap(_size, other._size);
+            tiny_stl::swap(_comp, other._comp);
+            tiny_stl::swap(_alloc, other._alloc);
+        }
+
+        /**
+         * @brief 相等比较运算符：元素数量相同且按顺序逐个相等
+         */
+        bool operator==(const __btree& other) const {
+            if (_size != other._size) {
+                return false;
+            }
+            for (const_iterator a = begin(), b = other.begin(); a != end(); ++a, ++b) {
+                if (!(*a == *b)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        bool operator!=(const __btree& other) const {
+            return !(*this == other);
+        }
+
+    protected:
+        /**
+         * @brief 若键不存在，先在临时存储上调用 construct 构造新元素，再把它移入叶节点
+         * 构造完成之后才修改树，构造抛出异常时树保持不变
+         * @param key 键
+         * @param construct 接受地址、在其上构造元素的函数
+         * @return 指向具有该键的元素的迭代器，以及是否插入了新元素
+         */
+        template <typename Construct>
+        pair<iterator, bool> insert_unique(const key_type& key, Construct&& construct) {
+            node_type* leaf = _rightmost;
+            int pos = leaf ? leaf->count : 0;
+            if (leaf && !_comp(Params::key(leaf->value(pos - 1)), key)) {
+                // 不比最右的元素大，从根开始查找
+                node_type* n = _root;
+                for (;;) {
+                    int i = node_lower_bound(n, key);
+                    if (i < n->count && !_comp(key, Params::key(n->value(i)))) {
+                        return pair<iterator, bool>(iterator(n, i), false);
+                    }
+                    if (n->leaf) {
+                        leaf = n;
+                        pos = i;
+                        break;
+                    }
+                    n = n->child(i);
+                }
+            }
+            return pair<iterator, bool>(insert_constructed(leaf, pos, construct), true);
+        }
+
+        /**
+         * @brief 把新元素追加到最右叶节点的末尾，调用者保证它比所有元素都大
+         */
+        template <typename Construct>
+        void append_back(Construct&& construct) {
+            insert_constructed(_rightmost, _rightmost ? _rightmost->count : 0, construct);
+        }
+
+        /**
+         * @brief 最后两个元素的键是否严格递增，用于检查按已排序范围追加的输入
+         */
+        bool last_two_ordered() const noexcept {
+            if (_size < 2) {
+                return true;
+            }
+            const_iterator last = end();
+            --last;
+            const_iterator before = last;
+            --before;
+            return _comp(Params::key(*before), Params::key(*last));
+        }
+
+        /**
+         * @brief 用分配器在地址 p 上构造元素
+         */
+        template <typename... Args>
+        void construct_value(value_type* p, Args&&... args) {
+            _alloc.construct(p, tiny_stl::forward<Args>(args)...);
+        }
+
+    private:
+        node_type* _root; /**< 根节点，空树时为空 */
+        node_type* _leftmost; /**< 最左叶节点，begin() 所在 */
+        node_type* _rightmost; /**< 最右叶节点，end() 所在 */
+        size_type _size; /**< 元素数量 */
+        Compare _comp; /**< 键的比较函数 */
+        value_allocator _alloc; /**< 元素的分配器 */
+
+        static iterator to_iterator(const_iterator it) noexcept {
+            return iterator(it._node, it._position);
+        }
+
+        void reset_to_empty() noexcept {
+            _root = _leftmost = _rightmost = nullptr;
+            _size = 0;
+        }
+
+        node_type* new_node(bool leaf, node_type* parent) {
+            node_type* n;
+            if (leaf) {
+                leaf_allocator alloc(_alloc);
+                n = ::new (static_cast<void*>(alloc.allocate(1))) node_type;
+            } else {
+                internal_allocator alloc(_alloc);
+                n = ::new (static_cast<void*>(alloc.allocate(1))) internal_node_type;
+            }
+            n->parent = parent;
+            n->position = 0;
+            n->count = 0;
+            n->leaf = leaf;
+            return n;
+        }
+
+        void delete_node(node_type* n) noexcept {
+            if (n->leaf) {
+                leaf_allocator alloc(_alloc);
+                alloc.deallocate(n, 1);
+            } else {
+                internal_allocator alloc(_alloc);
+                alloc.deallocate(static_cast<internal_node_type*>(n), 1);
+            }
+        }
+
+        void destroy_subtree(node_type* n) noexcept {
+            for (int i = 0; i < n->count; ++i) {
+                _alloc.destroy(&n->value(i));
+            }
+            if (!n->leaf) {
+                for (int i = 0; i <= n->count; ++i) {
+                    destroy_subtree(n->child(i));
+                }
+            }
+            delete_node(n);
+        }
+
+        void copy_from(const __btree& other) {
+            for (const value_type& v : other) {
+                append_back([&](value_type* p) { _alloc.construct(p, v); });
+            }
+        }
+
+        /**
+         * @brief 节点内第一个键不小于 key 的元素下标
+         */
+        int node_lower_bound(const node_type* n, const key_type& key) const {
+            if (n->count == 0) {
+                return 0;
+            }
+            auto less_than_key = [this](const value_type& v, const key_type& k) { return _comp(Params::key(v), k); };
+            const value_type* first = &n->value(0);
+            return static_cast<int>(tiny_stl::__branchless_lower_bound(first, n->count, key, less_than_key) - first);
+        }
+
+        const_iterator search_lower_bound(const key_type& key) const {
+            // 越往下找到的候选越小，但都不小于 key，最后一个候选就是答案
+            const_iterator result = end();
+            for (node_type* n = _root; n;) {
+                int i = node_lower_bound(n, key);
+                if (i < n->count) {
+                    result = const_iterator(n, i);
+                }
+                n = n->leaf ? nullptr : n->child(i);
+            }
+            return result;
+        }
+
+        const_iterator search_upper_bound(const key_type& key) const {
+            const_iterator it = search_lower_bound(key);
+            if (it != end() && !_comp(key, Params::key(*it))) {
+                ++it;
+            }
+            return it;
+        }
+
+        const_iterator search_find(const key_type& key) const {
+            for (node_type* n = _root; n;) {
+                int i = node_lower_bound(n, key);
+                if (i < n->count && !_comp(key, Params::key(n->value(i)))) {
+                    return const_iterator(n, i);
+                }
+                n = n->leaf ? nullptr : n->child(i);
+            }
+            return end();
+        }
+
+        /**
+         * @brief 在临时存储上构造元素，然后插入到叶节点 leaf 的 pos 处
+         */
+        template <typename Construct>
+        iterator insert_constructed(node_type* leaf, int pos, Construct& construct) {
+            alignas(value_type) unsigned char buffer[sizeof(value_type)];
+            value_type* tmp = reinterpret_cast<value_type*>(buffer);
+            construct(tmp);
+            try {
+                return insert_at(leaf, pos, tmp);
+            } catch (...) {
+                _alloc.destroy(tmp);
+                throw;
+            }
+        }
+
+        /**
+         * @brief 把 src 处的元素搬到叶节点 leaf 的 pos 处（leaf 为空表示空树），节点已满时先分裂
+         * 只有分配节点时可能抛出异常，此时 src 处的元素尚未被移动
+         */
+        iterator insert_at(node_type* leaf, int pos, value_type* src) {
+            if (!leaf) {
+                _root = _leftmost = _rightmost = leaf = new_node(true, nullptr);
+                pos = 0;
+            }
+            if (leaf->count == max_count) {
+                split(leaf, pos);
+            }
+            for (int i = leaf->count; i > pos; --i) {
+                Params::transfer(_alloc, leaf->slot(i), &leaf->value(i - 1));
+            }
+            Params::transfer(_alloc, leaf->slot(pos), src);
+            ++leaf->count;
+            ++_size;
+            return iterator(leaf, pos);
+        }
+
+        /**
+         * @brief 把已满的节点分裂成两个，中间的元素上移到父节点（父节点已满时先分裂父节点）
+         * @param node 要分裂的节点，返回时为待插入位置所在的节点
+         * @param pos 待插入的位置，返回时为分裂后的位置
+         */
+        void split(node_type*& node, int& pos) {
+            if (node == _root) {
+                node_type* root = new_node(false, nullptr);
+                root->set_child(0, node);
+                _root = root;
+            } else if (node->parent->count == max_count) {
+                node_type* parent = node->parent;
+                int parent_pos = node->position;
+                split(parent, parent_pos);
+            }
+            node_type* parent = node->parent;
+            int k = node->position;
+            node_type* right = new_node(node->leaf, parent);
+
+            // 在末尾插入时左节点保持满载，在开头插入时右节点保持满载，否则对半分
+            int count = node->count;
+            int mid = pos == count ? count - 1 : (pos == 0 ? 1 : count / 2);
+            for (int i = mid + 1; i < count; ++i) {
+                Params::transfer(_alloc, right->slot(i - mid - 1), &node->value(i));
+            }
+            right->count = static_cast<unsigned short>(count - mid - 1);
+            if (!node->leaf) {
+                for (int i = mid + 1; i <= count; ++i) {
+                    right->set_child(i - mid - 1, node->child(i));
+                }
+            }
+            node->count = static_cast<unsigned short>(mid);
+
+            for (int i = parent->count; i > k; --i) {
+                Params::transfer(_alloc, parent->slot(i), &parent->value(i - 1));
+            }
+            for (int i = parent->count + 1; i > k + 1; --i) {
+                parent->set_child(i, parent->child(i - 1));
+            }
+            Params::transfer(_alloc, parent->slot(k), &node->value(mid));
+            parent->set_child(k + 1, right);
+            ++parent->count;
+
+            if (node == _rightmost) {
+                _rightmost = right;
+            }
+            if (pos > mid) {
+                node = right;
+                pos -= mid + 1;
+            }
+        }
+
+        /**
+         * @brief 删除后从叶节点 node 向上恢复每个节点至少 min_count 个元素的约束，最后收缩空的根节点
+         * tn、tp 跟踪被删除元素的下一个元素（tn 为空表示 end()），元素在节点间移动时随之更新
+         */
+        void rebalance_after_erase(node_type* node, node_type*& tn, int& tp) noexcept {
+            while (node != _root && node->count < min_count) {
+                node_type* parent = node->parent;
+                int k = node->position;
+                if (k > 0 && parent->child(k - 1)->count > min_count) {
+                    rotate_right(parent, k - 1, tn, tp);
+                    break;
+                }
+                if (k < parent->count && parent->child(k + 1)->count > min_count) {
+                    rotate_left(parent, k, tn, tp);
+                    break;
+                }
+                if (k > 0) {
+                    merge(parent, k - 1, tn, tp);
+                } else if (k < parent->count) {
+                    merge(parent, k, tn, tp);
+                } else {
+                    break;
+                }
+                node = parent;
+            }
+            if (_root->count == 0) {
+                node_type* old_root = _root;
+                if (old_root->leaf) {
+                    reset_to_empty();
+                } else {
+                    _root = old_root->child(0);
+                    _root->parent = nullptr;
+                    _root->position = 0;
+                }
+                delete_node(old_root);
+            }
+        }
+
+        /**
+         * @brief 右兄弟借给左兄弟一个元素：父节点第 k 个元素下移到左节点末尾，右节点的第一个元素上移
+         */
+        void rotate_left(node_type* parent, int k, node_type*& tn, int& tp) noexcept {
+            node_type* left = parent->child(k);
+            node_type* right = parent->child(k + 1);
+            int left_count = left->count;
+            Params::transfer(_alloc, left->slot(left_count), &parent->value(k));
+            Params::transfer(_alloc, parent->slot(k), &right->value(0));
+            for (int i = 1; i < right->count; ++i) {
+                Params::transfer(_alloc, right->slot(i - 1), &right->value(i));
+            }
+            if (!left->leaf) {
+                left->set_child(left_count + 1, right->child(0));
+                for (int i = 1; i <= right->count; ++i) {
+                    right->set_child(i - 1, right->child(i));
+                }
+            }
+            ++left->count;
+            --right->count;
+            if (tn == parent && tp == k) {
+                tn = left;
+                tp = left_count;
+            } else if (tn == right) {
+                if (tp == 0) {
+                    tn = parent;
+                    tp = k;
+                } else {
+                    --tp;
+                }
+            }
+        }
+
+        /**
+         * @brief 左兄弟借给右兄弟一个元素：父节点第 k 个元素下移到右节点开头，左节点的最后一个元素上移
+         */
+        void rotate_right(node_type* parent, int k, node_type*& tn, int& tp) noexcept {
+            node_type* left = parent->child(k);
+            node_type* right = parent->child(k + 1);
+            int left_count = left->count;
+            for (int i = right->count; i > 0; --i) {
+                Params::transfer(_alloc, right->slot(i), &right->value(i - 1));
+            }
+            Params::transfer(_alloc, right->slot(0), &parent->value(k));
+            Params::transfer(_alloc, parent->slot(k), &left->value(left_count - 1));
+            if (!right->leaf) {
+                for (int i = right->count + 1; i > 0; --i) {
+                    right->set_child(i, right->child(i - 1));
+                }
+                right->set_child(0, left->child(left_count));
+            }
+            --left->count;
+            ++right->count;
+            if (tn == right) {
+                ++tp;
+            } else if (tn == parent && tp == k) {
+                tn = right;
+                tp = 0;
+            } else if (tn == left && tp == left_count - 1) {
+                tn = parent;
+                tp = k;
+            }
+        }
+
+        /**
+         * @brief 合并父节点的第 k 与 k + 1 个子节点，父节点第 k 个元素下移到二者之间
+         */
+        void merge(node_type* parent, int k, node_type*& tn, int& tp) noexcept {
+            node_type* left = parent->child(k);
+            node_type* right = parent->child(k + 1);
+            int left_count = left->count;
+            int right_count = right->count;
+            Params::transfer(_alloc, left->slot(left_count), &parent->value(k));
+            for (int i = 0; i < right_count; ++i) {
+                Params::transfer(_alloc, left->slot(left_count + 1 + i), &right->value(i));
+            }
+            if (!left->leaf) {
+                for (int i = 0; i <= right_count; ++i) {
+                    left->set_child(left_count + 1 + i, right->child(i));
+                }
+            }
+            left->count = static_cast<unsigned short>(left_count + 1 + right_count);
+            for (int i = k + 1; i < parent->count; ++i) {
+                Params::transfer(_alloc, parent->slot(i - 1), &parent->value(i));
+            }
+            for (int i = k + 2; i <= parent->count; ++i) {
+                parent->set_child(i - 1, parent->child(i));
+            }
+            --parent->count;
+            if (right == _rightmost) {
+                _rightmost = left;
+            }
+            delete_node(right);
+            if (tn == right) {
+                tn = left;
+                tp += left_count + 1;
+            } else if (tn == parent) {
+                if (tp == k) {
+                    tn = left;
+                    tp = left_count;
+                } else if (tp > k) {
+                    --tp;
+                }
+            }
+        }
+    };
+
+    /**
+     * @class btree_map
+     * @brief 基于 B 树的有序映射，接口与 `std::map` 相近。
+     *
+     * 与 `std::map` 不同，插入与删除会使迭代器、指针和引用失效（erase 返回的迭代器仍然有效）。
+     *
+     * @tparam Key 键类型
+     * @tparam T 值类型
+     * @tparam Compare 键的比较函数类型，默认为 `less<Key>`
+     * @tparam Alloc 分配器类型，默认为 `allocator<pair<const Key, T>>`
+     */
+    template <typename Key, typename T, typename Compare = less<Key>, typename Alloc = allocator<pair<const Key, T>>>
+    class btree_map : public __btree<__btree_map_params<Key, T>, Compare, Alloc> {
+        using base = __btree<__btree_map_params<Key, T>, Compare, Alloc>;
+    public:
+        using mapped_type = T; /**< 值类型 */
+        using typename base::key_type;
+        using typename base::value_type;
+        using typename base::iterator;
+        using typename base::const_iterator;
+
+        using base::base;
+        using base::operator=;
+        using base::erase;
+
+        btree_map() = default;
+
+        /**
+         * @brief 删除迭代器指向的元素
+         * @return 指向下一个元素的迭代器
+         */
+        iterator erase(iterator pos) {
+            return base::erase(const_iterator(pos));
+        }
+
+        /**
+         * @brief 键不存在时插入一个由 args 构造值的元素，键已存在时不做任何事（也不移动 args）
+         * @return 指向具有该键的元素的迭代器，以及是否插入了新元素
+         */
+        template <typename... Args>
+        pair<iterator, bool> try_emplace(const key_type& key, Args&&... args) {
+            return this->insert_unique(key, [&](value_type* p) {
+                this->construct_value(p, key, mapped_type(tiny_stl::forward<Args>(args)...));
+            });
+        }
+
+        template <typename... Args>
+        pair<iterator, bool> try_emplace(key_type&& key, Args&&... args) {
+            return this->insert_unique(key, [&](value_type* p) {
+                this->construct_value(p, tiny_stl::move(key), mapped_type(tiny_stl::forward<Args>(args)...));
+            });
+        }
+
+        /**
+         * @brief 用键和值构造元素后插入，键已存在时不做任何事
+         */
+        template <typename K, typename V>
+        pair<iterator, bool> emplace(K&& k, V&& v) {
+            key_type key(tiny_stl::forward<K>(k));
+            return try_emplace(tiny_stl::move(key), tiny_stl::forward<V>(v));
+        }
+
+        /**
+         * @brief 键不存在时插入元素，否则把值赋给已有的元素
+         */
+        template <typename M>
+        pair<iterator, bool> insert_or_assign(const key_type& key, M&& obj) {
+            bool inserted = false;
+            auto result = this->insert_unique(key, [&](value_type* p) {
+                this->construct_value(p, key, tiny_stl::forward<M>(obj));
+                inserted = true;
+            });
+            if (!inserted) {
+                result.first->second = tiny_stl::forward<M>(obj);
+            }
+            return result;
+        }
+
+        /**
+         * @brief 访问键对应的值，键不存在时插入一个值初始化的元素
+         */
+        mapped_type& operator[](const key_type& key) {
+            return try_emplace(key).first->second;
+        }
+
+        mapped_type& operator[](key_type&& key) {
+            return try_emplace(tiny_stl::move(key)).first->second;
+        }
+
+        /**
+         * @brief 访问键对应的值
+         * @throw std::out_of_range 如果键不存在。
+         */
+        mapped_type& at(const key_type& key) {
+            iterator it = this->find(key);
+            if (it == this->end()) {
+                throw std::out_of_range("Key not found");
+            }
+            return it->second;
+        }
+
+        const mapped_type& at(const key_type& key) const {
+            const_iterator it = this->find(key);
+            if (it == this->end()) {
+                throw std::out_of_range("Key not found");
+            }
+            return it->second;
+        }
+    };
+
+    /**
+     * @class btree_set
+     * @brief 基于 B 树的有序集合，接口与 `std::set` 相近，实现与 `btree_map` 相同。
+     * @tparam Key 键类型
+     * @tparam Compare 键的比较函数类型，默认为 `less<Key>`
+     * @tparam Alloc 分配器类型，默认为 `allocator<Key>`
+     */
+    template <typename Key, typename Compare = less<Key>, typename Alloc = allocator<Key>>
+    class btree_set : public __btree<__btree_set_params<Key>, Compare, Alloc> {
+        using base = __btree<__btree_set_params<Key>, Compare, Alloc>;
+    public:
+        using typename base::key_type;
+        using typename base::value_type;
+        using typename base::iterator;
+
+        using base::base;
+        using base::operator=;
+
+        btree_set() = default;
+
+        /**
+         * @brief 用 args 构造一个键后插入，键已存在时丢弃它
+         */
+        template <typename... Args>
+        pair<iterator, bool> emplace(Args&&... args) {
+            key_type key(tiny_stl::forward<Args>(args)...);
+            return this->insert(tiny_stl::move(key));
+        }
+    };
+
+    template <typename Key, typename T, typename Compare, typename Alloc>
+    void swap(btree_map<Key, T, Compare, Alloc>& a, btree_map<Key, T, Compare, Alloc>& b) noexcept {
+        a.swap(b);
+    }
+
+    template <typename Key, typename Compare, typename Alloc>
+    void swap(btree_set<Key, Compare, Alloc>& a, btree_set<Key, Compare, Alloc>& b) noexcept {
+        a.swap(b);
+    }
+
+}
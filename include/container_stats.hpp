@@ -0,0 +1,389 @@
+/**
+ * @file container_stats.hpp
+ * @brief 此文件定义了 tiny_stl 命名空间下的内存与容器统计：按容器类型计数的分配、重新分配与元素搬移，
+ * 以及把分配计入统计的 tracking_allocator。
+ *
+ * 容器内部的统计是编译期开关：定义 `TINY_STL_ENABLE_STATS` 后，vector、deque 与 list 在分配、释放、
+ * 重新分配与构造元素时更新各自类型的计数器；未定义时这些钩子都是空的内联函数，不产生任何代码。
+ * tracking_allocator 不受开关影响，使用它本身就是选择开启统计。
+ * 计数器使用 relaxed 原子操作，可以在多线程中使用；快照中的各项不保证来自同一时刻。
+ */
+
+#pragma once
+
+#ifdef __GNUC__
+#   pragma GCC system_header
+#endif
+#if defined(_MSC_VER) && _MSC_VER >= 1920
+#   pragma system_header
+#endif
+
+#include <allocator.hpp>
+#include <utility.hpp>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+
+namespace tiny_stl {
+
+    /**
+     * @brief 容器内部的统计是否开启，即是否定义了 `TINY_STL_ENABLE_STATS`
+     */
+#if defined(TINY_STL_ENABLE_STATS)
+    constexpr bool container_stats_enabled = true;
+#else
+    constexpr bool container_stats_enabled = false;
+#endif
+
+    /**
+     * @struct container_stats
+     * @brief 某一类型的统计快照
+     */
+    struct container_stats {
+        uint64_t allocations = 0;       /**< 分配次数 */
+        uint64_t deallocations = 0;     /**< 释放次数 */
+        uint64_t bytes_allocated = 0;   /**< 累计分配的字节数 */
+        uint64_t bytes_deallocated = 0; /**< 累计释放的字节数 */
+        uint64_t live_bytes = 0;        /**< 当前仍未释放的字节数 */
+        uint64_t peak_bytes = 0;        /**< 同时持有的最大字节数 */
+        uint64_t reallocations = 0;     /**< 重新分配次数：vector 扩容或缩容，deque 更换管控中心 */
+        uint64_t element_moves = 0;     /**< 移动构造（含按位重定位）的元素个数 */
+        uint64_t element_copies = 0;    /**< 拷贝构造的元素个数 */
+        uint64_t peak_capacity = 0;     /**< 单个容器达到的最大容量（元素个数），目前只有 vector 记录 */
+    };
+
+    /**
+     * @struct __stats_counters
+     * @brief 某一类型的计数器，首次使用时加入全局的链表，供 for_each_stats 遍历
+     */
+    struct __stats_counters {
+        std::string name; /**< 类型名 */
+        std::atomic<uint64_t> allocations{0};
+        std::atomic<uint64_t> deallocations{0};
+        std::atomic<uint64_t> bytes_allocated{0};
+        std::atomic<uint64_t> bytes_deallocated{0};
+        std::atomic<uint64_t> live_bytes{0};
+        std::atomic<uint64_t> peak_bytes{0};
+        std::atomic<uint64_t> reallocations{0};
+        std::atomic<uint64_t> element_moves{0};
+        std::atomic<uint64_t> element_copies{0};
+        std::atomic<uint64_t> peak_capacity{0};
+        __stats_counters* next; /**< 链表中的下一个计数器 */
+
+        explicit __stats_counters(std::string type_name);
+
+        static void add(std::atomic<uint64_t>& counter, uint64_t n) noexcept {
+            counter.fetch_add(n, std::memory_order_relaxed);
+        }
+
+        static void raise(std::atomic<uint64_t>& counter, uint64_t value) noexcept {
+            uint64_t cur = counter.load(std::memory_order_relaxed);
+            while (cur < value && !counter.compare_exchange_weak(cur, value, std::memory_order_relaxed)) { }
+        }
+
+        void record_allocate(uint64_t bytes) noexcept {
+            add(allocations, 1);
+            add(bytes_allocated, bytes);
+            raise(peak_bytes, live_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes);
+        }
+
+        void record_deallocate(uint64_t bytes) noexcept {
+            add(deallocations, 1);
+            add(bytes_deallocated, bytes);
+            live_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+        }
+
+        container_stats snapshot() const noexcept {
+            container_stats s;
+            s.allocations = allocations.load(std::memory_order_relaxed);
+            s.deallocations = deallocations.load(std::memory_order_relaxed);
+            s.bytes_allocated = bytes_allocated.load(std::memory_order_relaxed);
+            s.bytes_deallocated = bytes_deallocated.load(std::memory_order_relaxed);
+            s.live_bytes = live_bytes.load(std::memory_order_relaxed);
+            s.peak_bytes = peak_bytes.load(std::memory_order_relaxed);
+            s.reallocations = reallocations.load(std::memory_order_relaxed);
+            s.element_moves = element_moves.load(std::memory_order_relaxed);
+            s.element_copies = element_copies.load(std::memory_order_relaxed);
+            s.peak_capacity = peak_capacity.load(std::memory_order_relaxed);
+            return s;
+        }
+
+        /**
+         * @brief 清零累计的计数；live_bytes 反映仍在使用的内存，保留不变，峰值从它重新开始
+         */
+        void reset() noexcept {
+            allocations.store(0, std::memory_order_relaxed);
+            deallocations.store(0, std::memory_order_relaxed);
+            bytes_allocated.store(0, std::memory_order_relaxed);
+            bytes_deallocated.store(0, std::memory_order_relaxed);
+            peak_bytes.store(live_bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            reallocations.store(0, std::memory_order_relaxed);
+            element_moves.store(0, std::memory_order_relaxed);
+            element_copies.store(0, std::memory_order_relaxed);
+            peak_capacity.store(0, std::memory_order_relaxed);
+        }
+    };
+
+    /**
+     * @brief 全局计数器链表的表头
+     */
+    inline std::atomic<__stats_counters*>& __stats_registry() noexcept {
+        static std::atomic<__stats_counters*> head{nullptr};
+        return head;
+    }
+
+    inline __stats_counters::__stats_counters(std::string type_name)
+        : name(tiny_stl::move(type_name)), next(__stats_registry().load(std::memory_order_relaxed)) {
+        while (!__stats_registry().compare_exchange_weak(next, this, std::memory_order_release,
+                                                         std::memory_order_relaxed)) { }
+    }
+
+    /**
+     * @brief 返回包含类型名的函数签名，由 __stats_type_name 从中截取类型名
+     */
+    template <typename Key>
+    const char* __stats_signature() noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        return __PRETTY_FUNCTION__;
+#elif defined(_MSC_VER)
+        return __FUNCSIG__;
+#else
+        return typeid(Key).name();
+#endif
+    }
+
+    /**
+     * @brief 返回可读的类型名
+     */
+    template <typename Key>
+    std::string __stats_type_name() {
+        std::string sig = __stats_signature<Key>();
+#if defined(__GNUC__) || defined(__clang__)
+        // 形如 "const char* tiny_stl::__stats_signature() [with Key = tiny_stl::vector<int>]"
+        size_t begin = sig.find("Key = ");
+        size_t end = sig.rfind(']');
+        if (begin != std::string::npos && end != std::string::npos && end > begin) {
+            return sig.substr(begin + 6, end - begin - 6);
+        }
+#elif defined(_MSC_VER)
+        // 形如 "const char *__cdecl tiny_stl::__stats_signature<class tiny_stl::vector<int>>(void) noexcept"
+        size_t begin = sig.find("__stats_signature<");
+        size_t end = sig.rfind(">(void)");
+        if (begin != std::string::npos && end != std::string::npos && end > begin) {
+            return sig.substr(begin + 18, end - begin - 18);
+        }
+#endif
+        return sig;
+    }
+
+    /**
+     * @brief 返回类型 Key 的计数器。
+     * 计数器永不销毁，静态存储期的容器在程序退出时析构也能安全地更新统计
+     */
+    template <typename Key>
+    __stats_counters& __stats_of() {
+        static __stats_counters* counters = new __stats_counters(__stats_type_name<Key>());
+        return *counters;
+    }
+
+    /**
+     * @brief 返回类型 Key 的统计快照，例如 `stats_snapshot<tiny_stl::vector<int>>()`
+     * @tparam Key 容器类型，或 tracking_allocator 的标签类型
+     */
+    template <typename Key>
+    container_stats stats_snapshot() {
+        return __stats_of<Key>().snapshot();
+    }
+
+    /**
+     * @brief 清零类型 Key 累计的统计
+     * @tparam Key 容器类型，或 tracking_allocator 的标签类型
+     */
+    template <typename Key>
+    void reset_stats() {
+        __stats_of<Key>().reset();
+    }
+
+    /**
+     * @brief 遍历所有已经产生过统计的类型
+     * @param f 形如 `void(const std::string& name, const container_stats& stats)` 的可调用对象
+     */
+    template <typename Function>
+    void for_each_stats(Function f) {
+        for (__stats_counters* c = __stats_registry().load(std::memory_order_acquire); c; c = c->next) {
+            f(static_cast<const std::string&>(c->name), c->snapshot());
+        }
+    }
+
+    /**
+     * @struct __construct_kind
+     * @brief 根据转发给构造函数的参数判断一次 T 的构造是拷贝还是移动：
+     * 唯一的参数是非 const 的 T 右值时为移动，是 T 的左值或 const 右值时为拷贝，其余情况都不算
+     */
+    template <typename T, typename... Args>
+    struct __construct_kind {
+        static constexpr bool move = false;
+        static constexpr bool copy = false;
+    };
+
+    template <typename T, typename Arg>
+    struct __construct_kind<T, Arg> {
+        static constexpr bool same = std::is_same<std::decay_t<Arg>, T>::value;
+        static constexpr bool move = same && !std::is_lvalue_reference<Arg>::value &&
+                                     !std::is_const<std::remove_reference_t<Arg>>::value;
+        static constexpr bool copy = same && !move;
+    };
+
+    /**
+     * @struct __stats_hooks
+     * @brief 容器内部调用的统计钩子；未定义 `TINY_STL_ENABLE_STATS` 时全部为空函数
+     * @tparam Container 容器类型，统计按它分类
+     */
+    template <typename Container>
+    struct __stats_hooks {
+#if defined(TINY_STL_ENABLE_STATS)
+        static void on_allocate(size_t bytes) noexcept { __stats_of<Container>().record_allocate(bytes); }
+        static void on_deallocate(size_t bytes) noexcept { __stats_of<Container>().record_deallocate(bytes); }
+        static void on_reallocate() noexcept { __stats_counters::add(__stats_of<Container>().reallocations, 1); }
+        static void on_moves(size_t n) noexcept { __stats_counters::add(__stats_of<Container>().element_moves, n); }
+        static void on_copies(size_t n) noexcept { __stats_counters::add(__stats_of<Container>().element_copies, n); }
+        static void on_capacity(size_t n) noexcept { __stats_counters::raise(__stats_of<Container>().peak_capacity, n); }
+#else
+        static void on_allocate(size_t) noexcept { }
+        static void on_deallocate(size_t) noexcept { }
+        static void on_reallocate() noexcept { }
+        static void on_moves(size_t) noexcept { }
+        static void on_copies(size_t) noexcept { }
+        static void on_capacity(size_t) noexcept { }
+#endif
+
+        /**
+         * @brief 按构造参数统计一次元素构造，参见 __construct_kind
+         */
+        template <typename T, typename... Args>
+        static void on_construct() noexcept {
+            if constexpr (__construct_kind<T, Args...>::move) {
+                on_moves(1);
+            } else if constexpr (__construct_kind<T, Args...>::copy) {
+                on_copies(1);
+            }
+        }
+    };
+
+    /**
+     * @struct tracking_allocator_tag
+     * @brief tracking_allocator 的默认标签，未指定标签的 tracking_allocator 都计入它的统计
+     */
+    struct tracking_allocator_tag { };
+
+    /**
+     * @class tracking_allocator
+     * @brief 包装另一个分配器，把分配、释放与通过 construct 进行的拷贝和移动计入 Tag 的统计。
+     *
+     * rebind 得到的分配器使用同一个 Tag，因此容器内部为节点、管控中心等分配的内存都计入同一份统计，
+     * 用 `stats_snapshot<Tag>()` 读取。不受 `TINY_STL_ENABLE_STATS` 影响。
+     *
+     * @tparam T 分配的对象类型
+     * @tparam Tag 统计的分类标签
+     * @tparam Alloc 被包装的分配器类型
+     */
+    template <typename T, typename Tag = tracking_allocator_tag, typename Alloc = allocator<T>>
+    class tracking_allocator {
+        using inner_allocator = typename Alloc::template rebind<T>::other;
+
+    public:
+        using value_type = T; /**< 对象类型 */
+        using pointer = T*; /**< 指针类型 */
+        using const_pointer = const T*; /**< 常量指针类型 */
+        using reference = T&; /**< 引用类型 */
+        using const_reference = const T&; /**< 常量引用类型 */
+        using size_type = size_t; /**< 大小类型 */
+        using difference_type = ptrdiff_t; /**< 距离类型 */
+        using tag_type = Tag; /**< 统计的分类标签 */
+
+        /**
+         * @brief 获取管理另一种对象类型、使用同一标签的 tracking_allocator
+         */
+        template <typename U>
+        struct rebind {
+            using other = tracking_allocator<U, Tag, typename Alloc::template rebind<U>::other>;
+        };
+
+        tracking_allocator() = default;
+
+        /**
+         * @brief 用被包装的分配器构造
+         */
+        explicit tracking_allocator(const inner_allocator& inner) : _inner(inner) { }
+
+        /**
+         * @brief 从管理其他对象类型的 tracking_allocator 构造
+         */
+        template <typename U, typename OtherAlloc>
+        tracking_allocator(const tracking_allocator<U, Tag, OtherAlloc>& other) : _inner(other.inner()) { }
+
+        /**
+         * @brief 分配 n 个对象的内存并计入统计
+         * @throws std::bad_alloc 如果内存分配失败
+         */
+        pointer allocate(size_type n) {
+            pointer p = _inner.allocate(n);
+            if (p) {
+                __stats_of<Tag>().record_allocate(n * sizeof(T));
+            }
+            return p;
+        }
+
+        /**
+         * @brief 释放之前分配的 n 个对象的内存并计入统计
+         */
+        void deallocate(pointer p, size_type n) {
+            __stats_of<Tag>().record_deallocate(n * sizeof(T));
+            _inner.deallocate(p, n);
+        }
+
+        /**
+         * @brief 构造对象；唯一的参数是 T 时计为一次拷贝或移动
+         */
+        template <typename... Args>
+        pointer construct(pointer p, Args&&... args) {
+            if constexpr (__construct_kind<T, Args...>::move) {
+                __stats_counters::add(__stats_of<Tag>().element_moves, 1);
+            } else if constexpr (__construct_kind<T, Args...>::copy) {
+                __stats_counters::add(__stats_of<Tag>().element_copies, 1);
+            }
+            return _inner.construct(p, tiny_stl::forward<Args>(args)...);
+        }
+
+        /**
+         * @brief 销毁对象
+         */
+        void destroy(pointer p) {
+            _inner.destroy(p);
+        }
+
+        size_type max_size() const noexcept { return _inner.max_size(); }
+
+        /**
+         * @brief 返回被包装的分配器
+         */
+        const inner_allocator& inner() const noexcept { return _inner; }
+
+    private:
+        inner_allocator _inner; /**< 被包装的分配器 */
+    };
+
+    template <typename T1, typename T2, typename Tag, typename A1, typename A2>
+    bool operator==(const tracking_allocator<T1, Tag, A1>& lhs, const tracking_allocator<T2, Tag, A2>& rhs) noexcept {
+        return lhs.inner() == rhs.inner();
+    }
+
+    template <typename T1, typename T2, typename Tag, typename A1, typename A2>
+    bool operator!=(const tracking_allocator<T1, Tag, A1>& lhs, const tracking_allocator<T2, Tag, A2>& rhs) noexcept {
+        return !(lhs == rhs);
+    }
+
+}
@@ -0,0 +1,341 @@
+/**
+ * @file cow_vector.hpp
+ * @brief 此文件定义了 tiny_stl 命名空间下的 cow_vector 类，一个读多写少、写时复制的动态数组。
+ *
+ * 每个版本的引用计数、大小、版本号与元素存放在同一次分配的内存中，版本创建后不再修改，
+ * 通过 `atomic_shared_ptr` 发布：读者用一次原子读取拿到当前版本的快照，不加锁，
+ * 快照在读者持有期间始终有效；写者复制当前版本、修改副本，再原子地发布新版本，
+ * 旧版本在最后一个持有它的快照销毁时释放。写者之间由一个互斥量串行化，读者从不接触它。
+ */
+
+#pragma once
+
+#ifdef __GNUC__
+#   pragma GCC system_header
+#endif
+#if defined(_MSC_VER) && _MSC_VER >= 1920
+#   pragma system_header
+#endif
+
+#include <atomic_shared_ptr.hpp>
+#include <iterator.hpp>
+#include <memory.hpp>
+#include <shared_ptr.hpp>
+#include <utility.hpp>
+#include <vector.hpp>
+#include <atomic>
+#include <cstdint>
+#include <initializer_list>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+
+namespace tiny_stl {
+
+    /**
+     * @struct __cow_version
+     * @brief cow_vector 的一个版本，发布之后不再修改；元素紧跟在同一块内存中
+     * @tparam T 元素类型
+     */
+    template <typename T>
+    struct __cow_version {
+        const T* elements; /**< 首元素的地址，位于同一次分配的内存中 */
+        size_t size;       /**< 元素个数 */
+        uint64_t version;  /**< 版本号，每次发布加 1 */
+    };
+
+    /**
+     * @class __cow_block
+     * @brief cow_vector 版本的控制块，引用计数、__cow_version 与元素数组存放在同一次分配的内存中。
+     * 读者持有的 `shared_ptr<__cow_version<T>>` 直接指向其中的版本，读取大小与元素只需一次间接访问。
+     * 通过 `create` 分配并构造，通过 `destroy` 析构并释放，不可直接 `new`/`delete`。
+     * @tparam T 元素类型
+     */
+    template <typename T>
+    class __cow_block : public control_block {
+    private:
+        __cow_version<T> version_; /**< 版本的大小与版本号 */
+
+        /**
+         * @brief 元素数组相对控制块起始地址的偏移量，按 `T` 的对齐要求向上取整
+         */
+        static constexpr size_t offset() noexcept {
+            return (sizeof(__cow_block) + alignof(T) - 1) / alignof(T) * alignof(T);
+        }
+
+        /**
+         * @brief 整块内存所需的对齐值
+         */
+        static constexpr size_t alignment() noexcept {
+            return alignof(T) > alignof(__cow_block) ? alignof(T) : alignof(__cow_block);
+        }
+
+        static void* allocate(size_t n) {
+            size_t bytes = offset() + n * sizeof(T);
+            if constexpr (alignment() > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+                return ::operator new(bytes, std::align_val_t(alignment()));
+            } else {
+                return ::operator new(bytes);
+            }
+        }
+
+        static void deallocate(void* p) noexcept {
+            if constexpr (alignment() > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+                ::operator delete(p, std::align_val_t(alignment()));
+            } else {
+                ::operator delete(p);
+            }
+        }
+
+        T* elements() noexcept {
+            return reinterpret_cast<T*>(reinterpret_cast<unsigned char*>(this) + offset());
+        }
+
+        explicit __cow_block(uint64_t version) noexcept : version_{elements(), 0, version} { }
+
+    public:
+        /**
+         * @brief 一次分配控制块与元素数组，把 source 中的元素移动构造进来。
+         * 移动构造抛出异常时销毁已构造的元素并释放内存，source 中的元素可能已被移动
+         * @param source 新版本的元素
+         * @param version 版本号
+         * @return 新建的控制块指针，强引用计数为 1
+         */
+        static __cow_block* create(vector<T>& source, uint64_t version) {
+            void* mem = allocate(source.size());
+            auto* block = ::new (mem) __cow_block(version);
+            try {
+                tiny_stl::uninitialized_move(source.begin(), source.end(), block->elements());
+            } catch (...) {
+                block->~__cow_block();
+                deallocate(mem);
+                throw;
+            }
+            block->version_.size = source.size();
+            return block;
+        }
+
+        /**
+         * @brief 获取控制块中的版本
+         */
+        __cow_version<T>* get() noexcept {
+            return &version_;
+        }
+
+        void* get_pointer() noexcept override {
+            return &version_;
+        }
+
+        /**
+         * @brief 逆序销毁元素，内存随控制块一起释放
+         */
+        void dispose() noexcept override {
+            T* p = elements();
+            for (size_t i = version_.size; i > 0; --i) {
+                p[i - 1].~T();
+            }
+        }
+
+        /**
+         * @brief 释放控制块与元素所在的整块内存
+         */
+        void destroy() noexcept override {
+            this->~__cow_block();
+            deallocate(this);
+        }
+    };
+
+    /**
+     * @class cow_vector
+     * @brief 写时复制的动态数组：读者获取不可变的快照，写者复制、修改并原子地发布新版本。
+     *
+     * 适合被大量线程频繁读取、偶尔整体更新的数据，例如路由表、配置。
+     * 读取一次 `load()` 只是对 atomic_shared_ptr 的一次原子读取；每次写操作都会复制全部元素，
+     * 需要连续修改多处时应使用 `update()` 一次完成，只复制与发布一次。
+     *
+     * @tparam T 元素类型，需要可复制构造；set() 还需要可复制赋值
+     */
+    template <typename T>
+    class cow_vector {
+        using version_type = __cow_version<T>;
+
+    public:
+        using value_type = T;                 /**< 元素类型 */
+        using size_type = size_t;             /**< 大小类型 */
+        using difference_type = ptrdiff_t;    /**< 距离类型 */
+        using const_reference = const T&;     /**< 常量引用类型 */
+        using const_pointer = const T*;       /**< 常量指针类型 */
+        using const_iterator = const T*;      /**< 常量迭代器类型 */
+        using const_reverse_iterator = tiny_stl::reverse_iterator<const_iterator>; /**< 常量反向迭代器类型 */
+        using builder_type = vector<T>;       /**< update() 中供修改的副本类型 */
+
+        /**
+         * @class snapshot
+         * @brief cow_vector 某一版本的只读快照，持有期间元素不会改变也不会被释放
+         */
+        class snapshot {
+        public:
+            using value_type = T;
+            using size_type = size_t;
+            using difference_type = ptrdiff_t;
+            using const_reference = const T&;
+            using const_iterator = const T*;
+            using iterator = const T*;
+            using const_reverse_iterator = tiny_stl::reverse_iterator<const_iterator>;
+
+            /**
+             * @brief 构造一个空快照
+             */
+            snapshot() noexcept = default;
+
+            const T* data() const noexcept { return _version ? _version->elements : nullptr; }
+            size_type size() const noexcept { return _version ? _version->size : 0; }
+            bool empty() const noexcept { return size() == 0; }
+
+            /**
+             * @brief 快照对应的版本号，空的 cow_vector 从 0 开始，每次发布加 1
+             */
+            uint64_t version() const noexcept { return _version ? _version->version : 0; }
+
+            const_iterator begin() const noexcept { return data(); }
+            const_iterator end() const noexcept { return data() + size(); }
+            const_iterator cbegin() const noexcept { return begin(); }
+            const_iterator cend() const noexcept { return end(); }
+            const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+            const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+            const_reference operator[](size_type n) const noexcept { return data()[n]; }
+            const_reference front() const noexcept { return data()[0]; }
+            const_reference back() const noexcept { return data()[size() - 1]; }
+
+            /**
+             * @brief 访问下标为 n 的元素，检查边界
+             * @throw std::out_of_range 如果索引超出范围
+             */
+            const_reference at(size_type n) const {
+                if (n >= size()) {
+                    throw std::out_of_range("Index out of range");
+                }
+                return data()[n];
+            }
+
+        private:
+            friend class cow_vector;
+
+            shared_ptr<version_type> _version; /**< 快照持有的版本 */
+
+            explicit snapshot(shared_ptr<version_type> version) noexcept : _version(tiny_stl::move(version)) { }
+        };
+
+        /**
+         * @brief 构造一个空的 cow_vector
+         */
+        cow_vector() noexcept = default;
+
+        /**
+         * @brief 用 [first, last) 范围内的元素构造，作为版本 1 发布
+         */
+        template <typename InputIterator, __enable_if_input_iterator_t<InputIterator> = 0>
+        cow_vector(InputIterator first, InputIterator last) {
+            builder_type elements(first, last);
+            publish(elements, 1);
+        }
+
+        /**
+         * @brief 用初始化列表中的元素构造，作为版本 1 发布
+         */
+        cow_vector(std::initializer_list<T> il) : cow_vector(il.begin(), il.end()) { }
+
+        cow_vector(const cow_vector&) = delete;
+        cow_vector& operator=(const cow_vector&) = delete;
+
+        /**
+         * @brief 获取当前版本的快照，只有一次原子读取，可以与写者并发调用
+         */
+        snapshot load() const noexcept {
+            return snapshot(_current.load(std::memory_order_acquire));
+        }
+
+        /**
+         * @brief 当前版本的元素个数；需要多次访问时应先 load() 一次
+         */
+        size_type size() const noexcept { return load().size(); }
+        bool empty() const noexcept { return size() == 0; }
+
+        /**
+         * @brief 当前版本的版本号
+         */
+        uint64_t version() const noexcept { return load().version(); }
+
+        /**
+         * @brief 复制当前版本，交给 mutate 修改后作为新版本发布。
+         * mutate 抛出异常时不发布任何内容；写者之间串行执行，mutate 中不能再修改同一个 cow_vector。
+         * @param mutate 形如 `void(builder_type& elements)` 的可调用对象
+         */
+        template <typename Function>
+        void update(Function&& mutate) {
+            std::lock_guard<std::mutex> lock(_writer);
+            snapshot current = load();
+            builder_type elements(current.begin(), current.end());
+            tiny_stl::forward<Function>(mutate)(elements);
+            publish(elements, current.version() + 1);
+        }
+
+        /**
+         * @brief 用 [first, last) 范围内的元素替换全部内容，不复制当前版本
+         */
+        template <typename InputIterator, __enable_if_input_iterator_t<InputIterator> = 0>
+        void assign(InputIterator first, InputIterator last) {
+            builder_type elements(first, last);
+            std::lock_guard<std::mutex> lock(_writer);
+            publish(elements, version() + 1);
+        }
+
+        void push_back(const T& value) {
+            update([&value](builder_type& elements) { elements.push_back(value); });
+        }
+
+        void push_back(T&& value) {
+            update([&value](builder_type& elements) { elements.push_back(tiny_stl::move(value)); });
+        }
+
+        /**
+         * @brief 发布删除了最后一个元素的新版本，当前版本必须非空
+         */
+        void pop_back() {
+            update([](builder_type& elements) { elements.pop_back(); });
+        }
+
+        /**
+         * @brief 发布下标 n 处的元素被替换为 value 的新版本
+         * @throw std::out_of_range 如果索引超出范围
+         */
+        void set(size_type n, const T& value) {
+            update([n, &value](builder_type& elements) { elements.at(n) = value; });
+        }
+
+        /**
+         * @brief 发布一个空的新版本
+         */
+        void clear() {
+            std::lock_guard<std::mutex> lock(_writer);
+            builder_type elements;
+            publish(elements, version() + 1);
+        }
+
+    private:
+        atomic_shared_ptr<version_type> _current; /**< 当前发布的版本 */
+        std::mutex _writer; /**< 串行化写者 */
+
+        /**
+         * @brief 把 elements 移动构造进新版本的控制块，作为版本号为 version 的新版本发布；调用者需持有 _writer
+         */
+        void publish(builder_type& elements, uint64_t version) {
+            __cow_block<T>* block = __cow_block<T>::create(elements, version);
+            _current.store(__shared_ptr_access::make<shared_ptr<version_type>>(block->get(), block),
+                           std::memory_order_release);
+        }
+    };
+
+}
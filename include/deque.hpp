@@ -13,18 +13,34 @@
 #endif
 
 #include <cstddef>
-#include <algorithm> // 添加此头文件用于 std::copy 和 std::copy_backward
-                     // 稍后自己实现并替换
-// #include <algorithm.hpp>
+#include <cassert>
+#include <algorithm.hpp>
 #include <iterator>
 #include <memory> 
+#include <memory.hpp>
+#include <container_stats.hpp>
+#include <iterator.hpp>
+#include <initializer_list>
+#include <type_traits>
 
 namespace tiny_stl {
+    /**
+     * @brief 计算deque每个缓冲区容纳的元素数量
+     * 显式指定时直接使用；否则以约 4 KiB 为目标：元素小于 256 字节时为 4096 / sizeof(T)，
+     * 更大的元素每个缓冲区固定容纳 16 个，避免大元素得到巨大的缓冲区、小元素得到过小的缓冲区
+     * @param n deque 模板参数中指定的元素数量，为 0 表示自动计算
+     * @param size 元素的大小（字节）
+     * @return 每个缓冲区容纳的元素数量
+     */
+    constexpr size_t __deque_buffer_size(size_t n, size_t size) noexcept {
+        return n != 0 ? n : (size < 256 ? 4096 / size : 16);
+    }
+
     /**
      * @class __deque_iterator
      * @brief deque的迭代器
      * @tparam T 迭代器的元素类型
-     * @tparam buffer 缓冲区大小
+     * @tparam buffer 每个缓冲区容纳的元素数量
      * @tparam Ptr 指针，默认为T*
      * @tparam Ref 引用，默认为T&
      */
@@ -38,7 +54,7 @@ namespace tiny_stl {
         using self = __deque_iterator; /**< deque_iterator自身 */
 
         using value_type = T; /**< 元素类型 */
-        using iterator_category = std::random_access_iterator_tag; /**< 迭代器类型 */
+        using iterator_category = random_access_iterator_tag; /**< 迭代器类型 */
         using difference_type = ptrdiff_t; /**< 距离类型 */
         using pointer = Ptr; /**< 指针类型 */
         using reference = Ref; /**< 引用类型 */
@@ -90,7 +106,7 @@ namespace tiny_stl {
          * @brief 访问当前指向的元素的*运算符
          * @return 当前指向的元素
          */
-        reference operator*() { return *cur; }
+        reference operator*() const { return *cur; }
 
         /**
          * @brief 访问当前指向的元素的->运算符
@@ -104,6 +120,10 @@ namespace tiny_stl {
          * @return 两个迭代器之间的距离
          */
         difference_type operator-(const self& x) const {
+            if (node == x.node) {
+                // 同一缓冲区内（包括被移动后的空deque的空迭代器）直接相减
+                return cur - x.cur;
+            }
             return difference_type(buffer_size()) * (node - x.node - 1) +
                 (cur - first) + (x.last - x.cur);
         }
@@ -161,7 +181,7 @@ namespace tiny_stl {
          */
         self& operator+=(difference_type n) {
             difference_type offset = n + (cur - first);
-            if (offset >= 0 && offset <= difference_type(buffer_size())) {
+            if (offset >= 0 && offset < difference_type(buffer_size())) {
                 cur += n;
             } else {
                 difference_type node_offset =
@@ -258,13 +278,38 @@ namespace tiny_stl {
         }
     };
 
+    /**
+     * @brief deque 迭代器的分段特性：每个缓冲区是一段，段内迭代器就是指针
+     * 使 copy、fill、find 等算法可以按缓冲区逐段处理 deque 的范围
+     * @tparam T 元素类型
+     * @tparam buffer 每个缓冲区容纳的元素数量
+     * @tparam Ptr 指针类型
+     * @tparam Ref 引用类型
+     */
+    template <typename T, size_t buffer, typename Ptr, typename Ref>
+    struct __segmented_iterator_traits<__deque_iterator<T, buffer, Ptr, Ref>> {
+        using iterator = __deque_iterator<T, buffer, Ptr, Ref>; /**< 迭代器类型 */
+        using segment_iterator = T**; /**< 段迭代器，即管控中心中的节点 */
+        using local_iterator = Ptr; /**< 段内迭代器 */
+
+        static constexpr bool is_segmented = true; /**< 是分段迭代器 */
+
+        static segment_iterator segment(const iterator& it) { return it.node; }
+        static local_iterator local(const iterator& it) { return it.cur; }
+        static local_iterator begin(segment_iterator seg) { return *seg; }
+        static local_iterator end(segment_iterator seg) { return *seg + buffer; }
+        static iterator compose(segment_iterator seg, local_iterator local) {
+            return iterator(const_cast<T*>(local), seg);
+        }
+    };
+
     /**
      * @brief deque实现
      * @tparam T 元素类型
      * @tparam Alloc 内存分配器
-     * @tparam buffer 缓冲区大小
+     * @tparam buffer 每个缓冲区容纳的元素数量，默认为 0，表示按每个缓冲区约 4 KiB 由 sizeof(T) 计算
      */
-    template <typename T, typename Alloc = allocator<T>, size_t buffer = 512>
+    template <typename T, typename Alloc = allocator<T>, size_t buffer = 0>
     class deque {
     public:
         using value_type = T; /**< 元素类型 */
@@ -272,46 +317,55 @@ namespace tiny_stl {
         using pointer = T*; /**< 指针类型 */
         using reference = T&; /**< 引用类型 */
         using difference_type = ptrdiff_t; /**< 指针距离类型 */
-        using iterator = __deque_iterator<T, buffer>; /**< 迭代器 */
+        static constexpr size_t block_size = __deque_buffer_size(buffer, sizeof(T)); /**< 每个缓冲区容纳的元素数量 */
+        using iterator = __deque_iterator<T, block_size>; /**< 迭代器 */
+        using allocator_type = Alloc; /**< 分配器类型 */
     protected:
         using map_pointer = pointer*;
+        using map_allocator = typename Alloc::template rebind<pointer>::other; /**< 管控中心的分配器类型 */
     public:
         /**
-         * @brief 默认构造函数
+         * @brief 默认构造函数，不分配内存，管控中心在第一次插入元素时才分配
          */
-        deque() : _map(nullptr), _map_size(0) {
-            initialize_map_and_nodes(0);
-        }
+        deque() : deque(allocator_type()) { }
+
+        /**
+         * @brief 构造函数，创建一个使用指定分配器的空deque，不分配内存
+         * @param a 分配器
+         */
+        explicit deque(const allocator_type& a) : _map(nullptr), _map_size(0), alloc(a), map_alloc(a) { }
 
         /**
          * @brief 构造函数，创建包含n个值为value的元素的deque
          * @param n 元素数量
          * @param value 元素的值
+         * @param a 分配器
          */
-        deque(size_type n, const value_type& value) : _map(nullptr), _map_size(0) {
+        deque(size_type n, const value_type& value, const allocator_type& a = allocator_type())
+            : _map(nullptr), _map_size(0), alloc(a), map_alloc(a) {
             initialize_map_and_nodes(n);
-            for (iterator it = _begin; it != _end; ++it) {
-                *it = value;
-            }
+            fill_initialize(value);
         }
 
         /**
-         * @brief 复制构造函数
+         * @brief 复制构造函数，新deque使用other分配器的副本
          * @param other 要复制的deque
          */
-        deque(const deque& other) : _map(nullptr), _map_size(0) {
-            initialize_map_and_nodes(other.size());
-            iterator dest = _begin;
-            for (iterator src = other._begin; src != other._end; ++src, ++dest) {
-                *dest = *src;
+        deque(const deque& other) : _map(nullptr), _map_size(0), alloc(other.alloc), map_alloc(other.map_alloc) {
+            if (!other.empty()) {
+                initialize_map_and_nodes(other.size());
+                copy_initialize(other._begin);
             }
         }
 
         /**
-         * @brief 移动构造函数
-         * @param other 要移动的deque
+         * @brief 移动构造函数，连同分配器一起接管other的内存
+         * @param other 要移动的deque，之后成为不持有内存的空deque，可以继续使用
          */
-        deque(deque&& other) noexcept : _begin(other._begin), _end(other._end), _map(other._map), _map_size(other._map_size) {
+        deque(deque&& other) noexcept
+            : _begin(other._begin), _end(other._end), _map(other._map), _map_size(other._map_size),
+              alloc(tiny_stl::move(other.alloc)), map_alloc(tiny_stl::move(other.map_alloc)) {
+            take_spare_nodes(other);
             other._begin = iterator();
             other._end = iterator();
             other._map = nullptr;
@@ -323,9 +377,11 @@ namespace tiny_stl {
          * @tparam InputIterator 输入迭代器类型
          * @param first 起始迭代器
          * @param last 结束迭代器
+         * @param a 分配器
          */
-        template <typename InputIterator>
-        deque(InputIterator first, InputIterator last) : _map(nullptr), _map_size(0) {
+        template <typename InputIterator, __enable_if_input_iterator_t<InputIterator> = 0>
+        deque(InputIterator first, InputIterator last, const allocator_type& a = allocator_type())
+            : _map(nullptr), _map_size(0), alloc(a), map_alloc(a) {
             // 计算元素数量
             size_type num_elements = 0;
             InputIterator temp = first;
@@ -338,10 +394,7 @@ namespace tiny_stl {
             initialize_map_and_nodes(num_elements);
 
             // 将迭代器范围内的元素复制到 deque 中
-            iterator dest = _begin;
-            for (InputIterator src = first; src != last; ++src, ++dest) {
-                *dest = *src;
-            }
+            copy_initialize(first);
         }
 
         /**
@@ -349,35 +402,40 @@ namespace tiny_stl {
          */
         ~deque() {
             clear();
-            deallocate_map();
+            destroy_nodes_and_map();
+            release_spare_nodes();
         }
 
         /**
-         * @brief 复制赋值运算符
+         * @brief 复制赋值运算符，保留自身的分配器
          * @param other 要复制的deque
          * @return 赋值后的deque引用
          */
         deque& operator=(const deque& other) {
             if (this != &other) {
                 clear();
-                initialize_map_and_nodes(other.size());
-                iterator dest = _begin;
-                for (iterator src = other._begin; src != other._end; ++src, ++dest) {
-                    *dest = *src;
+                destroy_nodes_and_map();
+                if (!other.empty()) {
+                    initialize_map_and_nodes(other.size());
+                    copy_initialize(other._begin);
                 }
             }
             return *this;
         }
 
         /**
-         * @brief 移动赋值运算符
+         * @brief 移动赋值运算符，保留自身的分配器
+         * 两者的分配器相等时接管other的内存，否则逐个移动元素
          * @param other 要移动的deque
          * @return 赋值后的deque引用
          */
-        deque& operator=(deque&& other) noexcept {
-            if (this != &other) {
-                clear();
-                deallocate_map();
+        deque& operator=(deque&& other) noexcept(__allocator_always_equal<Alloc>::value) {
+            if (this == &other) {
+                return *this;
+            }
+            clear();
+            destroy_nodes_and_map();
+            if (__allocator_equal(alloc, other.alloc)) {
                 _begin = other._begin;
                 _end = other._end;
                 _map = other._map;
@@ -386,6 +444,9 @@ namespace tiny_stl {
                 other._end = iterator();
                 other._map = nullptr;
                 other._map_size = 0;
+            } else {
+                initialize_map_and_nodes(other.size());
+                copy_initialize(tiny_stl::make_move_iterator(other._begin));
             }
             return *this;
         }
@@ -445,28 +506,77 @@ namespace tiny_stl {
          */
         bool empty() const { return _end == _begin; }
 
+        /**
+         * @brief 获取deque使用的分配器
+         * @return 分配器的副本
+         */
+        allocator_type get_allocator() const { return alloc; }
+
+        /**
+         * @brief 交换两个deque的内容，分配器随内容一起交换
+         * @param other 要交换的deque
+         */
+        void swap(deque& other) noexcept {
+            tiny_stl::swap(_begin, other._begin);
+            tiny_stl::swap(_end, other._end);
+            tiny_stl::swap(_map, other._map);
+            tiny_stl::swap(_map_size, other._map_size);
+            tiny_stl::swap(alloc, other.alloc);
+            tiny_stl::swap(map_alloc, other.map_alloc);
+            for (size_type i = 0; i < spare_capacity; ++i) {
+                tiny_stl::swap(_spare[i], other._spare[i]);
+            }
+            tiny_stl::swap(_spare_count, other._spare_count);
+        }
+
+        /**
+         * @brief 友元函数，交换两个deque的内容
+         * @param lhs 第一个deque
+         * @param rhs 第二个deque
+         */
+        friend void swap(deque& lhs, deque& rhs) noexcept {
+            lhs.swap(rhs);
+        }
+
+        /**
+         * @brief 释放缓存的空闲缓冲区
+         */
+        void shrink_to_fit() noexcept {
+            release_spare_nodes();
+        }
+
         /**
          * @brief 在deque的末尾添加一个元素
          * @param value 要添加的元素的值
          */
         void push_back(const value_type& value) {
-            if (_end.cur != _end.last - 1) {
-                alloc.construct(_end.cur, value);
+            emplace_back(value);
+        }
+
+        /**
+         * @brief 在deque的末尾添加一个元素，移动value
+         * @param value 要添加的元素
+         */
+        void push_back(value_type&& value) {
+            emplace_back(tiny_stl::move(value));
+        }
+
+        /**
+         * @brief 在deque的末尾用args原地构造一个元素
+         * @tparam Args 构造参数的类型包
+         * @param args 构造参数，可以引用deque自身的元素
+         * @return 新元素的引用
+         */
+        template <typename... Args>
+        reference emplace_back(Args&&... args) {
+            if (_end.last - _end.cur > 1) {
+                alloc.construct(_end.cur, tiny_stl::forward<Args>(args)...);
+                stats_hooks::template on_construct<T, Args...>();
                 ++_end.cur;
             } else {
-                // 在当前缓冲区最后位置构造元素
-                alloc.construct(_end.cur, value);
-                // 检查并扩展 map
-                if (_end.node + 1 == _map + _map_size) {
-                    reallocate_map(1, false);
-                }
-                reserve_map_at_back();
-                // 分配新缓冲区并移动迭代器
-                map_pointer new_node = _end.node + 1;
-                *new_node = allocate_node();
-                _end.set_node(new_node);
-                _end.cur = _end.first; // 新缓冲区起始位置
+                emplace_back_aux(tiny_stl::forward<Args>(args)...);
             }
+            return back();
         }
 
         /**
@@ -474,18 +584,33 @@ namespace tiny_stl {
          * @param value 要添加的元素的值
          */
         void push_front(const value_type& value) {
-            if (_begin.cur == _begin.first) {
-                if (_begin.node == _map) {
-                    reallocate_map(1, true);
-                }
-                reserve_map_at_front();
-                *--_begin.node = allocate_node();
-                _begin.set_node(_begin.node);
-                _begin.cur = _begin.last - 1;
-            } else {
+            emplace_front(value);
+        }
+
+        /**
+         * @brief 在deque的开头添加一个元素，移动value
+         * @param value 要添加的元素
+         */
+        void push_front(value_type&& value) {
+            emplace_front(tiny_stl::move(value));
+        }
+
+        /**
+         * @brief 在deque的开头用args原地构造一个元素
+         * @tparam Args 构造参数的类型包
+         * @param args 构造参数，可以引用deque自身的元素
+         * @return 新元素的引用
+         */
+        template <typename... Args>
+        reference emplace_front(Args&&... args) {
+            if (_begin.cur != _begin.first) {
+                alloc.construct(_begin.cur - 1, tiny_stl::forward<Args>(args)...);
+                stats_hooks::template on_construct<T, Args...>();
                 --_begin.cur;
+            } else {
+                emplace_front_aux(tiny_stl::forward<Args>(args)...);
             }
-            alloc.construct(_begin.cur, value);
+            return front();
         }
 
         /**
@@ -498,11 +623,10 @@ namespace tiny_stl {
                     alloc.destroy(_end.cur);
                 } else {
                     // 移动到前一个缓冲区
-                    deallocate_node(_end.node); // 释放空缓冲区
+                    deallocate_node(*_end.node); // 释放空缓冲区
                     _end.set_node(_end.node - 1);
-                    _end.cur = _end.last - 1;   // 最后一个元素位置
+                    _end.cur = _end.last - 1;    // 最后一个元素位置，同时也是新的尾后位置
                     alloc.destroy(_end.cur);
-                    _end.cur = _end.last;       // 设置为尾后位置
                 }
             }
         }
@@ -514,7 +638,7 @@ namespace tiny_stl {
             if (!empty()) {
                 alloc.destroy(_begin.cur);
                 if (_begin.cur == _begin.last - 1) {
-                    deallocate_node(_begin.node);
+                    deallocate_node(*_begin.node);
                     _begin.set_node(_begin.node + 1);
                     _begin.cur = _begin.first;
                 } else {
@@ -524,11 +648,145 @@ namespace tiny_stl {
         }
 
         /**
-         * @brief 清空deque中的所有元素
+         * @brief 移出并删除deque的最后一个元素
+         * @return 被删除的元素
+         * @note deque不能为空
+         */
+        value_type pop_back_value() {
+            assert(!empty());
+            value_type value(tiny_stl::move(back()));
+            pop_back();
+            return value;
+        }
+
+        /**
+         * @brief 移出并删除deque的第一个元素
+         * @return 被删除的元素
+         * @note deque不能为空
+         */
+        value_type pop_front_value() {
+            assert(!empty());
+            value_type value(tiny_stl::move(front()));
+            pop_front();
+            return value;
+        }
+
+        /**
+         * @brief 在pos之前插入一个元素
+         * @param pos 插入位置
+         * @param value 要插入的元素的值
+         * @return 指向插入元素的迭代器
+         */
+        iterator insert(iterator pos, const value_type& value) {
+            return insert(pos, 1, value);
+        }
+
+        /**
+         * @brief 在pos之前插入n个值为value的元素
+         * @param pos 插入位置
+         * @param n 要插入的元素数量
+         * @param value 要插入的元素的值，可以引用deque自身的元素
+         * @return 指向第一个插入元素的迭代器
+         */
+        iterator insert(iterator pos, size_type n, const value_type& value) {
+            value_type tmp(value);
+            return insert_range(pos, __repeat_iterator<value_type>(tmp, 0),
+                                __repeat_iterator<value_type>(tmp, difference_type(n)), n);
+        }
+
+        /**
+         * @brief 在pos之前插入[first, last)范围内的元素
+         * 前向迭代器只计算一次长度，缓冲区一次性分配完毕，pos较短的一侧只整体移动一次；
+         * 单遍输入迭代器会先收集到临时deque中再插入
+         * @tparam InputIterator 输入迭代器类型，不能指向当前deque
+         * @param pos 插入位置
+         * @param first 起始迭代器
+         * @param last 结束迭代器
+         * @return 指向第一个插入元素的迭代器
+         */
+        template <typename InputIterator, __enable_if_input_iterator_t<InputIterator> = 0>
+        iterator insert(iterator pos, InputIterator first, InputIterator last) {
+            if constexpr (__is_iterator_of<InputIterator, forward_iterator_tag>::value) {
+                size_type n = tiny_stl::distance(first, last);
+                return insert_range(pos, first, last, n);
+            } else {
+                deque tmp;
+                for (; first != last; ++first) {
+                    tmp.push_back(*first);
+                }
+                return insert(pos, tmp.begin(), tmp.end());
+            }
+        }
+
+        /**
+         * @brief 在pos之前插入初始化列表中的元素
+         * @param pos 插入位置
+         * @param list 初始化列表
+         * @return 指向第一个插入元素的迭代器
+         */
+        iterator insert(iterator pos, std::initializer_list<value_type> list) {
+            return insert(pos, list.begin(), list.end());
+        }
+
+        /**
+         * @brief 在末尾追加一个范围内的全部元素
+         * @tparam Range 范围类型，需要支持 begin() 与 end()
+         * @param range 要追加的范围，不能是当前deque
+         */
+        template <typename Range>
+        void append_range(Range&& range) {
+            using std::begin;
+            using std::end;
+            insert(_end, begin(range), end(range));
+        }
+
+        /**
+         * @brief 把内容替换为n个值为value的元素
+         * @param n 元素数量
+         * @param value 元素的值
+         */
+        void assign(size_type n, const value_type& value) {
+            value_type tmp(value);
+            assign(__repeat_iterator<value_type>(tmp, 0), __repeat_iterator<value_type>(tmp, difference_type(n)));
+        }
+
+        /**
+         * @brief 把内容替换为[first, last)范围内的元素
+         * 复用已有元素进行赋值，多出的元素从尾部一次性插入或销毁
+         * @tparam InputIterator 输入迭代器类型，不能指向当前deque
+         * @param first 起始迭代器
+         * @param last 结束迭代器
+         */
+        template <typename InputIterator, __enable_if_input_iterator_t<InputIterator> = 0>
+        void assign(InputIterator first, InputIterator last) {
+            iterator cur = _begin;
+            for (; cur != _end && first != last; ++cur, ++first) {
+                *cur = *first;
+            }
+            if (first == last) {
+                erase_at_end(cur);
+            } else {
+                insert(_end, first, last);
+            }
+        }
+
+        /**
+         * @brief 把内容替换为初始化列表中的元素
+         * @param list 初始化列表
+         */
+        void assign(std::initializer_list<value_type> list) {
+            assign(list.begin(), list.end());
+        }
+
+        /**
+         * @brief 清空deque中的所有元素；没有管控中心（默认构造或被移动后）时什么也不做
          */
         void clear() {
+            if (!_map) {
+                return;
+            }
             for (map_pointer node = _begin.node + 1; node < _end.node; ++node) {
-                for (pointer p = *node; p < *node + buffer; ++p) {
+                for (pointer p = *node; p < *node + block_size; ++p) {
                     alloc.destroy(p);
                 }
                 deallocate_node(*node);
@@ -555,15 +813,19 @@ namespace tiny_stl {
         map_pointer _map;
         size_type _map_size;
         Alloc alloc;
-        typename Alloc::template rebind<pointer>::other map_alloc;
+        map_allocator map_alloc;
+
+        static constexpr size_type spare_capacity = 2; /**< 最多缓存的空闲缓冲区数量 */
+        pointer _spare[spare_capacity]; /**< 缓存的空闲缓冲区，供下一次 allocate_node 复用 */
+        size_type _spare_count = 0; /**< 缓存的空闲缓冲区数量 */
 
         /**
          * @brief 初始化管控中心和节点
          * @param num_elements 元素数量
          */
         void initialize_map_and_nodes(size_type num_elements) {
-            size_type num_nodes = num_elements / buffer + 1;
-            _map_size = std::max(static_cast<size_type>(8), num_nodes + 2);
+            size_type num_nodes = num_elements / block_size + 1;
+            _map_size = tiny_stl::max(static_cast<size_type>(8), num_nodes + 2);
             _map = allocate_map(_map_size);
             map_pointer nstart = _map + (_map_size - num_nodes) / 2;
             map_pointer nfinish = nstart + num_nodes;
@@ -571,21 +833,366 @@ namespace tiny_stl {
                 create_nodes(nstart, nfinish);
             } catch (...) {
                 deallocate_map();
+                _map = nullptr;
+                _map_size = 0;
                 throw;
             }
             _begin.set_node(nstart);
             _end.set_node(nfinish - 1);
             _begin.cur = _begin.first;
-            _end.cur = _end.first + num_elements % buffer;
+            _end.cur = _end.first + num_elements % block_size;
+        }
+
+        /**
+         * @brief 在 initialize_map_and_nodes 准备好的未初始化空间中填充 value
+         * 逐个缓冲区调用 uninitialized_fill，元素平凡可复制时每个缓冲区只需一次 memset 或简单循环
+         * @param value 元素的值
+         */
+        void fill_initialize(const value_type& value) {
+            map_pointer node = _begin.node;
+            try {
+                for (; node < _end.node; ++node) {
+                    tiny_stl::uninitialized_fill(*node, *node + block_size, value);
+                }
+                tiny_stl::uninitialized_fill(_end.first, _end.cur, value);
+            } catch (...) {
+                for (map_pointer done = _begin.node; done < node; ++done) {
+                    tiny_stl::destroy(*done, *done + block_size);
+                }
+                destroy_nodes_and_map();
+                throw;
+            }
+        }
+
+        /**
+         * @brief 从 first 开始复制 size() 个元素到 initialize_map_and_nodes 准备好的未初始化空间中
+         * 逐个缓冲区调用 uninitialized_copy，源为指向平凡可复制类型的指针时每个缓冲区只需一次 memcpy
+         * @tparam InputIterator 输入迭代器类型
+         * @param first 源范围的起始迭代器
+         */
+        template <typename InputIterator>
+        void copy_initialize(InputIterator first) {
+            map_pointer node = _begin.node;
+            try {
+                for (; node <= _end.node; ++node) {
+                    pointer dest_last = node == _end.node ? _end.cur : *node + block_size;
+                    InputIterator mid = first;
+                    if constexpr (std::is_pointer<InputIterator>::value) {
+                        mid += dest_last - *node;
+                    } else {
+                        for (pointer p = *node; p != dest_last; ++p) {
+                            ++mid;
+                        }
+                    }
+                    tiny_stl::uninitialized_copy(first, mid, *node);
+                    first = mid;
+                }
+            } catch (...) {
+                for (map_pointer done = _begin.node; done < node; ++done) {
+                    tiny_stl::destroy(*done, *done + block_size);
+                }
+                destroy_nodes_and_map();
+                throw;
+            }
+        }
+
+        /**
+         * @brief 在pos之前插入从first开始的n个元素
+         * 采用SGI STL的做法：pos之前的元素较少时向前扩展并整体前移，否则向后扩展并整体后移，
+         * 所需的缓冲区在移动之前一次性分配
+         * @tparam ForwardIterator 前向迭代器类型
+         * @param pos 插入位置
+         * @param first 起始迭代器
+         * @param last 结束迭代器
+         * @param n 元素数量，等于 distance(first, last)
+         * @return 指向第一个插入元素的迭代器
+         */
+        template <typename ForwardIterator>
+        iterator insert_range(iterator pos, ForwardIterator first, ForwardIterator last, size_type n) {
+            difference_type elems_before = pos - _begin;
+            if (n == 0) {
+                return pos;
+            }
+            lazy_initialize();
+            size_type length = size();
+            if (elems_before < difference_type(length / 2)) {
+                iterator new_start = reserve_elements_at_front(n);
+                iterator old_start = _begin;
+                pos = _begin + elems_before;
+                if (elems_before >= difference_type(n)) {
+                    iterator start_n = _begin + difference_type(n);
+                    try {
+                        tiny_stl::uninitialized_move(_begin, start_n, new_start);
+                    } catch (...) {
+                        destroy_nodes_before(new_start.node);
+                        throw;
+                    }
+                    _begin = new_start;
+                    move_assign(start_n, pos, old_start);
+                    copy_assign(first, last, pos - difference_type(n));
+                } else {
+                    ForwardIterator mid = first;
+                    tiny_stl::advance(mid, difference_type(n) - elems_before);
+                    iterator cur = new_start;
+                    try {
+                        cur = tiny_stl::uninitialized_move(_begin, pos, new_start);
+                        tiny_stl::uninitialized_copy(first, mid, cur);
+                    } catch (...) {
+                        tiny_stl::destroy(new_start, cur);
+                        destroy_nodes_before(new_start.node);
+                        throw;
+                    }
+                    _begin = new_start;
+                    copy_assign(mid, last, old_start);
+                }
+                return _begin + elems_before;
+            } else {
+                difference_type elems_after = difference_type(length) - elems_before;
+                iterator new_finish = reserve_elements_at_back(n);
+                iterator old_finish = _end;
+                pos = _end - elems_after;
+                if (elems_after > difference_type(n)) {
+                    iterator finish_n = _end - difference_type(n);
+                    try {
+                        tiny_stl::uninitialized_move(finish_n, _end, _end);
+                    } catch (...) {
+                        destroy_nodes_after(new_finish.node);
+                        throw;
+                    }
+                    _end = new_finish;
+                    move_assign_backward(pos, finish_n, old_finish);
+                    copy_assign(first, last, pos);
+                } else {
+                    ForwardIterator mid = first;
+                    tiny_stl::advance(mid, elems_after);
+                    iterator cur = _end;
+                    try {
+                        cur = tiny_stl::uninitialized_copy(mid, last, _end);
+                        tiny_stl::uninitialized_move(pos, _end, cur);
+                    } catch (...) {
+                        tiny_stl::destroy(_end, cur);
+                        destroy_nodes_after(new_finish.node);
+                        throw;
+                    }
+                    _end = new_finish;
+                    copy_assign(first, mid, pos);
+                }
+                return _begin + elems_before;
+            }
+        }
+
+        /**
+         * @brief 没有管控中心时（默认构造或被移动之后）分配管控中心与一个空缓冲区
+         */
+        void lazy_initialize() {
+            if (!_map) {
+                initialize_map_and_nodes(0);
+            }
+        }
+
+        /**
+         * @brief emplace_back 的慢速路径：尚未分配内存，或末尾缓冲区只剩最后一个位置
+         * 先准备好下一个缓冲区再构造元素，构造失败时不改变deque
+         * @tparam Args 构造参数的类型包
+         * @param args 构造参数
+         */
+        template <typename... Args>
+        void emplace_back_aux(Args&&... args) {
+            lazy_initialize();
+            if (_end.last - _end.cur > 1) {
+                alloc.construct(_end.cur, tiny_stl::forward<Args>(args)...);
+                stats_hooks::template on_construct<T, Args...>();
+                ++_end.cur;
+                return;
+            }
+            reserve_map_at_back();
+            *(_end.node + 1) = allocate_node();
+            try {
+                alloc.construct(_end.cur, tiny_stl::forward<Args>(args)...);
+                stats_hooks::template on_construct<T, Args...>();
+            } catch (...) {
+                deallocate_node(*(_end.node + 1));
+                throw;
+            }
+            _end.set_node(_end.node + 1);
+            _end.cur = _end.first;
         }
 
+        /**
+         * @brief emplace_front 的慢速路径：尚未分配内存，或首个缓冲区前面没有空位
+         * @tparam Args 构造参数的类型包
+         * @param args 构造参数
+         */
+        template <typename... Args>
+        void emplace_front_aux(Args&&... args) {
+            lazy_initialize();
+            reserve_map_at_front();
+            *(_begin.node - 1) = allocate_node();
+            try {
+                alloc.construct(*(_begin.node - 1) + (block_size - 1), tiny_stl::forward<Args>(args)...);
+                stats_hooks::template on_construct<T, Args...>();
+            } catch (...) {
+                deallocate_node(*(_begin.node - 1));
+                throw;
+            }
+            _begin.set_node(_begin.node - 1);
+            _begin.cur = _begin.last - 1;
+        }
+
+        /**
+         * @brief 确保头部之前有n个可用位置，必要时一次性分配新的缓冲区
+         * @param n 需要的位置数量
+         * @return 扩展后新的首迭代器位置
+         */
+        iterator reserve_elements_at_front(size_type n) {
+            size_type vacancies = _begin.cur - _begin.first;
+            if (n > vacancies) {
+                size_type new_nodes = (n - vacancies + block_size - 1) / block_size;
+                reserve_map_at_front(new_nodes);
+                size_type i = 1;
+                try {
+                    for (; i <= new_nodes; ++i) {
+                        *(_begin.node - i) = allocate_node();
+                    }
+                } catch (...) {
+                    for (size_type j = 1; j < i; ++j) {
+                        deallocate_node(*(_begin.node - j));
+                    }
+                    throw;
+                }
+            }
+            return _begin - difference_type(n);
+        }
+
+        /**
+         * @brief 确保尾部之后有n个可用位置，必要时一次性分配新的缓冲区
+         * @param n 需要的位置数量
+         * @return 扩展后新的尾迭代器位置
+         */
+        iterator reserve_elements_at_back(size_type n) {
+            size_type vacancies = (_end.last - _end.cur) - 1;
+            if (n > vacancies) {
+                size_type new_nodes = (n - vacancies + block_size - 1) / block_size;
+                reserve_map_at_back(new_nodes);
+                size_type i = 1;
+                try {
+                    for (; i <= new_nodes; ++i) {
+                        *(_end.node + i) = allocate_node();
+                    }
+                } catch (...) {
+                    for (size_type j = 1; j < i; ++j) {
+                        deallocate_node(*(_end.node + j));
+                    }
+                    throw;
+                }
+            }
+            return _end + difference_type(n);
+        }
+
+        /**
+         * @brief 释放 [node, _begin.node) 中由 reserve_elements_at_front 分配的缓冲区
+         * @param node 最前面的缓冲区节点
+         */
+        void destroy_nodes_before(map_pointer node) {
+            for (; node < _begin.node; ++node) {
+                deallocate_node(*node);
+            }
+        }
+
+        /**
+         * @brief 释放 (_end.node, node] 中由 reserve_elements_at_back 分配的缓冲区
+         * @param node 最后面的缓冲区节点
+         */
+        void destroy_nodes_after(map_pointer node) {
+            for (map_pointer cur = _end.node + 1; cur <= node; ++cur) {
+                deallocate_node(*cur);
+            }
+        }
+
+        /**
+         * @brief 销毁[pos, end)中的元素并释放pos之后不再使用的缓冲区
+         * @param pos 新的尾迭代器
+         */
+        void erase_at_end(iterator pos) {
+            tiny_stl::destroy(pos, _end);
+            for (map_pointer node = pos.node + 1; node <= _end.node; ++node) {
+                deallocate_node(*node);
+            }
+            _end = pos;
+        }
+
+        /**
+         * @brief 把[first, last)中的元素依次复制赋值到dest开始的位置
+         * @tparam InputIterator 输入迭代器类型
+         * @param first 起始迭代器
+         * @param last 结束迭代器
+         * @param dest 目标起始迭代器
+         */
+        template <typename InputIterator>
+        static void copy_assign(InputIterator first, InputIterator last, iterator dest) {
+            tiny_stl::copy(first, last, dest);
+        }
+
+        /**
+         * @brief 把[first, last)中的元素依次移动赋值到dest开始的位置，dest不能位于范围之后
+         * @param first 起始迭代器
+         * @param last 结束迭代器
+         * @param dest 目标起始迭代器
+         */
+        static void move_assign(iterator first, iterator last, iterator dest) {
+            if constexpr (std::is_trivially_copyable<value_type>::value) {
+                // 平凡类型的移动就是复制，按缓冲区逐段 memmove
+                tiny_stl::copy(first, last, dest);
+            } else {
+                for (; first != last; ++first, ++dest) {
+                    *dest = tiny_stl::move(*first);
+                }
+            }
+        }
+
+        /**
+         * @brief 把[first, last)中的元素从后往前移动赋值到dest_last之前的位置，dest_last不能位于范围之前
+         * @param first 起始迭代器
+         * @param last 结束迭代器
+         * @param dest_last 目标结束迭代器
+         */
+        static void move_assign_backward(iterator first, iterator last, iterator dest_last) {
+            while (first != last) {
+                *--dest_last = tiny_stl::move(*--last);
+            }
+        }
+
+        /**
+         * @brief 释放 [_begin.node, _end.node] 中的全部缓冲区以及管控中心，不销毁元素
+         * 之后deque处于不持有内存的空状态
+         */
+        void destroy_nodes_and_map() {
+            if (_map) {
+                for (map_pointer node = _begin.node; node <= _end.node; ++node) {
+                    deallocate_node(*node);
+                }
+                deallocate_map();
+                _map = nullptr;
+                _map_size = 0;
+                _begin = iterator();
+                _end = iterator();
+            }
+        }
+
+        /**
+         * @brief 统计钩子，见 container_stats.hpp
+         */
+        using stats_hooks = __stats_hooks<deque>;
+
         /**
          * @brief 分配管控中心内存
          * @param n 要分配的节点数量
          * @return 分配的管控中心指针
          */
         map_pointer allocate_map(size_type n) {
-            return map_alloc.allocate(n);
+            map_pointer p = map_alloc.allocate(n);
+            stats_hooks::on_allocate(n * sizeof(pointer));
+            return p;
         }
 
         /**
@@ -593,34 +1200,76 @@ namespace tiny_stl {
          */
         void deallocate_map() {
             if (_map) {
+                stats_hooks::on_deallocate(_map_size * sizeof(pointer));
                 map_alloc.deallocate(_map, _map_size);
             }
         }
 
         /**
-         * @brief 分配一个节点的内存
+         * @brief 分配一个节点的内存，优先复用缓存的空闲缓冲区
          * @return 分配的节点指针
          */
         pointer allocate_node() {
-            return alloc.allocate(buffer);
+            if (_spare_count) {
+                return _spare[--_spare_count];
+            }
+            pointer p = alloc.allocate(block_size);
+            stats_hooks::on_allocate(block_size * sizeof(T));
+            return p;
         }
 
         /**
          * @brief 释放一个节点的内存
+         * 缓存未满时留作下一次 allocate_node 使用，push_back/pop_front 交替跨越缓冲区边界时不必每次都经过分配器
          * @param p 要释放的节点指针
          */
         void deallocate_node(pointer p) {
-            alloc.deallocate(p, buffer);
+            if (_spare_count < spare_capacity) {
+                _spare[_spare_count++] = p;
+            } else {
+                stats_hooks::on_deallocate(block_size * sizeof(T));
+                alloc.deallocate(p, block_size);
+            }
+        }
+
+        /**
+         * @brief 把缓存的空闲缓冲区全部归还给分配器
+         */
+        void release_spare_nodes() noexcept {
+            while (_spare_count) {
+                stats_hooks::on_deallocate(block_size * sizeof(T));
+                alloc.deallocate(_spare[--_spare_count], block_size);
+            }
+        }
+
+        /**
+         * @brief 接管other缓存的空闲缓冲区，调用前自身的缓存必须为空
+         * @param other 缓存的来源
+         */
+        void take_spare_nodes(deque& other) noexcept {
+            for (size_type i = 0; i < other._spare_count; ++i) {
+                _spare[i] = other._spare[i];
+            }
+            _spare_count = other._spare_count;
+            other._spare_count = 0;
         }
 
         /**
-         * @brief 创建节点
+         * @brief 创建节点，失败时释放已经创建的节点
          * @param nstart 起始节点指针
          * @param nfinish 结束节点指针
          */
         void create_nodes(map_pointer nstart, map_pointer nfinish) {
-            for (map_pointer cur = nstart; cur < nfinish; ++cur) {
-                *cur = allocate_node();
+            map_pointer cur = nstart;
+            try {
+                for (; cur < nfinish; ++cur) {
+                    *cur = allocate_node();
+                }
+            } catch (...) {
+                for (map_pointer done = nstart; done < cur; ++done) {
+                    deallocate_node(*done);
+                }
+                throw;
             }
         }
 
@@ -637,17 +1286,18 @@ namespace tiny_stl {
                 new_nstart = _map + (_map_size - new_num_nodes) / 2
                     + (add_at_front ? nodes_to_add : 0);
                 if (new_nstart < _begin.node) {
-                    std::copy(_begin.node, _end.node + 1, new_nstart);
+                    tiny_stl::copy(_begin.node, _end.node + 1, new_nstart);
                 } else {
-                    std::copy_backward(_begin.node, _end.node + 1, new_nstart + old_num_nodes);
+                    tiny_stl::copy_backward(_begin.node, _end.node + 1, new_nstart + old_num_nodes);
                 }
             } else {
-                size_type new_map_size = _map_size + std::max(_map_size, nodes_to_add) + 2;
+                size_type new_map_size = _map_size + tiny_stl::max(_map_size, nodes_to_add) + 2;
                 map_pointer new_map = allocate_map(new_map_size);
                 new_nstart = new_map + (new_map_size - new_num_nodes) / 2
                     + (add_at_front ? nodes_to_add : 0);
-                std::copy(_begin.node, _end.node + 1, new_nstart);
+                tiny_stl::copy(_begin.node, _end.node + 1, new_nstart);
                 deallocate_map();
+                stats_hooks::on_reallocate();
                 _map = new_map;
                 _map_size = new_map_size;
             }
@@ -659,7 +1309,7 @@ namespace tiny_stl {
          * @brief 为尾部预留管控中心空间
          */
         void reserve_map_at_back(size_type nodes_to_add = 1) {
-            if (nodes_to_add > _map_size - (_end.node - _map)) {
+            if (nodes_to_add + 1 > _map_size - (_end.node - _map)) {
                 reallocate_map(nodes_to_add, false);
             }
         }
@@ -0,0 +1,470 @@
+/**
+ * @file execution.hpp
+ * @brief 此文件定义了 tiny_stl 命名空间下的执行策略 `execution::seq`、`execution::par`、`execution::par_unseq`，
+ * 以及接受执行策略的 for_each、transform、reduce、sort、fill、copy。
+ *
+ * 并行策略下，随机访问范围（vector、array、deque 等）按长度拆成若干块，在一个全局共享的
+ * `thread_pool` 上执行，调用线程也参与执行；元素不足 __parallel_cutoff 个时直接顺序执行，
+ * 避免任务调度的开销超过计算本身。其他迭代器类别总是顺序执行。
+ *
+ * 与 std 相同，并行执行时元素访问函数抛出异常会调用 std::terminate。
+ */
+
+#pragma once
+
+#ifdef __GNUC__
+#   pragma GCC system_header
+#endif
+#if defined(_MSC_VER) && _MSC_VER >= 1920
+#   pragma system_header
+#endif
+
+#include <algorithm.hpp>
+#include <iterator.hpp>
+#include <memory.hpp>
+#include <numeric.hpp>
+#include <thread_pool.hpp>
+#include <utility.hpp>
+#include <vector.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <type_traits>
+
+namespace tiny_stl {
+
+    namespace execution {
+
+        /**
+         * @brief 顺序执行策略：在调用线程上按顺序执行
+         */
+        struct sequenced_policy { };
+
+        /**
+         * @brief 并行执行策略：元素访问可以在多个线程上同时进行
+         */
+        struct parallel_policy { };
+
+        /**
+         * @brief 并行且无序执行策略：在并行的基础上，同一线程中的元素访问也可以交错（向量化）
+         * 每块内部调用的顺序算法本身就是可向量化的简单循环，因此与 parallel_policy 的执行方式相同
+         */
+        struct parallel_unsequenced_policy { };
+
+        inline constexpr sequenced_policy seq{}; /**< 顺序执行策略的实例 */
+        inline constexpr parallel_policy par{}; /**< 并行执行策略的实例 */
+        inline constexpr parallel_unsequenced_policy par_unseq{}; /**< 并行且无序执行策略的实例 */
+
+    }
+
+    /**
+     * @brief 判断 T 是否为执行策略类型
+     */
+    template <typename T>
+    struct is_execution_policy : std::false_type { };
+
+    template <>
+    struct is_execution_policy<execution::sequenced_policy> : std::true_type { };
+
+    template <>
+    struct is_execution_policy<execution::parallel_policy> : std::true_type { };
+
+    template <>
+    struct is_execution_policy<execution::parallel_unsequenced_policy> : std::true_type { };
+
+    template <typename T>
+    inline constexpr bool is_execution_policy_v = is_execution_policy<T>::value;
+
+    /**
+     * @brief 仅当 ExecutionPolicy 是执行策略时有效的返回类型，把接受执行策略的重载与顺序版本区分开
+     */
+    template <typename ExecutionPolicy, typename R = void>
+    using __enable_if_execution_policy_t = std::enable_if_t<is_execution_policy_v<std::decay_t<ExecutionPolicy>>, R>;
+
+    /**
+     * @brief 判断在执行策略 ExecutionPolicy 下能否并行处理迭代器类型为 Iterator 的范围
+     */
+    template <typename ExecutionPolicy, typename Iterator>
+    constexpr bool __is_parallel_v = !std::is_same<std::decay_t<ExecutionPolicy>, execution::sequenced_policy>::value &&
+                                     __is_iterator_of<Iterator, random_access_iterator_tag>::value;
+
+    constexpr ptrdiff_t __parallel_cutoff = 1 << 15; /**< 并行执行的最小元素数量，也是每块的最小长度 */
+    constexpr ptrdiff_t __parallel_chunks_per_thread = 4; /**< 每个线程平均分到的块数，块多一些可以平衡负载 */
+
+    /**
+     * @brief 并行算法共享的线程池，首次使用时创建，线程数为硬件线程数
+     */
+    inline thread_pool& __parallel_pool() {
+        static thread_pool pool;
+        return pool;
+    }
+
+    /**
+     * @brief 把 n 个元素拆成多少块：每块至少 __parallel_cutoff 个元素，至多每个线程 __parallel_chunks_per_thread 块
+     */
+    inline ptrdiff_t __parallel_chunk_count(ptrdiff_t n) {
+        ptrdiff_t threads = static_cast<ptrdiff_t>(__parallel_pool().size()) + 1;
+        ptrdiff_t chunks = n / __parallel_cutoff;
+        if (chunks > threads * __parallel_chunks_per_thread) {
+            chunks = threads * __parallel_chunks_per_thread;
+        }
+        return chunks > 1 ? chunks : 1;
+    }
+
+    /**
+     * @brief 第 c 块的起始下标。各块长度相差不超过 1，块数不超过 n 时每块都不为空
+     */
+    inline ptrdiff_t __parallel_chunk_begin(ptrdiff_t c, ptrdiff_t n, ptrdiff_t chunks) {
+        return c * n / chunks;
+    }
+
+    /**
+     * @brief 对 [0, n) 拆成的 chunks 块并行调用 fn(c, begin, end)，全部完成后返回
+     *
+     * 线程池中提交至多 chunks - 1 个辅助任务，它们与调用线程一起从共享的计数器中领取下一块，
+     * 先做完的线程会继续领取，因此各块耗时不均时也能保持负载均衡。
+     * 调用线程做完所有块后帮忙执行线程池中的任务，直到所有辅助任务结束。
+     */
+    template <typename Function>
+    void __parallel_for_chunks(ptrdiff_t n, ptrdiff_t chunks, Function&& fn) {
+        if (chunks <= 1) {
+            fn(ptrdiff_t(0), ptrdiff_t(0), n);
+            return;
+        }
+        thread_pool& pool = __parallel_pool();
+        std::atomic<ptrdiff_t> next(0);
+        std::mutex mutex;
+        std::condition_variable done;
+        size_t helpers = pool.size() < static_cast<size_t>(chunks - 1) ? pool.size() : static_cast<size_t>(chunks - 1);
+
+        auto run_chunks = [&]() noexcept {
+            for (;;) {
+                ptrdiff_t c = next.fetch_add(1, std::memory_order_relaxed);
+                if (c >= chunks) {
+                    break;
+                }
+                fn(c, __parallel_chunk_begin(c, n, chunks), __parallel_chunk_begin(c + 1, n, chunks));
+            }
+        };
+
+        size_t remaining = helpers;
+        for (size_t i = 0; i < helpers; ++i) {
+            pool.submit([&] {
+                run_chunks();
+                // 在锁内递减并通知：调用线程只有在锁内看到 0 才会返回并销毁这些局部变量
+                std::lock_guard<std::mutex> lock(mutex);
+                if (--remaining == 0) {
+                    done.notify_all();
+                }
+            });
+        }
+        run_chunks();
+        for (;;) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (remaining == 0) {
+                    return;
+                }
+            }
+            // 辅助任务还在队列中没有被取走时自己执行它；没有可执行的任务说明它们都已在运行，等待即可
+            if (!pool.try_run_one()) {
+                std::unique_lock<std::mutex> lock(mutex);
+                done.wait(lock, [&] { return remaining == 0; });
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief 对随机访问范围 [first, first + n) 拆成的若干块并行调用 fn(c, begin, end)
+     * @return 实际拆成的块数
+     */
+    template <typename Function>
+    ptrdiff_t __parallel_for(ptrdiff_t n, Function&& fn) {
+        ptrdiff_t chunks = __parallel_chunk_count(n);
+        tiny_stl::__parallel_for_chunks(n, chunks, fn);
+        return chunks;
+    }
+
+    /**
+     * @brief 返回把 it 前进 n 步后的迭代器
+     */
+    template <typename Iterator>
+    Iterator __parallel_next(Iterator it, ptrdiff_t n) {
+        tiny_stl::advance(it, n);
+        return it;
+    }
+
+    /**
+     * @brief 按执行策略对 [first, last) 中的每个元素调用 f
+     * @param policy 执行策略
+     * @param first 起始迭代器
+     * @param last 结束迭代器
+     * @param f 函数对象，并行执行时会在多个线程上同时调用
+     */
+    template <typename ExecutionPolicy, typename ForwardIt, typename Function>
+    __enable_if_execution_policy_t<ExecutionPolicy>
+    for_each(ExecutionPolicy&&, ForwardIt first, ForwardIt last, Function f) {
+        if constexpr (__is_parallel_v<ExecutionPolicy, ForwardIt>) {
+            ptrdiff_t n = tiny_stl::distance(first, last);
+            if (n >= __parallel_cutoff) {
+                tiny_stl::__parallel_for(n, [&](ptrdiff_t, ptrdiff_t b, ptrdiff_t e) {
+                    tiny_stl::for_each(__parallel_next(first, b), __parallel_next(first, e), f);
+                });
+                return;
+            }
+        }
+        tiny_stl::for_each(first, last, f);
+    }
+
+    /**
+     * @brief 按执行策略把 op 作用于 [first, last) 中的每个元素，结果写到 d_first 开始的位置
+     * @return 目标范围的结束迭代器
+     */
+    template <typename ExecutionPolicy, typename ForwardIt1, typename ForwardIt2, typename UnaryOperation>
+    __enable_if_execution_policy_t<ExecutionPolicy, ForwardIt2>
+    transform(ExecutionPolicy&&, ForwardIt1 first, ForwardIt1 last, ForwardIt2 d_first, UnaryOperation op) {
+        if constexpr (__is_parallel_v<ExecutionPolicy, ForwardIt1> && __is_parallel_v<ExecutionPolicy, ForwardIt2>) {
+            ptrdiff_t n = tiny_stl::distance(first, last);
+            if (n >= __parallel_cutoff) {
+                tiny_stl::__parallel_for(n, [&](ptrdiff_t, ptrdiff_t b, ptrdiff_t e) {
+                    tiny_stl::transform(__parallel_next(first, b), __parallel_next(first, e),
+                                        __parallel_next(d_first, b), op);
+                });
+                return __parallel_next(d_first, n);
+            }
+        }
+        return tiny_stl::transform(first, last, d_first, op);
+    }
+
+    /**
+     * @brief 按执行策略把 op 作用于两个范围中对应的元素，结果写到 d_first 开始的位置
+     * @return 目标范围的结束迭代器
+     */
+    template <typename ExecutionPolicy, typename ForwardIt1, typename ForwardIt2, typename ForwardIt3,
+              typename BinaryOperation>
+    __enable_if_execution_policy_t<ExecutionPolicy, ForwardIt3>
+    transform(ExecutionPolicy&&, ForwardIt1 first1, ForwardIt1 last1, ForwardIt2 first2, ForwardIt3 d_first,
+              BinaryOperation op) {
+        if constexpr (__is_parallel_v<ExecutionPolicy, ForwardIt1> && __is_parallel_v<ExecutionPolicy, ForwardIt2> &&
+                      __is_parallel_v<ExecutionPolicy, ForwardIt3>) {
+            ptrdiff_t n = tiny_stl::distance(first1, last1);
+            if (n >= __parallel_cutoff) {
+                tiny_stl::__parallel_for(n, [&](ptrdiff_t, ptrdiff_t b, ptrdiff_t e) {
+                    tiny_stl::transform(__parallel_next(first1, b), __parallel_next(first1, e),
+                                        __parallel_next(first2, b), __parallel_next(d_first, b), op);
+                });
+                return __parallel_next(d_first, n);
+            }
+        }
+        return tiny_stl::transform(first1, last1, first2, d_first, op);
+    }
+
+    /**
+     * @brief 按执行策略从 init 开始用 op 归约 [first, last)
+     * 并行执行时每块以块内第一个元素为初值分别归约，最后按块的顺序与 init 合并，因此不需要单位元
+     * @param op 满足结合律与交换律的二元操作
+     * @return 归约的结果
+     */
+    template <typename ExecutionPolicy, typename ForwardIt, typename T, typename BinaryOperation>
+    __enable_if_execution_policy_t<ExecutionPolicy, T>
+    reduce(ExecutionPolicy&&, ForwardIt first, ForwardIt last, T init, BinaryOperation op) {
+        if constexpr (__is_parallel_v<ExecutionPolicy, ForwardIt>) {
+            ptrdiff_t n = tiny_stl::distance(first, last);
+            if (n >= __parallel_cutoff) {
+                ptrdiff_t chunks = __parallel_chunk_count(n);
+                __temporary_buffer<T> partials(static_cast<size_t>(chunks));
+                T* partial = partials.data();
+                tiny_stl::__parallel_for_chunks(n, chunks, [&](ptrdiff_t c, ptrdiff_t b, ptrdiff_t e) {
+                    ForwardIt cfirst = __parallel_next(first, b);
+                    ForwardIt clast = __parallel_next(first, e);
+                    T acc(*cfirst);
+                    ::new (static_cast<void*>(partial + c)) T(tiny_stl::reduce(++cfirst, clast, tiny_stl::move(acc), op));
+                });
+                partials.set_size(static_cast<size_t>(chunks));
+                for (ptrdiff_t c = 0; c < chunks; ++c) {
+                    init = op(tiny_stl::move(init), tiny_stl::move(partial[c]));
+                }
+                return init;
+            }
+        }
+        return tiny_stl::reduce(first, last, tiny_stl::move(init), op);
+    }
+
+    template <typename ExecutionPolicy, typename ForwardIt, typename T>
+    __enable_if_execution_policy_t<ExecutionPolicy, T>
+    reduce(ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, T init) {
+        return tiny_stl::reduce(tiny_stl::forward<ExecutionPolicy>(policy), first, last, tiny_stl::move(init),
+                                [](const T& a, const T& b) { return a + b; });
+    }
+
+    template <typename ExecutionPolicy, typename ForwardIt>
+    __enable_if_execution_policy_t<ExecutionPolicy, typename iterator_traits<ForwardIt>::value_type>
+    reduce(ExecutionPolicy&& policy, ForwardIt first, ForwardIt last) {
+        using value_type = typename iterator_traits<ForwardIt>::value_type;
+        return tiny_stl::reduce(tiny_stl::forward<ExecutionPolicy>(policy), first, last, value_type());
+    }
+
+    /**
+     * @brief 按执行策略把 [first, last) 中的每个元素赋值为 value
+     */
+    template <typename ExecutionPolicy, typename ForwardIt, typename T>
+    __enable_if_execution_policy_t<ExecutionPolicy>
+    fill(ExecutionPolicy&&, ForwardIt first, ForwardIt last, const T& value) {
+        if constexpr (__is_parallel_v<ExecutionPolicy, ForwardIt>) {
+            ptrdiff_t n = tiny_stl::distance(first, last);
+            if (n >= __parallel_cutoff) {
+                tiny_stl::__parallel_for(n, [&](ptrdiff_t, ptrdiff_t b, ptrdiff_t e) {
+                    tiny_stl::fill(__parallel_next(first, b), __parallel_next(first, e), value);
+                });
+                return;
+            }
+        }
+        tiny_stl::fill(first, last, value);
+    }
+
+    /**
+     * @brief 按执行策略把 [first, last) 复制到 d_first 开始的位置，两个范围不能重叠
+     * @return 目标范围的结束迭代器
+     */
+    template <typename ExecutionPolicy, typename ForwardIt1, typename ForwardIt2>
+    __enable_if_execution_policy_t<ExecutionPolicy, ForwardIt2>
+    copy(ExecutionPolicy&&, ForwardIt1 first, ForwardIt1 last, ForwardIt2 d_first) {
+        if constexpr (__is_parallel_v<ExecutionPolicy, ForwardIt1> && __is_parallel_v<ExecutionPolicy, ForwardIt2>) {
+            ptrdiff_t n = tiny_stl::distance(first, last);
+            if (n >= __parallel_cutoff) {
+                tiny_stl::__parallel_for(n, [&](ptrdiff_t, ptrdiff_t b, ptrdiff_t e) {
+                    tiny_stl::copy(__parallel_next(first, b), __parallel_next(first, e), __parallel_next(d_first, b));
+                });
+                return __parallel_next(d_first, n);
+            }
+        }
+        return tiny_stl::copy(first, last, d_first);
+    }
+
+    /**
+     * @brief 在两个相邻有序段 a[0, m) 与 b[0, n) 的归并结果中，前 k 个元素里有多少个来自 a
+     * 归并时相等的元素先取 a，与 __move_merge 一致
+     */
+    template <typename RandomIt, typename Compare>
+    ptrdiff_t __merge_corank(ptrdiff_t k, RandomIt a, ptrdiff_t m, RandomIt b, ptrdiff_t n, Compare& comp) {
+        ptrdiff_t lo = k > n ? k - n : 0;
+        ptrdiff_t hi = k < m ? k : m;
+        while (lo < hi) {
+            ptrdiff_t i = lo + (hi - lo) / 2;
+            // a[i] 排在 b[k - i - 1] 之前，说明前 k 个元素中来自 a 的多于 i 个
+            if (!comp(b[k - i - 1], a[i])) {
+                lo = i + 1;
+            } else {
+                hi = i;
+            }
+        }
+        return lo;
+    }
+
+    /**
+     * @brief 并行归并排序的一趟：把 src 中每两个相邻的有序段（各 width 个块）归并到 dst 的相同位置
+     *
+     * 输出按长度平均拆分，先用 __merge_corank 求出每个拆分点在两个输入段中对应的位置，再让各块独立地归并。
+     * 拆分点必须在归并开始之前全部求出：归并会移走 src 中的元素，其他块此时再去二分查找就会读到被移走的值。
+     */
+    template <typename SourceIt, typename DestIt, typename Compare>
+    void __parallel_merge_pass(SourceIt src, DestIt dst, ptrdiff_t n, ptrdiff_t runs, ptrdiff_t width, Compare& comp) {
+        auto segment = [&](ptrdiff_t r) { return __parallel_chunk_begin(r < runs ? r : runs, n, runs); };
+        ptrdiff_t chunks = __parallel_chunk_count(n);
+        vector<ptrdiff_t> split_a(static_cast<size_t>(chunks) + 1);
+        vector<ptrdiff_t> split_b(static_cast<size_t>(chunks) + 1);
+        for (ptrdiff_t c = 0; c <= chunks; ++c) {
+            ptrdiff_t p = __parallel_chunk_begin(c, n, chunks);
+            for (ptrdiff_t r = 0; r < runs; r += 2 * width) {
+                ptrdiff_t a0 = segment(r), a1 = segment(r + width), b1 = segment(r + 2 * width);
+                if (a0 < p && p < b1) {
+                    ptrdiff_t i = tiny_stl::__merge_corank(p - a0, src + a0, a1 - a0, src + a1, b1 - a1, comp);
+                    split_a[c] = a0 + i;
+                    split_b[c] = a1 + (p - a0 - i);
+                    break;
+                }
+            }
+        }
+        tiny_stl::__parallel_for_chunks(n, chunks, [&](ptrdiff_t c, ptrdiff_t out_begin, ptrdiff_t out_end) {
+            for (ptrdiff_t r = 0; r < runs; r += 2 * width) {
+                ptrdiff_t a0 = segment(r), a1 = segment(r + width), b1 = segment(r + 2 * width);
+                if (out_end <= a0 || b1 <= out_begin) {
+                    continue;
+                }
+                // 拆分点落在这一对有序段内部时从拆分点开始（或结束），否则整段归并
+                ptrdiff_t first1 = out_begin > a0 ? split_a[c] : a0;
+                ptrdiff_t first2 = out_begin > a0 ? split_b[c] : a1;
+                ptrdiff_t last1 = out_end < b1 ? split_a[c + 1] : a1;
+                ptrdiff_t last2 = out_end < b1 ? split_b[c + 1] : b1;
+                ptrdiff_t out = out_begin > a0 ? out_begin : a0;
+                tiny_stl::__move_merge(src + first1, src + last1, src + first2, src + last2, dst + out, comp);
+            }
+        });
+    }
+
+    /**
+     * @brief 按执行策略排序（不稳定）。
+     *
+     * 并行执行时把范围拆成 2 的幂个段，各段并行地用 sort 排序，再在原范围与一块同样大小的缓冲区之间
+     * 来回做 log(段数) 趟归并。每趟的输出按长度平均拆分给各线程，最后几趟只有一两对段时也能充分并行。
+     *
+     * @param policy 执行策略
+     * @param first 起始迭代器
+     * @param last 结束迭代器
+     * @param comp 比较函数，默认为 `less`
+     */
+    template <typename ExecutionPolicy, typename RandomIt, typename Compare>
+    __enable_if_execution_policy_t<ExecutionPolicy>
+    sort(ExecutionPolicy&&, RandomIt first, RandomIt last, Compare comp) {
+        if constexpr (__is_parallel_v<ExecutionPolicy, RandomIt>) {
+            using value_type = typename iterator_traits<RandomIt>::value_type;
+            ptrdiff_t n = last - first;
+            ptrdiff_t threads = static_cast<ptrdiff_t>(__parallel_pool().size()) + 1;
+            ptrdiff_t runs = 1;
+            while (runs < threads && n / (runs * 2) >= __parallel_cutoff) {
+                runs *= 2;
+            }
+            if (runs > 1) {
+                tiny_stl::__parallel_for_chunks(n, runs, [&](ptrdiff_t, ptrdiff_t b, ptrdiff_t e) {
+                    tiny_stl::sort(first + b, first + e, comp);
+                });
+                __temporary_buffer<value_type> temp(static_cast<size_t>(n));
+                value_type* buffer = temp.data();
+                tiny_stl::__parallel_for(n, [&](ptrdiff_t, ptrdiff_t b, ptrdiff_t e) {
+                    tiny_stl::uninitialized_move(first + b, first + e, buffer + b);
+                });
+                temp.set_size(static_cast<size_t>(n));
+                bool in_buffer = true;
+                for (ptrdiff_t width = 1; width < runs; width *= 2, in_buffer = !in_buffer) {
+                    if (in_buffer) {
+                        tiny_stl::__parallel_merge_pass(buffer, first, n, runs, width, comp);
+                    } else {
+                        tiny_stl::__parallel_merge_pass(first, buffer, n, runs, width, comp);
+                    }
+                }
+                tiny_stl::__parallel_for(n, [&](ptrdiff_t, ptrdiff_t b, ptrdiff_t e) {
+                    if (in_buffer) {
+                        for (ptrdiff_t i = b; i < e; ++i) {
+                            first[i] = tiny_stl::move(buffer[i]);
+                        }
+                    }
+                    tiny_stl::destroy(buffer + b, buffer + e);
+                });
+                temp.set_size(0);
+                return;
+            }
+        }
+        tiny_stl::sort(first, last, comp);
+    }
+
+    template <typename ExecutionPolicy, typename RandomIt>
+    __enable_if_execution_policy_t<ExecutionPolicy>
+    sort(ExecutionPolicy&& policy, RandomIt first, RandomIt last) {
+        tiny_stl::sort(tiny_stl::forward<ExecutionPolicy>(policy), first, last,
+                       less<typename iterator_traits<RandomIt>::value_type>());
+    }
+
+}
@@ -0,0 +1,1267 @@
+/**
+ * @file flat_hash_map.hpp
+ * @brief 此文件定义了 tiny_stl 命名空间下的开放寻址哈希表 `flat_hash_map` 与 `flat_hash_set`。
+ *
+ * 布局与 Swiss table 相同：元素直接存放在一个槽位数组中，另有一个与之一一对应的控制字节数组。
+ * 控制字节记录槽位是空、已删除还是已占用，已占用时保存哈希值的低 7 位（H2）。
+ * 查找时以哈希值的其余位（H1）选定起点，每次把一组（SSE2 下 16 个，其他平台 8 个）控制字节
+ * 与 H2 并行比较，只有 H2 相同的槽位才需要真正比较键，遇到组内有空槽位即可确定键不存在。
+ */
+
+#pragma once
+
+#ifdef __GNUC__
+#   pragma GCC system_header
+#endif
+#if defined(_MSC_VER) && _MSC_VER >= 1920
+#   pragma system_header
+#endif
+
+#include <algorithm.hpp>
+#include <allocator.hpp>
+#include <functional.hpp>
+#include <iterator.hpp>
+#include <utility.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <stdexcept>
+#include <type_traits>
+
+#if !defined(TINY_STL_NO_SIMD)
+#   if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#       define TINY_STL_HASH_SSE2 1
+#       include <emmintrin.h>
+#   elif defined(__ARM_NEON) && defined(__aarch64__)
+#       define TINY_STL_HASH_NEON 1
+#       include <arm_neon.h>
+#   endif
+#endif
+
+namespace tiny_stl {
+
+    /**
+     * @brief 控制字节类型
+     */
+    using __ctrl_t = signed char;
+
+    constexpr __ctrl_t __ctrl_empty = -128; /**< 空槽位 */
+    constexpr __ctrl_t __ctrl_deleted = -2; /**< 已删除的槽位（墓碑），查找时需要越过它继续探测 */
+    constexpr __ctrl_t __ctrl_sentinel = -1; /**< 位于控制字节数组末尾，迭代器遇到它即停止 */
+
+    /**
+     * @class __hash_bitmask
+     * @brief 一组控制字节的比较结果，每个槽位对应 2^Shift 个位，置位表示匹配
+     * @tparam Width 一组槽位的数量
+     * @tparam Shift 每个槽位占用的位数的对数：SSE2 的 movemask 为 0，按字节比较时为 3
+     */
+    template <size_t Width, unsigned Shift>
+    class __hash_bitmask {
+    public:
+        explicit __hash_bitmask(uint64_t mask) noexcept : _mask(mask) { }
+
+        explicit operator bool() const noexcept { return _mask != 0; }
+
+        /**
+         * @brief 最低的匹配槽位，要求存在匹配
+         */
+        unsigned lowest_bit() const noexcept { return __countr_zero(_mask) >> Shift; }
+
+        /**
+         * @brief 清除最低的匹配槽位
+         */
+        void clear_lowest() noexcept { _mask &= _mask - 1; }
+
+        /**
+         * @brief 从组首开始连续不匹配的槽位数量
+         */
+        unsigned trailing_zeros() const noexcept {
+            return _mask ? __countr_zero(_mask) >> Shift : static_cast<unsigned>(Width);
+        }
+
+        /**
+         * @brief 从组尾开始连续不匹配的槽位数量
+         */
+        unsigned leading_zeros() const noexcept {
+            constexpr unsigned extra = 64 - (static_cast<unsigned>(Width) << Shift);
+            return _mask ? __countl_zero(_mask << extra) >> Shift : static_cast<unsigned>(Width);
+        }
+
+    private:
+        uint64_t _mask;
+    };
+
+    /**
+     * @brief 数出按字节比较的结果中从最低字节开始连续匹配的字节数
+     * @param lanes 每个字节的最高位表示该槽位是否匹配（其余位可以任意）
+     * @return 连续匹配的字节数，全部匹配时为 8
+     */
+    inline unsigned __hash_count_leading_lanes(uint64_t lanes) noexcept {
+        uint64_t gaps = ~(lanes | 0x7F7F7F7F7F7F7F7Full);
+        return gaps ? __countr_zero(gaps) >> 3 : 8;
+    }
+
+#if defined(TINY_STL_HASH_SSE2)
+
+    /**
+     * @brief 一组 16 个控制字节，用 SSE2 的一条比较指令同时处理
+     */
+    struct __hash_group {
+        static constexpr size_t width = 16; /**< 一组槽位的数量 */
+        using bitmask = __hash_bitmask<16, 0>;
+
+        explicit __hash_group(const __ctrl_t* pos) noexcept
+            : _ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pos))) { }
+
+        /**
+         * @brief 控制字节等于 h2 的槽位
+         */
+        bitmask match(__ctrl_t h2) const noexcept {
+            return bitmask(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), _ctrl))));
+        }
+
+        /**
+         * @brief 空的槽位
+         */
+        bitmask mask_empty() const noexcept {
+            return match(__ctrl_empty);
+        }
+
+        /**
+         * @brief 空的或已删除的槽位
+         */
+        bitmask mask_empty_or_deleted() const noexcept {
+            return bitmask(static_cast<uint32_t>(
+                _mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(__ctrl_sentinel), _ctrl))));
+        }
+
+        /**
+         * @brief 从组首开始连续的空槽位与已删除槽位的数量
+         */
+        unsigned count_leading_empty_or_deleted() const noexcept {
+            uint32_t mask = static_cast<uint32_t>(
+                _mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(__ctrl_sentinel), _ctrl)));
+            return __countr_zero(mask + 1);
+        }
+
+    private:
+        __m128i _ctrl;
+    };
+
+#elif defined(TINY_STL_HASH_NEON)
+
+    /**
+     * @brief 一组 8 个控制字节，用 NEON 的一条比较指令同时处理，结果每个槽位占一个字节
+     */
+    struct __hash_group {
+        static constexpr size_t width = 8; /**< 一组槽位的数量 */
+        using bitmask = __hash_bitmask<8, 3>;
+
+        explicit __hash_group(const __ctrl_t* pos) noexcept
+            : _ctrl(vld1_s8(reinterpret_cast<const int8_t*>(pos))) { }
+
+        bitmask match(__ctrl_t h2) const noexcept {
+            return to_mask(vceq_s8(_ctrl, vdup_n_s8(h2)));
+        }
+
+        bitmask mask_empty() const noexcept {
+            return to_mask(vceq_s8(_ctrl, vdup_n_s8(__ctrl_empty)));
+        }
+
+        bitmask mask_empty_or_deleted() const noexcept {
+            return to_mask(vcgt_s8(vdup_n_s8(__ctrl_sentinel), _ctrl));
+        }
+
+        unsigned count_leading_empty_or_deleted() const noexcept {
+            return __hash_count_leading_lanes(vget_lane_u64(vreinterpret_u64_u8(vcgt_s8(vdup_n_s8(__ctrl_sentinel), _ctrl)), 0));
+        }
+
+    private:
+        int8x8_t _ctrl;
+
+        static bitmask to_mask(uint8x8_t lanes) noexcept {
+            return bitmask(vget_lane_u64(vreinterpret_u64_u8(lanes), 0) & 0x8080808080808080ull);
+        }
+    };
+
+#else
+
+    /**
+     * @brief 一组 8 个控制字节，装入一个 64 位整数后用位运算同时处理（SWAR）
+     */
+    struct __hash_group {
+        static constexpr size_t width = 8; /**< 一组槽位的数量 */
+        using bitmask = __hash_bitmask<8, 3>;
+
+        explicit __hash_group(const __ctrl_t* pos) noexcept {
+            std::memcpy(&_ctrl, pos, sizeof(_ctrl));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+            _ctrl = __builtin_bswap64(_ctrl);
+#endif
+        }
+
+        /**
+         * @brief 控制字节等于 h2 的槽位
+         * @note 借位可能让紧挨着真正匹配的槽位误报，调用者总会再比较键，因此不影响正确性
+         */
+        bitmask match(__ctrl_t h2) const noexcept {
+            uint64_t x = _ctrl ^ (lsbs * static_cast<unsigned char>(h2));
+            return bitmask((x - lsbs) & ~x & msbs);
+        }
+
+        /**
+         * @brief 空的槽位：最高位为 1 且第二位为 0 的只有 -128
+         */
+        bitmask mask_empty() const noexcept {
+            return bitmask(_ctrl & (~_ctrl << 6) & msbs);
+        }
+
+        /**
+         * @brief 空的或已删除的槽位：最高位为 1 且最低位为 0
+         */
+        bitmask mask_empty_or_deleted() const noexcept {
+            return bitmask(_ctrl & (~_ctrl << 7) & msbs);
+        }
+
+        /**
+         * @brief 从组首开始连续的空槽位与已删除槽位的数量
+         */
+        unsigned count_leading_empty_or_deleted() const noexcept {
+            return __hash_count_leading_lanes(_ctrl & (~_ctrl << 7) & msbs);
+        }
+
+    private:
+        static constexpr uint64_t lsbs = 0x0101010101010101ull;
+        static constexpr uint64_t msbs = 0x8080808080808080ull;
+        uint64_t _ctrl;
+    };
+
+#endif
+
+    /**
+     * @brief 空表共用的控制字节：一个哨兵加上一组空槽位，查找与迭代都无需判断表是否为空
+     * @return 只读的控制字节数组
+     */
+    inline __ctrl_t* __hash_empty_group() noexcept {
+        alignas(16) static const __ctrl_t group[32] = {
+            __ctrl_sentinel, __ctrl_empty, __ctrl_empty, __ctrl_empty, __ctrl_empty, __ctrl_empty,
+            __ctrl_empty, __ctrl_empty, __ctrl_empty, __ctrl_empty, __ctrl_empty, __ctrl_empty,
+            __ctrl_empty, __ctrl_empty, __ctrl_empty, __ctrl_empty, __ctrl_empty, __ctrl_empty,
+            __ctrl_empty, __ctrl_empty, __ctrl_empty, __ctrl_empty, __ctrl_empty, __ctrl_empty,
+            __ctrl_empty, __ctrl_empty, __ctrl_empty, __ctrl_empty, __ctrl_empty, __ctrl_empty,
+            __ctrl_empty, __ctrl_empty};
+        return const_cast<__ctrl_t*>(group);
+    }
+
+    /**
+     * @class __hash_table_iterator
+     * @brief 哈希表的前向迭代器，同时指向控制字节与槽位，自增时跳过空的与已删除的槽位
+     * @tparam Value 元素类型
+     * @tparam Ref 引用类型
+     * @tparam Ptr 指针类型
+     */
+    template <typename Value, typename Ref, typename Ptr>
+    class __hash_table_iterator {
+        template <typename, typename, typename, typename> friend class __raw_hash_table;
+        template <typename, typename, typename> friend class __hash_table_iterator;
+    public:
+        using iterator_category = forward_iterator_tag; /**< 迭代器类别 */
+        using value_type = Value; /**< 元素类型 */
+        using difference_type = ptrdiff_t; /**< 距离类型 */
+        using pointer = Ptr; /**< 指针类型 */
+        using reference = Ref; /**< 引用类型 */
+
+        __hash_table_iterator() noexcept : _ctrl(nullptr), _slot(nullptr) { }
+
+        /**
+         * @brief 从非常量迭代器转换
+         */
+        template <typename R, typename P,
+                  typename = std::enable_if_t<std::is_convertible<P, Ptr>::value && !std::is_same<P, Ptr>::value>>
+        __hash_table_iterator(const __hash_table_iterator<Value, R, P>& other) noexcept
+            : _ctrl(other._ctrl), _slot(other._slot) { }
+
+        reference operator*() const noexcept { return *_slot; }
+        pointer operator->() const noexcept { return _slot; }
+
+        __hash_table_iterator& operator++() noexcept {
+            ++_ctrl;
+            ++_slot;
+            skip_empty_or_deleted();
+            return *this;
+        }
+
+        __hash_table_iterator operator++(int) noexcept {
+            __hash_table_iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        template <typename R, typename P>
+        bool operator==(const __hash_table_iterator<Value, R, P>& other) const noexcept {
+            return _ctrl == other._ctrl;
+        }
+
+        template <typename R, typename P>
+        bool operator!=(const __hash_table_iterator<Value, R, P>& other) const noexcept {
+            return _ctrl != other._ctrl;
+        }
+
+    private:
+        __ctrl_t* _ctrl; /**< 控制字节 */
+        Value* _slot; /**< 槽位 */
+
+        __hash_table_iterator(__ctrl_t* ctrl, Value* slot) noexcept : _ctrl(ctrl), _slot(slot) { }
+
+        /**
+         * @brief 一次跳过一整组中连续的空槽位与已删除的槽位，直到遇到元素或哨兵
+         */
+        void skip_empty_or_deleted() noexcept {
+            while (*_ctrl < __ctrl_sentinel) {
+                unsigned shift = __hash_group(_ctrl).count_leading_empty_or_deleted();
+                _ctrl += shift;
+                _slot += shift;
+            }
+        }
+    };
+
+    /**
+     * @brief `flat_hash_set` 的槽位策略：元素就是键
+     * @tparam Key 键类型
+     */
+    template <typename Key>
+    struct __flat_hash_set_policy {
+        using key_type = Key;
+        using value_type = Key;
+        static constexpr bool constant_iterators = true; /**< 元素决定了它在表中的位置，不能通过迭代器修改 */
+
+        static const key_type& key(const value_type& v) noexcept { return v; }
+
+        /**
+         * @brief 在 p 处用 v 移动构造元素
+         */
+        template <typename Alloc>
+        static void construct_move(Alloc& alloc, value_type* p, value_type& v) {
+            alloc.construct(p, tiny_stl::move(v));
+        }
+
+        /**
+         * @brief 把 src 处的元素搬到 dst 处，并销毁 src 处的元素
+         */
+        template <typename Alloc>
+        static void transfer(Alloc& alloc, value_type* dst, value_type* src) {
+            alloc.construct(dst, tiny_stl::move(*src));
+            alloc.destroy(src);
+        }
+    };
+
+    /**
+     * @brief `flat_hash_map` 的槽位策略：元素是 `pair<const Key, T>`
+     * @tparam Key 键类型
+     * @tparam T 值类型
+     */
+    template <typename Key, typename T>
+    struct __flat_hash_map_policy {
+        using key_type = Key;
+        using value_type = pair<const Key, T>;
+        static constexpr bool constant_iterators = false;
+
+        static const key_type& key(const value_type& v) noexcept { return v.first; }
+
+        /**
+         * @brief 在 p 处构造元素：键不能从 const 的 first 中移出，只能复制，值则移动过来
+         */
+        template <typename Alloc>
+        static void construct_move(Alloc& alloc, value_type* p, value_type& v) {
+            alloc.construct(p, v.first, tiny_stl::move(v.second));
+        }
+
+        /**
+         * @brief 把 src 处的元素搬到 dst 处，并销毁 src 处的元素
+         * src 处的元素随后就被销毁，不会再有人观察它的键，因此这里去掉 const 把键也移动过去
+         */
+        template <typename Alloc>
+        static void transfer(Alloc& alloc, value_type* dst, value_type* src) {
+            alloc.construct(dst, tiny_stl::move(const_cast<Key&>(src->first)), tiny_stl::move(src->second));
+            alloc.destroy(src);
+        }
+    };
+
+    /**
+     * @class __raw_hash_table
+     * @brief `flat_hash_map` 与 `flat_hash_set` 共用的开放寻址哈希表
+     *
+     * - 容量总是 2^k - 1，控制字节数组的长度为容量加上一组的宽度：
+     *   下标为容量处是哨兵，其后复制了开头的一组控制字节，从任何位置开始读取一组都不会越界，也不必处理回绕；
+     * - 以组为单位做三角探测（第 i 次跳过 i 组），在容量为 2 的幂减一时可以遍历所有组；
+     * - 最大负载为 7/8；删除元素时，如果它所在的位置从来没有让某次探测越过去，直接置为空，否则留下墓碑；
+     * - 没有空闲位置时，大部分位置是墓碑就以相同容量重新散列，否则容量加倍。
+     *
+     * 重新散列时元素被移动到新的槽位数组中，要求哈希函数与元素的移动构造不抛出异常。
+     * 插入、删除与重新散列都会使迭代器、指针和引用失效。
+     *
+     * @tparam Policy 槽位策略，规定元素类型以及如何从元素取得键
+     * @tparam Hash 哈希函数类型，其结果还会再经过 `__hash_mix` 混合
+     * @tparam KeyEqual 键的相等比较函数类型
+     * @tparam Alloc 分配器类型，通过 `rebind` 得到元素与控制字节的分配器
+     */
+    template <typename Policy, typename Hash, typename KeyEqual, typename Alloc>
+    class __raw_hash_table {
+    public:
+        using key_type = typename Policy::key_type; /**< 键类型 */
+        using value_type = typename Policy::value_type; /**< 元素类型 */
+        using size_type = size_t; /**< 大小类型 */
+        using difference_type = ptrdiff_t; /**< 距离类型 */
+        using hasher = Hash; /**< 哈希函数类型 */
+        using key_equal = KeyEqual; /**< 键的相等比较函数类型 */
+        using allocator_type = Alloc; /**< 分配器类型 */
+        using reference = value_type&; /**< 引用类型 */
+        using const_reference = const value_type&; /**< 常量引用类型 */
+        using pointer = value_type*; /**< 指针类型 */
+        using const_pointer = const value_type*; /**< 常量指针类型 */
+        using const_iterator = __hash_table_iterator<value_type, const value_type&, const value_type*>; /**< 常量迭代器类型 */
+        using iterator = std::conditional_t<Policy::constant_iterators, const_iterator,
+                                            __hash_table_iterator<value_type, value_type&, value_type*>>; /**< 迭代器类型 */
+
+    protected:
+        using slot_allocator = typename Alloc::template rebind<value_type>::other; /**< 槽位的分配器类型 */
+        using ctrl_allocator = typename Alloc::template rebind<__ctrl_t>::other; /**< 控制字节的分配器类型 */
+        static constexpr size_type width = __hash_group::width; /**< 一组槽位的数量 */
+        static constexpr size_type npos = static_cast<size_type>(-1); /**< 查找失败时返回的下标 */
+
+    public:
+        /**
+         * @brief 默认构造函数，不分配内存
+         */
+        __raw_hash_table() : __raw_hash_table(0) { }
+
+        /**
+         * @brief 构造一个空表
+         * @param bucket_count 至少能容纳的元素数量，为 0 时不分配内存
+         * @param hash 哈希函数
+         * @param eq 键的相等比较函数
+         * @param alloc 分配器
+         */
+        explicit __raw_hash_table(size_type bucket_count, const hasher& hash = hasher(),
+                                  const key_equal& eq = key_equal(), const allocator_type& alloc = allocator_type())
+            : _ctrl(__hash_empty_group()), _slots(nullptr), _size(0), _capacity(0), _growth_left(0),
+              _hash(hash), _eq(eq), _alloc(alloc) {
+            reserve(bucket_count);
+        }
+
+        /**
+         * @brief 构造一个使用指定分配器的空表
+         * @param alloc 分配器
+         */
+        explicit __raw_hash_table(const allocator_type& alloc)
+            : __raw_hash_table(0, hasher(), key_equal(), alloc) { }
+
+        /**
+         * @brief 用迭代器范围内的元素构造，重复的键只保留第一个
+         * @param first 起始迭代器
+         * @param last 结束迭代器
+         * @param bucket_count 至少能容纳的元素数量
+         * @param hash 哈希函数
+         * @param eq 键的相等比较函数
+         * @param alloc 分配器
+         */
+        template <typename InputIterator, __enable_if_input_iterator_t<InputIterator> = 0>
+        __raw_hash_table(InputIterator first, InputIterator last, size_type bucket_count = 0,
+                         const hasher& hash = hasher(), const key_equal& eq = key_equal(),
+                         const allocator_type& alloc = allocator_type())
+            : __raw_hash_table(bucket_count, hash, eq, alloc) {
+            try {
+                insert(first, last);
+            } catch (...) {
+                destroy_and_deallocate();
+                throw;
+            }
+        }
+
+        /**
+         * @brief 用初始化列表中的元素构造，重复的键只保留第一个
+         * @param il 初始化列表
+         * @param bucket_count 至少能容纳的元素数量
+         * @param hash 哈希函数
+         * @param eq 键的相等比较函数
+         * @param alloc 分配器
+         */
+        __raw_hash_table(std::initializer_list<value_type> il, size_type bucket_count = 0,
+                         const hasher& hash = hasher(), const key_equal& eq = key_equal(),
+                         const allocator_type& alloc = allocator_type())
+            : __raw_hash_table(il.begin(), il.end(), bucket_count ? bucket_count : il.size(), hash, eq, alloc) { }
+
+        /**
+         * @brief 拷贝构造函数，新表使用 other 分配器的副本
+         */
+        __raw_hash_table(const __raw_hash_table& other)
+            : __raw_hash_table(0, other._hash, other._eq, other._alloc) {
+            try {
+                copy_from(other);
+            } catch (...) {
+                destroy_and_deallocate();
+                throw;
+            }
+        }
+
+        /**
+         * @brief 移动构造函数，接管 other 的内存，other 变为空表
+         */
+        __raw_hash_table(__raw_hash_table&& other) noexcept
+            : _ctrl(other._ctrl), _slots(other._slots), _size(other._size), _capacity(other._capacity),
+              _growth_left(other._growth_left), _hash(other._hash), _eq(other._eq), _alloc(other._alloc) {
+            other.reset_to_empty();
+        }
+
+        /**
+         * @brief 析构函数
+         */
+        ~__raw_hash_table() {
+            destroy_and_deallocate();
+        }
+
+        /**
+         * @brief 拷贝赋值运算符，保留自身的分配器
+         */
+        __raw_hash_table& operator=(const __raw_hash_table& other) {
+            if (this != &other) {
+                clear();
+                _hash = other._hash;
+                _eq = other._eq;
+                copy_from(other);
+            }
+            return *this;
+        }
+
+        /**
+         * @brief 移动赋值运算符，保留自身的分配器
+         * 两者的分配器相等时接管 other 的内存，否则逐个移动元素
+         */
+        __raw_hash_table& operator=(__raw_hash_table&& other) noexcept(__allocator_always_equal<slot_allocator>::value) {
+            if (this == &other) {
+                return *this;
+            }
+            if (__allocator_equal(_alloc, other._alloc)) {
+                destroy_and_deallocate();
+                _ctrl = other._ctrl;
+                _slots = other._slots;
+                _size = other._size;
+                _capacity = other._capacity;
+                _growth_left = other._growth_left;
+                _hash = other._hash;
+                _eq = other._eq;
+                other.reset_to_empty();
+            } else {
+                clear();
+                _hash = other._hash;
+                _eq = other._eq;
+                reserve(other._size);
+                for (size_type i = 0; i < other._capacity; ++i) {
+                    if (other._ctrl[i] >= 0) {
+                        size_type j = prepare_insert(hash_of(Policy::key(other._slots[i])));
+                        construct_at_index(j, [&](value_type* p) {
+                            Policy::construct_move(_alloc, p, other._slots[i]);
+                        });
+                    }
+                }
+                other.clear();
+            }
+            return *this;
+        }
+
+        /**
+         * @brief 用初始化列表中的元素替换表中的内容
+         */
+        __raw_hash_table& operator=(std::initializer_list<value_type> il) {
+            clear();
+            insert(il);
+            return *this;
+        }
+
+        iterator begin() noexcept {
+            iterator it(_ctrl, _slots);
+            it.skip_empty_or_deleted();
+            return it;
+        }
+
+        const_iterator begin() const noexcept {
+            const_iterator it(_ctrl, _slots);
+            it.skip_empty_or_deleted();
+            return it;
+        }
+
+        const_iterator cbegin() const noexcept { return begin(); }
+
+        iterator end() noexcept { return iterator(_ctrl + _capacity, _slots + _capacity); }
+
+        const_iterator end() const noexcept { return const_iterator(_ctrl + _capacity, _slots + _capacity); }
+
+        const_iterator cend() const noexcept { return end(); }
+
+        /**
+         * @brief 判断表是否为空
+         */
+        bool empty() const noexcept { return _size == 0; }
+
+        /**
+         * @brief 获取元素的数量
+         */
+        size_type size() const noexcept { return _size; }
+
+        /**
+         * @brief 获取槽位的数量
+         */
+        size_type capacity() const noexcept { return _capacity; }
+
+        /**
+         * @brief 获取最大的元素数量
+         */
+        size_type max_size() const noexcept { return static_cast<size_type>(-1) / sizeof(value_type) / 2; }
+
+        /**
+         * @brief 获取负载因子，即元素数量与槽位数量之比
+         */
+        float load_factor() const noexcept {
+            return _capacity ? static_cast<float>(_size) / static_cast<float>(_capacity) : 0.0f;
+        }
+
+        hasher hash_function() const { return _hash; }
+
+        key_equal key_eq() const { return _eq; }
+
+        allocator_type get_allocator() const { return allocator_type(_alloc); }
+
+        /**
+         * @brief 销毁所有元素，保留已分配的内存
+         */
+        void clear() noexcept {
+            if (_capacity == 0) {
+                return;
+            }
+            destroy_slots();
+            reset_ctrl();
+            _size = 0;
+            _growth_left = capacity_to_growth(_capacity);
+        }
+
+        /**
+         * @brief 预留空间，使插入 n 个元素之前不再重新散列
+         * @param n 元素数量
+         */
+        void reserve(size_type n) {
+            if (n > _size + _growth_left) {
+                resize(normalize_capacity(growth_to_lower_bound_capacity(n)));
+            }
+        }
+
+        /**
+         * @brief 重新散列，同时清除所有墓碑
+         * @param n 至少需要的槽位数量，为 0 且表为空时释放内存
+         */
+        void rehash(size_type n) {
+            if (n == 0 && _size == 0) {
+                destroy_and_deallocate();
+                reset_to_empty();
+                return;
+            }
+            size_type lower = growth_to_lower_bound_capacity(_size);
+            resize(normalize_capacity(n > lower ? n : lower));
+        }
+
+        /**
+         * @brief 插入元素的副本，键已存在时不做任何事
+         * @param value 要插入的元素
+         * @return 指向具有该键的元素的迭代器，以及是否插入了新元素
+         */
+        pair<iterator, bool> insert(const value_type& value) {
+            return insert_with(Policy::key(value), [&](value_type* p) { _alloc.construct(p, value); });
+        }
+
+        /**
+         * @brief 插入元素，键已存在时不做任何事
+         * @param value 要插入的元素，插入时被移动
+         * @return 指向具有该键的元素的迭代器，以及是否插入了新元素
+         */
+        pair<iterator, bool> insert(value_type&& value) {
+            return insert_with(Policy::key(value), [&](value_type* p) { Policy::construct_move(_alloc, p, value); });
+        }
+
+        /**
+         * @brief 插入迭代器范围内的元素
+         */
+        template <typename InputIterator, __enable_if_input_iterator_t<InputIterator> = 0>
+        void insert(InputIterator first, InputIterator last) {
+            for (; first != last; ++first) {
+                insert(*first);
+            }
+        }
+
+        /**
+         * @brief 插入初始化列表中的元素
+         */
+        void insert(std::initializer_list<value_type> il) {
+            insert(il.begin(), il.end());
+        }
+
+        /**
+         * @brief 查找具有给定键的元素
+         * @param key 键
+         * @return 指向该元素的迭代器，不存在时返回 end()
+         */
+        iterator find(const key_type& key) {
+            size_type i = find_index(key, hash_of(key));
+            return i == npos ? end() : iterator_at(i);
+        }
+
+        const_iterator find(const key_type& key) const {
+            size_type i = find_index(key, hash_of(key));
+            return i == npos ? end() : const_iterator(_ctrl + i, _slots + i);
+        }
+
+        /**
+         * @brief 判断是否存在具有给定键的元素
+         */
+        bool contains(const key_type& key) const {
+            return find_index(key, hash_of(key)) != npos;
+        }
+
+        /**
+         * @brief 获取具有给定键的元素的数量（0 或 1）
+         */
+        size_type count(const key_type& key) const {
+            return contains(key) ? 1 : 0;
+        }
+
+        /**
+         * @brief 删除迭代器指向的元素
+         * @param pos 指向要删除元素的迭代器
+         * @return 指向下一个元素的迭代器
+         */
+        iterator erase(const_iterator pos) {
+            iterator next(pos._ctrl, pos._slot);
+            ++next;
+            erase_at(static_cast<size_type>(pos._ctrl - _ctrl));
+            return next;
+        }
+
+        /**
+         * @brief 删除范围 [first, last) 内的元素
+         * @return last
+         */
+        iterator erase(const_iterator first, const_iterator last) {
+            while (first != last) {
+                first = erase(first);
+            }
+            return iterator(last._ctrl, last._slot);
+        }
+
+        /**
+         * @brief 删除具有给定键的元素
+         * @param key 键
+         * @return 删除的元素数量（0 或 1）
+         */
+        size_type erase(const key_type& key) {
+            size_type i = find_index(key, hash_of(key));
+            if (i == npos) {
+                return 0;
+            }
+            erase_at(i);
+            return 1;
+        }
+
+        /**
+         * @brief 交换两个表的内容，包括分配器
+         */
+        void swap(__raw_hash_table& other) noexcept {
+            tiny_stl::swap(_ctrl, other._ctrl);
+            tiny_stl::swap(_slots, other._slots);
+            tiny_stl::swap(_size, other._size);
+            tiny_stl::swap(_capacity, other._capacity);
+            tiny_stl::swap(_growth_left, other._growth_left);
+            tiny_stl::swap(_hash, other._hash);
+            tiny_stl::swap(_eq, other._eq);
+            tiny_stl::swap(_alloc, other._alloc);
+        }
+
+        /**
+         * @brief 相等比较运算符：元素数量相同，并且每个元素都能在另一个表中找到相等的元素
+         */
+        bool operator==(const __raw_hash_table& other) const {
+            if (_size != other._size) {
+                return false;
+            }
+            const __raw_hash_table& outer = _capacity > other._capacity ? other : *this;
+            const __raw_hash_table& inner = _capacity > other._capacity ? *this : other;
+            for (const value_type& v : outer) {
+                size_type i = inner.find_index(Policy::key(v), inner.hash_of(Policy::key(v)));
+                if (i == npos || !(inner._slots[i] == v)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        bool operator!=(const __raw_hash_table& other) const {
+            return !(*this == other);
+        }
+
+    protected:
+        /**
+         * @brief 若键不存在，在为它准备好的槽位上调用 construct 构造新元素
+         * @param key 键
+         * @param construct 接受槽位指针、在其上构造元素的函数
+         * @return 指向具有该键的元素的迭代器，以及是否插入了新元素
+         */
+        template <typename Construct>
+        pair<iterator, bool> insert_with(const key_type& key, Construct&& construct) {
+            size_t h = hash_of(key);
+            size_type i = find_index(key, h);
+            if (i != npos) {
+                return pair<iterator, bool>(iterator_at(i), false);
+            }
+            i = prepare_insert(h);
+            construct_at_index(i, construct);
+            return pair<iterator, bool>(iterator_at(i), true);
+        }
+
+        iterator iterator_at(size_type i) noexcept {
+            return iterator(_ctrl + i, _slots + i);
+        }
+
+        /**
+         * @brief 用分配器在槽位 p 上构造元素
+         */
+        template <typename... Args>
+        void construct_slot(value_type* p, Args&&... args) {
+            _alloc.construct(p, tiny_stl::forward<Args>(args)...);
+        }
+
+    private:
+        __ctrl_t* _ctrl; /**< 控制字节，空表时指向共用的 __hash_empty_group */
+        value_type* _slots; /**< 槽位 */
+        size_type _size; /**< 元素数量 */
+        size_type _capacity; /**< 槽位数量，为 0 或 2^k - 1 */
+        size_type _growth_left; /**< 还能插入多少个元素而不必重新散列（墓碑不计入） */
+        hasher _hash; /**< 哈希函数 */
+        key_equal _eq; /**< 键的相等比较函数 */
+        slot_allocator _alloc; /**< 槽位的分配器 */
+
+        static size_t h1(size_t h) noexcept { return h >> 7; }
+
+        static __ctrl_t h2(size_t h) noexcept { return static_cast<__ctrl_t>(h & 0x7F); }
+
+        size_t hash_of(const key_type& key) const { return __hash_mix(_hash(key)); }
+
+        /**
+         * @brief 最大负载 7/8 时，给定容量最多能容纳的元素数量
+         */
+        static size_type capacity_to_growth(size_type capacity) noexcept {
+            // 宽度为 8 时，容量 7 如果允许放满 7 个元素，查找不存在的键时将找不到空槽位
+            return (width == 8 && capacity == 7) ? 6 : capacity - capacity / 8;
+        }
+
+        /**
+         * @brief capacity_to_growth 的逆运算：容纳 growth 个元素至少需要的槽位数量
+         */
+        static size_type growth_to_lower_bound_capacity(size_type growth) noexcept {
+            if (growth == 0) {
+                return 0;
+            }
+            if (width == 8 && growth == 7) {
+                return 8;
+            }
+            return growth + (growth - 1) / 7;
+        }
+
+        /**
+         * @brief 把槽位数量向上取整为 2^k - 1
+         */
+        static size_type normalize_capacity(size_type n) noexcept {
+            return n ? static_cast<size_type>(-1) >> __countl_zero(n) : 1;
+        }
+
+        /**
+         * @brief 设置控制字节，开头 width - 1 个槽位的控制字节同时写入哨兵之后的副本
+         */
+        void set_ctrl(size_type i, __ctrl_t h) noexcept {
+            _ctrl[i] = h;
+            _ctrl[((i - (width - 1)) & _capacity) + ((width - 1) & _capacity)] = h;
+        }
+
+        /**
+         * @brief 按探测序列查找键
+         * @param key 键
+         * @param h 混合后的哈希值
+         * @return 元素的下标，不存在时返回 npos
+         */
+        size_type find_index(const key_type& key, size_t h) const {
+            size_type offset = h1(h) & _capacity;
+            for (size_type step = width;; step += width) {
+                __hash_group g(_ctrl + offset);
+                for (auto m = g.match(h2(h)); m; m.clear_lowest()) {
+                    size_type i = (offset + m.lowest_bit()) & _capacity;
+                    if (_eq(Policy::key(_slots[i]), key)) {
+                        return i;
+                    }
+                }
+                if (g.mask_empty()) {
+                    return npos;
+                }
+                offset = (offset + step) & _capacity;
+            }
+        }
+
+        /**
+         * @brief 按探测序列找到第一个空的或已删除的槽位
+         * @param h 混合后的哈希值
+         * @return 槽位的下标
+         */
+        size_type find_first_non_full(size_t h) const noexcept {
+            size_type offset = h1(h) & _capacity;
+            for (size_type step = width;; step += width) {
+                auto m = __hash_group(_ctrl + offset).mask_empty_or_deleted();
+                if (m) {
+                    return (offset + m.lowest_bit()) & _capacity;
+                }
+                offset = (offset + step) & _capacity;
+            }
+        }
+
+        /**
+         * @brief 为哈希值为 h 的新元素占用一个槽位，必要时先重新散列
+         * @param h 混合后的哈希值
+         * @return 槽位的下标，元素尚未构造
+         */
+        size_type prepare_insert(size_t h) {
+            size_type target = find_first_non_full(h);
+            if (_growth_left == 0 && _ctrl[target] != __ctrl_deleted) {
+                rehash_and_grow_if_necessary();
+                target = find_first_non_full(h);
+            }
+            ++_size;
+            _growth_left -= (_ctrl[target] == __ctrl_empty);
+            set_ctrl(target, h2(h));
+            return target;
+        }
+
+        /**
+         * @brief 在 prepare_insert 准备好的槽位上构造元素，构造抛出异常时归还该槽位
+         */
+        template <typename Construct>
+        void construct_at_index(size_type i, Construct&& construct) {
+            try {
+                construct(_slots + i);
+            } catch (...) {
+                erase_meta(i);
+                throw;
+            }
+        }
+
+        /**
+         * @brief 没有空闲槽位时重新散列：墓碑较多时只清除墓碑，否则容量加倍
+         */
+        void rehash_and_grow_if_necessary() {
+            if (_capacity == 0) {
+                resize(1);
+            } else if (_capacity > width && _size * 32 <= _capacity * 25) {
+                resize(_capacity);
+            } else {
+                resize(_capacity * 2 + 1);
+            }
+        }
+
+        /**
+         * @brief 分配 new_capacity 个槽位，并把所有元素搬过去
+         * @param new_capacity 新的槽位数量，为 2^k - 1
+         */
+        void resize(size_type new_capacity) {
+            __ctrl_t* old_ctrl = _ctrl;
+            value_type* old_slots = _slots;
+            size_type old_capacity = _capacity;
+
+            ctrl_allocator ctrl_alloc(_alloc);
+            __ctrl_t* ctrl = ctrl_alloc.allocate(new_capacity + width);
+            try {
+                _slots = _alloc.allocate(new_capacity);
+            } catch (...) {
+                ctrl_alloc.deallocate(ctrl, new_capacity + width);
+                throw;
+            }
+            _ctrl = ctrl;
+            _capacity = new_capacity;
+            reset_ctrl();
+            _growth_left = capacity_to_growth(new_capacity) - _size;
+
+            for (size_type i = 0; i < old_capacity; ++i) {
+                if (old_ctrl[i] >= 0) {
+                    size_t h = hash_of(Policy::key(old_slots[i]));
+                    size_type target = find_first_non_full(h);
+                    set_ctrl(target, h2(h));
+                    Policy::transfer(_alloc, _slots + target, old_slots + i);
+                }
+            }
+            if (old_capacity) {
+                ctrl_alloc.deallocate(old_ctrl, old_capacity + width);
+                _alloc.deallocate(old_slots, old_capacity);
+            }
+        }
+
+        /**
+         * @brief 把所有控制字节置为空，并写入哨兵
+         */
+        void reset_ctrl() noexcept {
+            std::memset(_ctrl, static_cast<unsigned char>(__ctrl_empty), _capacity + width);
+            _ctrl[_capacity] = __ctrl_sentinel;
+        }
+
+        /**
+         * @brief 销毁下标为 i 的元素并释放其槽位
+         */
+        void erase_at(size_type i) {
+            _alloc.destroy(_slots + i);
+            erase_meta(i);
+        }
+
+        /**
+         * @brief 释放下标为 i 的槽位：没有探测序列越过它时直接置为空，否则留下墓碑
+         */
+        void erase_meta(size_type i) noexcept {
+            --_size;
+            bool was_never_full = _capacity <= width;
+            if (!was_never_full) {
+                // 包含 i 的任何一组中都有空槽位时，探测都会在越过 i 之前停下
+                auto empty_after = __hash_group(_ctrl + i).mask_empty();
+                auto empty_before = __hash_group(_ctrl + ((i - width) & _capacity)).mask_empty();
+                was_never_full = empty_before && empty_after &&
+                                 empty_after.trailing_zeros() + empty_before.leading_zeros() < width;
+            }
+            set_ctrl(i, was_never_full ? __ctrl_empty : __ctrl_deleted);
+            _growth_left += was_never_full;
+        }
+
+        /**
+         * @brief 把 other 中的元素逐个复制过来，当前表必须为空
+         */
+        void copy_from(const __raw_hash_table& other) {
+            reserve(other._size);
+            for (size_type i = 0; i < other._capacity; ++i) {
+                if (other._ctrl[i] >= 0) {
+                    const value_type& v = other._slots[i];
+                    size_type j = prepare_insert(hash_of(Policy::key(v)));
+                    construct_at_index(j, [&](value_type* p) { _alloc.construct(p, v); });
+                }
+            }
+        }
+
+        void destroy_slots() noexcept {
+            if (!std::is_trivially_destructible<value_type>::value) {
+                for (size_type i = 0; i < _capacity; ++i) {
+                    if (_ctrl[i] >= 0) {
+                        _alloc.destroy(_slots + i);
+                    }
+                }
+            }
+        }
+
+        /**
+         * @brief 销毁所有元素并释放内存，之后必须调用 reset_to_empty 或重新分配
+         */
+        void destroy_and_deallocate() noexcept {
+            if (_capacity == 0) {
+                return;
+            }
+            destroy_slots();
+            ctrl_allocator ctrl_alloc(_alloc);
+            ctrl_alloc.deallocate(_ctrl, _capacity + width);
+            _alloc.deallocate(_slots, _capacity);
+        }
+
+        /**
+         * @brief 回到不占用内存的空表状态
+         */
+        void reset_to_empty() noexcept {
+            _ctrl = __hash_empty_group();
+            _slots = nullptr;
+            _size = 0;
+            _capacity = 0;
+            _growth_left = 0;
+        }
+    };
+
+    /**
+     * @class flat_hash_map
+     * @brief 开放寻址的哈希映射，接口与 `std::unordered_map` 相近。
+     *
+     * 元素 `pair<const Key, T>` 直接存放在连续的槽位数组中，查找一个键通常只访问一组控制字节和一个槽位，
+     * 比链式哈希表少一次指针跳转，也不为每个元素单独分配内存。
+     * 代价是插入、删除与重新散列都会使迭代器、指针和引用失效。
+     *
+     * @tparam Key 键类型
+     * @tparam T 值类型
+     * @tparam Hash 哈希函数类型，默认为 `hash<Key>`
+     * @tparam KeyEqual 键的相等比较函数类型，默认为 `equal_to<Key>`
+     * @tparam Alloc 分配器类型，默认为 `allocator<pair<const Key, T>>`
+     */
+    template <typename Key, typename T, typename Hash = hash<Key>, typename KeyEqual = equal_to<Key>,
+              typename Alloc = allocator<pair<const Key, T>>>
+    class flat_hash_map : public __raw_hash_table<__flat_hash_map_policy<Key, T>, Hash, KeyEqual, Alloc> {
+        using base = __raw_hash_table<__flat_hash_map_policy<Key, T>, Hash, KeyEqual, Alloc>;
+    public:
+        using mapped_type = T; /**< 值类型 */
+        using typename base::key_type;
+        using typename base::value_type;
+        using typename base::size_type;
+        using typename base::iterator;
+        using typename base::const_iterator;
+
+        using base::base;
+        using base::operator=;
+        using base::erase;
+
+        flat_hash_map() = default;
+
+        /**
+         * @brief 删除迭代器指向的元素
+         * @param pos 指向要删除元素的迭代器
+         * @return 指向下一个元素的迭代器
+         */
+        iterator erase(iterator pos) {
+            return base::erase(const_iterator(pos));
+        }
+
+        /**
+         * @brief 键不存在时插入一个由 args 构造值的元素，键已存在时不做任何事（也不移动 args）
+         * @param key 键
+         * @param args 构造值的参数
+         * @return 指向具有该键的元素的迭代器，以及是否插入了新元素
+         */
+        template <typename... Args>
+        pair<iterator, bool> try_emplace(const key_type& key, Args&&... args) {
+            return this->insert_with(key, [&](value_type* p) {
+                this->construct_slot(p, key, mapped_type(tiny_stl::forward<Args>(args)...));
+            });
+        }
+
+        /**
+         * @brief 键不存在时插入一个由 args 构造值的元素，键被移动进表中；键已存在时不做任何事
+         */
+        template <typename... Args>
+        pair<iterator, bool> try_emplace(key_type&& key, Args&&... args) {
+            return this->insert_with(key, [&](value_type* p) {
+                this->construct_slot(p, tiny_stl::move(key), mapped_type(tiny_stl::forward<Args>(args)...));
+            });
+        }
+
+        /**
+         * @brief 用键和值构造元素后插入，键已存在时不做任何事
+         * @param k 构造键的参数
+         * @param v 构造值的参数
+         */
+        template <typename K, typename V>
+        pair<iterator, bool> emplace(K&& k, V&& v) {
+            key_type key(tiny_stl::forward<K>(k));
+            return try_emplace(tiny_stl::move(key), tiny_stl::forward<V>(v));
+        }
+
+        /**
+         * @brief 键不存在时插入元素，否则把值赋给已有的元素
+         * @param key 键
+         * @param obj 值
+         * @return 指向具有该键的元素的迭代器，以及是否插入了新元素
+         */
+        template <typename M>
+        pair<iterator, bool> insert_or_assign(const key_type& key, M&& obj) {
+            bool inserted = false;
+            auto result = this->insert_with(key, [&](value_type* p) {
+                this->construct_slot(p, key, tiny_stl::forward<M>(obj));
+                inserted = true;
+            });
+            if (!inserted) {
+                result.first->second = tiny_stl::forward<M>(obj);
+            }
+            return result;
+        }
+
+        /**
+         * @brief 访问键对应的值，键不存在时插入一个值初始化的元素
+         */
+        mapped_type& operator[](const key_type& key) {
+            return try_emplace(key).first->second;
+        }
+
+        mapped_type& operator[](key_type&& key) {
+            return try_emplace(tiny_stl::move(key)).first->second;
+        }
+
+        /**
+         * @brief 访问键对应的值
+         * @throw std::out_of_range 如果键不存在。
+         */
+        mapped_type& at(const key_type& key) {
+            iterator it = this->find(key);
+            if (it == this->end()) {
+                throw std::out_of_range("Key not found");
+            }
+            return it->second;
+        }
+
+        const mapped_type& at(const key_type& key) const {
+            const_iterator it = this->find(key);
+            if (it == this->end()) {
+                throw std::out_of_range("Key not found");
+            }
+            return it->second;
+        }
+    };
+
+    /**
+     * @class flat_hash_set
+     * @brief 开放寻址的哈希集合，接口与 `std::unordered_set` 相近，实现与 `flat_hash_map` 相同。
+     * @tparam Key 键类型
+     * @tparam Hash 哈希函数类型，默认为 `hash<Key>`
+     * @tparam KeyEqual 键的相等比较函数类型，默认为 `equal_to<Key>`
+     * @tparam Alloc 分配器类型，默认为 `allocator<Key>`
+     */
+    template <typename Key, typename Hash = hash<Key>, typename KeyEqual = equal_to<Key>, typename Alloc = allocator<Key>>
+    class flat_hash_set : public __raw_hash_table<__flat_hash_set_policy<Key>, Hash, KeyEqual, Alloc> {
+        using base = __raw_hash_table<__flat_hash_set_policy<Key>, Hash, KeyEqual, Alloc>;
+    public:
+        using typename base::key_type;
+        using typename base::value_type;
+        using typename base::iterator;
+
+        using base::base;
+        using base::operator=;
+
+        flat_hash_set() = default;
+
+        /**
+         * @brief 用 args 构造一个键后插入，键已存在时丢弃它
+         * @param args 构造键的参数
+         * @return 指向具有该键的元素的迭代器，以及是否插入了新元素
+         */
+        template <typename... Args>
+        pair<iterator, bool> emplace(Args&&... args) {
+            key_type key(tiny_stl::forward<Args>(args)...);
+            return this->insert(tiny_stl::move(key));
+        }
+    };
+
+    /**
+     * @brief 交换两个 flat_hash_map 的内容
+     */
+    template <typename Key, typename T, typename Hash, typename KeyEqual, typename Alloc>
+    void swap(flat_hash_map<Key, T, Hash, KeyEqual, Alloc>& a, flat_hash_map<Key, T, Hash, KeyEqual, Alloc>& b) noexcept {
+        a.swap(b);
+    }
+
+    /**
+     * @brief 交换两个 flat_hash_set 的内容
+     */
+    template <typename Key, typename Hash, typename KeyEqual, typename Alloc>
+    void swap(flat_hash_set<Key, Hash, KeyEqual, Alloc>& a, flat_hash_set<Key, Hash, KeyEqual, Alloc>& b) noexcept {
+        a.swap(b);
+    }
+
+}
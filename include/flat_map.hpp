@@ -0,0 +1,790 @@
+/**
+ * @file flat_map.hpp
+ * @brief 此文件定义了 tiny_stl 命名空间下基于有序数组的关联容器 `flat_map` 与 `flat_set`。
+ *
+ * 键按顺序存放在一个连续的 `vector` 中（`flat_map` 的值存放在另一个下标相同的 `vector` 中），
+ * 查找是对键数组的无分支二分查找：只读取键，不会把值拉进缓存，比较次数固定，没有节点之间的指针跳转。
+ * 插入与删除需要移动其后的元素，是 O(n) 的，因此适合一次构建、频繁查询的表；
+ * 批量构建时先整体排序再去重，只需 O(n log n)。键数组是普通的有序数组，可以直接写入文件或映射回内存。
+ */
+
+#pragma once
+
+#ifdef __GNUC__
+#   pragma GCC system_header
+#endif
+#if defined(_MSC_VER) && _MSC_VER >= 1920
+#   pragma system_header
+#endif
+
+#include <algorithm.hpp>
+#include <functional.hpp>
+#include <iterator.hpp>
+#include <utility.hpp>
+#include <vector.hpp>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <stdexcept>
+#include <type_traits>
+
+namespace tiny_stl {
+
+    /**
+     * @brief 求让 keys 有序的下标排列，相等的键保持原有顺序，只读取键
+     * @return order，满足 keys[order[0]] <= keys[order[1]] <= ...
+     */
+    template <typename KeyContainer, typename Compare>
+    vector<size_t> __flat_sort_order(const KeyContainer& keys, Compare& comp) {
+        vector<size_t> order;
+        order.reserve(keys.size());
+        for (size_t i = 0; i < keys.size(); ++i) {
+            order.push_back(i);
+        }
+        tiny_stl::stable_sort(order.begin(), order.end(),
+                              [&](size_t a, size_t b) { return comp(keys[a], keys[b]); });
+        return order;
+    }
+
+    /**
+     * @brief 判断 keys 是否严格递增（有序且没有重复）
+     */
+    template <typename KeyContainer, typename Compare>
+    bool __flat_is_sorted_unique(const KeyContainer& keys, Compare& comp) {
+        for (size_t i = 1; i < keys.size(); ++i) {
+            if (!comp(keys[i - 1], keys[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @class flat_map
+     * @brief 基于两个有序数组的映射，接口与 C++23 的 `std::flat_map` 相近。
+     *
+     * 键与值分别存放在 `KeyContainer` 与 `MappedContainer` 中，二者下标一一对应。
+     * 由于元素并不是作为 `pair` 存放的，解引用迭代器得到的是 `pair<const Key&, T&>`。
+     * 插入与删除会使指向插入、删除位置之后的迭代器失效。
+     *
+     * @tparam Key 键类型
+     * @tparam T 值类型
+     * @tparam Compare 键的比较函数类型，默认为 `less<Key>`
+     * @tparam KeyContainer 存放键的连续容器类型，默认为 `vector<Key>`
+     * @tparam MappedContainer 存放值的随机访问容器类型，默认为 `vector<T>`
+     */
+    template <typename Key, typename T, typename Compare = less<Key>,
+              typename KeyContainer = vector<Key>, typename MappedContainer = vector<T>>
+    class flat_map {
+    public:
+        using key_type = Key; /**< 键类型 */
+        using mapped_type = T; /**< 值类型 */
+        using value_type = pair<Key, T>; /**< 元素类型（用于插入与初始化） */
+        using key_compare = Compare; /**< 键的比较函数类型 */
+        using reference = pair<const Key&, T&>; /**< 解引用迭代器得到的类型 */
+        using const_reference = pair<const Key&, const T&>; /**< 解引用常量迭代器得到的类型 */
+        using size_type = size_t; /**< 大小类型 */
+        using difference_type = ptrdiff_t; /**< 距离类型 */
+        using key_container_type = KeyContainer; /**< 键的容器类型 */
+        using mapped_container_type = MappedContainer; /**< 值的容器类型 */
+
+    private:
+        /**
+         * @brief 同时指向键与值的随机访问迭代器
+         * @tparam Const 是否为常量迭代器
+         */
+        template <bool Const>
+        class basic_iterator {
+            friend class flat_map;
+            template <bool> friend class basic_iterator;
+            using key_iterator = typename KeyContainer::const_iterator;
+            using mapped_iterator = std::conditional_t<Const, typename MappedContainer::const_iterator,
+                                                       typename MappedContainer::iterator>;
+        public:
+            using iterator_category = random_access_iterator_tag; /**< 迭代器类别 */
+            using value_type = flat_map::value_type; /**< 元素类型 */
+            using difference_type = ptrdiff_t; /**< 距离类型 */
+            using reference = std::conditional_t<Const, const_reference, flat_map::reference>; /**< 引用类型 */
+
+            /**
+             * @brief operator-> 返回的代理，持有一个临时的 reference
+             */
+            struct pointer {
+                reference ref;
+                const reference* operator->() const noexcept { return &ref; }
+            };
+
+            basic_iterator() = default;
+
+            /**
+             * @brief 从非常量迭代器转换
+             */
+            template <bool C = Const, typename = std::enable_if_t<C>>
+            basic_iterator(const basic_iterator<false>& other) : _key(other._key), _value(other._value) { }
+
+            reference operator*() const { return reference(*_key, *_value); }
+            pointer operator->() const { return pointer{**this}; }
+            reference operator[](difference_type n) const { return *(*this + n); }
+
+            basic_iterator& operator++() { ++_key; ++_value; return *this; }
+            basic_iterator operator++(int) { basic_iterator tmp = *this; ++*this; return tmp; }
+            basic_iterator& operator--() { --_key; --_value; return *this; }
+            basic_iterator operator--(int) { basic_iterator tmp = *this; --*this; return tmp; }
+            basic_iterator& operator+=(difference_type n) { _key += n; _value += n; return *this; }
+            basic_iterator& operator-=(difference_type n) { _key -= n; _value -= n; return *this; }
+            basic_iterator operator+(difference_type n) const { basic_iterator tmp = *this; return tmp += n; }
+            basic_iterator operator-(difference_type n) const { basic_iterator tmp = *this; return tmp -= n; }
+            friend basic_iterator operator+(difference_type n, const basic_iterator& it) { return it + n; }
+            difference_type operator-(const basic_iterator& other) const { return _key - other._key; }
+
+            bool operator==(const basic_iterator& other) const { return _key == other._key; }
+            bool operator!=(const basic_iterator& other) const { return _key != other._key; }
+            bool operator<(const basic_iterator& other) const { return _key < other._key; }
+            bool operator>(const basic_iterator& other) const { return _key > other._key; }
+            bool operator<=(const basic_iterator& other) const { return _key <= other._key; }
+            bool operator>=(const basic_iterator& other) const { return _key >= other._key; }
+
+        private:
+            key_iterator _key; /**< 指向键 */
+            mapped_iterator _value; /**< 指向值 */
+
+            basic_iterator(key_iterator key, mapped_iterator value) : _key(key), _value(value) { }
+        };
+
+    public:
+        using iterator = basic_iterator<false>; /**< 迭代器类型 */
+        using const_iterator = basic_iterator<true>; /**< 常量迭代器类型 */
+        using reverse_iterator = tiny_stl::reverse_iterator<iterator>; /**< 反向迭代器类型 */
+        using const_reverse_iterator = tiny_stl::reverse_iterator<const_iterator>; /**< 常量反向迭代器类型 */
+
+        /**
+         * @brief 默认构造函数，构造一个空的映射
+         */
+        flat_map() : flat_map(Compare()) { }
+
+        /**
+         * @brief 构造一个使用指定比较函数的空映射
+         * @param comp 比较函数
+         */
+        explicit flat_map(const Compare& comp) : _comp(comp) { }
+
+        /**
+         * @brief 接管两个容器中的键与值，排序后去掉重复的键（保留最先出现的）
+         * @param keys 键
+         * @param values 值，数量必须与键相同
+         * @param comp 比较函数
+         */
+        flat_map(KeyContainer keys, MappedContainer values, const Compare& comp = Compare())
+            : _keys(tiny_stl::move(keys)), _values(tiny_stl::move(values)), _comp(comp) {
+            assert(_keys.size() == _values.size());
+            sort_and_unique();
+        }
+
+        /**
+         * @brief 接管两个已经有序且没有重复键的容器，不再排序
+         * @param keys 键，必须严格递增
+         * @param values 值，数量必须与键相同
+         * @param comp 比较函数
+         */
+        flat_map(sorted_unique_t, KeyContainer keys, MappedContainer values, const Compare& comp = Compare())
+            : _keys(tiny_stl::move(keys)), _values(tiny_stl::move(values)), _comp(comp) {
+            assert(_keys.size() == _values.size());
+            assert(__flat_is_sorted_unique(_keys, _comp));
+        }
+
+        /**
+         * @brief 用迭代器范围内的键值对构造，排序后去掉重复的键（保留最先出现的）
+         * @param first 起始迭代器，元素具有 first 与 second 成员
+         * @param last 结束迭代器
+         * @param comp 比较函数
+         */
+        template <typename InputIterator, __enable_if_input_iterator_t<InputIterator> = 0>
+        flat_map(InputIterator first, InputIterator last, const Compare& comp = Compare()) : _comp(comp) {
+            append(first, last);
+            sort_and_unique();
+        }
+
+        /**
+         * @brief 用初始化列表中的键值对构造，排序后去掉重复的键（保留最先出现的）
+         */
+        flat_map(std::initializer_list<value_type> il, const Compare& comp = Compare())
+            : flat_map(il.begin(), il.end(), comp) { }
+
+        /**
+         * @brief 用初始化列表中的键值对替换内容
+         */
+        flat_map& operator=(std::initializer_list<value_type> il) {
+            clear();
+            append(il.begin(), il.end());
+            sort_and_unique();
+            return *this;
+        }
+
+        iterator begin() noexcept { return iterator(_keys.begin(), _values.begin()); }
+        const_iterator begin() const noexcept { return const_iterator(_keys.begin(), _values.begin()); }
+        const_iterator cbegin() const noexcept { return begin(); }
+        iterator end() noexcept { return iterator(_keys.end(), _values.end()); }
+        const_iterator end() const noexcept { return const_iterator(_keys.end(), _values.end()); }
+        const_iterator cend() const noexcept { return end(); }
+        reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+        const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+        reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+        const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+        /**
+         * @brief 判断映射是否为空
+         */
+        bool empty() const noexcept { return _keys.empty(); }
+
+        /**
+         * @brief 获取元素的数量
+         */
+        size_type size() const noexcept { return _keys.size(); }
+
+        /**
+         * @brief 为 n 个元素预留空间
+         */
+        void reserve(size_type n) {
+            _keys.reserve(n);
+            _values.reserve(n);
+        }
+
+        /**
+         * @brief 删除所有元素
+         */
+        void clear() noexcept {
+            _keys.clear();
+            _values.clear();
+        }
+
+        /**
+         * @brief 有序的键数组
+         */
+        const KeyContainer& keys() const noexcept { return _keys; }
+
+        /**
+         * @brief 与键数组下标对应的值数组
+         */
+        const MappedContainer& values() const noexcept { return _values; }
+
+        /**
+         * @brief 访问键对应的值，键不存在时插入一个值初始化的元素
+         */
+        mapped_type& operator[](const key_type& key) {
+            return try_emplace(key).first->second;
+        }
+
+        mapped_type& operator[](key_type&& key) {
+            return try_emplace(tiny_stl::move(key)).first->second;
+        }
+
+        /**
+         * @brief 访问键对应的值
+         * @throw std::out_of_range 如果键不存在。
+         */
+        mapped_type& at(const key_type& key) {
+            size_type i = find_index(key);
+            if (i == size()) {
+                throw std::out_of_range("Key not found");
+            }
+            return _values[i];
+        }
+
+        const mapped_type& at(const key_type& key) const {
+            size_type i = find_index(key);
+            if (i == size()) {
+                throw std::out_of_range("Key not found");
+            }
+            return _values[i];
+        }
+
+        /**
+         * @brief 键不存在时在有序位置插入一个由 args 构造值的元素，键已存在时不做任何事
+         * @param key 键
+         * @param args 构造值的参数
+         * @return 指向具有该键的元素的迭代器，以及是否插入了新元素
+         */
+        template <typename... Args>
+        pair<iterator, bool> try_emplace(const key_type& key, Args&&... args) {
+            return emplace_at(key, key, tiny_stl::forward<Args>(args)...);
+        }
+
+        template <typename... Args>
+        pair<iterator, bool> try_emplace(key_type&& key, Args&&... args) {
+            return emplace_at(key, tiny_stl::move(key), tiny_stl::forward<Args>(args)...);
+        }
+
+        /**
+         * @brief 插入一个键值对，键已存在时不做任何事
+         */
+        pair<iterator, bool> insert(const value_type& value) {
+            return try_emplace(value.first, value.second);
+        }
+
+        pair<iterator, bool> insert(value_type&& value) {
+            return try_emplace(tiny_stl::move(value.first), tiny_stl::move(value.second));
+        }
+
+        /**
+         * @brief 键不存在时插入元素，否则把值赋给已有的元素
+         */
+        template <typename M>
+        pair<iterator, bool> insert_or_assign(const key_type& key, M&& obj) {
+            size_type i = lower_bound_index(key);
+            if (i != size() && !_comp(key, _keys[i])) {
+                _values[i] = tiny_stl::forward<M>(obj);
+                return pair<iterator, bool>(begin() + difference_type(i), false);
+            }
+            return emplace_at(key, key, tiny_stl::forward<M>(obj));
+        }
+
+        /**
+         * @brief 批量插入迭代器范围内的键值对：追加到末尾后整体重新排序、去重，已有的键优先
+         * 相比逐个插入（每次 O(n)），插入大量元素时只需 O((n + m) log (n + m))
+         */
+        template <typename InputIterator, __enable_if_input_iterator_t<InputIterator> = 0>
+        void insert(InputIterator first, InputIterator last) {
+            append(first, last);
+            sort_and_unique();
+        }
+
+        void insert(std::initializer_list<value_type> il) {
+            insert(il.begin(), il.end());
+        }
+
+        /**
+         * @brief 删除迭代器指向的元素
+         * @return 指向下一个元素的迭代器
+         */
+        iterator erase(const_iterator pos) {
+            difference_type i = pos - cbegin();
+            _keys.erase(_keys.begin() + i);
+            _values.erase(_values.begin() + i);
+            return begin() + i;
+        }
+
+        iterator erase(iterator pos) {
+            return erase(const_iterator(pos));
+        }
+
+        /**
+         * @brief 删除范围 [first, last) 内的元素
+         */
+        iterator erase(const_iterator first, const_iterator last) {
+            difference_type i = first - cbegin(), j = last - cbegin();
+            _keys.erase(_keys.begin() + i, _keys.begin() + j);
+            _values.erase(_values.begin() + i, _values.begin() + j);
+            return begin() + i;
+        }
+
+        /**
+         * @brief 删除具有给定键的元素
+         * @return 删除的元素数量（0 或 1）
+         */
+        size_type erase(const key_type& key) {
+            size_type i = find_index(key);
+            if (i == size()) {
+                return 0;
+            }
+            erase(cbegin() + difference_type(i));
+            return 1;
+        }
+
+        /**
+         * @brief 查找具有给定键的元素
+         * @return 指向该元素的迭代器，不存在时返回 end()
+         */
+        iterator find(const key_type& key) { return begin() + difference_type(find_index(key)); }
+        const_iterator find(const key_type& key) const { return begin() + difference_type(find_index(key)); }
+
+        /**
+         * @brief 判断是否存在具有给定键的元素
+         */
+        bool contains(const key_type& key) const { return find_index(key) != size(); }
+
+        /**
+         * @brief 获取具有给定键的元素的数量（0 或 1）
+         */
+        size_type count(const key_type& key) const { return contains(key) ? 1 : 0; }
+
+        /**
+         * @brief 第一个键不小于 key 的元素
+         */
+        iterator lower_bound(const key_type& key) { return begin() + difference_type(lower_bound_index(key)); }
+        const_iterator lower_bound(const key_type& key) const { return begin() + difference_type(lower_bound_index(key)); }
+
+        /**
+         * @brief 第一个键大于 key 的元素
+         */
+        iterator upper_bound(const key_type& key) { return begin() + difference_type(upper_bound_index(key)); }
+        const_iterator upper_bound(const key_type& key) const { return begin() + difference_type(upper_bound_index(key)); }
+
+        /**
+         * @brief 键等于 key 的元素范围
+         */
+        pair<iterator, iterator> equal_range(const key_type& key) {
+            return pair<iterator, iterator>(lower_bound(key), upper_bound(key));
+        }
+
+        pair<const_iterator, const_iterator> equal_range(const key_type& key) const {
+            return pair<const_iterator, const_iterator>(lower_bound(key), upper_bound(key));
+        }
+
+        /**
+         * @brief 获取键的比较函数
+         */
+        key_compare key_comp() const { return _comp; }
+
+        /**
+         * @brief 交换两个映射的内容
+         */
+        void swap(flat_map& other) noexcept {
+            _keys.swap(other._keys);
+            _values.swap(other._values);
+            tiny_stl::swap(_comp, other._comp);
+        }
+
+        /**
+         * @brief 相等比较运算符
+         */
+        bool operator==(const flat_map& other) const {
+            return _keys == other._keys && _values == other._values;
+        }
+
+        bool operator!=(const flat_map& other) const {
+            return !(*this == other);
+        }
+
+    private:
+        KeyContainer _keys; /**< 严格递增的键 */
+        MappedContainer _values; /**< 与键下标对应的值 */
+        Compare _comp; /**< 键的比较函数 */
+
+        size_type lower_bound_index(const key_type& key) const {
+            return size_type(tiny_stl::__branchless_lower_bound(_keys.data(), _keys.size(), key, _comp) - _keys.data());
+        }
+
+        size_type upper_bound_index(const key_type& key) const {
+            size_type i = lower_bound_index(key);
+            return i != size() && !_comp(key, _keys[i]) ? i + 1 : i;
+        }
+
+        /**
+         * @brief 查找键的下标，不存在时返回 size()
+         */
+        size_type find_index(const key_type& key) const {
+            size_type i = lower_bound_index(key);
+            return i != size() && !_comp(key, _keys[i]) ? i : size();
+        }
+
+        /**
+         * @brief 键不存在时在有序位置插入由 k 构造的键与由 args 构造的值
+         * @param key 用于查找的键
+         * @param k 构造键的参数
+         * @param args 构造值的参数
+         */
+        template <typename K, typename... Args>
+        pair<iterator, bool> emplace_at(const key_type& key, K&& k, Args&&... args) {
+            size_type i = lower_bound_index(key);
+            if (i != size() && !_comp(key, _keys[i])) {
+                return pair<iterator, bool>(begin() + difference_type(i), false);
+            }
+            _keys.insert(_keys.begin() + difference_type(i), tiny_stl::forward<K>(k));
+            try {
+                _values.emplace(_values.begin() + difference_type(i), tiny_stl::forward<Args>(args)...);
+            } catch (...) {
+                _keys.erase(_keys.begin() + difference_type(i));
+                throw;
+            }
+            return pair<iterator, bool>(begin() + difference_type(i), true);
+        }
+
+        /**
+         * @brief 把键值对追加到两个容器的末尾，不维护顺序
+         */
+        template <typename InputIterator>
+        void append(InputIterator first, InputIterator last) {
+            for (; first != last; ++first) {
+                _keys.push_back((*first).first);
+                try {
+                    _values.push_back((*first).second);
+                } catch (...) {
+                    _keys.pop_back();
+                    throw;
+                }
+            }
+        }
+
+        /**
+         * @brief 把键与值按键排序并去掉重复的键，相等的键保留最先出现的
+         *
+         * 只对下标排序（比较时读取键），再按排列就地循环移动两个容器中的元素，
+         * 每个元素只移动一次，也不需要与容器同样大小的临时键值数组。
+         */
+        void sort_and_unique() {
+            if (__flat_is_sorted_unique(_keys, _comp)) {
+                return;
+            }
+            vector<size_t> order = __flat_sort_order(_keys, _comp);
+            size_type n = order.size();
+            for (size_type i = 0; i < n; ++i) {
+                if (order[i] == i) {
+                    continue;
+                }
+                key_type key = tiny_stl::move(_keys[i]);
+                mapped_type value = tiny_stl::move(_values[i]);
+                size_type j = i;
+                for (;;) {
+                    size_type src = order[j];
+                    order[j] = j;
+                    if (src == i) {
+                        _keys[j] = tiny_stl::move(key);
+                        _values[j] = tiny_stl::move(value);
+                        break;
+                    }
+                    _keys[j] = tiny_stl::move(_keys[src]);
+                    _values[j] = tiny_stl::move(_values[src]);
+                    j = src;
+                }
+            }
+            size_type out = 1;
+            for (size_type i = 1; i < n; ++i) {
+                if (_comp(_keys[out - 1], _keys[i])) {
+                    if (out != i) {
+                        _keys[out] = tiny_stl::move(_keys[i]);
+                        _values[out] = tiny_stl::move(_values[i]);
+                    }
+                    ++out;
+                }
+            }
+            _keys.erase(_keys.begin() + difference_type(out), _keys.end());
+            _values.erase(_values.begin() + difference_type(out), _values.end());
+        }
+    };
+
+    /**
+     * @class flat_set
+     * @brief 基于有序数组的集合，接口与 C++23 的 `std::flat_set` 相近。
+     * @tparam Key 键类型
+     * @tparam Compare 键的比较函数类型，默认为 `less<Key>`
+     * @tparam KeyContainer 存放键的连续容器类型，默认为 `vector<Key>`
+     */
+    template <typename Key, typename Compare = less<Key>, typename KeyContainer = vector<Key>>
+    class flat_set {
+    public:
+        using key_type = Key; /**< 键类型 */
+        using value_type = Key; /**< 元素类型 */
+        using key_compare = Compare; /**< 键的比较函数类型 */
+        using reference = const Key&; /**< 引用类型 */
+        using const_reference = const Key&; /**< 常量引用类型 */
+        using size_type = size_t; /**< 大小类型 */
+        using difference_type = ptrdiff_t; /**< 距离类型 */
+        using container_type = KeyContainer; /**< 容器类型 */
+        using iterator = typename KeyContainer::const_iterator; /**< 迭代器类型，元素不能通过迭代器修改 */
+        using const_iterator = iterator; /**< 常量迭代器类型 */
+        using reverse_iterator = tiny_stl::reverse_iterator<iterator>; /**< 反向迭代器类型 */
+        using const_reverse_iterator = reverse_iterator; /**< 常量反向迭代器类型 */
+
+        /**
+         * @brief 默认构造函数，构造一个空的集合
+         */
+        flat_set() : flat_set(Compare()) { }
+
+        /**
+         * @brief 构造一个使用指定比较函数的空集合
+         */
+        explicit flat_set(const Compare& comp) : _comp(comp) { }
+
+        /**
+         * @brief 接管容器中的键，排序后去掉重复的键（保留最先出现的）
+         */
+        explicit flat_set(KeyContainer keys, const Compare& comp = Compare())
+            : _keys(tiny_stl::move(keys)), _comp(comp) {
+            sort_and_unique();
+        }
+
+        /**
+         * @brief 接管已经有序且没有重复的键，不再排序
+         */
+        flat_set(sorted_unique_t, KeyContainer keys, const Compare& comp = Compare())
+            : _keys(tiny_stl::move(keys)), _comp(comp) {
+            assert(__flat_is_sorted_unique(_keys, _comp));
+        }
+
+        /**
+         * @brief 用迭代器范围内的键构造，排序后去掉重复的键
+         */
+        template <typename InputIterator, __enable_if_input_iterator_t<InputIterator> = 0>
+        flat_set(InputIterator first, InputIterator last, const Compare& comp = Compare()) : _comp(comp) {
+            insert(first, last);
+        }
+
+        /**
+         * @brief 用初始化列表中的键构造，排序后去掉重复的键
+         */
+        flat_set(std::initializer_list<value_type> il, const Compare& comp = Compare())
+            : flat_set(il.begin(), il.end(), comp) { }
+
+        flat_set& operator=(std::initializer_list<value_type> il) {
+            clear();
+            insert(il);
+            return *this;
+        }
+
+        iterator begin() const noexcept { return _keys.begin(); }
+        iterator cbegin() const noexcept { return _keys.begin(); }
+        iterator end() const noexcept { return _keys.end(); }
+        iterator cend() const noexcept { return _keys.end(); }
+        reverse_iterator rbegin() const noexcept { return reverse_iterator(end()); }
+        reverse_iterator rend() const noexcept { return reverse_iterator(begin()); }
+
+        bool empty() const noexcept { return _keys.empty(); }
+        size_type size() const noexcept { return _keys.size(); }
+        void reserve(size_type n) { _keys.reserve(n); }
+        void clear() noexcept { _keys.clear(); }
+
+        /**
+         * @brief 有序的键数组
+         */
+        const KeyContainer& keys() const noexcept { return _keys; }
+
+        /**
+         * @brief 键不存在时在有序位置插入，键已存在时不做任何事
+         * @return 指向具有该键的元素的迭代器，以及是否插入了新元素
+         */
+        pair<iterator, bool> insert(const value_type& value) {
+            return insert_at(value, value);
+        }
+
+        pair<iterator, bool> insert(value_type&& value) {
+            return insert_at(value, tiny_stl::move(value));
+        }
+
+        /**
+         * @brief 用 args 构造一个键后插入，键已存在时丢弃它
+         */
+        template <typename... Args>
+        pair<iterator, bool> emplace(Args&&... args) {
+            key_type key(tiny_stl::forward<Args>(args)...);
+            return insert(tiny_stl::move(key));
+        }
+
+        /**
+         * @brief 批量插入：追加到末尾后整体重新排序、去重，已有的键优先
+         */
+        template <typename InputIterator, __enable_if_input_iterator_t<InputIterator> = 0>
+        void insert(InputIterator first, InputIterator last) {
+            for (; first != last; ++first) {
+                _keys.push_back(*first);
+            }
+            sort_and_unique();
+        }
+
+        void insert(std::initializer_list<value_type> il) {
+            insert(il.begin(), il.end());
+        }
+
+        /**
+         * @brief 删除迭代器指向的元素
+         * @return 指向下一个元素的迭代器
+         */
+        iterator erase(iterator pos) {
+            return _keys.erase(pos);
+        }
+
+        iterator erase(iterator first, iterator last) {
+            return _keys.erase(first, last);
+        }
+
+        /**
+         * @brief 删除具有给定键的元素
+         * @return 删除的元素数量（0 或 1）
+         */
+        size_type erase(const key_type& key) {
+            iterator it = find(key);
+            if (it == end()) {
+                return 0;
+            }
+            erase(it);
+            return 1;
+        }
+
+        iterator find(const key_type& key) const {
+            iterator it = lower_bound(key);
+            return it != end() && !_comp(key, *it) ? it : end();
+        }
+
+        bool contains(const key_type& key) const { return find(key) != end(); }
+
+        size_type count(const key_type& key) const { return contains(key) ? 1 : 0; }
+
+        iterator lower_bound(const key_type& key) const {
+            return begin() + (tiny_stl::__branchless_lower_bound(_keys.data(), _keys.size(), key, _comp) - _keys.data());
+        }
+
+        iterator upper_bound(const key_type& key) const {
+            iterator it = lower_bound(key);
+            return it != end() && !_comp(key, *it) ? it + 1 : it;
+        }
+
+        pair<iterator, iterator> equal_range(const key_type& key) const {
+            return pair<iterator, iterator>(lower_bound(key), upper_bound(key));
+        }
+
+        key_compare key_comp() const { return _comp; }
+
+        void swap(flat_set& other) noexcept {
+            _keys.swap(other._keys);
+            tiny_stl::swap(_comp, other._comp);
+        }
+
+        bool operator==(const flat_set& other) const { return _keys == other._keys; }
+
+        bool operator!=(const flat_set& other) const { return !(*this == other); }
+
+    private:
+        KeyContainer _keys; /**< 严格递增的键 */
+        Compare _comp; /**< 键的比较函数 */
+
+        template <typename K>
+        pair<iterator, bool> insert_at(const key_type& key, K&& k) {
+            iterator it = lower_bound(key);
+            if (it != end() && !_comp(key, *it)) {
+                return pair<iterator, bool>(it, false);
+            }
+            return pair<iterator, bool>(_keys.insert(it, tiny_stl::forward<K>(k)), true);
+        }
+
+        /**
+         * @brief 稳定排序后去掉重复的键，相等的键保留最先出现的
+         */
+        void sort_and_unique() {
+            if (__flat_is_sorted_unique(_keys, _comp)) {
+                return;
+            }
+            tiny_stl::stable_sort(_keys.begin(), _keys.end(), _comp);
+            size_type out = 1;
+            for (size_type i = 1; i < _keys.size(); ++i) {
+                if (_comp(_keys[out - 1], _keys[i])) {
+                    if (out != i) {
+                        _keys[out] = tiny_stl::move(_keys[i]);
+                    }
+                    ++out;
+                }
+            }
+            _keys.erase(_keys.begin() + difference_type(out), _keys.end());
+        }
+    };
+
+    template <typename Key, typename T, typename Compare, typename KeyContainer, typename MappedContainer>
+    void swap(flat_map<Key, T, Compare, KeyContainer, MappedContainer>& a,
+              flat_map<Key, T, Compare, KeyContainer, MappedContainer>& b) noexcept {
+        a.swap(b);
+    }
+
+    template <typename Key, typename Compare, typename KeyContainer>
+    void swap(flat_set<Key, Compare, KeyContainer>& a, flat_set<Key, Compare, KeyContainer>& b) noexcept {
+        a.swap(b);
+    }
+
+}
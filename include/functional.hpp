@@ -3,6 +3,7 @@
  * @brief 此文件定义了一系列函数对象，用于实现常见的算术、比较等操作，类似于标准库 `<functional>` 头文件中的部分功能。
  * 
  * 这些函数对象可以作为模板参数传递给算法或容器，以实现自定义的操作逻辑。
+ * 此外还定义了类型擦除的可调用对象包装器 `function`、只能移动的 `unique_function` 与不拥有对象的 `function_ref`。
  */
 
 #pragma once
@@ -13,6 +14,17 @@
 #   pragma system_header
 #endif
 
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional> // 包含 std::invoke 与 std::bad_function_call
+#include <memory>     // 包含 std::addressof
+#include <new>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility.hpp>
+
 namespace tiny_stl {
 
     /**
@@ -199,7 +211,7 @@ namespace tiny_stl {
     };
 
     /**
-     * @class equal
+     * @class equal_to
      * @brief 二元函数对象，用于实现相等比较操作。
      * 
      * 该类继承自 `binary_function`，并重载了 `operator()` 以实现两个相同类型对象的相等比较。
@@ -207,7 +219,7 @@ namespace tiny_stl {
      * @tparam T 比较操作的操作数类型。
      */
     template <typename T>
-    struct equal : public binary_function<T, T, bool> {
+    struct equal_to : public binary_function<T, T, bool> {
         /**
          * @brief 执行相等比较操作。
          * 
@@ -307,4 +319,562 @@ namespace tiny_stl {
             return x <= y;
         }
     };
+
+    // ==================== 哈希 ====================
+
+    /**
+     * @brief 计算两个 64 位整数的 128 位乘积，并把高低两半异或起来。
+     * 这是一次乘法就能把输入的每一位扩散到结果各处的混合函数。
+     * @param a 第一个因子。
+     * @param b 第二个因子。
+     * @return 乘积高 64 位与低 64 位的异或。
+     */
+    inline uint64_t __hash_mum(uint64_t a, uint64_t b) noexcept {
+#if defined(__SIZEOF_INT128__)
+        __uint128_t r = static_cast<__uint128_t>(a) * b;
+        return static_cast<uint64_t>(r) ^ static_cast<uint64_t>(r >> 64);
+#else
+        uint64_t a_lo = a & 0xFFFFFFFFu, a_hi = a >> 32;
+        uint64_t b_lo = b & 0xFFFFFFFFu, b_hi = b >> 32;
+        uint64_t lo_lo = a_lo * b_lo, hi_lo = a_hi * b_lo, lo_hi = a_lo * b_hi, hi_hi = a_hi * b_hi;
+        uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFFu) + lo_hi;
+        uint64_t lo = (cross << 32) | (lo_lo & 0xFFFFFFFFu);
+        uint64_t hi = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+        return lo ^ hi;
+#endif
+    }
+
+    /**
+     * @brief 混合一个哈希值，使低位与高位都依赖输入的每一位。
+     * 哈希表用它处理 `hash` 的结果，因此整数的恒等哈希也能均匀地分布到各个桶中。
+     * @param h 原始哈希值。
+     * @return 混合后的哈希值。
+     */
+    inline size_t __hash_mix(size_t h) noexcept {
+        return static_cast<size_t>(__hash_mum(static_cast<uint64_t>(h), 0x9E3779B97F4A7C15ull));
+    }
+
+    /**
+     * @brief 计算一段字节的哈希值，每次处理 8 个字节。
+     * @param data 字节的起始地址。
+     * @param len 字节数。
+     * @param seed 种子。
+     * @return 哈希值。
+     */
+    inline size_t __hash_bytes(const void* data, size_t len, uint64_t seed = 0xA0761D6478BD642Full) noexcept {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        uint64_t h = seed ^ __hash_mum(len, 0xE7037ED1A0B428DBull);
+        for (; len >= 8; len -= 8, p += 8) {
+            uint64_t k;
+            std::memcpy(&k, p, 8);
+            h = __hash_mum(h ^ k, 0x8EBC6AF09C88C6E3ull);
+        }
+        uint64_t tail = 0;
+        for (size_t i = 0; i < len; ++i) {
+            tail |= static_cast<uint64_t>(p[i]) << (8 * i);
+        }
+        h = __hash_mum(h ^ tail, 0x589965CC75374CC3ull);
+        return static_cast<size_t>(h);
+    }
+
+    /**
+     * @class hash
+     * @brief 哈希函数对象，类似于 `std::hash`。
+     *
+     * 对整数、枚举、指针、浮点数、`std::string` 与 `std::string_view` 提供了特化；
+     * 其他类型可以特化该模板。整数与指针的哈希就是它们自身的值，由哈希表负责进一步混合。
+     *
+     * @tparam T 要计算哈希值的类型。
+     */
+    template <typename T, typename = void>
+    struct hash;
+
+    /**
+     * @brief 整数与枚举的哈希：值本身。
+     * @tparam T 整数或枚举类型。
+     */
+    template <typename T>
+    struct hash<T, std::enable_if_t<std::is_integral<T>::value || std::is_enum<T>::value>> {
+        size_t operator()(T value) const noexcept {
+            return static_cast<size_t>(value);
+        }
+    };
+
+    /**
+     * @brief 指针的哈希：地址本身。
+     * @tparam T 指针指向的类型。
+     */
+    template <typename T>
+    struct hash<T*, void> {
+        size_t operator()(T* p) const noexcept {
+            return static_cast<size_t>(reinterpret_cast<uintptr_t>(p));
+        }
+    };
+
+    /**
+     * @brief 浮点数的哈希：对字节表示求哈希，+0.0 与 -0.0 的哈希值相同。
+     * @tparam T 浮点类型。
+     */
+    template <typename T>
+    struct hash<T, std::enable_if_t<std::is_floating_point<T>::value>> {
+        size_t operator()(T value) const noexcept {
+            if (value == T(0)) {
+                value = T(0);
+            }
+            return __hash_bytes(&value, sizeof(T));
+        }
+    };
+
+    /**
+     * @brief `std::string_view` 的哈希。
+     */
+    template <>
+    struct hash<std::string_view, void> {
+        size_t operator()(std::string_view s) const noexcept {
+            return __hash_bytes(s.data(), s.size());
+        }
+    };
+
+    /**
+     * @brief `std::string` 的哈希，与相同内容的 `std::string_view` 的哈希值相同。
+     */
+    template <>
+    struct hash<std::string, void> {
+        size_t operator()(const std::string& s) const noexcept {
+            return __hash_bytes(s.data(), s.size());
+        }
+    };
+
+    /**
+     * @brief `function` 与 `unique_function` 默认的内联缓冲区大小：4 个指针。
+     * 捕获不超过这么多字节、且移动构造不抛出异常的可调用对象直接存放在包装器内部，不分配堆内存。
+     */
+    constexpr size_t __function_buffer_size = 4 * sizeof(void*);
+
+    /**
+     * @brief 可调用对象的存储：内联缓冲区，或放不下时指向堆上对象的指针
+     * @tparam BufferSize 内联缓冲区的大小
+     */
+    template <size_t BufferSize>
+    union __function_storage {
+        void* heap; /**< 堆上的对象 */
+        alignas(std::max_align_t) unsigned char buffer[BufferSize > sizeof(void*) ? BufferSize : sizeof(void*)]; /**< 内联缓冲区 */
+    };
+
+    /**
+     * @brief 存储中可调用对象的管理函数，每种可调用对象类型一张静态的表
+     */
+    struct __function_ops {
+        void (*move)(void* dst, void* src) noexcept; /**< 把 src 中的对象移动到空的 dst 中，src 随后为空 */
+        void (*copy)(void* dst, const void* src); /**< 把 src 中的对象复制到空的 dst 中，不可复制时为空 */
+        void (*destroy)(void* storage) noexcept; /**< 销毁存储中的对象 */
+    };
+
+    /**
+     * @brief 类型为 F 的可调用对象在大小为 BufferSize 的存储中的创建、调用、移动、复制与销毁
+     * @tparam F 可调用对象的类型
+     * @tparam BufferSize 内联缓冲区的大小
+     */
+    template <typename F, size_t BufferSize>
+    struct __function_handler {
+        /**
+         * @brief 是否存放在内联缓冲区中：大小与对齐都放得下，并且移动构造不抛出异常，这样包装器的移动才能是 noexcept
+         */
+        static constexpr bool is_inline = sizeof(F) <= sizeof(__function_storage<BufferSize>) &&
+                                          alignof(std::max_align_t) % alignof(F) == 0 &&
+                                          std::is_nothrow_move_constructible<F>::value;
+
+        static F* get(void* storage) noexcept {
+            if constexpr (is_inline) {
+                return std::launder(reinterpret_cast<F*>(storage));
+            } else {
+                return static_cast<F*>(static_cast<__function_storage<BufferSize>*>(storage)->heap);
+            }
+        }
+
+        template <typename... A>
+        static void create(void* storage, A&&... args) {
+            if constexpr (is_inline) {
+                ::new (storage) F(tiny_stl::forward<A>(args)...);
+            } else {
+                static_cast<__function_storage<BufferSize>*>(storage)->heap = new F(tiny_stl::forward<A>(args)...);
+            }
+        }
+
+        static void move(void* dst, void* src) noexcept {
+            if constexpr (is_inline) {
+                F* f = get(src);
+                ::new (dst) F(tiny_stl::move(*f));
+                f->~F();
+            } else {
+                static_cast<__function_storage<BufferSize>*>(dst)->heap = static_cast<__function_storage<BufferSize>*>(src)->heap;
+            }
+        }
+
+        static void copy(void* dst, const void* src) {
+            create(dst, *get(const_cast<void*>(src)));
+        }
+
+        static void destroy(void* storage) noexcept {
+            if constexpr (is_inline) {
+                get(storage)->~F();
+            } else {
+                delete get(storage);
+            }
+        }
+
+        template <typename R, typename... Args>
+        static R invoke(void* storage, Args&&... args) {
+            return static_cast<R>(std::invoke(*get(storage), tiny_stl::forward<Args>(args)...));
+        }
+
+        static constexpr __function_ops copyable_ops = { &move, &copy, &destroy }; /**< 可复制的包装器的管理函数表 */
+        static constexpr __function_ops move_only_ops = { &move, nullptr, &destroy }; /**< 不可复制的包装器不需要 copy，也就不要求 F 可复制 */
+
+        /**
+         * @brief 获取管理函数表。用 if constexpr 选择，只实例化用到的那一张表
+         */
+        template <bool Copyable>
+        static const __function_ops* ops() noexcept {
+            if constexpr (Copyable) {
+                return &copyable_ops;
+            } else {
+                return &move_only_ops;
+            }
+        }
+    };
+
+    /**
+     * @brief 空包装器的调用函数：抛出 `std::bad_function_call`。
+     * 空包装器也指向一个调用函数，调用时就不需要先判断是否为空
+     */
+    template <typename R, typename... Args>
+    R __function_empty_invoke(void*, Args&&...) {
+        throw std::bad_function_call();
+    }
+
+    /**
+     * @class __function_base
+     * @brief `function` 与 `unique_function` 的公共实现：内联缓冲区、调用函数指针与管理函数表。
+     *
+     * 调用只经过一次间接跳转（调用函数指针直接保存在对象中）；移动、复制与销毁经过管理函数表。
+     *
+     * @tparam Copyable 包装器是否可复制，可复制时要求存放的可调用对象可复制
+     * @tparam BufferSize 内联缓冲区的大小
+     * @tparam R 返回值类型
+     * @tparam Args 参数类型
+     */
+    template <bool Copyable, size_t BufferSize, typename R, typename... Args>
+    class __function_base {
+    public:
+        using result_type = R; /**< 返回值类型 */
+
+        /**
+         * @brief 判断 F 能否存放到包装器中：可以用 Args 调用并转换为 R；可复制的包装器还要求 F 可复制
+         */
+        template <typename F, typename D = std::decay_t<F>>
+        static constexpr bool accepts = !std::is_base_of<__function_base, D>::value &&
+                                        std::is_invocable_r<R, D&, Args...>::value &&
+                                        std::is_constructible<D, F>::value &&
+                                        (!Copyable || std::is_copy_constructible<D>::value);
+
+        /**
+         * @brief 构造空的包装器
+         */
+        __function_base() noexcept : _invoke(&__function_empty_invoke<R, Args...>), _ops(nullptr) { }
+
+        /**
+         * @brief 构造空的包装器
+         */
+        __function_base(std::nullptr_t) noexcept : __function_base() { }
+
+        /**
+         * @brief 存放可调用对象 f。函数指针或成员指针为空时构造空的包装器
+         * @param f 可调用对象
+         */
+        template <typename F, typename = std::enable_if_t<accepts<F>>>
+        __function_base(F&& f) : __function_base() {
+            using D = std::decay_t<F>;
+            if constexpr (std::is_pointer<D>::value || std::is_member_pointer<D>::value) {
+                if (f == nullptr) {
+                    return;
+                }
+            }
+            using handler = __function_handler<D, BufferSize>;
+            handler::create(&_storage, tiny_stl::forward<F>(f));
+            _invoke = &handler::template invoke<R, Args...>;
+            _ops = handler::template ops<Copyable>();
+        }
+
+        __function_base(const __function_base&) = delete;
+        __function_base& operator=(const __function_base&) = delete;
+
+        /**
+         * @brief 析构函数，销毁存放的可调用对象
+         */
+        ~__function_base() {
+            reset();
+        }
+
+        /**
+         * @brief 判断是否存放了可调用对象
+         * @return 不为空时返回 true
+         */
+        explicit operator bool() const noexcept {
+            return _ops != nullptr;
+        }
+
+        /**
+         * @brief 调用存放的可调用对象
+         * @param args 参数
+         * @return 调用的结果
+         * @throws std::bad_function_call 包装器为空时
+         */
+        R operator()(Args... args) const {
+            return _invoke(&_storage, tiny_stl::forward<Args>(args)...);
+        }
+
+        friend bool operator==(const __function_base& f, std::nullptr_t) noexcept { return !f; }
+        friend bool operator==(std::nullptr_t, const __function_base& f) noexcept { return !f; }
+        friend bool operator!=(const __function_base& f, std::nullptr_t) noexcept { return static_cast<bool>(f); }
+        friend bool operator!=(std::nullptr_t, const __function_base& f) noexcept { return static_cast<bool>(f); }
+
+    protected:
+        /**
+         * @brief 销毁存放的可调用对象，变为空
+         */
+        void reset() noexcept {
+            if (_ops) {
+                _ops->destroy(&_storage);
+                _invoke = &__function_empty_invoke<R, Args...>;
+                _ops = nullptr;
+            }
+        }
+
+        /**
+         * @brief 把 other 中的可调用对象移动到当前为空的包装器中，other 随后为空
+         */
+        void move_from(__function_base& other) noexcept {
+            if (other._ops) {
+                other._ops->move(&_storage, &other._storage);
+                _invoke = other._invoke;
+                _ops = other._ops;
+                other._invoke = &__function_empty_invoke<R, Args...>;
+                other._ops = nullptr;
+            }
+        }
+
+        /**
+         * @brief 把 other 中的可调用对象复制到当前为空的包装器中
+         */
+        void copy_from(const __function_base& other) {
+            if (other._ops) {
+                other._ops->copy(&_storage, &other._storage);
+                _invoke = other._invoke;
+                _ops = other._ops;
+            }
+        }
+
+        /**
+         * @brief 交换两个包装器存放的可调用对象
+         */
+        void swap_with(__function_base& other) noexcept {
+            if (this != &other) {
+                __function_base tmp;
+                tmp.move_from(other);
+                other.move_from(*this);
+                move_from(tmp);
+            }
+        }
+
+    private:
+        mutable __function_storage<BufferSize> _storage; /**< 可调用对象的存储，调用 const 包装器时也可以调用非 const 的 operator() */
+        R (*_invoke)(void*, Args&&...); /**< 调用函数 */
+        const __function_ops* _ops; /**< 管理函数表，为空表示包装器为空 */
+    };
+
+    /**
+     * @class function
+     * @brief 可复制的类型擦除可调用对象包装器，类似于 `std::function`，带有可配置的内联缓冲区。
+     *
+     * 大小不超过 BufferSize、移动构造不抛出异常的可调用对象存放在对象内部，不分配堆内存；
+     * 更大的对象分配在堆上。调用空的 `function` 会抛出 `std::bad_function_call`。
+     *
+     * @tparam Signature 函数签名 `R(Args...)`
+     * @tparam BufferSize 内联缓冲区的大小，默认为 4 个指针
+     */
+    template <typename Signature, size_t BufferSize = __function_buffer_size>
+    class function;
+
+    template <typename R, typename... Args, size_t BufferSize>
+    class function<R(Args...), BufferSize> : public __function_base<true, BufferSize, R, Args...> {
+        using base = __function_base<true, BufferSize, R, Args...>;
+
+    public:
+        using base::base;
+
+        /**
+         * @brief 拷贝构造函数，复制存放的可调用对象
+         */
+        function(const function& other) : base() {
+            this->copy_from(other);
+        }
+
+        /**
+         * @brief 移动构造函数，other 随后为空
+         */
+        function(function&& other) noexcept : base() {
+            this->move_from(other);
+        }
+
+        function& operator=(const function& other) {
+            function(other).swap(*this);
+            return *this;
+        }
+
+        function& operator=(function&& other) noexcept {
+            if (this != &other) {
+                this->reset();
+                this->move_from(other);
+            }
+            return *this;
+        }
+
+        function& operator=(std::nullptr_t) noexcept {
+            this->reset();
+            return *this;
+        }
+
+        template <typename F, typename = std::enable_if_t<base::template accepts<F>>>
+        function& operator=(F&& f) {
+            function(tiny_stl::forward<F>(f)).swap(*this);
+            return *this;
+        }
+
+        /**
+         * @brief 交换两个包装器存放的可调用对象
+         */
+        void swap(function& other) noexcept {
+            this->swap_with(other);
+        }
+
+        friend void swap(function& lhs, function& rhs) noexcept {
+            lhs.swap(rhs);
+        }
+    };
+
+    /**
+     * @class unique_function
+     * @brief 只能移动的类型擦除可调用对象包装器，可以存放只能移动的可调用对象（例如捕获了 `unique_ptr` 的 lambda）。
+     *
+     * 除了不能复制之外与 `function` 相同，也不要求存放的可调用对象可复制。
+     *
+     * @tparam Signature 函数签名 `R(Args...)`
+     * @tparam BufferSize 内联缓冲区的大小，默认为 4 个指针
+     */
+    template <typename Signature, size_t BufferSize = __function_buffer_size>
+    class unique_function;
+
+    template <typename R, typename... Args, size_t BufferSize>
+    class unique_function<R(Args...), BufferSize> : public __function_base<false, BufferSize, R, Args...> {
+        using base = __function_base<false, BufferSize, R, Args...>;
+
+    public:
+        using base::base;
+
+        /**
+         * @brief 移动构造函数，other 随后为空
+         */
+        unique_function(unique_function&& other) noexcept : base() {
+            this->move_from(other);
+        }
+
+        unique_function& operator=(unique_function&& other) noexcept {
+            if (this != &other) {
+                this->reset();
+                this->move_from(other);
+            }
+            return *this;
+        }
+
+        unique_function& operator=(std::nullptr_t) noexcept {
+            this->reset();
+            return *this;
+        }
+
+        template <typename F, typename = std::enable_if_t<base::template accepts<F>>>
+        unique_function& operator=(F&& f) {
+            unique_function(tiny_stl::forward<F>(f)).swap(*this);
+            return *this;
+        }
+
+        /**
+         * @brief 交换两个包装器存放的可调用对象
+         */
+        void swap(unique_function& other) noexcept {
+            this->swap_with(other);
+        }
+
+        friend void swap(unique_function& lhs, unique_function& rhs) noexcept {
+            lhs.swap(rhs);
+        }
+    };
+
+    /**
+     * @class function_ref
+     * @brief 不拥有对象的可调用对象引用，只保存对象的地址与调用函数两个指针，构造与复制都不分配内存。
+     *
+     * 被引用的可调用对象必须比 `function_ref` 活得更久，适合作为只在调用期间使用的回调参数。
+     * 函数指针按值保存，因此可以直接由函数名或临时的函数指针构造。
+     *
+     * @tparam Signature 函数签名 `R(Args...)`
+     */
+    template <typename Signature>
+    class function_ref;
+
+    template <typename R, typename... Args>
+    class function_ref<R(Args...)> {
+        /**
+         * @brief 被引用的对象的地址，或函数指针
+         */
+        union target {
+            void* object;
+            void (*function)();
+        };
+
+    public:
+        /**
+         * @brief 引用可调用对象 f
+         * @param f 可调用对象或函数
+         */
+        template <typename F, typename D = std::decay_t<F>,
+                  typename = std::enable_if_t<!std::is_same<D, function_ref>::value && std::is_invocable_r<R, F&, Args...>::value>>
+        function_ref(F&& f) noexcept {
+            if constexpr (std::is_pointer<D>::value && std::is_function<std::remove_pointer_t<D>>::value) {
+                _target.function = reinterpret_cast<void (*)()>(static_cast<D>(f));
+                _invoke = [](target t, Args&&... args) -> R {
+                    return static_cast<R>(std::invoke(reinterpret_cast<D>(t.function), tiny_stl::forward<Args>(args)...));
+                };
+            } else {
+                using object_type = std::remove_reference_t<F>;
+                _target.object = const_cast<void*>(static_cast<const void*>(std::addressof(f)));
+                _invoke = [](target t, Args&&... args) -> R {
+                    return static_cast<R>(std::invoke(*static_cast<object_type*>(t.object), tiny_stl::forward<Args>(args)...));
+                };
+            }
+        }
+
+        /**
+         * @brief 调用被引用的可调用对象
+         * @param args 参数
+         * @return 调用的结果
+         */
+        R operator()(Args... args) const {
+            return _invoke(_target, tiny_stl::forward<Args>(args)...);
+        }
+
+    private:
+        target _target; /**< 被引用的对象 */
+        R (*_invoke)(target, Args&&...); /**< 调用函数 */
+    };
 }
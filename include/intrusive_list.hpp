@@ -0,0 +1,474 @@
+/**
+ * @file intrusive_list.hpp
+ * @brief 此文件定义了 tiny_stl 命名空间下的侵入式双向链表 `intrusive_list`。
+ *
+ * 元素类型通过继承 `intrusive_list_hook` 自带 prev/next 指针，链表本身只把这些钩子串起来，
+ * 因此插入和删除都不会分配内存，也不会复制或移动元素。
+ * splice、merge、sort、reverse 与 `list` 共用 `__list_transfer` 与 `__list_sort`。
+ */
+
+#pragma once
+
+#ifdef __GNUC__
+#   pragma GCC system_header
+#endif
+#if defined(_MSC_VER) && _MSC_VER >= 1920
+#   pragma system_header
+#endif
+
+#include <list.hpp>
+#include <iterator.hpp>
+#include <functional.hpp>
+#include <utility.hpp>
+#include <cassert>
+#include <cstddef>
+
+namespace tiny_stl {
+
+    /**
+     * @class intrusive_list_hook
+     * @brief 侵入式链表的钩子，元素类型通过继承它加入 `intrusive_list`。
+     *
+     * 钩子不可被复制：拷贝构造得到的钩子总是未链接的，赋值不改变钩子的链接状态，
+     * 因此复制元素不会破坏链表。同一个元素需要同时加入多个链表时，用不同的 Tag 继承多个钩子。
+     *
+     * @tparam Tag 用于区分同一元素上多个钩子的标签类型。
+     */
+    template <typename Tag = void>
+    class intrusive_list_hook {
+    public:
+        /**
+         * @brief 默认构造函数，钩子处于未链接状态。
+         */
+        intrusive_list_hook() noexcept : prev(nullptr), next(nullptr) { }
+
+        /**
+         * @brief 拷贝构造函数，新钩子处于未链接状态。
+         */
+        intrusive_list_hook(const intrusive_list_hook&) noexcept : prev(nullptr), next(nullptr) { }
+
+        /**
+         * @brief 赋值运算符，不改变钩子的链接状态。
+         * @return 引用自身。
+         */
+        intrusive_list_hook& operator=(const intrusive_list_hook&) noexcept { return *this; }
+
+        /**
+         * @brief 析构函数。元素被销毁前必须先从链表中删除。
+         */
+        ~intrusive_list_hook() {
+            assert(!is_linked() && "元素被销毁时仍在 intrusive_list 中");
+        }
+
+        /**
+         * @brief 判断钩子是否已经链接到某个链表中。
+         * @return 已链接时返回 `true`。
+         */
+        bool is_linked() const noexcept { return next != nullptr; }
+
+    private:
+        template <typename, typename> friend class intrusive_list;
+        template <typename, typename, typename, typename> friend struct __intrusive_list_iterator;
+        template <typename NodePtr> friend void __list_transfer(NodePtr, NodePtr, NodePtr) noexcept;
+        template <typename NodePtr, typename NodeCompare>
+        friend void __list_merge_chains(NodePtr, NodePtr, NodeCompare&, NodePtr&);
+        template <typename NodePtr> friend void __list_relink(NodePtr, NodePtr) noexcept;
+        template <typename NodePtr, typename NodeCompare> friend void __list_sort(NodePtr, NodeCompare);
+
+        intrusive_list_hook* prev; /**< 指向前一个钩子 */
+        intrusive_list_hook* next; /**< 指向后一个钩子，未链接时为 nullptr */
+    };
+
+    /**
+     * @brief 侵入式链表迭代器。
+     * @tparam T 元素类型。
+     * @tparam Tag 钩子的标签类型。
+     * @tparam Ref 引用类型。
+     * @tparam Ptr 指针类型。
+     */
+    template <typename T, typename Tag, typename Ref, typename Ptr>
+    struct __intrusive_list_iterator {
+        using hook_type = intrusive_list_hook<Tag>; /**< 钩子类型 */
+        using iterator = __intrusive_list_iterator<T, Tag, T&, T*>; /**< 迭代器类型的别名 */
+        using self = __intrusive_list_iterator<T, Tag, Ref, Ptr>; /**< 迭代器自身类型的别名 */
+
+        using iterator_category = bidirectional_iterator_tag; /**< 迭代器的类别 */
+        using value_type = T; /**< 元素类型 */
+        using difference_type = std::ptrdiff_t; /**< 差值类型 */
+        using pointer = Ptr; /**< 指针类型 */
+        using reference = Ref; /**< 引用类型 */
+
+        hook_type* node; /**< 指向当前元素的钩子 */
+
+        /**
+         * @brief 构造函数，用一个钩子指针初始化迭代器。
+         * @param x 指向钩子的指针。
+         */
+        __intrusive_list_iterator(hook_type* x) : node(x) {}
+
+        /**
+         * @brief 默认构造函数，将迭代器初始化为空。
+         */
+        __intrusive_list_iterator() : node(nullptr) {}
+
+        /**
+         * @brief 拷贝构造函数，也用于从非常量迭代器构造常量迭代器。
+         * @param x 另一个迭代器。
+         */
+        __intrusive_list_iterator(const iterator& x) : node(x.node) {}
+
+        bool operator==(const self& x) const { return node == x.node; }
+        bool operator!=(const self& x) const { return node != x.node; }
+
+        /**
+         * @brief 解引用操作符，由钩子转换回所属的元素。
+         * @return 元素的引用。
+         */
+        reference operator*() const { return static_cast<reference>(*node); }
+
+        pointer operator->() const { return &(operator*()); }
+
+        self& operator++() {
+            node = node->next;
+            return *this;
+        }
+
+        self operator++(int) {
+            self tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        self& operator--() {
+            node = node->prev;
+            return *this;
+        }
+
+        self operator--(int) {
+            self tmp = *this;
+            --*this;
+            return tmp;
+        }
+    };
+
+    /**
+     * @class intrusive_list
+     * @brief 侵入式双向链表。
+     *
+     * 链表不拥有元素，只链接元素中的钩子：插入、删除都是 O(1) 且不分配内存，
+     * 仅凭元素的引用即可在 O(1) 时间内把它删除。哨兵钩子直接存放在链表对象内部。
+     * 元素的生命周期由使用者管理，元素在链表中时其地址不能改变。
+     *
+     * @tparam T 元素类型，必须继承 `intrusive_list_hook<Tag>`。
+     * @tparam Tag 钩子的标签类型，默认为 void。
+     */
+    template <typename T, typename Tag = void>
+    class intrusive_list {
+    public:
+        using value_type = T; /**< 元素类型 */
+        using pointer = T*; /**< 指针类型 */
+        using const_pointer = const T*; /**< 常量指针类型 */
+        using reference = T&; /**< 引用类型 */
+        using const_reference = const T&; /**< 常量引用类型 */
+        using size_type = size_t; /**< 大小类型 */
+        using difference_type = std::ptrdiff_t; /**< 差值类型 */
+        using hook_type = intrusive_list_hook<Tag>; /**< 钩子类型 */
+        using iterator = __intrusive_list_iterator<T, Tag, T&, T*>; /**< 迭代器类型 */
+        using const_iterator = __intrusive_list_iterator<T, Tag, const T&, const T*>; /**< 常量迭代器类型 */
+
+        /**
+         * @brief 默认构造函数，创建一个空链表，不分配内存。
+         */
+        intrusive_list() noexcept : length(0) { reset_head(); }
+
+        intrusive_list(const intrusive_list&) = delete;
+        intrusive_list& operator=(const intrusive_list&) = delete;
+
+        /**
+         * @brief 移动构造函数，接管other中的全部元素。
+         * @param other 元素的来源，之后为空链表。
+         */
+        intrusive_list(intrusive_list&& other) noexcept : length(0) {
+            reset_head();
+            splice(end(), other);
+        }
+
+        /**
+         * @brief 移动赋值运算符，先解除自身的全部元素，再接管other中的全部元素。
+         * @param other 元素的来源，之后为空链表。
+         * @return 引用自身。
+         */
+        intrusive_list& operator=(intrusive_list&& other) noexcept {
+            if (this != &other) {
+                clear();
+                splice(end(), other);
+            }
+            return *this;
+        }
+
+        /**
+         * @brief 析构函数，解除全部元素的链接，但不销毁元素。
+         */
+        ~intrusive_list() {
+            clear();
+            head.prev = head.next = nullptr;
+        }
+
+        iterator begin() noexcept { return head.next; }
+        const_iterator begin() const noexcept { return const_cast<hook_type*>(head.next); }
+        iterator end() noexcept { return &head; }
+        const_iterator end() const noexcept { return const_cast<hook_type*>(&head); }
+
+        /**
+         * @brief 判断链表是否为空。
+         * @return 为空时返回 `true`。
+         */
+        bool empty() const noexcept { return head.next == &head; }
+
+        /**
+         * @brief 返回链表中元素的数量，复杂度为 O(1)。
+         * @return 元素的数量。
+         */
+        size_type size() const noexcept { return length; }
+
+        reference front() { return *begin(); }
+        const_reference front() const { return *begin(); }
+        reference back() { return *(--end()); }
+        const_reference back() const { return *(--end()); }
+
+        /**
+         * @brief 返回指向元素x的迭代器，复杂度为 O(1)。
+         * @param x 链表中的元素。
+         * @return 指向x的迭代器。
+         */
+        iterator iterator_to(reference x) noexcept { return static_cast<hook_type*>(&x); }
+
+        /**
+         * @brief 返回指向元素x的常量迭代器，复杂度为 O(1)。
+         * @param x 链表中的元素。
+         * @return 指向x的常量迭代器。
+         */
+        const_iterator iterator_to(const_reference x) const noexcept {
+            return const_cast<hook_type*>(static_cast<const hook_type*>(&x));
+        }
+
+        /**
+         * @brief 把元素x链接到pos之前。
+         * @param pos 插入位置。
+         * @param x 要插入的元素，不能已在某个链表中。
+         * @return 指向x的迭代器。
+         */
+        iterator insert(iterator pos, reference x) noexcept {
+            hook_type* h = static_cast<hook_type*>(&x);
+            assert(!h->is_linked() && "元素已在某个 intrusive_list 中");
+            hook_type* p = pos.node;
+            h->next = p;
+            h->prev = p->prev;
+            p->prev->next = h;
+            p->prev = h;
+            ++length;
+            return h;
+        }
+
+        void push_back(reference x) noexcept { insert(end(), x); }
+        void push_front(reference x) noexcept { insert(begin(), x); }
+        void pop_front() noexcept { erase(begin()); }
+        void pop_back() noexcept { erase(--end()); }
+
+        /**
+         * @brief 解除pos指向的元素的链接，不销毁元素。
+         * @param pos 要删除的元素的迭代器。
+         * @return 指向下一个元素的迭代器。
+         */
+        iterator erase(iterator pos) noexcept {
+            hook_type* h = pos.node;
+            hook_type* next = h->next;
+            h->prev->next = next;
+            next->prev = h->prev;
+            h->prev = h->next = nullptr;
+            --length;
+            return next;
+        }
+
+        /**
+         * @brief 解除[first, last)内全部元素的链接。
+         * @param first 起始迭代器。
+         * @param last 结束迭代器。
+         * @return last。
+         */
+        iterator erase(iterator first, iterator last) noexcept {
+            while (first != last) {
+                first = erase(first);
+            }
+            return last;
+        }
+
+        /**
+         * @brief 仅凭元素的引用解除它的链接，复杂度为 O(1)。
+         * @param x 链表中的元素。
+         */
+        void erase(reference x) noexcept { erase(iterator_to(x)); }
+
+        /**
+         * @brief 解除全部元素的链接，元素之后可以加入其他链表。
+         */
+        void clear() noexcept {
+            hook_type* cur = head.next;
+            while (cur != &head) {
+                hook_type* next = cur->next;
+                cur->prev = cur->next = nullptr;
+                cur = next;
+            }
+            reset_head();
+            length = 0;
+        }
+
+        /**
+         * @brief 交换两个链表的内容。
+         * @param other 要交换的链表。
+         */
+        void swap(intrusive_list& other) noexcept {
+            intrusive_list tmp(tiny_stl::move(other));
+            other.splice(other.end(), *this);
+            splice(end(), tmp);
+        }
+
+        /**
+         * @brief 友元函数，交换两个链表的内容。
+         * @param lhs 第一个链表。
+         * @param rhs 第二个链表。
+         */
+        friend void swap(intrusive_list& lhs, intrusive_list& rhs) noexcept { lhs.swap(rhs); }
+
+        /**
+         * @brief 将链表x的所有元素移动到pos之前，x变为空。
+         * @param pos 目标位置的迭代器。
+         * @param x 要移动元素的链表，不能是自身。
+         */
+        void splice(iterator pos, intrusive_list& x) noexcept {
+            if (!x.empty()) {
+                __list_transfer(pos.node, x.head.next, &x.head);
+                length += x.length;
+                x.length = 0;
+            }
+        }
+
+        /**
+         * @brief 将链表x中迭代器i指向的元素移动到pos之前。
+         * @param pos 目标位置的迭代器。
+         * @param x 元素所在的链表，可以是自身。
+         * @param i 要移动元素的迭代器。
+         */
+        void splice(iterator pos, intrusive_list& x, iterator i) noexcept {
+            iterator j = i;
+            ++j;
+            if (pos == i || pos == j) return;
+            __list_transfer(pos.node, i.node, j.node);
+            ++length;
+            --x.length;
+        }
+
+        /**
+         * @brief 将链表x中[first, last)区间的元素移动到pos之前。
+         * x不是自身时需要遍历区间以更新两者的大小，复杂度与区间长度成线性。
+         * @param pos 目标位置的迭代器，不能位于[first, last)内。
+         * @param x 元素所在的链表，可以是自身。
+         * @param first 移动范围的起始迭代器。
+         * @param last 移动范围的结束迭代器。
+         */
+        void splice(iterator pos, intrusive_list& x, iterator first, iterator last) noexcept {
+            if (first == last || pos == last) return;
+            if (&x != this) {
+                size_type n = static_cast<size_type>(tiny_stl::distance(first, last));
+                length += n;
+                x.length -= n;
+            }
+            __list_transfer(pos.node, first.node, last.node);
+        }
+
+        /**
+         * @brief 合并两个有序链表，x之后为空。
+         * @tparam Pred 比较函数类型。
+         * @param x 要合并的链表。
+         * @param comp 比较函数。
+         */
+        template <typename Pred>
+        void merge(intrusive_list& x, Pred comp) {
+            if (&x == this) return;
+            iterator first1 = begin();
+            iterator last1 = end();
+            iterator first2 = x.begin();
+            iterator last2 = x.end();
+
+            while (first1 != last1 && first2 != last2) {
+                if (comp(*first2, *first1)) {
+                    iterator next = first2;
+                    ++next;
+                    __list_transfer(first1.node, first2.node, next.node);
+                    first2 = next;
+                } else {
+                    ++first1;
+                }
+            }
+
+            // 将x中剩余元素全部移到末尾
+            if (first2 != last2) {
+                __list_transfer(last1.node, first2.node, last2.node);
+            }
+            length += x.length;
+            x.length = 0;
+        }
+
+        /**
+         * @brief 按升序合并两个有序链表。
+         * @param x 要合并的链表。
+         */
+        void merge(intrusive_list& x) { merge(x, less<T>()); }
+
+        /**
+         * @brief 反转链表。
+         */
+        void reverse() noexcept {
+            if (head.next == &head || head.next->next == &head) {
+                return;
+            }
+            iterator first = begin();
+            ++first;
+            while (first != end()) {
+                iterator old = first;
+                ++first;
+                __list_transfer(head.next, old.node, first.node);
+            }
+        }
+
+        /**
+         * @brief 对链表进行稳定排序，只重新链接钩子，不分配内存，也不移动任何元素。
+         * @tparam Pred 比较函数类型。
+         * @param comp 比较函数。
+         */
+        template <typename Pred>
+        void sort(Pred comp) {
+            __list_sort(&head, [&comp](hook_type* a, hook_type* b) {
+                return comp(static_cast<const T&>(*a), static_cast<const T&>(*b));
+            });
+        }
+
+        /**
+         * @brief 按升序对链表进行稳定排序。
+         */
+        void sort() { sort(less<T>()); }
+
+    private:
+        hook_type head; /**< 哨兵钩子，作为链表的头和尾 */
+        size_type length; /**< 链表中元素的数量 */
+
+        /**
+         * @brief 把哨兵钩子重置为空链表的状态。
+         */
+        void reset_head() noexcept {
+            head.prev = &head;
+            head.next = &head;
+        }
+    };
+
+}
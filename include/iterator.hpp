@@ -15,6 +15,8 @@
 #endif
 
 #include <cstddef> // 包含 ptrdiff_t
+#include <iterator> // 包含标准库的迭代器标签
+#include <type_traits>
 #include "utility.hpp" // 包含 remove_reference, forward, move, swap 等
 
 namespace tiny_stl {
@@ -23,36 +25,37 @@ namespace tiny_stl {
      * @brief 输入迭代器标签，用于标记只支持单向、单次遍历的迭代器。
      * 
      * 输入迭代器可以用于读取元素，但不保证可以多次读取相同的元素，也不支持随机访问。
+     * 各迭代器标签与标准库中的标签是同一类型，因此标准库迭代器与本库迭代器可以互相使用对方的算法。
      */
-    struct input_iterator_tag {};
+    using input_iterator_tag = std::input_iterator_tag;
 
     /**
      * @brief 输出迭代器标签，用于标记只支持单向、单次写入的迭代器。
      * 
      * 输出迭代器可以用于写入元素，但不保证可以多次写入相同的位置，也不支持随机访问。
      */
-    struct output_iterator_tag {};
+    using output_iterator_tag = std::output_iterator_tag;
 
     /**
      * @brief 前向迭代器标签，继承自输入迭代器标签，用于标记支持单向、多次遍历的迭代器。
      * 
      * 前向迭代器可以用于读取和写入元素，并且可以多次遍历相同的元素，但不支持随机访问。
      */
-    struct forward_iterator_tag : public input_iterator_tag {};
+    using forward_iterator_tag = std::forward_iterator_tag;
 
     /**
      * @brief 双向迭代器标签，继承自前向迭代器标签，用于标记支持双向遍历的迭代器。
      * 
      * 双向迭代器可以用于读取和写入元素，支持向前和向后遍历，并且可以多次遍历相同的元素，但不支持随机访问。
      */
-    struct bidirectional_iterator_tag : public forward_iterator_tag {};
+    using bidirectional_iterator_tag = std::bidirectional_iterator_tag;
 
     /**
      * @brief 随机访问迭代器标签，继承自双向迭代器标签，用于标记支持随机访问的迭代器。
      * 
      * 随机访问迭代器可以用于读取和写入元素，支持向前和向后遍历，并且可以在常数时间内访问任意位置的元素。
      */
-    struct random_access_iterator_tag : public bidirectional_iterator_tag {};
+    using random_access_iterator_tag = std::random_access_iterator_tag;
 
     /**
      * @class iterator_traits
@@ -150,6 +153,44 @@ namespace tiny_stl {
         using reference = const T&;
     };
 
+    /**
+     * @struct __iterator_category_of
+     * @brief 取得迭代器的类别；对于不是迭代器的类型（例如整数）不定义 `type`，可用于 SFINAE。
+     * @tparam T 要检查的类型。
+     */
+    template <typename T, typename = void>
+    struct __iterator_category_of { };
+
+    template <typename T>
+    struct __iterator_category_of<T*, void> {
+        using type = random_access_iterator_tag;
+    };
+
+    template <typename T>
+    struct __iterator_category_of<T, std::void_t<typename T::iterator_category>> {
+        using type = typename T::iterator_category;
+    };
+
+    /**
+     * @struct __is_iterator_of
+     * @brief 判断类型是否为类别不低于 Tag 的迭代器。
+     * @tparam T 要检查的类型。
+     * @tparam Tag 要求的最低迭代器类别。
+     */
+    template <typename T, typename Tag, typename = void>
+    struct __is_iterator_of : std::false_type { };
+
+    template <typename T, typename Tag>
+    struct __is_iterator_of<T, Tag, std::void_t<typename __iterator_category_of<T>::type>>
+        : std::is_convertible<typename __iterator_category_of<T>::type, Tag> { };
+
+    /**
+     * @brief 仅当 T 是输入迭代器时有效的类型，用于把迭代器范围重载与计数重载区分开。
+     * @tparam T 要检查的类型。
+     */
+    template <typename T>
+    using __enable_if_input_iterator_t = std::enable_if_t<__is_iterator_of<T, input_iterator_tag>::value, int>;
+
     /**
      * @class iterator
      * @brief 迭代器基类模板，用于简化自定义迭代器的定义。
@@ -202,7 +243,7 @@ namespace tiny_stl {
      * @return 两个迭代器之间的距离，类型为 `iterator_traits<InputIterator>::difference_type`。
      */
     template <typename InputIterator>
-    auto distance_aux(
+    constexpr auto distance_aux(
         InputIterator first,
         InputIterator last,
         input_iterator_tag
@@ -228,7 +269,7 @@ namespace tiny_stl {
      * @return 两个迭代器之间的距离，类型为 `iterator_traits<RandomAccessIterator>::difference_type`。
      */
     template <typename RandomAccessIterator>
-    auto distance_aux(
+    constexpr auto distance_aux(
         RandomAccessIterator first,
         RandomAccessIterator last,
         random_access_iterator_tag
@@ -248,7 +289,7 @@ namespace tiny_stl {
      * @return 两个迭代器之间的距离，类型为 `iterator_traits<InputIterator>::difference_type`。
      */
     template <typename InputIterator>
-    auto distance(
+    constexpr auto distance(
         InputIterator first,
         InputIterator last
     ) 
@@ -269,8 +310,8 @@ namespace tiny_stl {
      * @param tag 迭代器标签，用于标记迭代器的类别。
      */
     template <typename InputIterator, typename Distance>
-    void advance_aux(
-        InputIterator it,
+    constexpr void advance_aux(
+        InputIterator& it,
         Distance n,
         input_iterator_tag
     ) {
@@ -291,8 +332,8 @@ namespace tiny_stl {
      * @param tag 迭代器标签，用于标记迭代器的类别。
      */
     template <class BidirectionalIterator, typename Distance>
-    void advance_aux(
-        BidirectionalIterator it,
+    constexpr void advance_aux(
+        BidirectionalIterator& it,
         Distance n,
         bidirectional_iterator_tag
     ) {
@@ -319,8 +360,8 @@ namespace tiny_stl {
      * @param tag 迭代器标签，用于标记迭代器的类别。
      */
     template <class RandomAccessIterator, typename Distance>
-    void advance_aux(
-        RandomAccessIterator it,
+    constexpr void advance_aux(
+        RandomAccessIterator& it,
         Distance n,
         random_access_iterator_tag
     ) {
@@ -338,14 +379,47 @@ namespace tiny_stl {
      * @param n 要移动的距离。
      */
     template <typename InputIterator, typename Distance>
-    void advance(
-        InputIterator it,
+    constexpr void advance(
+        InputIterator& it,
         Distance n
     ) {
         typename iterator_traits<InputIterator>::iterator_category category;
         advance_aux(it, n, category);
     }
 
+    /**
+     * @class __repeat_iterator
+     * @brief 把同一个值重复 n 次的前向迭代器，供容器把“插入 n 个 value”复用到迭代器范围的实现上。
+     * @tparam T 值的类型。
+     */
+    template <typename T>
+    class __repeat_iterator {
+    public:
+        using iterator_category = forward_iterator_tag; /**< 迭代器类别 */
+        using value_type = T; /**< 值类型 */
+        using difference_type = ptrdiff_t; /**< 差值类型 */
+        using pointer = const T*; /**< 指针类型 */
+        using reference = const T&; /**< 引用类型 */
+
+        /**
+         * @brief 构造函数。
+         * @param value 要重复的值。
+         * @param index 当前的位置编号。
+         */
+        __repeat_iterator(const T& value, difference_type index) : value_(&value), index_(index) { }
+
+        reference operator*() const { return *value_; }
+        pointer operator->() const { return value_; }
+        __repeat_iterator& operator++() { ++index_; return *this; }
+        __repeat_iterator operator++(int) { __repeat_iterator tmp = *this; ++index_; return tmp; }
+        bool operator==(const __repeat_iterator& other) const { return index_ == other.index_; }
+        bool operator!=(const __repeat_iterator& other) const { return index_ != other.index_; }
+
+    private:
+        const T* value_; /**< 指向被重复的值 */
+        difference_type index_; /**< 当前的位置编号 */
+    };
+
     /**
      * @class reverse_iterator
      * @brief 反向迭代器适配器，用于将双向迭代器或随机访问迭代器的方向反转。
@@ -385,14 +459,14 @@ namespace tiny_stl {
         /**
          * @brief 默认构造函数，初始化底层迭代器为默认值。
          */
-        reverse_iterator() : current() {}
+        constexpr reverse_iterator() : current() {}
 
         /**
          * @brief 从正向迭代器构造反向迭代器。
          * 
          * @param x 正向迭代器。
          */
-        explicit reverse_iterator(Iterator x) : current(x) {}
+        constexpr explicit reverse_iterator(Iterator x) : current(x) {}
 
         /**
          * @brief 从其他反向迭代器构造反向迭代器。
@@ -401,7 +475,7 @@ namespace tiny_stl {
          * @param other 其他反向迭代器。
          */
         template <typename U>
-        reverse_iterator(const reverse_iterator<U>& other) 
+        constexpr reverse_iterator(const reverse_iterator<U>& other) 
             : current(other.base()) {}
 
         /**
@@ -409,14 +483,14 @@ namespace tiny_stl {
          * 
          * @return 底层迭代器。
          */
-        Iterator base() const { return current; }
+        constexpr Iterator base() const { return current; }
 
         /**
          * @brief 解引用操作符，返回反向迭代器指向的元素的引用。
          * 
          * @return 反向迭代器指向的元素的引用。
          */
-        reference operator*() const {
+        constexpr reference operator*() const {
             Iterator tmp = current;
             return *--tmp;
         }
@@ -426,7 +500,7 @@ namespace tiny_stl {
          * 
          * @return 反向迭代器指向的元素的指针。
          */
-        pointer operator->() const {
+        constexpr pointer operator->() const {
             return &(operator*());
         }
 
@@ -435,7 +509,7 @@ namespace tiny_stl {
          * 
          * @return 递增后的反向迭代器的引用。
          */
-        reverse_iterator& operator++() {
+        constexpr reverse_iterator& operator++() {
             --current;
             return *this;
         }
@@ -446,7 +520,7 @@ namespace tiny_stl {
          * @param 占位参数，用于区分前置和后置递增。
          * @return 递增前的反向迭代器的副本。
          */
-        reverse_iterator operator++(int) {
+        constexpr reverse_iterator operator++(int) {
             reverse_iterator tmp(*this);
             --current;
             return tmp;
@@ -457,7 +531,7 @@ namespace tiny_stl {
          * 
          * @return 递减后的反向迭代器的引用。
          */
-        reverse_iterator& operator--() {
+        constexpr reverse_iterator& operator--() {
             ++current;
             return *this;
         }
@@ -468,7 +542,7 @@ namespace tiny_stl {
          * @param 占位参数，用于区分前置和后置递减。
          * @return 递减前的反向迭代器的副本。
          */
-        reverse_iterator operator--(int) {
+        constexpr reverse_iterator operator--(int) {
             reverse_iterator tmp(*this);
             ++current;
             return tmp;
@@ -480,7 +554,7 @@ namespace tiny_stl {
          * @param n 要移动的距离。
          * @return 移动后的反向迭代器的副本。
          */
-        reverse_iterator operator+(difference_type n) const {
+        constexpr reverse_iterator operator+(difference_type n) const {
             return reverse_iterator(current - n);
         }
 
@@ -490,7 +564,7 @@ namespace tiny_stl {
          * @param n 要移动的距离。
          * @return 移动后的反向迭代器的引用。
          */
-        reverse_iterator& operator+=(difference_type n) {
+        constexpr reverse_iterator& operator+=(difference_type n) {
             current -= n;
             return *this;
         }
@@ -501,7 +575,7 @@ namespace tiny_stl {
          * @param n 要移动的距离。
          * @return 移动后的反向迭代器的副本。
          */
-        reverse_iterator operator-(difference_type n) const {
+        constexpr reverse_iterator operator-(difference_type n) const {
             return reverse_iterator(current + n);
         }
 
@@ -511,7 +585,7 @@ namespace tiny_stl {
          * @param n 要移动的距离。
          * @return 移动后的反向迭代器的引用。
          */
-        reverse_iterator& operator-=(difference_type n) {
+        constexpr reverse_iterator& operator-=(difference_type n) {
             current += n;
             return *this;
         }
@@ -522,34 +596,10 @@ namespace tiny_stl {
          * @param n 偏移的距离。
          * @return 偏移后的元素的引用。
          */
-        reference operator[](difference_type n) const {
+        constexpr reference operator[](difference_type n) const {
             return *(*this + n);
         }
 
-        /**
-         * @brief 相等比较操作符，比较两个反向迭代器是否相等。
-         * 
-         * @tparam It 另一个反向迭代器的底层迭代器类型。
-         * @param other 另一个反向迭代器。
-         * @return 如果两个反向迭代器相等，返回 `true`；否则返回 `false`。
-         */
-        template <typename It>
-        bool operator==(const reverse_iterator<It>& other) const {
-            return current == other.base();
-        }
-
-        /**
-         * @brief 不等比较操作符，比较两个反向迭代器是否不相等。
-         * 
-         * @tparam It 另一个反向迭代器的底层迭代器类型。
-         * @param other 另一个反向迭代器。
-         * @return 如果两个反向迭代器不相等，返回 `true`；否则返回 `false`。
-         */
-        template <typename It>
-        bool operator!=(const reverse_iterator<It>& other) const {
-            return !(*this == other);
-        }
-
         /**
          * @brief 小于比较操作符，比较两个反向迭代器的顺序。
          * 
@@ -558,7 +608,7 @@ namespace tiny_stl {
          * @return 如果当前反向迭代器小于另一个反向迭代器，返回 `true`；否则返回 `false`。
          */
         template <typename It>
-        bool operator<(const reverse_iterator<It>& other) const {
+        constexpr bool operator<(const reverse_iterator<It>& other) const {
             return current > other.base();
         }
 
@@ -570,7 +620,7 @@ namespace tiny_stl {
          * @return 如果当前反向迭代器小于等于另一个反向迭代器，返回 `true`；否则返回 `false`。
          */
         template <typename It>
-        bool operator<=(const reverse_iterator<It>& other) const {
+        constexpr bool operator<=(const reverse_iterator<It>& other) const {
             return !(other < *this);
         }
 
@@ -582,7 +632,7 @@ namespace tiny_stl {
          * @return 如果当前反向迭代器大于另一个反向迭代器，返回 `true`；否则返回 `false`。
          */
         template <typename It>
-        bool operator>(const reverse_iterator<It>& other) const {
+        constexpr bool operator>(const reverse_iterator<It>& other) const {
             return other < *this;
         }
 
@@ -594,7 +644,7 @@ namespace tiny_stl {
          * @return 如果当前反向迭代器大于等于另一个反向迭代器，返回 `true`；否则返回 `false`。
          */
         template <typename It>
-        bool operator>=(const reverse_iterator<It>& other) const {
+        constexpr bool operator>=(const reverse_iterator<It>& other) const {
             return !(*this < other);
         }
 
@@ -611,7 +661,7 @@ namespace tiny_stl {
      * @return 相加后的反向迭代器的副本。
      */
     template <typename Iterator>
-    reverse_iterator<Iterator> operator+(
+    constexpr reverse_iterator<Iterator> operator+(
         typename reverse_iterator<Iterator>::difference_type n,
         const reverse_iterator<Iterator>& it) {
         return it + n;
@@ -627,7 +677,7 @@ namespace tiny_stl {
      * @return 两个反向迭代器之间的距离，类型为 `decltype(rhs.base() - lhs.base())`。
      */
     template <typename Iterator1, typename Iterator2>
-    auto operator-(const reverse_iterator<Iterator1>& lhs,
+    constexpr auto operator-(const reverse_iterator<Iterator1>& lhs,
                 const reverse_iterator<Iterator2>& rhs)
         -> decltype(rhs.base() - lhs.base()) {
         return rhs.base() - lhs.base();
@@ -643,7 +693,7 @@ namespace tiny_stl {
      * @return 如果两个反向迭代器相等，返回 `true`；否则返回 `false`。
      */
     template <typename Iterator1, typename Iterator2>
-    bool operator==(const reverse_iterator<Iterator1>& lhs,
+    constexpr bool operator==(const reverse_iterator<Iterator1>& lhs,
                 const reverse_iterator<Iterator2>& rhs) {
         return lhs.base() == rhs.base();
     }
@@ -658,7 +708,7 @@ namespace tiny_stl {
      * @return 如果两个反向迭代器不相等，返回 `true`；否则返回 `false`。
      */
     template <typename Iterator1, typename Iterator2>
-    bool operator!=(const reverse_iterator<Iterator1>& lhs,
+    constexpr bool operator!=(const reverse_iterator<Iterator1>& lhs,
                 const reverse_iterator<Iterator2>& rhs) {
         return !(lhs == rhs);
     }
@@ -673,7 +723,7 @@ namespace tiny_stl {
      * @return 如果第一个反向迭代器小于第二个反向迭代器，返回 `true`；否则返回 `false`。
      */
     template <typename Iterator1, typename Iterator2>
-    bool operator<(const reverse_iterator<Iterator1>& lhs,
+    constexpr bool operator<(const reverse_iterator<Iterator1>& lhs,
                 const reverse_iterator<Iterator2>& rhs) {
         return lhs.base() > rhs.base();
     }
@@ -688,7 +738,7 @@ namespace tiny_stl {
      * @return 如果第一个反向迭代器小于等于第二个反向迭代器，返回 `true`；否则返回 `false`。
      */
     template <typename Iterator1, typename Iterator2>
-    bool operator<=(const reverse_iterator<Iterator1>& lhs,
+    constexpr bool operator<=(const reverse_iterator<Iterator1>& lhs,
                 const reverse_iterator<Iterator2>& rhs) {
         return !(rhs < lhs);
     }
@@ -703,7 +753,7 @@ namespace tiny_stl {
      * @return 如果第一个反向迭代器大于第二个反向迭代器，返回 `true`；否则返回 `false`。
      */
     template <typename Iterator1, typename Iterator2>
-    bool operator>(const reverse_iterator<Iterator1>& lhs,
+    constexpr bool operator>(const reverse_iterator<Iterator1>& lhs,
                 const reverse_iterator<Iterator2>& rhs) {
         return rhs < lhs;
     }
@@ -718,9 +768,72 @@ namespace tiny_stl {
      * @return 如果第一个反向迭代器大于等于第二个反向迭代器，返回 `true`；否则返回 `false`。
      */
     template <typename Iterator1, typename Iterator2>
-    bool operator>=(const reverse_iterator<Iterator1>& lhs,
+    constexpr bool operator>=(const reverse_iterator<Iterator1>& lhs,
                 const reverse_iterator<Iterator2>& rhs) {
         return !(lhs < rhs);
     }
 
+    /**
+     * @class move_iterator
+     * @brief 移动迭代器适配器，解引用时返回右值引用，使容器可以逐个移动而不是复制元素。
+     * @tparam Iterator 底层迭代器类型。
+     */
+    template <typename Iterator>
+    class move_iterator {
+    public:
+        using iterator_type = Iterator; /**< 底层迭代器类型 */
+        using iterator_category = typename iterator_traits<Iterator>::iterator_category; /**< 迭代器类别 */
+        using value_type = typename iterator_traits<Iterator>::value_type; /**< 值类型 */
+        using difference_type = typename iterator_traits<Iterator>::difference_type; /**< 差值类型 */
+        using pointer = Iterator; /**< 指针类型 */
+        using reference = value_type&&; /**< 引用类型 */
+
+        /**
+         * @brief 默认构造函数。
+         */
+        constexpr move_iterator() : current() {}
+
+        /**
+         * @brief 由底层迭代器构造移动迭代器。
+         * @param x 底层迭代器。
+         */
+        constexpr explicit move_iterator(Iterator x) : current(x) {}
+
+        /**
+         * @brief 获取底层迭代器。
+         * @return 底层迭代器。
+         */
+        constexpr Iterator base() const { return current; }
+
+        constexpr reference operator*() const { return static_cast<reference>(*current); }
+        constexpr pointer operator->() const { return current; }
+        constexpr reference operator[](difference_type n) const { return static_cast<reference>(current[n]); }
+        constexpr move_iterator& operator++() { ++current; return *this; }
+        constexpr move_iterator operator++(int) { move_iterator tmp = *this; ++current; return tmp; }
+        constexpr move_iterator& operator--() { --current; return *this; }
+        constexpr move_iterator operator--(int) { move_iterator tmp = *this; --current; return tmp; }
+        constexpr move_iterator& operator+=(difference_type n) { current += n; return *this; }
+        constexpr move_iterator& operator-=(difference_type n) { current -= n; return *this; }
+        constexpr move_iterator operator+(difference_type n) const { return move_iterator(current + n); }
+        constexpr move_iterator operator-(difference_type n) const { return move_iterator(current - n); }
+        constexpr difference_type operator-(const move_iterator& other) const { return current - other.current; }
+        constexpr bool operator==(const move_iterator& other) const { return current == other.current; }
+        constexpr bool operator!=(const move_iterator& other) const { return !(current == other.current); }
+        constexpr bool operator<(const move_iterator& other) const { return current < other.current; }
+
+    private:
+        Iterator current; /**< 底层迭代器 */
+    };
+
+    /**
+     * @brief 创建移动迭代器。
+     * @tparam Iterator 底层迭代器类型。
+     * @param it 底层迭代器。
+     * @return 包装了 `it` 的移动迭代器。
+     */
+    template <typename Iterator>
+    constexpr move_iterator<Iterator> make_move_iterator(Iterator it) {
+        return move_iterator<Iterator>(it);
+    }
+
 } // namespace tiny_stl
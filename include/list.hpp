@@ -15,6 +15,7 @@
 #endif
 
 #include <memory.hpp>
+#include <container_stats.hpp>
 #include <iterator.hpp>
 #include <functional.hpp>
 #include <initializer_list>
@@ -48,7 +49,7 @@ namespace tiny_stl {
         using const_iterator = __list_iterator<T, const T&, const T*>; /**< 常量迭代器类型的别名。 */
         using self = __list_iterator<T, Ref, Ptr>; /**< 迭代器自身类型的别名。 */
 
-        using iterator_category = std::bidirectional_iterator_tag; /**< 迭代器的类别。 */
+        using iterator_category = bidirectional_iterator_tag; /**< 迭代器的类别。 */
         using value_type = T; /**< 迭代器指向元素的值类型。 */
         using difference_type = std::ptrdiff_t; /**< 迭代器的差值类型，用于表示两个迭代器之间的距离。 */
         using pointer = Ptr; /**< 迭代器指向元素的指针类型。 */
@@ -140,12 +141,167 @@ namespace tiny_stl {
         }
     };
 
+    /**
+     * @brief 把节点区间[first, last)摘下并接到pos之前，其余节点保持不动。
+     *
+     * 只依赖节点的 prev/next 指针，`list` 与 `intrusive_list` 的 splice、merge、reverse 都建立在它之上。
+     * @tparam NodePtr 节点指针类型，节点需有 prev 与 next 成员。
+     * @param pos 目标位置的节点，不能位于[first, last)内。
+     * @param first 区间的第一个节点。
+     * @param last 区间之后的节点，不能与first相同。
+     */
+    template <typename NodePtr>
+    void __list_transfer(NodePtr pos, NodePtr first, NodePtr last) noexcept {
+        NodePtr l = last->prev; // 移动区域的最后一个节点
+
+        // 从原位置断开 [first, last)
+        first->prev->next = last;
+        last->prev = first->prev;
+
+        // 插入到pos之前
+        l->next = pos;
+        first->prev = pos->prev;
+        pos->prev->next = first;
+        pos->prev = l;
+    }
+
+    /**
+     * @brief 合并两条以 nullptr 结尾的有序单向链，相等的节点中a的排在前面。
+     * 合并结果随合并过程逐步写入 out；comp 抛出异常时，out 是包含 a、b 全部节点的一条链（顺序未指定）。
+     * @tparam NodePtr 节点指针类型。
+     * @tparam NodeCompare 节点比较函数类型，接受两个节点指针。
+     * @param a 第一条链，不能为空。
+     * @param b 第二条链，不能为空。
+     * @param comp 节点比较函数。
+     * @param out 合并后的链的首节点。
+     */
+    template <typename NodePtr, typename NodeCompare>
+    void __list_merge_chains(NodePtr a, NodePtr b, NodeCompare& comp, NodePtr& out) {
+        out = nullptr;
+        NodePtr* tail = &out;
+        try {
+            while (a && b) {
+                if (comp(b, a)) {
+                    *tail = b;
+                    b = b->next;
+                } else {
+                    *tail = a;
+                    a = a->next;
+                }
+                tail = &(*tail)->next;
+            }
+        } catch (...) {
+            *tail = a;
+            while (*tail) {
+                tail = &(*tail)->next;
+            }
+            *tail = b;
+            throw;
+        }
+        *tail = a ? a : b;
+    }
+
+    /**
+     * @brief 把以 nullptr 结尾的单向链 chain 按顺序重新链接为以 head 为哨兵的环形双向链表。
+     * @tparam NodePtr 节点指针类型。
+     * @param head 哨兵节点。
+     * @param chain 单向链的首节点，可以为空。
+     */
+    template <typename NodePtr>
+    void __list_relink(NodePtr head, NodePtr chain) noexcept {
+        NodePtr prev = head;
+        for (NodePtr cur = chain; cur; cur = cur->next) {
+            cur->prev = prev;
+            prev->next = cur;
+            prev = cur;
+        }
+        prev->next = head;
+        head->prev = prev;
+    }
+
+    /**
+     * @brief 对以head为哨兵的环形双向链表进行稳定排序。
+     *
+     * 自底向上的归并排序：把节点拆成以 nullptr 结尾的单向链，在栈上的 64 个槽中
+     * 按二进制进位的方式合并长度为 2 的幂的有序段，最后重建 prev 指针。
+     * 只重新链接节点，不分配内存，也不构造或移动任何元素。
+     * comp 抛出异常时，所有节点都被重新链接回链表（顺序未指定），然后重新抛出异常。
+     * @tparam NodePtr 节点指针类型。
+     * @tparam NodeCompare 节点比较函数类型，接受两个节点指针。
+     * @param head 哨兵节点。
+     * @param comp 节点比较函数。
+     */
+    template <typename NodePtr, typename NodeCompare>
+    void __list_sort(NodePtr head, NodeCompare comp) {
+        // 空链表或只有一个元素时无需排序
+        if (head->next == head || head->next->next == head) return;
+
+        NodePtr bins[64] = {}; // bins[i] 为空或长度为 2^i 的有序单向链
+        int fill = 0;          // 当前使用的槽数
+        NodePtr rest = head->next;
+        NodePtr carry = nullptr; // 正在合并的链，不在 bins 与 rest 中
+        head->prev->next = nullptr;
+
+        try {
+            while (rest) {
+                carry = rest;
+                rest = rest->next;
+                carry->next = nullptr;
+
+                int i = 0;
+                for (; i < fill && bins[i]; ++i) {
+                    // bins[i] 中的元素更早出现，放在左侧以保持稳定
+                    NodePtr left = bins[i];
+                    NodePtr right = carry;
+                    bins[i] = nullptr;
+                    __list_merge_chains(left, right, comp, carry);
+                }
+                bins[i] = carry;
+                carry = nullptr;
+                if (i == fill) ++fill;
+            }
+
+            for (int i = 0; i < fill; ++i) {
+                if (bins[i]) {
+                    NodePtr left = bins[i];
+                    bins[i] = nullptr;
+                    if (carry) {
+                        NodePtr right = carry;
+                        __list_merge_chains(left, right, comp, carry);
+                    } else {
+                        carry = left;
+                    }
+                }
+            }
+        } catch (...) {
+            // 把正在合并的链、各个槽与尚未处理的节点连成一条链，恢复为合法的链表
+            NodePtr all = nullptr;
+            NodePtr* tail = &all;
+            auto append = [&tail](NodePtr chain) noexcept {
+                *tail = chain;
+                while (*tail) {
+                    tail = &(*tail)->next;
+                }
+            };
+            append(carry);
+            for (int i = 0; i < fill; ++i) {
+                append(bins[i]);
+            }
+            append(rest);
+            __list_relink(head, all);
+            throw;
+        }
+
+        __list_relink(head, carry);
+    }
+
     /**
      * @brief 双向链表类。
      *
      * 该类实现了一个双向链表，提供了基本的链表操作，如插入、删除、合并、反转和排序等功能。
      * @tparam T 链表节点存储的值的类型。
-     * @tparam Alloc 节点分配器类型，默认为 `allocator<__list_node<T>>`。
+     * @tparam Alloc 分配器类型，默认为 `allocator<__list_node<T>>`；链表通过 `rebind` 得到节点分配器，
+     * 因此也可以传入 `allocator<T>`、`pool_allocator<T>` 等以元素类型实例化的分配器。
      */
     template <typename T, typename Alloc = allocator<__list_node<T>>>
     class list {
@@ -159,25 +315,35 @@ namespace tiny_stl {
         using difference_type = std::ptrdiff_t; /**< 差值类型。 */
         using iterator = __list_iterator<T, T&, T*>; /**< 迭代器类型。 */
         using const_iterator = __list_iterator<T, const T&, const T*>; /**< 常量迭代器类型。 */
+        using allocator_type = Alloc; /**< 分配器类型。 */
     protected:
-        using node_allocator = Alloc; /**< 节点分配器类型。 */
+        using node_allocator = typename Alloc::template rebind<__list_node<T>>::other; /**< 节点分配器类型。 */
         using node_type = __list_node<T>; /**< 节点类型。 */
         using node_pointer = node_type*; /**< 节点指针类型。 */
 
         node_pointer node;  /**< 指向一个空白节点，作为链表的头和尾。 */
+        size_type length; /**< 链表中节点的数量（不含空白节点）。 */
         node_allocator alloc; /**< 节点分配器对象。 */
+        using stats_hooks = __stats_hooks<list>; /**< 统计钩子，见 container_stats.hpp。 */
 
         /**
          * @brief 分配一个新节点。
          * @return 指向新分配节点的指针。
          */
-        node_pointer get_node() { return alloc.allocate(1); }
+        node_pointer get_node() {
+            node_pointer p = alloc.allocate(1);
+            stats_hooks::on_allocate(sizeof(node_type));
+            return p;
+        }
 
         /**
          * @brief 释放一个节点。
          * @param p 指向要释放节点的指针。
          */
-        void put_node(node_pointer p) { alloc.deallocate(p, 1); }
+        void put_node(node_pointer p) {
+            stats_hooks::on_deallocate(sizeof(node_type));
+            alloc.deallocate(p, 1);
+        }
 
         /**
          * @brief 构造一个新节点。
@@ -188,6 +354,7 @@ namespace tiny_stl {
             node_pointer p = get_node();
             try {
                 alloc.construct(p, node_type{nullptr, nullptr, x});
+                stats_hooks::on_copies(1);
             } catch (...) {
                 put_node(p);
                 throw;
@@ -203,20 +370,7 @@ namespace tiny_stl {
          */
         void transfer(iterator pos, iterator first, iterator last) {
             if (pos == last || first == last) return; // 无需移动的情况
-            
-            node_pointer f = first.node;
-            node_pointer l = last.node->prev; // 移动区域的最后一个节点
-            
-            // 从原位置断开 [first, last)
-            f->prev->next = l->next;
-            l->next->prev = f->prev;
-            
-            // 插入到pos之前
-            node_pointer p = pos.node;
-            l->next = p;
-            f->prev = p->prev;
-            p->prev->next = f;
-            p->prev = l;
+            __list_transfer(pos.node, first.node, last.node);
         }
 
         /**
@@ -239,45 +393,50 @@ namespace tiny_stl {
             new_node->prev = pos->prev;
             pos->prev->next = new_node;
             pos->prev = new_node;
+            ++length;
+        }
+
+        /**
+         * @brief 把[first, last)内的元素依次追加到链表末尾。出现异常时清空链表。
+         * @tparam InputIterator 输入迭代器类型。
+         * @param first 输入范围的起始迭代器。
+         * @param last 输入范围的结束迭代器。
+         */
+        template <class InputIterator>
+        void append(InputIterator first, InputIterator last) {
+            try {
+                for (; first != last; ++first) {
+                    insert_aux(node, *first);
+                }
+            } catch (...) {
+                clear();
+                throw;
+            }
         }
 
     public:
         /**
          * @brief 默认构造函数，初始化一个空链表。
          */
-        list() { empty_initialize(); }
+        list() : list(allocator_type()) { }
+
+        /**
+         * @brief 构造函数，初始化一个使用指定分配器的空链表。
+         * @param a 分配器。
+         */
+        explicit list(const allocator_type& a) : alloc(a) { empty_initialize(); }
 
         /**
          * @brief 构造函数，创建一个包含n个值为v的节点的链表。
          * @param n 节点数量。
          * @param v 节点存储的值，默认为值类型的默认构造值。
+         * @param a 分配器，默认为 `allocator_type()`。
          */
-        list(size_type n, const value_type& v = value_type{}) {
+        list(size_type n, const value_type& v = value_type{}, const allocator_type& a = allocator_type())
+            : alloc(a) {
             empty_initialize(); // 初始化空链表结构
-            
-            if (n == 0) {
-                return;
-            }
-            
-            node_pointer current = node; // 从哨兵节点开始
-            
-            try {
-                // 创建n个节点并连接
-                for (size_type i = 0; i < n; ++i) {
-                    node_pointer new_node = create_node(v);
-                    
-                    // 插入到current之后
-                    new_node->prev = current;
-                    new_node->next = current->next;
-                    current->next->prev = new_node;
-                    current->next = new_node;
-                    
-                    current = new_node; // 移动到新节点
-                }
-            } catch (...) {
-                clear(); // 异常发生时清理已分配的节点
-                throw;
-            }
+            append(__repeat_iterator<value_type>(v, 0),
+                   __repeat_iterator<value_type>(v, static_cast<difference_type>(n)));
         }
 
         /**
@@ -285,41 +444,39 @@ namespace tiny_stl {
          * @tparam InputIterator 输入迭代器类型。
          * @param first 输入范围的起始迭代器。
          * @param last 输入范围的结束迭代器。
+         * @param a 分配器，默认为 `allocator_type()`。
          */
-        template <class InputIterator>
-        list(InputIterator first, InputIterator last) {
+        template <class InputIterator, __enable_if_input_iterator_t<InputIterator> = 0>
+        list(InputIterator first, InputIterator last, const allocator_type& a = allocator_type())
+            : alloc(a) {
             empty_initialize(); // 初始化空链表结构
-            
-            if (first == last) {
-                return;
-            }
-            
-            node_pointer current = node; // 从哨兵节点开始
-            
-            try {
-                for (; first != last; first++) {
-                    node_pointer new_node = create_node(*first);
-                    
-                    // 插入到current之后
-                    new_node->prev = current;
-                    new_node->next = current->next;
-                    current->next->prev = new_node;
-                    current->next = new_node;
-                    
-                    current = new_node; // 移动到新节点
-                }
-            } catch (...) {
-                clear(); // 异常发生时清理已分配的节点
-                throw;
-            }
+            append(first, last);
         }
 
         /**
          * @brief 构造函数，使用初始化列表初始化链表。
          * @param l 初始化列表。
+         * @param a 分配器，默认为 `allocator_type()`。
+         */
+        list(std::initializer_list<T> l, const allocator_type& a = allocator_type())
+            : list(l.begin(), l.end(), a) { }
+
+        /**
+         * @brief 拷贝构造函数，新链表使用other分配器的副本。
+         * @param other 要拷贝的链表。
          */
-        list(std::initializer_list<T> l) {
-            *this = list(l.begin(), l.end());
+        list(const list& other) : alloc(other.alloc) {
+            empty_initialize();
+            append(other.begin(), other.end());
+        }
+
+        /**
+         * @brief 移动构造函数，连同分配器一起接管other的节点，other之后为空链表。
+         * @param other 要移动的链表。
+         */
+        list(list&& other) : alloc(other.alloc) {
+            empty_initialize();
+            take_all(other);
         }
 
         /**
@@ -327,9 +484,76 @@ namespace tiny_stl {
          */
         ~list() {
             clear();
-            destroy_node(node);
+            put_node(node);
+        }
+
+        /**
+         * @brief 拷贝赋值运算符，保留自身的分配器。
+         * @param other 要拷贝的链表。
+         * @return 引用自身。
+         */
+        list& operator=(const list& other) {
+            if (this != &other) {
+                clear();
+                append(other.begin(), other.end());
+            }
+            return *this;
+        }
+
+        /**
+         * @brief 移动赋值运算符，保留自身的分配器。
+         * 两者的分配器相等时直接接管other的节点，否则逐个复制元素。
+         * @param other 要移动的链表。
+         * @return 引用自身。
+         */
+        list& operator=(list&& other) {
+            if (this != &other) {
+                clear();
+                if (__allocator_equal(alloc, other.alloc)) {
+                    take_all(other);
+                } else {
+                    append(other.begin(), other.end());
+                }
+            }
+            return *this;
+        }
+
+        /**
+         * @brief 初始化列表赋值运算符。
+         * @param l 初始化列表。
+         * @return 引用自身。
+         */
+        list& operator=(std::initializer_list<T> l) {
+            clear();
+            append(l.begin(), l.end());
+            return *this;
+        }
+
+        /**
+         * @brief 交换两个链表的内容，分配器随内容一起交换。
+         * @param other 要交换的链表。
+         */
+        void swap(list& other) noexcept {
+            tiny_stl::swap(node, other.node);
+            tiny_stl::swap(length, other.length);
+            tiny_stl::swap(alloc, other.alloc);
+        }
+
+        /**
+         * @brief 友元函数，交换两个链表的内容。
+         * @param lhs 第一个链表。
+         * @param rhs 第二个链表。
+         */
+        friend void swap(list& lhs, list& rhs) noexcept {
+            lhs.swap(rhs);
         }
 
+        /**
+         * @brief 获取链表使用的分配器。
+         * @return 分配器的副本。
+         */
+        allocator_type get_allocator() const { return allocator_type(alloc); }
+
         /**
          * @brief 清空链表。
          */
@@ -342,15 +566,17 @@ namespace tiny_stl {
             }
             node->next = node;
             node->prev = node;
+            length = 0;
         }
 
         /**
-         * @brief 初始化一个空链表。
+         * @brief 初始化一个空链表。哨兵节点只分配内存，不构造其中的值。
          */
         void empty_initialize() {
             node = get_node();
             node->next = node;
             node->prev = node;
+            length = 0;
         }
 
         /**
@@ -384,18 +610,10 @@ namespace tiny_stl {
         bool empty() const { return node->next == node; }
 
         /**
-         * @brief 返回链表的大小。
+         * @brief 返回链表的大小，复杂度为 O(1)。
          * @return 链表中节点的数量。
          */
-        size_type size() const {
-            size_type result = 0;
-            const_iterator it = begin();
-            while (it != end()) {
-                ++it;
-                ++result;
-            }
-            return result;
-        }
+        size_type size() const { return length; }
 
         /**
          * @brief 返回链表的第一个元素的引用。
@@ -468,52 +686,84 @@ namespace tiny_stl {
             prev_node->next = next_node;
             next_node->prev = prev_node;
             destroy_node(position.node);
+            --length;
             return next_node;
         }
 
         /**
          * @brief 将链表x的所有元素移动到pos之前，x变为空。
          * @param pos 目标位置的迭代器。
-         * @param x 要移动元素的链表。
+         * @param x 要移动元素的链表，不能是自身。
          */
         void splice(iterator pos, list& x) {
             if (!x.empty()) {
                 transfer(pos, x.begin(), x.end());
+                length += x.length;
+                x.length = 0;
             }
         }
 
         /**
-         * @brief 将迭代器i指向的元素移动到pos之前。
+         * @brief 将链表x中迭代器i指向的元素移动到pos之前。
          * @param pos 目标位置的迭代器。
+         * @param x 元素所在的链表，可以是自身。
          * @param i 要移动元素的迭代器。
          */
-        void splice(iterator pos, iterator i) {
+        void splice(iterator pos, list& x, iterator i) {
             iterator j = i;
             ++j;
             if (pos == i || pos == j) return;
             transfer(pos, i, j);
+            ++length;
+            --x.length;
         }
 
         /**
-         * @brief 将[first, last)区间的元素移动到pos之前。
-         * @param pos 目标位置的迭代器。
+         * @brief 将链表x中[first, last)区间的元素移动到pos之前。
+         * x不是自身时需要遍历区间以更新两者的大小，复杂度与区间长度成线性。
+         * @param pos 目标位置的迭代器，不能位于[first, last)内。
+         * @param x 元素所在的链表，可以是自身。
          * @param first 移动范围的起始迭代器。
          * @param last 移动范围的结束迭代器。
          */
-        void splice(iterator pos, iterator first, iterator last) {
-            if (first != last) {
-                transfer(pos, first, last);
+        void splice(iterator pos, list& x, iterator first, iterator last) {
+            if (first == last) return;
+            if (&x != this) {
+                size_type n = static_cast<size_type>(tiny_stl::distance(first, last));
+                length += n;
+                x.length -= n;
             }
+            transfer(pos, first, last);
+        }
+
+        /**
+         * @brief 将本链表中迭代器i指向的元素移动到pos之前。
+         * @param pos 目标位置的迭代器。
+         * @param i 要移动元素的迭代器，必须属于本链表。
+         */
+        void splice(iterator pos, iterator i) {
+            splice(pos, *this, i);
+        }
+
+        /**
+         * @brief 将本链表中[first, last)区间的元素移动到pos之前。
+         * @param pos 目标位置的迭代器。
+         * @param first 移动范围的起始迭代器，必须属于本链表。
+         * @param last 移动范围的结束迭代器。
+         */
+        void splice(iterator pos, iterator first, iterator last) {
+            splice(pos, *this, first, last);
         }
 
         /**
          * @brief 合并两个有序链表（默认升序）。
          * @tparam Pred 比较函数类型。
          * @param x 要合并的链表。
-         * @param comp 比较函数，默认为 `less<T>()`。
+         * @param comp 比较函数。
          */
         template <typename Pred>
-        void merge(list& x, Pred comp = less<T>()) {
+        void merge(list& x, Pred comp) {
+            if (&x == this) return;
             iterator first1 = begin();
             iterator last1 = end();
             iterator first2 = x.begin();
@@ -535,10 +785,17 @@ namespace tiny_stl {
                 transfer(last1, first2, last2);
             }
             
-            // 清空x
-            x.clear();
+            // x的节点已经全部转移到本链表
+            length += x.length;
+            x.length = 0;
         }
 
+        /**
+         * @brief 按升序合并两个有序链表。
+         * @param x 要合并的链表。
+         */
+        void merge(list& x) { merge(x, less<T>()); }
+
         /**
          * @brief 反转链表。
          */
@@ -558,42 +815,29 @@ namespace tiny_stl {
         }
 
         /**
-         * @brief 对链表进行排序。
+         * @brief 对链表进行稳定排序，只重新链接节点，不分配内存，也不构造或移动任何元素。
          * @tparam Pred 比较函数类型。
-         * @param comp 比较函数，默认为 `less<T>()`。
+         * @param comp 比较函数。
          */
         template <typename Pred>
-        void sort(Pred comp = less<T>()) {
-            // 空链表或只有一个元素时无需排序
-            if (node->next == node || node->next->next == node) return;
-
-            list<T> carry;
-            list<T> counter[64]; // 用于归并的计数器数组
-            int fill = 0;        // 当前使用的计数器位置
-
-            while (!empty()) {
-                // 将当前链表的第一个元素移到carry中
-                carry.splice(carry.begin(), *this, begin());
+        void sort(Pred comp) {
+            __list_sort(node, [&comp](node_pointer a, node_pointer b) { return comp(a->value, b->value); });
+        }
 
-                int i = 0;
-                while (i < fill && !counter[i].empty()) {
-                    // 合并carry和counter[i]，结果存入counter[i]
-                    counter[i].merge(carry, comp);
-                    // 将合并后的结果移到carry
-                    carry.swap(counter[i]);
-                    ++i;
-                }
-                // 将carry存入计数器数组
-                carry.swap(counter[i]);
-                if (i == fill) ++fill;
-            }
+        /**
+         * @brief 按升序对链表进行稳定排序。
+         */
+        void sort() { sort(less<T>()); }
 
-            // 合并所有计数器中的链表
-            for (int i = 1; i < fill; ++i) {
-                counter[i].merge(counter[i - 1], comp);
-            }
-            // 将排序好的链表移回本链表
-            swap(counter[fill - 1]);
+    private:
+        /**
+         * @brief 接管other的全部节点，调用前自身必须为空。
+         * @param other 节点的来源，之后为空链表。
+         */
+        void take_all(list& other) {
+            transfer(end(), other.begin(), other.end());
+            length = other.length;
+            other.length = 0;
         }
     };
 }
@@ -0,0 +1,488 @@
+/**
+ * @file mapped_vector.hpp
+ * @brief 此文件定义了 tiny_stl 命名空间下的 mapped_vector 类，一个以内存映射文件为存储的动态数组。
+ *
+ * 元素直接存放在文件映射中，打开已有文件时不需要逐个反序列化元素，只读打开也不会复制任何数据，
+ * 页面在首次访问时才由操作系统读入。文件以一个 64 字节的头部开始，记录格式标识、元素大小与元素个数，
+ * 随后是连续的元素数组；容量不足时先扩大文件，再重新映射（Linux 上使用 mremap）。
+ * 元素类型必须是平凡可复制的，因为文件中的字节会被直接当作对象使用。目前只支持 POSIX 系统。
+ */
+
+#pragma once
+
+#ifdef __GNUC__
+#   pragma GCC system_header
+#endif
+#if defined(_MSC_VER) && _MSC_VER >= 1920
+#   pragma system_header
+#endif
+
+#if defined(_WIN32)
+#   error "mapped_vector 目前只支持 POSIX 系统"
+#endif
+
+#include <iterator.hpp>
+#include <utility.hpp>
+#include <vector.hpp>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace tiny_stl {
+
+    /**
+     * @enum map_mode
+     * @brief mapped_vector 打开文件的方式
+     */
+    enum class map_mode {
+        read_only,  /**< 只读打开已有文件，映射为只读，不复制数据 */
+        read_write, /**< 读写打开已有文件，文件不存在时创建 */
+        truncate    /**< 创建新文件，已有文件的内容被丢弃 */
+    };
+
+    /**
+     * @struct __mapped_header
+     * @brief mapped_vector 文件的头部，占用文件开头的 __mapped_header_size 字节
+     */
+    struct __mapped_header {
+        char magic[8];          /**< 格式标识 */
+        uint64_t element_size;  /**< 元素的大小（字节） */
+        uint64_t size;          /**< 元素个数 */
+    };
+
+    /**
+     * @brief 头部占用的字节数，元素数组从这个偏移开始，因此元素的对齐要求不能超过它
+     */
+    constexpr size_t __mapped_header_size = 64;
+
+    /**
+     * @brief mapped_vector 文件的格式标识
+     */
+    constexpr char __mapped_magic[8] = {'T', 'S', 'T', 'L', 'M', 'V', 'E', '1'};
+
+    /**
+     * @class mapped_vector
+     * @brief 以内存映射文件为存储的动态数组，接口与 vector 一致，迭代器就是元素指针。
+     *
+     * 元素个数保存在映射中的文件头里，修改会随映射一起写回文件；flush() 用 msync 等待写回完成。
+     * 扩容会重新映射文件，使所有迭代器、指针与引用失效。以 map_mode::read_only 打开时，
+     * 修改大小或容量的操作会抛出 std::logic_error，通过 data() 写入元素是未定义行为。
+     *
+     * @tparam T 元素类型，必须是平凡可复制的
+     */
+    template <typename T>
+    class mapped_vector {
+        static_assert(std::is_trivially_copyable<T>::value, "mapped_vector 的元素类型必须是平凡可复制的");
+        static_assert(alignof(T) <= __mapped_header_size, "mapped_vector 的元素对齐要求不能超过文件头的大小");
+
+    public:
+        using value_type             = T; /**< 元素类型 */
+        using size_type              = size_t; /**< 大小类型 */
+        using difference_type        = ptrdiff_t; /**< 距离类型 */
+        using pointer                = T*; /**< 指针类型 */
+        using const_pointer          = const T*; /**< 常量指针类型 */
+        using reference              = T&; /**< 引用类型 */
+        using const_reference        = const T&; /**< 常量引用类型 */
+        using iterator               = T*; /**< 迭代器类型 */
+        using const_iterator         = const T*; /**< 常量迭代器类型 */
+        using reverse_iterator       = tiny_stl::reverse_iterator<iterator>; /**< 反向迭代器类型 */
+        using const_reverse_iterator = tiny_stl::reverse_iterator<const_iterator>; /**< 常量反向迭代器类型 */
+
+        /**
+         * @brief 默认构造函数，不关联任何文件
+         */
+        mapped_vector() noexcept : _fd(-1), _map(nullptr), _map_bytes(0), _capacity(0), _writable(false) { }
+
+        /**
+         * @brief 打开或创建文件并映射
+         * @param path 文件路径
+         * @param mode 打开方式
+         * @throw std::system_error 如果打开、扩大或映射文件失败
+         * @throw std::runtime_error 如果已有文件不是元素类型相同的 mapped_vector 文件
+         */
+        explicit mapped_vector(const std::string& path, map_mode mode = map_mode::read_write) : mapped_vector() {
+            open(path, mode);
+        }
+
+        mapped_vector(const mapped_vector&) = delete;
+        mapped_vector& operator=(const mapped_vector&) = delete;
+
+        /**
+         * @brief 移动构造函数，接管 other 的文件与映射
+         */
+        mapped_vector(mapped_vector&& other) noexcept
+            : _fd(other._fd), _map(other._map), _map_bytes(other._map_bytes),
+              _capacity(other._capacity), _writable(other._writable) {
+            other.release();
+        }
+
+        /**
+         * @brief 移动赋值运算符，先关闭当前文件
+         */
+        mapped_vector& operator=(mapped_vector&& other) noexcept {
+            if (this != &other) {
+                close();
+                _fd = other._fd;
+                _map = other._map;
+                _map_bytes = other._map_bytes;
+                _capacity = other._capacity;
+                _writable = other._writable;
+                other.release();
+            }
+            return *this;
+        }
+
+        /**
+         * @brief 析构函数，解除映射并关闭文件；不等待写回完成
+         */
+        ~mapped_vector() {
+            close();
+        }
+
+        /**
+         * @brief 打开或创建文件并映射，先关闭当前文件
+         * @param path 文件路径
+         * @param mode 打开方式
+         * @throw std::system_error 如果打开、扩大或映射文件失败
+         * @throw std::runtime_error 如果已有文件不是元素类型相同的 mapped_vector 文件
+         */
+        void open(const std::string& path, map_mode mode = map_mode::read_write) {
+            close();
+            bool writable = mode != map_mode::read_only;
+            int flags = writable ? O_RDWR | O_CREAT : O_RDONLY;
+            if (mode == map_mode::truncate) {
+                flags |= O_TRUNC;
+            }
+            int fd = ::open(path.c_str(), flags | O_CLOEXEC, 0644);
+            if (fd < 0) {
+                throw std::system_error(errno, std::generic_category(), "mapped_vector: open " + path);
+            }
+            try {
+                struct stat st;
+                if (::fstat(fd, &st) != 0) {
+                    throw std::system_error(errno, std::generic_category(), "mapped_vector: fstat " + path);
+                }
+                size_t file_bytes = static_cast<size_t>(st.st_size);
+                bool fresh = file_bytes == 0 && writable;
+                if (fresh) {
+                    file_bytes = __mapped_header_size;
+                    resize_file(fd, file_bytes);
+                } else if (file_bytes < __mapped_header_size) {
+                    throw std::runtime_error("mapped_vector: " + path + " is not a mapped_vector file");
+                }
+                void* map = ::mmap(nullptr, file_bytes, writable ? PROT_READ | PROT_WRITE : PROT_READ,
+                                   MAP_SHARED, fd, 0);
+                if (map == MAP_FAILED) {
+                    throw std::system_error(errno, std::generic_category(), "mapped_vector: mmap " + path);
+                }
+                __mapped_header* hdr = static_cast<__mapped_header*>(map);
+                size_t capacity = (file_bytes - __mapped_header_size) / sizeof(T);
+                if (fresh) {
+                    std::memcpy(hdr->magic, __mapped_magic, sizeof(__mapped_magic));
+                    hdr->element_size = sizeof(T);
+                    hdr->size = 0;
+                } else if (std::memcmp(hdr->magic, __mapped_magic, sizeof(__mapped_magic)) != 0 ||
+                           hdr->element_size != sizeof(T) || hdr->size > capacity) {
+                    ::munmap(map, file_bytes);
+                    throw std::runtime_error("mapped_vector: " + path + " is not a mapped_vector file of this element type");
+                }
+                _fd = fd;
+                _map = static_cast<unsigned char*>(map);
+                _map_bytes = file_bytes;
+                _capacity = capacity;
+                _writable = writable;
+            } catch (...) {
+                ::close(fd);
+                throw;
+            }
+        }
+
+        /**
+         * @brief 解除映射并关闭文件，之后不再关联任何文件；不等待写回完成
+         */
+        void close() noexcept {
+            if (_map) {
+                ::munmap(_map, _map_bytes);
+            }
+            if (_fd >= 0) {
+                ::close(_fd);
+            }
+            release();
+        }
+
+        /**
+         * @brief 是否关联了文件
+         */
+        bool is_open() const noexcept { return _map != nullptr; }
+
+        /**
+         * @brief 是否可以修改
+         */
+        bool writable() const noexcept { return _writable; }
+
+        /**
+         * @brief 把映射中被修改的页面与文件头同步写回文件，返回前等待写回完成
+         * @throw std::system_error 如果 msync 失败
+         */
+        void flush() {
+            if (_map && _writable && ::msync(_map, _map_bytes, MS_SYNC) != 0) {
+                throw std::system_error(errno, std::generic_category(), "mapped_vector: msync");
+            }
+        }
+
+        iterator begin() noexcept { return data(); }
+        const_iterator begin() const noexcept { return data(); }
+        const_iterator cbegin() const noexcept { return data(); }
+        iterator end() noexcept { return data() + size(); }
+        const_iterator end() const noexcept { return data() + size(); }
+        const_iterator cend() const noexcept { return end(); }
+        reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+        const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+        reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+        const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+        /**
+         * @brief 返回元素数组的起始指针；没有关联文件时为 nullptr
+         */
+        pointer data() noexcept {
+            return _map ? reinterpret_cast<pointer>(_map + __mapped_header_size) : nullptr;
+        }
+
+        const_pointer data() const noexcept {
+            return _map ? reinterpret_cast<const_pointer>(_map + __mapped_header_size) : nullptr;
+        }
+
+        size_type size() const noexcept { return _map ? static_cast<size_type>(header()->size) : 0; }
+        size_type capacity() const noexcept { return _capacity; }
+        bool empty() const noexcept { return size() == 0; }
+
+        reference operator[](size_type n) noexcept { return data()[n]; }
+        const_reference operator[](size_type n) const noexcept { return data()[n]; }
+
+        /**
+         * @brief 访问下标为 n 的元素，检查边界
+         * @throw std::out_of_range 如果索引超出范围
+         */
+        reference at(size_type n) {
+            if (n >= size()) {
+                throw std::out_of_range("Index out of range");
+            }
+            return data()[n];
+        }
+
+        /**
+         * @brief 访问下标为 n 的元素，检查边界
+         * @throw std::out_of_range 如果索引超出范围
+         */
+        const_reference at(size_type n) const {
+            if (n >= size()) {
+                throw std::out_of_range("Index out of range");
+            }
+            return data()[n];
+        }
+
+        reference front() noexcept { return data()[0]; }
+        const_reference front() const noexcept { return data()[0]; }
+        reference back() noexcept { return data()[size() - 1]; }
+        const_reference back() const noexcept { return data()[size() - 1]; }
+
+        /**
+         * @brief 保证容量至少为 n；需要扩容时扩大文件并重新映射
+         * @param n 需要的最小容量
+         * @throw std::system_error 如果扩大文件或重新映射失败，此时内容保持不变
+         */
+        void reserve(size_type n) {
+            check_writable();
+            if (n > _capacity) {
+                remap(n);
+            }
+        }
+
+        /**
+         * @brief 在末尾追加一个元素
+         */
+        void push_back(const value_type& value) {
+            emplace_back(value);
+        }
+
+        /**
+         * @brief 在末尾构造一个元素
+         * @return 新元素的引用
+         */
+        template <typename... Args>
+        reference emplace_back(Args&&... args) {
+            check_writable();
+            size_type n = size();
+            if (n == _capacity) {
+                value_type tmp(tiny_stl::forward<Args>(args)...);
+                remap(grow_capacity(n + 1));
+                std::memcpy(static_cast<void*>(data() + n), &tmp, sizeof(T));
+            } else {
+                ::new (static_cast<void*>(data() + n)) value_type(tiny_stl::forward<Args>(args)...);
+            }
+            header()->size = n + 1;
+            return data()[n];
+        }
+
+        /**
+         * @brief 把 [first, last) 范围内的元素追加到末尾。
+         * 前向迭代器先求出元素个数，至多扩容一次；单趟的输入迭代器只能逐个 emplace_back
+         */
+        template <typename InputIterator, __enable_if_input_iterator_t<InputIterator> = 0>
+        void append(InputIterator first, InputIterator last) {
+            check_writable();
+            if constexpr (__is_iterator_of<InputIterator, forward_iterator_tag>::value) {
+                size_type n = size();
+                size_type count = static_cast<size_type>(tiny_stl::distance(first, last));
+                if (n + count > _capacity) {
+                    remap(grow_capacity(n + count));
+                }
+                pointer out = data() + n;
+                for (; first != last; ++first, ++out) {
+                    ::new (static_cast<void*>(out)) value_type(*first);
+                }
+                header()->size = n + count;
+            } else {
+                for (; first != last; ++first) {
+                    emplace_back(*first);
+                }
+            }
+        }
+
+        /**
+         * @brief 删除最后一个元素
+         */
+        void pop_back() {
+            check_writable();
+            --header()->size;
+        }
+
+        /**
+         * @brief 把大小改为 n，新增的元素值初始化
+         */
+        void resize(size_type n) {
+            check_writable();
+            size_type old_size = size();
+            if (n > _capacity) {
+                remap(grow_capacity(n));
+            }
+            for (size_type i = old_size; i < n; ++i) {
+                ::new (static_cast<void*>(data() + i)) value_type();
+            }
+            header()->size = n;
+        }
+
+        /**
+         * @brief 删除所有元素，不缩小文件
+         */
+        void clear() {
+            check_writable();
+            header()->size = 0;
+        }
+
+        /**
+         * @brief 把文件与映射缩小到恰好容纳当前的元素
+         */
+        void shrink_to_fit() {
+            check_writable();
+            if (_capacity > size()) {
+                remap(size());
+            }
+        }
+
+        /**
+         * @brief 与 other 交换文件与映射
+         */
+        void swap(mapped_vector& other) noexcept {
+            tiny_stl::swap(_fd, other._fd);
+            tiny_stl::swap(_map, other._map);
+            tiny_stl::swap(_map_bytes, other._map_bytes);
+            tiny_stl::swap(_capacity, other._capacity);
+            tiny_stl::swap(_writable, other._writable);
+        }
+
+    private:
+        int _fd;                /**< 文件描述符 */
+        unsigned char* _map;    /**< 映射的起始地址，即文件头 */
+        size_t _map_bytes;      /**< 映射与文件的字节数 */
+        size_type _capacity;    /**< 文件中可以容纳的元素个数 */
+        bool _writable;         /**< 是否以可写方式映射 */
+
+        __mapped_header* header() noexcept { return reinterpret_cast<__mapped_header*>(_map); }
+        const __mapped_header* header() const noexcept { return reinterpret_cast<const __mapped_header*>(_map); }
+
+        void release() noexcept {
+            _fd = -1;
+            _map = nullptr;
+            _map_bytes = 0;
+            _capacity = 0;
+            _writable = false;
+        }
+
+        void check_writable() const {
+            if (!_writable) {
+                throw std::logic_error("mapped_vector is not open for writing");
+            }
+        }
+
+        size_type grow_capacity(size_type min_capacity) const noexcept {
+            return doubling_growth::next_capacity(_capacity, min_capacity, sizeof(T));
+        }
+
+        static void resize_file(int fd, size_t bytes) {
+            if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+                throw std::system_error(errno, std::generic_category(), "mapped_vector: ftruncate");
+            }
+        }
+
+        /**
+         * @brief 把文件大小改为容纳 new_capacity 个元素，并重新映射。
+         * 扩大时先扩大文件再映射，缩小时先缩小映射再缩小文件，失败时恢复原来的文件大小。
+         */
+        void remap(size_type new_capacity) {
+            size_t new_bytes = __mapped_header_size + new_capacity * sizeof(T);
+            bool grow = new_bytes > _map_bytes;
+            if (grow) {
+                resize_file(_fd, new_bytes);
+            }
+#if defined(__linux__) && defined(MREMAP_MAYMOVE)
+            void* map = ::mremap(_map, _map_bytes, new_bytes, MREMAP_MAYMOVE);
+#else
+            void* map = ::mmap(nullptr, new_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+#endif
+            if (map == MAP_FAILED) {
+                int err = errno;
+                if (grow) {
+                    ::ftruncate(_fd, static_cast<off_t>(_map_bytes));
+                }
+                throw std::system_error(err, std::generic_category(), "mapped_vector: remap");
+            }
+#if !(defined(__linux__) && defined(MREMAP_MAYMOVE))
+            ::munmap(_map, _map_bytes);
+#endif
+            if (!grow) {
+                ::ftruncate(_fd, static_cast<off_t>(new_bytes));
+            }
+            _map = static_cast<unsigned char*>(map);
+            _map_bytes = new_bytes;
+            _capacity = new_capacity;
+        }
+    };
+
+    /**
+     * @brief 交换两个 mapped_vector 的文件与映射
+     */
+    template <typename T>
+    void swap(mapped_vector<T>& lhs, mapped_vector<T>& rhs) noexcept {
+        lhs.swap(rhs);
+    }
+
+}
@@ -15,14 +15,109 @@
 
 #include <allocator.hpp>
 #include <shared_ptr.hpp>
+#include <atomic_shared_ptr.hpp>
 #include <unique_ptr.hpp>
 #include <utility.hpp> // 包含 remove_reference, forward, move, swap 等
 #include <new>        // 包含 placement new 和 bad_alloc
 #include <cstddef>    // 包含 size_t, ptrdiff_t
 #include <iterator.hpp>   // 包含 iterator_traits
+#include <cstring>    // 包含 memcpy, memmove, memset
+#include <type_traits>
 
 namespace tiny_stl {
 
+    // ==================== 类型特征 ====================
+
+    /**
+     * @struct is_trivially_relocatable
+     * @brief 判断类型是否可以平凡重定位，即“移动构造到新地址并销毁旧对象”等价于逐字节复制。
+     *
+     * 默认对平凡可复制的类型成立。对于只持有指针、不依赖自身地址的用户类型
+     * （例如自行实现的智能指针或句柄），可以特化该模板以启用 `memcpy` 搬移：
+     * @code
+     * template <> struct tiny_stl::is_trivially_relocatable<my_handle> : std::true_type { };
+     * @endcode
+     * @tparam T 要判断的类型
+     */
+    template <typename T>
+    struct is_trivially_relocatable : std::integral_constant<bool, std::is_trivially_copyable<T>::value> { };
+
+    /**
+     * @brief `is_trivially_relocatable<T>::value` 的简写。
+     * @tparam T 要判断的类型
+     */
+    template <typename T>
+    constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+    /**
+     * @brief 缓存行的字节数，并发结构用它隔开不同线程频繁写入的数据，避免伪共享。
+     * 取 64 字节，适用于常见的 x86-64 与 ARM64 处理器。
+     */
+    constexpr size_t __cache_line_size = 64;
+
+    /**
+     * @struct __is_bitwise_copyable
+     * @brief 判断从 `InputIt` 到 `ForwardIt` 的构造能否用 `memcpy` 完成。
+     * 要求两者都是指向同一（忽略 const）平凡可复制类型的指针，且对应的构造是平凡的。
+     * @tparam InputIt 源迭代器类型
+     * @tparam ForwardIt 目标迭代器类型
+     * @tparam Source 构造时使用的源引用类型
+     */
+    template <typename InputIt, typename ForwardIt, typename Source>
+    struct __is_bitwise_copyable : std::false_type { };
+
+    template <typename T, typename U, typename Source>
+    struct __is_bitwise_copyable<T*, U*, Source> : std::integral_constant<bool,
+        std::is_same<std::remove_const_t<T>, U>::value &&
+        std::is_trivially_copyable<U>::value &&
+        std::is_trivially_constructible<U, Source>::value> { };
+
+    /**
+     * @brief 用 `memcpy` 把 n 个平凡可复制的对象复制到不重叠的未初始化内存中。
+     * @tparam T 对象的类型
+     * @param first 源范围的起始指针
+     * @param n 对象数量
+     * @param d_first 目标范围的起始指针
+     * @return 目标范围的结束指针
+     */
+    template <typename T>
+    T* __bitwise_copy_n(const T* first, size_t n, T* d_first) noexcept {
+        if (n != 0) {
+            std::memcpy(static_cast<void*>(d_first), static_cast<const void*>(first), n * sizeof(T));
+        }
+        return d_first + n;
+    }
+
+    /**
+     * @brief 用 n 份 value 填充平凡可复制的未初始化内存。
+     * 单字节类型与全零值直接使用 `memset`，其余情况退化为可被向量化的简单循环。
+     * @tparam T 对象的类型
+     * @param first 目标范围的起始指针
+     * @param n 对象数量
+     * @param value 要填充的值
+     * @return 目标范围的结束指针
+     */
+    template <typename T>
+    T* __bitwise_fill_n(T* first, size_t n, const T& value) noexcept {
+        if (n == 0) {
+            return first;
+        }
+        unsigned char bytes[sizeof(T)];
+        std::memcpy(bytes, static_cast<const void*>(&value), sizeof(T));
+        bool same = true;
+        for (size_t i = 1; i < sizeof(T); ++i) {
+            same = same && bytes[i] == bytes[0];
+        }
+        if (same && (sizeof(T) == 1 || bytes[0] == 0)) {
+            std::memset(static_cast<void*>(first), bytes[0], n * sizeof(T));
+        } else {
+            for (size_t i = 0; i < n; ++i) {
+                std::memcpy(static_cast<void*>(first + i), bytes, sizeof(T));
+            }
+        }
+        return first + n;
+    }
+
     // ==================== 基础工具 ====================
 
     /**
@@ -63,8 +158,11 @@ namespace tiny_stl {
      */
     template <typename ForwardIt>
     void destroy(ForwardIt first, ForwardIt last) {
-        for (; first != last; ++first) {
-            destroy_at(&*first);
+        using ValueType = typename tiny_stl::iterator_traits<ForwardIt>::value_type;
+        if constexpr (!std::is_trivially_destructible<ValueType>::value) {
+            for (; first != last; ++first) {
+                tiny_stl::destroy_at(&*first);
+            }
         }
     }
 
@@ -75,13 +173,19 @@ namespace tiny_stl {
      * @param n 要销毁的对象数量
      * @return 最后销毁元素的下一个位置
      * @details 遍历指定数量的元素，对每个元素调用 destroy_at 函数进行销毁。
+     * 元素可平凡析构且迭代器为指针时不做任何事。
      */
     template <typename ForwardIt>
     ForwardIt destroy_n(ForwardIt first, size_t n) {
-        for (size_t i = 0; i < n; ++i, ++first) {
-            destroy_at(&*first);
+        using ValueType = typename tiny_stl::iterator_traits<ForwardIt>::value_type;
+        if constexpr (std::is_trivially_destructible<ValueType>::value && std::is_pointer<ForwardIt>::value) {
+            return first + n;
+        } else {
+            for (size_t i = 0; i < n; ++i, ++first) {
+                tiny_stl::destroy_at(&*first);
+            }
+            return first;
         }
-        return first;
     }
 
     // ==================== 复制操作 ====================
@@ -95,17 +199,21 @@ namespace tiny_stl {
      * @param d_first 目标范围的起始
      * @return 目标范围中最后复制元素的下一个位置的迭代器
      * @details 遍历输入范围，将每个元素复制到目标范围的未初始化内存中。如果复制过程中发生异常，会销毁已经复制的元素。
+     * 源与目标都是指向平凡可复制类型的指针时，整体使用 `memcpy`。
      */
     template <typename InputIt, typename ForwardIt>
     ForwardIt uninitialized_copy(InputIt first, InputIt last, ForwardIt d_first) {
+        if constexpr (__is_bitwise_copyable<InputIt, ForwardIt, decltype(*first)>::value) {
+            return __bitwise_copy_n(first, static_cast<size_t>(last - first), d_first);
+        }
         ForwardIt current = d_first;
         try {
             for (; first != last; ++first, (void)++current) {
-                construct_at(&*current, *first);
+                tiny_stl::construct_at(&*current, *first);
             }
             return current;
         } catch (...) {
-            destroy(d_first, current);
+            tiny_stl::destroy(d_first, current);
             throw;
         }
     }
@@ -120,17 +228,21 @@ namespace tiny_stl {
      * @param d_first 目标范围的起始
      * @return 目标范围中最后复制元素的下一个位置的迭代器
      * @details 复制指定数量的元素到目标范围的未初始化内存中。如果复制过程中发生异常，会销毁已经复制的元素。
+     * 源与目标都是指向平凡可复制类型的指针时，整体使用 `memcpy`。
      */
     template <typename InputIt, typename Size, typename ForwardIt>
     ForwardIt uninitialized_copy_n(InputIt first, Size count, ForwardIt d_first) {
+        if constexpr (__is_bitwise_copyable<InputIt, ForwardIt, decltype(*first)>::value) {
+            return __bitwise_copy_n(first, count > 0 ? static_cast<size_t>(count) : 0, d_first);
+        }
         ForwardIt current = d_first;
         try {
             for (Size i = 0; i < count; ++i, ++first, (void)++current) {
-                construct_at(&*current, *first);
+                tiny_stl::construct_at(&*current, *first);
             }
             return current;
         } catch (...) {
-            destroy(d_first, current);
+            tiny_stl::destroy(d_first, current);
             throw;
         }
     }
@@ -145,16 +257,21 @@ namespace tiny_stl {
      * @param last 结束迭代器
      * @param value 要填充的值
      * @details 遍历迭代器范围，将指定值复制到目标范围的未初始化内存中。如果填充过程中发生异常，会销毁已经填充的元素。
+     * 目标是指向平凡可复制类型的指针时，使用 `memset` 或简单的逐字节复制循环。
      */
     template <typename ForwardIt, typename T>
     void uninitialized_fill(ForwardIt first, ForwardIt last, const T& value) {
+        if constexpr (__is_bitwise_copyable<const T*, ForwardIt, const T&>::value) {
+            __bitwise_fill_n(first, static_cast<size_t>(last - first), value);
+            return;
+        }
         ForwardIt current = first;
         try {
             for (; current != last; ++current) {
-                construct_at(&*current, value);
+                tiny_stl::construct_at(&*current, value);
             }
         } catch (...) {
-            destroy(first, current);
+            tiny_stl::destroy(first, current);
             throw;
         }
     }
@@ -169,17 +286,21 @@ namespace tiny_stl {
      * @param value 要填充的值
      * @return 最后填充元素的下一个位置
      * @details 填充指定数量的元素到目标范围的未初始化内存中。如果填充过程中发生异常，会销毁已经填充的元素。
+     * 目标是指向平凡可复制类型的指针时，使用 `memset` 或简单的逐字节复制循环。
      */
     template <typename ForwardIt, typename Size, typename T>
     ForwardIt uninitialized_fill_n(ForwardIt first, Size count, const T& value) {
+        if constexpr (__is_bitwise_copyable<const T*, ForwardIt, const T&>::value) {
+            return __bitwise_fill_n(first, count > 0 ? static_cast<size_t>(count) : 0, value);
+        }
         ForwardIt current = first;
         try {
             for (Size i = 0; i < count; ++i, ++current) {
-                construct_at(&*current, value);
+                tiny_stl::construct_at(&*current, value);
             }
             return current;
         } catch (...) {
-            destroy(first, current);
+            tiny_stl::destroy(first, current);
             throw;
         }
     }
@@ -195,17 +316,21 @@ namespace tiny_stl {
      * @param d_first 目标范围的起始
      * @return 目标范围中最后移动元素的下一个位置的迭代器
      * @details 遍历输入范围，将每个元素移动到目标范围的未初始化内存中。如果移动过程中发生异常，会销毁已经移动的元素。
+     * 源与目标都是指向平凡可复制类型的指针时，整体使用 `memcpy`。
      */
     template <typename InputIt, typename ForwardIt>
     ForwardIt uninitialized_move(InputIt first, InputIt last, ForwardIt d_first) {
+        if constexpr (__is_bitwise_copyable<InputIt, ForwardIt, decltype(tiny_stl::move(*first))>::value) {
+            return __bitwise_copy_n(first, static_cast<size_t>(last - first), d_first);
+        }
         ForwardIt current = d_first;
         try {
             for (; first != last; ++first, (void)++current) {
-                construct_at(&*current, tiny_stl::move(*first));
+                tiny_stl::construct_at(&*current, tiny_stl::move(*first));
             }
             return current;
         } catch (...) {
-            destroy(d_first, current);
+            tiny_stl::destroy(d_first, current);
             throw;
         }
     }
@@ -220,21 +345,56 @@ namespace tiny_stl {
      * @param d_first 目标范围的起始
      * @return 目标范围中最后移动元素的下一个位置的迭代器
      * @details 移动指定数量的元素到目标范围的未初始化内存中。如果移动过程中发生异常，会销毁已经移动的元素。
+     * 源与目标都是指向平凡可复制类型的指针时，整体使用 `memcpy`。
      */
     template <typename InputIt, typename Size, typename ForwardIt>
     ForwardIt uninitialized_move_n(InputIt first, Size count, ForwardIt d_first) {
+        if constexpr (__is_bitwise_copyable<InputIt, ForwardIt, decltype(tiny_stl::move(*first))>::value) {
+            return __bitwise_copy_n(first, count > 0 ? static_cast<size_t>(count) : 0, d_first);
+        }
         ForwardIt current = d_first;
         try {
             for (Size i = 0; i < count; ++i, ++first, (void)++current) {
-                construct_at(&*current, tiny_stl::move(*first));
+                tiny_stl::construct_at(&*current, tiny_stl::move(*first));
             }
             return current;
         } catch (...) {
-            destroy(d_first, current);
+            tiny_stl::destroy(d_first, current);
             throw;
         }
     }
 
+    // ==================== 重定位操作 ====================
+
+    /**
+     * @brief 将对象范围重定位到未初始化的内存区域：在目标处移动构造，随后销毁源对象
+     * @tparam T 对象的类型
+     * @param first 源范围的起始
+     * @param last 源范围的结束
+     * @param d_first 目标范围的起始，不能与源范围重叠
+     * @return 目标范围中最后重定位元素的下一个位置
+     * @details 元素可平凡重定位时整体使用 `memcpy` 且不调用析构函数；否则逐个移动构造并销毁源对象，
+     * 此时要求移动构造不抛出异常。
+     */
+    template <typename T>
+    T* uninitialized_relocate(T* first, T* last, T* d_first) noexcept {
+        if constexpr (is_trivially_relocatable<T>::value) {
+            size_t n = static_cast<size_t>(last - first);
+            if (n != 0) {
+                std::memcpy(static_cast<void*>(d_first), static_cast<const void*>(first), n * sizeof(T));
+            }
+            return d_first + n;
+        } else {
+            static_assert(std::is_nothrow_move_constructible<T>::value,
+                          "uninitialized_relocate 要求移动构造不抛出异常");
+            for (; first != last; ++first, ++d_first) {
+                tiny_stl::construct_at(d_first, tiny_stl::move(*first));
+                tiny_stl::destroy_at(first);
+            }
+            return d_first;
+        }
+    }
+
     // ==================== 默认构造 ====================
 
     /**
@@ -243,17 +403,21 @@ namespace tiny_stl {
      * @param first 起始迭代器
      * @param last 结束迭代器
      * @details 遍历迭代器范围，在目标范围的未初始化内存中默认构造对象。如果构造过程中发生异常，会销毁已经构造的元素。
+     * 元素可平凡默认构造时不做任何事。
      */
     template <typename ForwardIt>
     void uninitialized_default_construct(ForwardIt first, ForwardIt last) {
         using ValueType = typename tiny_stl::iterator_traits<ForwardIt>::value_type;
+        if constexpr (std::is_trivially_default_constructible<ValueType>::value) {
+            return;
+        }
         ForwardIt current = first;
         try {
             for (; current != last; ++current) {
                 ::new (static_cast<void*>(&*current)) ValueType;
             }
         } catch (...) {
-            destroy(first, current);
+            tiny_stl::destroy(first, current);
             throw;
         }
     }
@@ -265,10 +429,14 @@ namespace tiny_stl {
      * @param n 元素数量
      * @return 最后构造元素的下一个位置
      * @details 在目标范围的未初始化内存中默认构造指定数量的对象。如果构造过程中发生异常，会销毁已经构造的元素。
+     * 元素可平凡默认构造且迭代器为指针时不做任何事。
      */
     template <typename ForwardIt>
     ForwardIt uninitialized_default_construct_n(ForwardIt first, size_t n) {
         using ValueType = typename tiny_stl::iterator_traits<ForwardIt>::value_type;
+        if constexpr (std::is_trivially_default_constructible<ValueType>::value && std::is_pointer<ForwardIt>::value) {
+            return first + n;
+        }
         ForwardIt current = first;
         try {
             for (size_t i = 0; i < n; ++i, ++current) {
@@ -276,7 +444,7 @@ namespace tiny_stl {
             }
             return current;
         } catch (...) {
-            destroy(first, current);
+            tiny_stl::destroy(first, current);
             throw;
         }
     }
@@ -289,17 +457,22 @@ namespace tiny_stl {
      * @param first 起始迭代器
      * @param last 结束迭代器
      * @details 遍历迭代器范围，在目标范围的未初始化内存中值初始化构造对象。如果构造过程中发生异常，会销毁已经构造的元素。
+     * 元素为平凡类型且迭代器为指针时，等价于填充值初始化的对象（通常是一次 `memset`）。
      */
     template <typename ForwardIt>
     void uninitialized_value_construct(ForwardIt first, ForwardIt last) {
         using ValueType = typename tiny_stl::iterator_traits<ForwardIt>::value_type;
+        if constexpr (std::is_trivial<ValueType>::value && std::is_pointer<ForwardIt>::value) {
+            __bitwise_fill_n(first, static_cast<size_t>(last - first), ValueType());
+            return;
+        }
         ForwardIt current = first;
         try {
             for (; current != last; ++current) {
                 ::new (static_cast<void*>(&*current)) ValueType();
             }
         } catch (...) {
-            destroy(first, current);
+            tiny_stl::destroy(first, current);
             throw;
         }
     }
@@ -311,10 +484,14 @@ namespace tiny_stl {
      * @param n 元素数量
      * @return 最后构造元素的下一个位置
      * @details 在目标范围的未初始化内存中值初始化构造指定数量的对象。如果构造过程中发生异常，会销毁已经构造的元素。
+     * 元素为平凡类型且迭代器为指针时，等价于填充值初始化的对象（通常是一次 `memset`）。
      */
     template <typename ForwardIt>
     ForwardIt uninitialized_value_construct_n(ForwardIt first, size_t n) {
         using ValueType = typename tiny_stl::iterator_traits<ForwardIt>::value_type;
+        if constexpr (std::is_trivial<ValueType>::value && std::is_pointer<ForwardIt>::value) {
+            return __bitwise_fill_n(first, n, ValueType());
+        }
         ForwardIt current = first;
         try {
             for (size_t i = 0; i < n; ++i, ++current) {
@@ -322,9 +499,70 @@ namespace tiny_stl {
             }
             return current;
         } catch (...) {
-            destroy(first, current);
+            tiny_stl::destroy(first, current);
             throw;
         }
     }
 
+    // ==================== 临时缓冲区 ====================
+
+    /**
+     * @class __temporary_buffer
+     * @brief 算法内部使用的未初始化缓冲区，析构时销毁已构造的前缀并释放内存。
+     * 对齐要求超过 `__STDCPP_DEFAULT_NEW_ALIGNMENT__` 的类型使用带对齐参数的 `::operator new`。
+     * 调用者构造或销毁元素后用 `set_size` 记录已构造的前缀长度，异常退出时由析构函数清理。
+     * @tparam T 元素类型
+     */
+    template <typename T>
+    class __temporary_buffer {
+    public:
+        /**
+         * @brief 分配可容纳 n 个元素的未初始化内存
+         * @throw std::bad_alloc 如果内存分配失败
+         */
+        explicit __temporary_buffer(size_t n) : _data(allocate(n)), _size(0) { }
+
+        __temporary_buffer(const __temporary_buffer&) = delete;
+        __temporary_buffer& operator=(const __temporary_buffer&) = delete;
+
+        /**
+         * @brief 销毁 [data(), data() + size()) 中的元素并释放内存
+         */
+        ~__temporary_buffer() {
+            tiny_stl::destroy(_data, _data + _size);
+            deallocate(_data);
+        }
+
+        T* data() const noexcept { return _data; }
+        size_t size() const noexcept { return _size; }
+
+        /**
+         * @brief 记录 [data(), data() + n) 中的元素已被构造；元素已由调用者销毁时传入 0
+         */
+        void set_size(size_t n) noexcept { _size = n; }
+
+    private:
+        T* _data; /**< 缓冲区起始地址 */
+        size_t _size; /**< 已构造的元素个数 */
+
+        static T* allocate(size_t n) {
+            if (n > size_t(-1) / sizeof(T)) {
+                throw std::bad_alloc();
+            }
+            if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+                return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+            } else {
+                return static_cast<T*>(::operator new(n * sizeof(T)));
+            }
+        }
+
+        static void deallocate(T* p) noexcept {
+            if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+                ::operator delete(p, std::align_val_t(alignof(T)));
+            } else {
+                ::operator delete(p);
+            }
+        }
+    };
+
 } // namespace tiny_stl
@@ -0,0 +1,295 @@
+/**
+ * @file monotonic_arena.hpp
+ * @brief 此文件定义了 tiny_stl 命名空间下的 `monotonic_arena` 与 `arena_allocator`。
+ *
+ * `monotonic_arena` 只向前移动指针来分配内存，单次释放什么也不做，
+ * 全部内存在 `release()` 或析构时一次性归还，适合生命周期一致的一批对象（例如处理一个请求期间的临时容器）。
+ */
+
+#pragma once
+
+#ifdef __GNUC__
+#   pragma GCC system_header
+#endif
+#if defined(_MSC_VER) && _MSC_VER >= 1920
+#   pragma system_header
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <cassert>
+#include <type_traits>
+
+namespace tiny_stl {
+
+    /**
+     * @class monotonic_arena
+     * @brief 单调增长的内存区域，分配是一次指针移动，释放只能整体进行。
+     *
+     * 可以先使用调用者提供的缓冲区（例如栈上的数组），用完后向 `::operator new`
+     * 申请新的内存块，内存块的大小按几何级数增长。
+     *
+     * @note 该类不是线程安全的。
+     */
+    class monotonic_arena {
+    public:
+        /**
+         * @brief 构造一个不带初始缓冲区的内存区域。
+         * @param initial_size 第一次向系统申请的字节数。
+         */
+        explicit monotonic_arena(size_t initial_size = 1024) noexcept
+            : _cur(nullptr), _end(nullptr), _chunks(nullptr),
+              _buffer(nullptr), _buffer_size(0),
+              _initial_size(initial_size ? initial_size : 1), _next_size(_initial_size) { }
+
+        /**
+         * @brief 构造一个先使用调用者缓冲区的内存区域。
+         * @param buffer 初始缓冲区，其生命周期必须长于内存区域。
+         * @param size 初始缓冲区的字节数。
+         */
+        monotonic_arena(void* buffer, size_t size) noexcept
+            : _cur(static_cast<char*>(buffer)), _end(static_cast<char*>(buffer) + size), _chunks(nullptr),
+              _buffer(static_cast<char*>(buffer)), _buffer_size(size),
+              _initial_size(size ? size : 1), _next_size(_initial_size) { }
+
+        monotonic_arena(const monotonic_arena&) = delete;
+        monotonic_arena& operator=(const monotonic_arena&) = delete;
+
+        /**
+         * @brief 析构函数，释放所有向系统申请的内存。
+         */
+        ~monotonic_arena() {
+            release();
+        }
+
+        /**
+         * @brief 分配 bytes 字节的内存。
+         * @param bytes 请求的字节数。
+         * @param alignment 对齐要求，必须是 2 的幂。
+         * @return 指向内存的指针。
+         * @throws std::bad_alloc 如果内存分配失败。
+         */
+        void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+            char* p = align_up(_cur, alignment);
+            if (!p || p > _end || size_t(_end - p) < bytes) {
+                grow(bytes, alignment);
+                p = align_up(_cur, alignment);
+            }
+            _cur = p + bytes;
+            return p;
+        }
+
+        /**
+         * @brief 单次释放不做任何事，内存在 release() 时统一归还。
+         */
+        void deallocate(void*, size_t, size_t = alignof(std::max_align_t)) noexcept { }
+
+        /**
+         * @brief 归还所有向系统申请的内存，并重新从初始缓冲区开始分配。之前分配的内存全部失效。
+         */
+        void release() noexcept {
+            while (_chunks) {
+                chunk* next = _chunks->next;
+                ::operator delete(_chunks);
+                _chunks = next;
+            }
+            _cur = _buffer;
+            _end = _buffer ? _buffer + _buffer_size : nullptr;
+            _next_size = _initial_size;
+        }
+
+    private:
+        /**
+         * @brief 向系统申请的内存块的头部，所有内存块通过它串成链表以便统一释放。
+         */
+        struct alignas(std::max_align_t) chunk {
+            chunk* next;
+        };
+
+        char* _cur; /**< 下一次分配的起始位置 */
+        char* _end; /**< 当前内存块的末尾 */
+        chunk* _chunks; /**< 已向系统申请的内存块链表 */
+        char* _buffer; /**< 调用者提供的初始缓冲区 */
+        size_t _buffer_size; /**< 初始缓冲区的字节数 */
+        size_t _initial_size; /**< 第一次向系统申请的字节数 */
+        size_t _next_size; /**< 下一次向系统申请的字节数 */
+
+        /**
+         * @brief 把指针向上对齐。
+         * @param p 要对齐的指针，可以为空。
+         * @param alignment 对齐要求，必须是 2 的幂。
+         * @return 对齐后的指针；p 为空时返回 nullptr。
+         */
+        static char* align_up(char* p, size_t alignment) noexcept {
+            if (!p) {
+                return nullptr;
+            }
+            uintptr_t value = reinterpret_cast<uintptr_t>(p);
+            return p + ((alignment - value % alignment) % alignment);
+        }
+
+        /**
+         * @brief 申请一个足以容纳 bytes 字节（按 alignment 对齐）的新内存块，之后的分配从中进行。
+         * 块大小翻倍到会溢出时改为恰好满足请求，不再继续翻倍。
+         * @param bytes 请求的字节数。
+         * @param alignment 对齐要求。
+         * @throws std::bad_alloc 如果内存分配失败，或请求加上块头部后超出 size_t 的范围。
+         */
+        void grow(size_t bytes, size_t alignment) {
+            constexpr size_t limit = SIZE_MAX - sizeof(chunk);
+            size_t extra = alignment > alignof(std::max_align_t) ? alignment : 0;
+            if (bytes > limit - extra) {
+                throw std::bad_alloc();
+            }
+            size_t needed = bytes + extra;
+            size_t size = _next_size;
+            while (size < needed) {
+                size = size > limit / 2 ? needed : size * 2;
+            }
+            chunk* c = static_cast<chunk*>(::operator new(sizeof(chunk) + size));
+            c->next = _chunks;
+            _chunks = c;
+            _cur = reinterpret_cast<char*>(c + 1);
+            _end = _cur + size;
+            _next_size = size > limit / 2 ? size : size * 2;
+        }
+    };
+
+    /**
+     * @class arena_allocator
+     * @brief 从 `monotonic_arena` 分配内存的有状态分配器。
+     *
+     * 分配器只保存指向内存区域的指针，拷贝与 `rebind` 后的分配器共享同一个内存区域；
+     * 两个分配器相等当且仅当它们使用同一个内存区域。`deallocate` 不归还内存。
+     * 没有默认构造函数，容器需要通过接受分配器的构造函数传入。
+     *
+     * @tparam T 分配器管理的对象类型。
+     */
+    template <typename T>
+    class arena_allocator {
+    public:
+        using value_type      = T;         /**< 对象类型 */
+        using size_type       = size_t;    /**< 大小类型 */
+        using difference_type = ptrdiff_t; /**< 差值类型 */
+        using pointer         = T*;        /**< 指针类型 */
+        using const_pointer   = const T*;  /**< 常量指针类型 */
+        using reference       = T&;        /**< 引用类型 */
+        using const_reference = const T&;  /**< 常量引用类型 */
+        using is_always_equal = std::false_type; /**< 不同的内存区域分配的内存不能互相释放 */
+
+        template <class U>
+        struct rebind {
+            using other = arena_allocator<U>;
+        };
+
+        /**
+         * @brief 构造一个使用指定内存区域的分配器。
+         * @param arena 内存区域，其生命周期必须长于所有使用它的分配器与容器。
+         */
+        explicit arena_allocator(monotonic_arena& arena) noexcept : _arena(&arena) { }
+
+        /**
+         * @brief 模板拷贝构造函数，与 other 共享同一个内存区域。
+         * @tparam U 另一个分配器管理的对象类型。
+         * @param other 要复制的分配器。
+         */
+        template <class U>
+        arena_allocator(const arena_allocator<U>& other) noexcept : _arena(other.arena()) { }
+
+        /**
+         * @brief 分配可容纳 n 个对象的内存。
+         * @param n 对象数量。
+         * @return 指向内存的指针，如果 n 为 0，则返回 nullptr。
+         * @throws std::bad_alloc 如果内存分配失败。
+         */
+        pointer allocate(size_type n) {
+            if (n == 0) {
+                return nullptr;
+            }
+            if (n > max_size()) {
+                throw std::bad_alloc();
+            }
+            return static_cast<pointer>(_arena->allocate(n * sizeof(T), alignof(T)));
+        }
+
+        /**
+         * @brief 释放内存，什么也不做；内存在内存区域 release() 时统一归还。
+         * @param p 指向内存的指针。
+         * @param n 分配时的对象数量。
+         */
+        void deallocate(pointer p, size_type n) noexcept {
+            assert(p != nullptr && n > 0);
+            (void)p;
+            (void)n;
+        }
+
+        /**
+         * @brief 在已分配的内存上构造对象。
+         * @tparam Args 构造函数参数的类型包。
+         * @param p 指向已分配内存的指针。
+         * @param args 用于构造对象的参数。
+         * @return 指向构造好的对象的指针。
+         */
+        template <typename... Args>
+        pointer construct(pointer p, Args&&... args) {
+            assert(p != nullptr);
+            return ::new (static_cast<void*>(p)) value_type(static_cast<Args&&>(args)...);
+        }
+
+        /**
+         * @brief 销毁已构造的对象。
+         * @param p 指向要销毁的对象的指针。
+         */
+        void destroy(pointer p) {
+            assert(p != nullptr);
+            p->~value_type();
+        }
+
+        /**
+         * @brief 获取分配器可以分配的最大对象数量。
+         * @return 最大对象数量。
+         */
+        size_type max_size() const noexcept {
+            return size_type(-1) / sizeof(value_type);
+        }
+
+        /**
+         * @brief 返回分配器使用的内存区域。
+         * @return 指向内存区域的指针。
+         */
+        monotonic_arena* arena() const noexcept {
+            return _arena;
+        }
+
+    private:
+        monotonic_arena* _arena; /**< 使用的内存区域 */
+    };
+
+    /**
+     * @brief 判断两个 `arena_allocator` 是否相等，即是否使用同一个内存区域。
+     * @tparam T1 第一个分配器管理的对象类型。
+     * @tparam T2 第二个分配器管理的对象类型。
+     * @param lhs 第一个分配器。
+     * @param rhs 第二个分配器。
+     * @return 使用同一个内存区域时返回 `true`。
+     */
+    template <class T1, class T2>
+    bool operator==(const arena_allocator<T1>& lhs, const arena_allocator<T2>& rhs) noexcept {
+        return lhs.arena() == rhs.arena();
+    }
+
+    /**
+     * @brief 判断两个 `arena_allocator` 是否不相等。
+     * @tparam T1 第一个分配器管理的对象类型。
+     * @tparam T2 第二个分配器管理的对象类型。
+     * @param lhs 第一个分配器。
+     * @param rhs 第二个分配器。
+     * @return 使用不同的内存区域时返回 `true`。
+     */
+    template <class T1, class T2>
+    bool operator!=(const arena_allocator<T1>& lhs, const arena_allocator<T2>& rhs) noexcept {
+        return !(lhs == rhs);
+    }
+
+}
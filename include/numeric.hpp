@@ -0,0 +1,95 @@
+/**
+ * @file numeric.hpp
+ * @brief 此文件定义了 tiny_stl 命名空间下的数值算法，例如 accumulate、reduce。
+ * 分段迭代器（例如 deque 的迭代器）按缓冲区逐段处理，内层循环只是简单的指针循环。
+ */
+
+#pragma once
+
+#ifdef __GNUC__
+#   pragma GCC system_header
+#endif
+#if defined(_MSC_VER) && _MSC_VER >= 1920
+#   pragma system_header
+#endif
+
+#include <algorithm.hpp>
+#include <utility.hpp>
+
+namespace tiny_stl {
+
+    /**
+     * @brief 从 init 开始，依次用 op 把 [first, last) 中的元素累积起来。
+     * @tparam InputIterator 输入迭代器类型。
+     * @tparam T 累积值的类型。
+     * @tparam BinaryOperation 二元操作的类型。
+     * @param first 起始迭代器。
+     * @param last 结束迭代器。
+     * @param init 初始值。
+     * @param op 二元操作，op(acc, x) 返回新的累积值。
+     * @return 累积的结果。
+     */
+    template <typename InputIterator, typename T, typename BinaryOperation>
+    T accumulate(InputIterator first, InputIterator last, T init, BinaryOperation op) {
+        if constexpr (__is_segmented_iterator_v<InputIterator>) {
+            __for_each_segment(first, last, [&init, &op](auto lfirst, auto llast) {
+                init = tiny_stl::accumulate(lfirst, llast, tiny_stl::move(init), op);
+            });
+        } else {
+            for (; first != last; ++first) {
+                init = op(tiny_stl::move(init), *first);
+            }
+        }
+        return init;
+    }
+
+    /**
+     * @brief 从 init 开始，依次用 operator+ 把 [first, last) 中的元素累加起来。
+     * @tparam InputIterator 输入迭代器类型。
+     * @tparam T 累加值的类型。
+     * @param first 起始迭代器。
+     * @param last 结束迭代器。
+     * @param init 初始值。
+     * @return 累加的结果。
+     */
+    template <typename InputIterator, typename T>
+    T accumulate(InputIterator first, InputIterator last, T init) {
+        return tiny_stl::accumulate(first, last, tiny_stl::move(init),
+                                    [](T&& acc, const auto& x) { return tiny_stl::move(acc) + x; });
+    }
+
+    /**
+     * @brief 从 init 开始，用 op 把 [first, last) 中的元素归约起来。
+     * 与 accumulate 不同，op 需要满足结合律与交换律，元素可以按任意顺序、任意分组归约，
+     * 并行版本（见 execution.hpp）据此把范围拆成若干块分别归约再合并。
+     * @tparam InputIterator 输入迭代器类型。
+     * @tparam T 归约值的类型。
+     * @tparam BinaryOperation 二元操作的类型。
+     * @param first 起始迭代器。
+     * @param last 结束迭代器。
+     * @param init 初始值。
+     * @param op 二元操作。
+     * @return 归约的结果。
+     */
+    template <typename InputIterator, typename T, typename BinaryOperation>
+    T reduce(InputIterator first, InputIterator last, T init, BinaryOperation op) {
+        return tiny_stl::accumulate(first, last, tiny_stl::move(init), op);
+    }
+
+    /**
+     * @brief 从 init 开始，用 operator+ 把 [first, last) 中的元素归约起来。
+     */
+    template <typename InputIterator, typename T>
+    T reduce(InputIterator first, InputIterator last, T init) {
+        return tiny_stl::accumulate(first, last, tiny_stl::move(init));
+    }
+
+    /**
+     * @brief 用 operator+ 把 [first, last) 中的元素归约起来，初始值为值初始化的元素类型。
+     */
+    template <typename InputIterator>
+    typename iterator_traits<InputIterator>::value_type reduce(InputIterator first, InputIterator last) {
+        return tiny_stl::accumulate(first, last, typename iterator_traits<InputIterator>::value_type());
+    }
+
+}
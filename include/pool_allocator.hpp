@@ -0,0 +1,410 @@
+/**
+ * @file pool_allocator.hpp
+ * @brief 此文件定义了 tiny_stl 命名空间下的 `pool_resource` 与 `pool_allocator`。
+ *
+ * `pool_resource` 按大小类别（8、16、32 ... 4096 字节）维护定长块的空闲链表，
+ * 每个类别按需向 `::operator new` 申请一整块内存并切分成若干定长块，
+ * 之后的分配与释放只是对空闲链表的一次压入或弹出。
+ * `pool_allocator<T>` 是引用某个 `pool_resource` 的有状态分配器，可以通过 `rebind`
+ * 用于 `list` 的节点、`deque` 的缓冲区与管控中心以及 `vector` 的存储；
+ * 默认构造的 `pool_allocator` 总是使用调用线程自己的默认内存池。
+ */
+
+#pragma once
+
+#ifdef __GNUC__
+#   pragma GCC system_header
+#endif
+#if defined(_MSC_VER) && _MSC_VER >= 1920
+#   pragma system_header
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <cassert>
+#include <atomic>
+#include <type_traits>
+
+namespace tiny_stl {
+
+    /**
+     * @class pool_resource
+     * @brief 按大小类别管理定长块的内存池。
+     *
+     * 请求的字节数向上取整到 2 的幂作为大小类别；超过 `max_block` 字节或对齐要求超过
+     * `alignof(std::max_align_t)` 的请求直接转交给 `::operator new`。
+     * 释放的块回到所属类别的空闲链表中，只有 `release()` 或析构时才把内存归还给系统。
+     *
+     * @note 该类不是线程安全的，同一个 `pool_resource` 只能由一个线程使用。
+     */
+    class pool_resource {
+    public:
+        static constexpr size_t min_block = 8; /**< 最小的块大小（字节） */
+        static constexpr size_t max_block = 4096; /**< 由内存池管理的最大块大小（字节） */
+        static constexpr size_t class_count = 10; /**< 大小类别的数量 */
+
+        /**
+         * @brief 默认构造函数，所有空闲链表为空，不分配任何内存。
+         */
+        pool_resource() noexcept : _chunks(nullptr), _next_default(nullptr) {
+            for (size_t i = 0; i < class_count; ++i) {
+                _free[i] = nullptr;
+                _chunk_blocks[i] = initial_blocks(i);
+            }
+        }
+
+        pool_resource(const pool_resource&) = delete;
+        pool_resource& operator=(const pool_resource&) = delete;
+
+        /**
+         * @brief 析构函数，释放内存池持有的全部内存。
+         */
+        ~pool_resource() {
+            release();
+        }
+
+        /**
+         * @brief 分配 bytes 字节的内存。
+         * @param bytes 请求的字节数。
+         * @param alignment 对齐要求。
+         * @return 指向内存的指针。
+         * @throws std::bad_alloc 如果内存分配失败。
+         */
+        void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+            if (!pooled(bytes, alignment)) {
+                return allocate_large(bytes, alignment);
+            }
+            size_t index = class_of(bytes);
+            if (!_free[index]) {
+                refill(index);
+            }
+            free_block* block = _free[index];
+            _free[index] = block->next;
+            return block;
+        }
+
+        /**
+         * @brief 释放由 allocate 分配的内存。
+         * @param p 指向内存的指针。
+         * @param bytes 分配时请求的字节数。
+         * @param alignment 分配时的对齐要求。
+         */
+        void deallocate(void* p, size_t bytes, size_t alignment = alignof(std::max_align_t)) noexcept {
+            assert(p != nullptr);
+            if (!pooled(bytes, alignment)) {
+                deallocate_large(p, alignment);
+                return;
+            }
+            size_t index = class_of(bytes);
+            free_block* block = static_cast<free_block*>(p);
+            block->next = _free[index];
+            _free[index] = block;
+        }
+
+        /**
+         * @brief 把内存池持有的全部内存归还给系统，之前分配的块全部失效。
+         */
+        void release() noexcept {
+            while (_chunks) {
+                chunk* next = _chunks->next;
+                ::operator delete(_chunks);
+                _chunks = next;
+            }
+            for (size_t i = 0; i < class_count; ++i) {
+                _free[i] = nullptr;
+                _chunk_blocks[i] = initial_blocks(i);
+            }
+        }
+
+        /**
+         * @brief 返回当前线程的默认内存池，默认构造的 `pool_allocator` 使用它。
+         *
+         * 每个线程第一次调用时创建自己的内存池，该内存池直到程序结束都不会释放。
+         * 默认构造的 `pool_allocator` 每次分配与释放都使用调用线程的默认内存池，
+         * 因此块可以在其他线程、或在分配它的线程退出后释放：块进入释放线程的空闲链表，
+         * 各个默认内存池只被自己的线程访问。也正因为块会在默认内存池之间流动，
+         * 不能对默认内存池调用 `release()`。
+         *
+         * @return 当前线程的默认内存池。
+         */
+        static pool_resource& thread_default() {
+            static thread_local pool_resource* pool = nullptr;
+            if (!pool) {
+                pool = new pool_resource();
+                // 挂到全局链表上，使内存池在线程退出后仍可达
+                pool->_next_default = default_pools().load(std::memory_order_relaxed);
+                while (!default_pools().compare_exchange_weak(pool->_next_default, pool,
+                        std::memory_order_release, std::memory_order_relaxed)) { }
+            }
+            return *pool;
+        }
+
+    private:
+        /**
+         * @brief 空闲块，空闲时块的起始位置存放指向下一个空闲块的指针。
+         */
+        struct free_block {
+            free_block* next;
+        };
+
+        /**
+         * @brief 从系统申请的一整块内存的头部，所有块通过它串成链表以便统一释放。
+         */
+        struct alignas(std::max_align_t) chunk {
+            chunk* next;
+        };
+
+        static constexpr size_t max_chunk_bytes = 256 * 1024; /**< 单次向系统申请的最大字节数 */
+
+        free_block* _free[class_count]; /**< 每个大小类别的空闲链表 */
+        size_t _chunk_blocks[class_count]; /**< 每个大小类别下一次申请的块数量 */
+        chunk* _chunks; /**< 已从系统申请的内存块链表 */
+        pool_resource* _next_default; /**< 所有线程默认内存池组成的链表 */
+
+        /**
+         * @brief 所有线程默认内存池组成的链表的表头。
+         * @return 表头的引用。
+         */
+        static std::atomic<pool_resource*>& default_pools() noexcept {
+            static std::atomic<pool_resource*> head{nullptr};
+            return head;
+        }
+
+        /**
+         * @brief 判断请求能否由内存池满足。
+         * @param bytes 请求的字节数。
+         * @param alignment 对齐要求。
+         * @return 能由内存池满足时返回 true。
+         */
+        static constexpr bool pooled(size_t bytes, size_t alignment) noexcept {
+            return bytes <= max_block && alignment <= alignof(std::max_align_t);
+        }
+
+        /**
+         * @brief 计算请求所属的大小类别。
+         * @param bytes 请求的字节数，不超过 max_block。
+         * @return 大小类别的下标，对应的块大小为 `min_block << index`。
+         */
+        static size_t class_of(size_t bytes) noexcept {
+            size_t index = 0;
+            size_t size = min_block;
+            while (size < bytes) {
+                size <<= 1;
+                ++index;
+            }
+            return index;
+        }
+
+        /**
+         * @brief 计算大小类别第一次向系统申请的块数量，约为 4 KiB，至少 4 块。
+         * @param index 大小类别的下标。
+         * @return 块数量。
+         */
+        static constexpr size_t initial_blocks(size_t index) noexcept {
+            return (min_block << index) >= 1024 ? 4 : 4096 / (min_block << index);
+        }
+
+        /**
+         * @brief 为大小类别申请一整块内存并切分成空闲块。每次申请的块数量翻倍，直到达到 max_chunk_bytes。
+         * @param index 大小类别的下标。
+         * @throws std::bad_alloc 如果内存分配失败。
+         */
+        void refill(size_t index) {
+            size_t block_size = min_block << index;
+            size_t count = _chunk_blocks[index];
+            chunk* c = static_cast<chunk*>(::operator new(sizeof(chunk) + count * block_size));
+            c->next = _chunks;
+            _chunks = c;
+
+            char* first = reinterpret_cast<char*>(c + 1);
+            for (size_t i = count; i-- > 0;) {
+                free_block* block = reinterpret_cast<free_block*>(first + i * block_size);
+                block->next = _free[index];
+                _free[index] = block;
+            }
+            if (count * block_size * 2 <= max_chunk_bytes) {
+                _chunk_blocks[index] = count * 2;
+            }
+        }
+
+        /**
+         * @brief 分配不由内存池管理的内存。
+         * @param bytes 请求的字节数。
+         * @param alignment 对齐要求。
+         * @return 指向内存的指针。
+         */
+        static void* allocate_large(size_t bytes, size_t alignment) {
+            if (alignment > alignof(std::max_align_t)) {
+                return ::operator new(bytes, std::align_val_t(alignment));
+            }
+            return ::operator new(bytes);
+        }
+
+        /**
+         * @brief 释放不由内存池管理的内存。
+         * @param p 指向内存的指针。
+         * @param alignment 分配时的对齐要求。
+         */
+        static void deallocate_large(void* p, size_t alignment) noexcept {
+            if (alignment > alignof(std::max_align_t)) {
+                ::operator delete(p, std::align_val_t(alignment));
+            } else {
+                ::operator delete(p);
+            }
+        }
+    };
+
+    /**
+     * @class pool_allocator
+     * @brief 从 `pool_resource` 分配内存的有状态分配器。
+     *
+     * 分配器只保存指向内存池的指针，拷贝与 `rebind` 后的分配器共享同一个内存池；
+     * 两个分配器相等当且仅当它们使用同一个内存池。
+     * 默认构造的分配器不绑定内存池，每次分配与释放都使用调用线程的默认内存池
+     * `pool_resource::thread_default()`，所有默认构造的分配器彼此相等，
+     * 使用它们的容器可以在任何线程中修改或销毁（同一时刻仍只能由一个线程访问）。
+     *
+     * @tparam T 分配器管理的对象类型。
+     */
+    template <typename T>
+    class pool_allocator {
+    public:
+        using value_type      = T;         /**< 对象类型 */
+        using size_type       = size_t;    /**< 大小类型 */
+        using difference_type = ptrdiff_t; /**< 差值类型 */
+        using pointer         = T*;        /**< 指针类型 */
+        using const_pointer   = const T*;  /**< 常量指针类型 */
+        using reference       = T&;        /**< 引用类型 */
+        using const_reference = const T&;  /**< 常量引用类型 */
+        using is_always_equal = std::false_type; /**< 不同的内存池分配的内存不能互相释放 */
+
+        template <class U>
+        struct rebind {
+            using other = pool_allocator<U>;
+        };
+
+        /**
+         * @brief 默认构造函数，使用调用线程的默认内存池。
+         */
+        pool_allocator() noexcept : _pool(nullptr) { }
+
+        /**
+         * @brief 构造一个使用指定内存池的分配器。
+         * @param pool 内存池，其生命周期必须长于所有使用它的分配器与容器。
+         */
+        explicit pool_allocator(pool_resource& pool) noexcept : _pool(&pool) { }
+
+        /**
+         * @brief 模板拷贝构造函数，与 other 共享同一个内存池。
+         * @tparam U 另一个分配器管理的对象类型。
+         * @param other 要复制的分配器。
+         */
+        template <class U>
+        pool_allocator(const pool_allocator<U>& other) noexcept : _pool(other._pool) { }
+
+        /**
+         * @brief 分配可容纳 n 个对象的内存。
+         * @param n 对象数量。
+         * @return 指向内存的指针，如果 n 为 0，则返回 nullptr。
+         * @throws std::bad_alloc 如果内存分配失败。
+         */
+        pointer allocate(size_type n) {
+            if (n == 0) {
+                return nullptr;
+            }
+            if (n > max_size()) {
+                throw std::bad_alloc();
+            }
+            return static_cast<pointer>(pool().allocate(n * sizeof(T), alignof(T)));
+        }
+
+        /**
+         * @brief 释放由 allocate 分配的内存。
+         * @param p 指向内存的指针。
+         * @param n 分配时的对象数量。
+         */
+        void deallocate(pointer p, size_type n) {
+            assert(p != nullptr && n > 0);
+            pool().deallocate(p, n * sizeof(T), alignof(T));
+        }
+
+        /**
+         * @brief 在已分配的内存上构造对象。
+         * @tparam Args 构造函数参数的类型包。
+         * @param p 指向已分配内存的指针。
+         * @param args 用于构造对象的参数。
+         * @return 指向构造好的对象的指针。
+         */
+        template <typename... Args>
+        pointer construct(pointer p, Args&&... args) {
+            assert(p != nullptr);
+            return ::new (static_cast<void*>(p)) value_type(static_cast<Args&&>(args)...);
+        }
+
+        /**
+         * @brief 销毁已构造的对象。
+         * @param p 指向要销毁的对象的指针。
+         */
+        void destroy(pointer p) {
+            assert(p != nullptr);
+            p->~value_type();
+        }
+
+        /**
+         * @brief 获取分配器可以分配的最大对象数量。
+         * @return 最大对象数量。
+         */
+        size_type max_size() const noexcept {
+            return size_type(-1) / sizeof(value_type);
+        }
+
+        /**
+         * @brief 返回分配器绑定的内存池。
+         * @return 指向内存池的指针；默认构造的分配器返回 nullptr，表示调用线程的默认内存池。
+         */
+        pool_resource* resource() const noexcept {
+            return _pool;
+        }
+
+    private:
+        template <class U>
+        friend class pool_allocator;
+
+        pool_resource* _pool; /**< 绑定的内存池，为空时使用调用线程的默认内存池 */
+
+        /**
+         * @brief 返回本次分配或释放使用的内存池。
+         */
+        pool_resource& pool() const {
+            return _pool ? *_pool : pool_resource::thread_default();
+        }
+    };
+
+    /**
+     * @brief 判断两个 `pool_allocator` 是否相等，即是否使用同一个内存池。
+     * @tparam T1 第一个分配器管理的对象类型。
+     * @tparam T2 第二个分配器管理的对象类型。
+     * @param lhs 第一个分配器。
+     * @param rhs 第二个分配器。
+     * @return 使用同一个内存池时返回 `true`。
+     */
+    template <class T1, class T2>
+    bool operator==(const pool_allocator<T1>& lhs, const pool_allocator<T2>& rhs) noexcept {
+        return lhs.resource() == rhs.resource();
+    }
+
+    /**
+     * @brief 判断两个 `pool_allocator` 是否不相等。
+     * @tparam T1 第一个分配器管理的对象类型。
+     * @tparam T2 第二个分配器管理的对象类型。
+     * @param lhs 第一个分配器。
+     * @param rhs 第二个分配器。
+     * @return 使用不同的内存池时返回 `true`。
+     */
+    template <class T1, class T2>
+    bool operator!=(const pool_allocator<T1>& lhs, const pool_allocator<T2>& rhs) noexcept {
+        return !(lhs == rhs);
+    }
+
+}
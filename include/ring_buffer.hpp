@@ -0,0 +1,509 @@
+/**
+ * @file ring_buffer.hpp
+ * @brief 此文件定义了 tiny_stl 命名空间下的无锁有界环形队列 `spsc_ring_buffer` 与 `mpmc_ring_buffer`。
+ *
+ * 两者都使用固定容量的 `tiny_stl::array` 作为存储，构造之后不再分配内存；
+ * 生产者与消费者各自修改的索引放在不同的缓存行中，避免伪共享。
+ * - `spsc_ring_buffer`：单生产者单消费者，每次操作只有一次 acquire 读与一次 release 写；
+ * - `mpmc_ring_buffer`：多生产者多消费者，采用 Dmitry Vyukov 的有界队列算法，每个槽位带有序号。
+ */
+
+#pragma once
+
+#ifdef __GNUC__
+#   pragma GCC system_header
+#endif
+#if defined(_MSC_VER) && _MSC_VER >= 1920
+#   pragma system_header
+#endif
+
+#include <array.hpp>
+#include <memory.hpp>
+#include <utility.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+namespace tiny_stl {
+
+    /**
+     * @struct __ring_slot
+     * @brief 可容纳一个 T 的未初始化存储，对象的构造与销毁由使用者负责。
+     * 本身是平凡类型，因此可以作为 `array` 的元素。
+     * @tparam T 对象类型
+     */
+    template <typename T>
+    struct __ring_slot {
+        alignas(T) unsigned char storage[sizeof(T)]; /**< 对象的存储 */
+
+        /**
+         * @brief 返回存储中的对象
+         * @return 指向对象的指针
+         */
+        T* get() noexcept {
+            return std::launder(reinterpret_cast<T*>(storage));
+        }
+
+        /**
+         * @brief 返回存储的起始地址，用于构造对象
+         * @return 指向存储的指针
+         */
+        void* address() noexcept {
+            return storage;
+        }
+    };
+
+    /**
+     * @class spsc_ring_buffer
+     * @brief 单生产者单消费者的无锁有界环形队列。
+     *
+     * 同一时刻最多一个线程调用 try_push 系列函数，最多一个线程调用 try_pop 系列函数。
+     * 生产者与消费者各自缓存一份对方的索引，只有缓存显示队列已满（或已空）时才重新读取对方的原子变量，
+     * 因此在不满不空时，一次操作不会访问对方所在的缓存行。
+     *
+     * @tparam T 元素类型
+     * @tparam Capacity 容量，必须是 2 的幂
+     */
+    template <typename T, size_t Capacity>
+    class spsc_ring_buffer {
+        static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "spsc_ring_buffer 的容量必须是 2 的幂");
+    public:
+        using value_type = T; /**< 元素类型 */
+        using size_type = size_t; /**< 大小类型 */
+
+        /**
+         * @brief 构造一个空队列
+         */
+        spsc_ring_buffer() noexcept : _head(0), _cached_tail(0), _tail(0), _cached_head(0) { }
+
+        spsc_ring_buffer(const spsc_ring_buffer&) = delete;
+        spsc_ring_buffer& operator=(const spsc_ring_buffer&) = delete;
+
+        /**
+         * @brief 析构函数，销毁队列中剩余的元素，调用时不能有其他线程访问队列
+         */
+        ~spsc_ring_buffer() {
+            size_type tail = _tail.load(std::memory_order_acquire);
+            for (size_type head = _head.load(std::memory_order_relaxed); head != tail; ++head) {
+                slot(head).get()->~T();
+            }
+        }
+
+        /**
+         * @brief 在队尾用args原地构造一个元素，仅限生产者线程调用
+         * @tparam Args 构造参数的类型包
+         * @param args 构造参数
+         * @return 成功时返回true；队列已满时返回false，不构造元素
+         */
+        template <typename... Args>
+        bool try_emplace(Args&&... args) {
+            size_type tail = _tail.load(std::memory_order_relaxed);
+            if (tail - _cached_head == Capacity) {
+                _cached_head = _head.load(std::memory_order_acquire);
+                if (tail - _cached_head == Capacity) {
+                    return false;
+                }
+            }
+            ::new (slot(tail).address()) T(tiny_stl::forward<Args>(args)...);
+            _tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief 在队尾添加一个元素，仅限生产者线程调用
+         * @param value 要添加的元素
+         * @return 成功时返回true；队列已满时返回false
+         */
+        bool try_push(const value_type& value) {
+            return try_emplace(value);
+        }
+
+        /**
+         * @brief 在队尾添加一个元素，移动value，仅限生产者线程调用
+         * @param value 要添加的元素，队列已满时不会被移动
+         * @return 成功时返回true；队列已满时返回false
+         */
+        bool try_push(value_type&& value) {
+            return try_emplace(tiny_stl::move(value));
+        }
+
+        /**
+         * @brief 从first开始最多添加n个元素，仅限生产者线程调用
+         * 只读取一次消费者的索引，全部元素构造完毕后一次性发布
+         * @tparam InputIterator 输入迭代器类型
+         * @param first 起始迭代器
+         * @param n 最多添加的元素数量
+         * @return 实际添加的元素数量，队列空位不足时小于n
+         */
+        template <typename InputIterator>
+        size_type try_push_n(InputIterator first, size_type n) {
+            size_type tail = _tail.load(std::memory_order_relaxed);
+            if (Capacity - (tail - _cached_head) < n) {
+                _cached_head = _head.load(std::memory_order_acquire);
+            }
+            size_type vacancies = Capacity - (tail - _cached_head);
+            size_type count = n < vacancies ? n : vacancies;
+            size_type i = 0;
+            try {
+                for (; i < count; ++i, (void)++first) {
+                    ::new (slot(tail + i).address()) T(*first);
+                }
+            } catch (...) {
+                _tail.store(tail + i, std::memory_order_release);
+                throw;
+            }
+            _tail.store(tail + count, std::memory_order_release);
+            return count;
+        }
+
+        /**
+         * @brief 移出队首元素，仅限消费者线程调用
+         * @param out 接收元素的对象
+         * @return 成功时返回true；队列为空时返回false，不修改out
+         */
+        bool try_pop(value_type& out) {
+            size_type head = _head.load(std::memory_order_relaxed);
+            if (head == _cached_tail) {
+                _cached_tail = _tail.load(std::memory_order_acquire);
+                if (head == _cached_tail) {
+                    return false;
+                }
+            }
+            T* p = slot(head).get();
+            out = tiny_stl::move(*p);
+            p->~T();
+            _head.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief 最多移出n个元素，依次写入out，仅限消费者线程调用
+         * 只读取一次生产者的索引，全部元素移出之后一次性归还槽位
+         * @tparam OutputIterator 输出迭代器类型
+         * @param out 输出迭代器
+         * @param n 最多移出的元素数量
+         * @return 实际移出的元素数量，队列中元素不足时小于n
+         */
+        template <typename OutputIterator>
+        size_type try_pop_n(OutputIterator out, size_type n) {
+            size_type head = _head.load(std::memory_order_relaxed);
+            if (_cached_tail - head < n) {
+                _cached_tail = _tail.load(std::memory_order_acquire);
+            }
+            size_type available = _cached_tail - head;
+            size_type count = n < available ? n : available;
+            size_type i = 0;
+            try {
+                for (; i < count; ++i, (void)++out) {
+                    T* p = slot(head + i).get();
+                    *out = tiny_stl::move(*p);
+                    p->~T();
+                }
+            } catch (...) {
+                _head.store(head + i, std::memory_order_release);
+                throw;
+            }
+            _head.store(head + count, std::memory_order_release);
+            return count;
+        }
+
+        /**
+         * @brief 获取队列中元素的数量，其他线程同时操作时只是一个近似值
+         * @return 元素的数量
+         */
+        size_type size() const noexcept {
+            size_type head = _head.load(std::memory_order_acquire);
+            size_type tail = _tail.load(std::memory_order_acquire);
+            return tail - head;
+        }
+
+        /**
+         * @brief 判断队列是否为空，其他线程同时操作时只是一个近似值
+         * @return 为空时返回true
+         */
+        bool empty() const noexcept {
+            return size() == 0;
+        }
+
+        /**
+         * @brief 获取队列的容量
+         * @return 容量
+         */
+        static constexpr size_type capacity() noexcept {
+            return Capacity;
+        }
+
+    private:
+        alignas(__cache_line_size) std::atomic<size_type> _head; /**< 下一个要移出的位置，由消费者写入 */
+        size_type _cached_tail; /**< 消费者缓存的生产者索引 */
+        alignas(__cache_line_size) std::atomic<size_type> _tail; /**< 下一个要写入的位置，由生产者写入 */
+        size_type _cached_head; /**< 生产者缓存的消费者索引 */
+        alignas(__cache_line_size) array<__ring_slot<T>, Capacity> _slots; /**< 元素的存储 */
+
+        /**
+         * @brief 返回索引对应的槽位
+         * @param index 单调递增的索引
+         * @return 槽位的引用
+         */
+        __ring_slot<T>& slot(size_type index) noexcept {
+            return _slots[index & (Capacity - 1)];
+        }
+    };
+
+    /**
+     * @class mpmc_ring_buffer
+     * @brief 多生产者多消费者的无锁有界环形队列（Dmitry Vyukov 的有界 MPMC 队列）。
+     *
+     * 每个槽位带有一个序号：序号等于位置 pos 时槽位空闲，可以写入第 pos 个元素；
+     * 序号等于 pos + 1 时槽位已写入，可以移出；移出后序号设为 pos + Capacity，留给下一轮。
+     * 生产者与消费者分别通过 CAS 推进各自的位置来占用槽位，之后只写自己占用的槽位，
+     * 不同线程之间只在同一个槽位上同步。批量操作一次 CAS 占用多个连续槽位。
+     *
+     * 槽位一旦被占用就必须完成写入或移出，因此要求 T 的移动构造、移动赋值与析构不抛出异常；
+     * 构造可能抛出异常时，try_emplace 先在槽位之外构造好元素，再把它移动进槽位。
+     *
+     * @tparam T 元素类型
+     * @tparam Capacity 容量，必须是 2 的幂
+     */
+    template <typename T, size_t Capacity>
+    class mpmc_ring_buffer {
+        static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "mpmc_ring_buffer 的容量必须是 2 的幂");
+        static_assert(std::is_nothrow_move_constructible<T>::value && std::is_nothrow_move_assignable<T>::value &&
+                      std::is_nothrow_destructible<T>::value,
+                      "mpmc_ring_buffer 要求元素的移动构造、移动赋值与析构不抛出异常");
+    public:
+        using value_type = T; /**< 元素类型 */
+        using size_type = size_t; /**< 大小类型 */
+
+        /**
+         * @brief 构造一个空队列
+         */
+        mpmc_ring_buffer() noexcept : _enqueue_pos(0), _dequeue_pos(0) {
+            for (size_type i = 0; i < Capacity; ++i) {
+                ::new (_cells[i].sequence.address()) std::atomic<size_type>(i);
+            }
+        }
+
+        mpmc_ring_buffer(const mpmc_ring_buffer&) = delete;
+        mpmc_ring_buffer& operator=(const mpmc_ring_buffer&) = delete;
+
+        /**
+         * @brief 析构函数，销毁队列中剩余的元素，调用时不能有其他线程访问队列
+         */
+        ~mpmc_ring_buffer() {
+            size_type tail = _enqueue_pos.load(std::memory_order_acquire);
+            for (size_type pos = _dequeue_pos.load(std::memory_order_relaxed); pos != tail; ++pos) {
+                cell_at(pos).value.get()->~T();
+            }
+        }
+
+        /**
+         * @brief 在队尾用args构造一个元素
+         * @tparam Args 构造参数的类型包
+         * @param args 构造参数
+         * @return 成功时返回true；队列已满时返回false
+         */
+        template <typename... Args>
+        bool try_emplace(Args&&... args) {
+            if constexpr (std::is_nothrow_constructible<T, Args&&...>::value) {
+                size_type pos;
+                if (claim(_enqueue_pos, 1, 0, pos) == 0) {
+                    return false;
+                }
+                publish(pos, tiny_stl::forward<Args>(args)...);
+                return true;
+            } else {
+                // 构造可能抛出异常，先在槽位之外构造，避免占用槽位之后无法完成写入
+                T tmp(tiny_stl::forward<Args>(args)...);
+                return try_emplace(tiny_stl::move(tmp));
+            }
+        }
+
+        /**
+         * @brief 在队尾添加一个元素
+         * @param value 要添加的元素
+         * @return 成功时返回true；队列已满时返回false
+         */
+        bool try_push(const value_type& value) {
+            return try_emplace(value);
+        }
+
+        /**
+         * @brief 在队尾添加一个元素，移动value
+         * @param value 要添加的元素，队列已满时不会被移动
+         * @return 成功时返回true；队列已满时返回false
+         */
+        bool try_push(value_type&& value) {
+            return try_emplace(tiny_stl::move(value));
+        }
+
+        /**
+         * @brief 从first开始最多添加n个元素
+         * 由 *first 构造元素不抛出异常时，一次 CAS 占用全部可用的连续槽位；否则逐个调用 try_push
+         * @tparam InputIterator 输入迭代器类型
+         * @param first 起始迭代器
+         * @param n 最多添加的元素数量
+         * @return 实际添加的元素数量，队列空位不足时小于n
+         */
+        template <typename InputIterator>
+        size_type try_push_n(InputIterator first, size_type n) {
+            if constexpr (std::is_nothrow_constructible<T, decltype(*first)>::value) {
+                size_type pos;
+                size_type count = claim(_enqueue_pos, n, 0, pos);
+                for (size_type i = 0; i < count; ++i, (void)++first) {
+                    publish(pos + i, *first);
+                }
+                return count;
+            } else {
+                size_type count = 0;
+                for (; count < n && try_push(*first); ++count, (void)++first) { }
+                return count;
+            }
+        }
+
+        /**
+         * @brief 移出队首元素
+         * @param out 接收元素的对象
+         * @return 成功时返回true；队列为空时返回false，不修改out
+         */
+        bool try_pop(value_type& out) noexcept {
+            size_type pos;
+            if (claim(_dequeue_pos, 1, 1, pos) == 0) {
+                return false;
+            }
+            consume(pos, out);
+            return true;
+        }
+
+        /**
+         * @brief 最多移出n个元素，依次写入out，一次 CAS 占用全部可用的连续槽位
+         * @tparam OutputIterator 输出迭代器类型，写入不能抛出异常（例如指向已有元素的迭代器或指针）
+         * @param out 输出迭代器
+         * @param n 最多移出的元素数量
+         * @return 实际移出的元素数量，队列中元素不足时小于n
+         */
+        template <typename OutputIterator>
+        size_type try_pop_n(OutputIterator out, size_type n) {
+            size_type pos;
+            size_type count = claim(_dequeue_pos, n, 1, pos);
+            for (size_type i = 0; i < count; ++i, (void)++out) {
+                consume(pos + i, *out);
+            }
+            return count;
+        }
+
+        /**
+         * @brief 获取队列中元素的数量，其他线程同时操作时只是一个近似值
+         * @return 元素的数量
+         */
+        size_type size() const noexcept {
+            size_type head = _dequeue_pos.load(std::memory_order_acquire);
+            size_type tail = _enqueue_pos.load(std::memory_order_acquire);
+            // 两次读取之间其他线程可能推进了位置，差值为负时视为空
+            return static_cast<ptrdiff_t>(tail - head) > 0 ? tail - head : 0;
+        }
+
+        /**
+         * @brief 判断队列是否为空，其他线程同时操作时只是一个近似值
+         * @return 为空时返回true
+         */
+        bool empty() const noexcept {
+            return size() == 0;
+        }
+
+        /**
+         * @brief 获取队列的容量
+         * @return 容量
+         */
+        static constexpr size_type capacity() noexcept {
+            return Capacity;
+        }
+
+    private:
+        /**
+         * @brief 槽位：序号与元素的存储
+         */
+        struct cell {
+            __ring_slot<std::atomic<size_type>> sequence; /**< 槽位的序号 */
+            __ring_slot<T> value; /**< 元素的存储 */
+        };
+
+        alignas(__cache_line_size) std::atomic<size_type> _enqueue_pos; /**< 下一个要写入的位置 */
+        alignas(__cache_line_size) std::atomic<size_type> _dequeue_pos; /**< 下一个要移出的位置 */
+        alignas(__cache_line_size) array<cell, Capacity> _cells; /**< 槽位 */
+
+        /**
+         * @brief 返回位置对应的槽位
+         * @param pos 单调递增的位置
+         * @return 槽位的引用
+         */
+        cell& cell_at(size_type pos) noexcept {
+            return _cells[pos & (Capacity - 1)];
+        }
+
+        /**
+         * @brief 从counter开始占用最多n个连续的可用槽位
+         * 槽位可用的条件是它的序号等于 位置 + offset；写入时 offset 为 0，移出时为 1
+         * @param counter 生产者或消费者的位置
+         * @param n 最多占用的槽位数量
+         * @param offset 可用槽位的序号相对于位置的偏移
+         * @param pos 输出占用的第一个位置
+         * @return 占用的槽位数量，队列已满（写入）或为空（移出）时为 0
+         */
+        size_type claim(std::atomic<size_type>& counter, size_type n, size_type offset, size_type& pos) noexcept {
+            pos = counter.load(std::memory_order_relaxed);
+            for (;;) {
+                size_type count = 0;
+                ptrdiff_t diff = 0;
+                for (; count < n; ++count) {
+                    size_type seq = cell_at(pos + count).sequence.get()->load(std::memory_order_acquire);
+                    diff = static_cast<ptrdiff_t>(seq - (pos + count + offset));
+                    if (diff != 0) {
+                        break;
+                    }
+                }
+                if (count == 0) {
+                    if (diff < 0 || n == 0) {
+                        return 0;
+                    }
+                    // 其他线程已经占用了这个位置，重新读取
+                    pos = counter.load(std::memory_order_relaxed);
+                } else if (counter.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed,
+                                                         std::memory_order_relaxed)) {
+                    return count;
+                }
+            }
+        }
+
+        /**
+         * @brief 在已占用的位置上构造元素并发布给消费者
+         * @tparam Args 构造参数的类型包
+         * @param pos 已占用的位置
+         * @param args 构造参数，构造不能抛出异常
+         */
+        template <typename... Args>
+        void publish(size_type pos, Args&&... args) noexcept {
+            cell& c = cell_at(pos);
+            ::new (c.value.address()) T(tiny_stl::forward<Args>(args)...);
+            c.sequence.get()->store(pos + 1, std::memory_order_release);
+        }
+
+        /**
+         * @brief 从已占用的位置移出元素，并把槽位留给下一轮的生产者
+         * @tparam Out 接收元素的类型
+         * @param pos 已占用的位置
+         * @param out 接收元素的对象
+         */
+        template <typename Out>
+        void consume(size_type pos, Out&& out) noexcept {
+            cell& c = cell_at(pos);
+            T* p = c.value.get();
+            out = tiny_stl::move(*p);
+            p->~T();
+            c.sequence.get()->store(pos + Capacity, std::memory_order_release);
+        }
+    };
+
+}
@@ -15,64 +15,249 @@
 
 #include "utility.hpp"
 #include <atomic>
+#include <memory> // 包含 std::bad_weak_ptr
+#include <new>
+#include <type_traits>
 
 namespace tiny_stl {
     
     /**
-     * @class control_block
+     * @struct atomic_count_policy
+     * @brief 原子引用计数策略，`shared_ptr` 的默认策略，可在多个线程间安全地共享所有权。
+     */
+    struct atomic_count_policy {
+        using count_type = std::atomic<size_t>; /**< 计数器类型 */
+
+        /**
+         * @brief 增加计数。
+         * 使用 `std::memory_order_relaxed` 内存顺序，仅增加计数。
+         * @param count 计数器。
+         * @param n 增加的数量，默认为 1。
+         */
+        static void increment(count_type& count, size_t n = 1) noexcept {
+            count.fetch_add(n, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief 减少计数并返回减少后的计数。
+         * 使用 `std::memory_order_acq_rel` 内存顺序，确保操作的原子性和内存同步。
+         * @param count 计数器。
+         * @param n 减少的数量，默认为 1。
+         * @return 减少后的计数。
+         */
+        static size_t decrement(count_type& count, size_t n = 1) noexcept {
+            return count.fetch_sub(n, std::memory_order_acq_rel) - n;
+        }
+
+        /**
+         * @brief 仅当计数不为 0 时增加计数。
+         * @param count 计数器。
+         * @return 增加成功返回 `true`，否则返回 `false`。
+         */
+        static bool try_increment(count_type& count) noexcept {
+            size_t value = count.load(std::memory_order_relaxed);
+            while (value != 0) {
+                if (count.compare_exchange_weak(value, value + 1,
+                        std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /**
+         * @brief 读取计数。
+         * 使用 `std::memory_order_acquire` 内存顺序，确保读取到最新的计数值。
+         * @param count 计数器。
+         * @return 当前计数。
+         */
+        static size_t load(const count_type& count) noexcept {
+            return count.load(std::memory_order_acquire);
+        }
+    };
+
+    /**
+     * @struct local_count_policy
+     * @brief 非原子引用计数策略，仅适用于所有副本都在同一线程内使用的场景。
+     * 计数操作编译为普通的整数加减，避免带 `lock` 前缀的原子指令。
+     */
+    struct local_count_policy {
+        using count_type = size_t; /**< 计数器类型 */
+
+        /**
+         * @brief 增加计数。
+         * @param count 计数器。
+         * @param n 增加的数量，默认为 1。
+         */
+        static void increment(count_type& count, size_t n = 1) noexcept {
+            count += n;
+        }
+
+        /**
+         * @brief 减少计数并返回减少后的计数。
+         * @param count 计数器。
+         * @param n 减少的数量，默认为 1。
+         * @return 减少后的计数。
+         */
+        static size_t decrement(count_type& count, size_t n = 1) noexcept {
+            return count -= n;
+        }
+
+        /**
+         * @brief 仅当计数不为 0 时增加计数。
+         * @param count 计数器。
+         * @return 增加成功返回 `true`，否则返回 `false`。
+         */
+        static bool try_increment(count_type& count) noexcept {
+            if (count == 0) {
+                return false;
+            }
+            ++count;
+            return true;
+        }
+
+        /**
+         * @brief 读取计数。
+         * @param count 计数器。
+         * @return 当前计数。
+         */
+        static size_t load(const count_type& count) noexcept {
+            return count;
+        }
+    };
+
+    /**
+     * @class basic_control_block
      * @brief 控制块基类，用于管理引用计数。
-     * 该类是所有控制块的基类，包含一个原子类型的引用计数，提供了增加、减少引用计数以及获取引用计数的方法。
+     * 该类是所有控制块的基类，包含强引用计数与弱引用计数，计数方式由 `Policy` 决定。
+     * 强引用计数降为 0 时调用 `dispose` 销毁所管理的对象；
+     * 弱引用计数降为 0 时调用 `destroy` 释放控制块自身。
+     * 所有强引用共同持有一个弱引用，因此控制块总是晚于对象释放。
+     * @tparam Policy 引用计数策略，`atomic_count_policy` 或 `local_count_policy`。
      */
-    class control_block {
+    template <typename Policy>
+    class basic_control_block {
     private:
-        std::atomic<size_t> ref_count_; /**< 原子类型的引用计数 */
+        using count_type = typename Policy::count_type;
+
+        count_type ref_count_; /**< 强引用计数 */
+        count_type weak_count_; /**< 弱引用计数（所有强引用合计占 1） */
 
     public:
         /**
-         * @brief 构造函数，初始化引用计数为 1。
+         * @brief 构造函数，初始化强引用计数与弱引用计数为 1。
          */
-        control_block() : ref_count_(1) {}
+        basic_control_block() : ref_count_(1), weak_count_(1) {}
 
         /**
          * @brief 虚析构函数，确保派生类对象能正确释放。
          */
-        virtual ~control_block() = default;
+        virtual ~basic_control_block() = default;
         
         /**
          * @brief 增加引用计数。
-         * 使用 `std::memory_order_relaxed` 内存顺序，仅增加引用计数。
+         * @param n 增加的数量，默认为 1。
          */
-        void increment() noexcept {
-            ref_count_.fetch_add(1, std::memory_order_relaxed);
+        void increment(size_t n = 1) noexcept {
+            Policy::increment(ref_count_, n);
         }
         
         /**
          * @brief 减少引用计数并返回减少后的计数。
-         * 使用 `std::memory_order_acq_rel` 内存顺序，确保操作的原子性和内存同步。
+         * @param n 减少的数量，默认为 1。
          * @return 减少后的引用计数。
          */
-        size_t decrement() noexcept {
-            return ref_count_.fetch_sub(1, std::memory_order_acq_rel) - 1;
+        size_t decrement(size_t n = 1) noexcept {
+            return Policy::decrement(ref_count_, n);
+        }
+
+        /**
+         * @brief 仅当强引用计数不为 0 时增加强引用计数，供 `weak_ptr::lock` 使用。
+         * @return 增加成功返回 `true`；对象已销毁返回 `false`。
+         */
+        bool try_increment() noexcept {
+            return Policy::try_increment(ref_count_);
+        }
+
+        /**
+         * @brief 增加弱引用计数。
+         */
+        void weak_increment() noexcept {
+            Policy::increment(weak_count_);
+        }
+
+        /**
+         * @brief 减少弱引用计数并返回减少后的计数。
+         * @return 减少后的弱引用计数。
+         */
+        size_t weak_decrement() noexcept {
+            return Policy::decrement(weak_count_);
+        }
+
+        /**
+         * @brief 释放强引用。
+         * 强引用计数降为 0 时立即销毁对象，并释放所有强引用共同持有的弱引用。
+         * @param n 释放的强引用数量，默认为 1。
+         */
+        void release_shared(size_t n = 1) noexcept {
+            if (decrement(n) == 0) {
+                dispose();
+                release_weak();
+            }
+        }
+
+        /**
+         * @brief 释放一个弱引用，弱引用计数降为 0 时释放控制块。
+         */
+        void release_weak() noexcept {
+            if (weak_decrement() == 0) {
+                destroy();
+            }
         }
         
         /**
          * @brief 获取当前引用计数。
-         * 使用 `std::memory_order_acquire` 内存顺序，确保读取到最新的引用计数值。
          * @return 当前引用计数。
          */
         size_t use_count() const noexcept {
-            return ref_count_.load(std::memory_order_acquire);
+            return Policy::load(ref_count_);
+        }
+
+        /**
+         * @brief 获取所管理对象（或数组首元素）的地址。
+         * 供只持有控制块指针的场合（如 `atomic_shared_ptr`）还原对象指针。
+         * @return 所管理对象的地址。
+         */
+        virtual void* get_pointer() noexcept = 0;
+
+        /**
+         * @brief 销毁所管理的对象，但不释放控制块。
+         */
+        virtual void dispose() noexcept = 0;
+
+        /**
+         * @brief 销毁控制块自身。
+         * 默认通过 `delete` 释放；内存布局特殊的控制块（如尾随数组）需重写此函数。
+         */
+        virtual void destroy() noexcept {
+            delete this;
         }
     };
 
+    /**
+     * @brief 使用原子引用计数的控制块。
+     */
+    using control_block = basic_control_block<atomic_count_policy>;
+
     /**
      * @class object_control_block
      * @brief 对象控制块特化，用于管理单个对象的引用计数。
-     * 继承自 `control_block`，负责在引用计数降为 0 时释放单个对象。
+     * 继承自 `basic_control_block`，负责在强引用计数降为 0 时释放单个对象。
      * @tparam T 对象的类型。
+     * @tparam Policy 引用计数策略。
      */
-    template <typename T>
-    class object_control_block : public control_block {
+    template <typename T, typename Policy = atomic_count_policy>
+    class object_control_block : public basic_control_block<Policy> {
     private:
         T* ptr_; /**< 指向管理对象的指针 */
 
@@ -84,9 +269,17 @@ namespace tiny_stl {
         object_control_block(T* ptr) : ptr_(ptr) {}
 
         /**
-         * @brief 析构函数，释放管理的单个对象。
+         * @brief 获取管理对象的地址。
+         * @return 管理对象的地址。
          */
-        ~object_control_block() override {
+        void* get_pointer() noexcept override {
+            return const_cast<std::remove_cv_t<T>*>(ptr_);
+        }
+
+        /**
+         * @brief 释放管理的单个对象。
+         */
+        void dispose() noexcept override {
             delete ptr_;
         }
     };
@@ -94,11 +287,12 @@ namespace tiny_stl {
     /**
      * @class array_control_block
      * @brief 数组控制块特化，用于管理数组的引用计数。
-     * 继承自 `control_block`，负责在引用计数降为 0 时释放数组。
+     * 继承自 `basic_control_block`，负责在强引用计数降为 0 时释放数组。
      * @tparam T 数组元素的类型。
+     * @tparam Policy 引用计数策略。
      */
-    template <typename T>
-    class array_control_block : public control_block {
+    template <typename T, typename Policy = atomic_count_policy>
+    class array_control_block : public basic_control_block<Policy> {
     private:
         T* ptr_; /**< 指向管理数组的指针 */
 
@@ -110,24 +304,234 @@ namespace tiny_stl {
         array_control_block(T* ptr) : ptr_(ptr) {}
 
         /**
-         * @brief 析构函数，释放管理的数组。
+         * @brief 获取管理数组首元素的地址。
+         * @return 管理数组首元素的地址。
          */
-        ~array_control_block() override {
+        void* get_pointer() noexcept override {
+            return const_cast<std::remove_cv_t<T>*>(ptr_);
+        }
+
+        /**
+         * @brief 释放管理的数组。
+         */
+        void dispose() noexcept override {
             delete[] ptr_;
         }
     };
 
+    /**
+     * @class inplace_control_block
+     * @brief 内联对象控制块，对象与引用计数存放在同一次分配的内存中。
+     * 供 `make_shared` 使用，只需一次堆分配，解引用与引用计数位于相邻的缓存行。
+     * @tparam T 对象的类型。
+     * @tparam Policy 引用计数策略。
+     */
+    template <typename T, typename Policy = atomic_count_policy>
+    class inplace_control_block : public basic_control_block<Policy> {
+    private:
+        alignas(T) unsigned char storage_[sizeof(T)]; /**< 存放对象的未初始化内存 */
+
+    public:
+        /**
+         * @brief 构造函数，在内联存储中原地构造对象。
+         * @tparam Args 构造函数参数的类型包。
+         * @param args 构造函数参数。
+         */
+        template <typename... Args>
+        explicit inplace_control_block(Args&&... args) {
+            ::new (static_cast<void*>(storage_)) T(tiny_stl::forward<Args>(args)...);
+        }
+
+        /**
+         * @brief 销毁内联存储中的对象，存储本身随控制块一起释放。
+         */
+        void dispose() noexcept override {
+            get()->~T();
+        }
+
+        /**
+         * @brief 获取内联存储中的对象指针。
+         * @return 指向对象的指针。
+         */
+        T* get() noexcept {
+            return reinterpret_cast<T*>(storage_);
+        }
+
+        /**
+         * @brief 获取内联存储中对象的地址。
+         * @return 对象的地址。
+         */
+        void* get_pointer() noexcept override {
+            return storage_;
+        }
+    };
+
+    /**
+     * @class inplace_array_control_block
+     * @brief 内联数组控制块，数组元素紧跟在控制块之后存放于同一次分配的内存中。
+     * 通过 `create` 分配并构造，通过 `destroy` 析构并释放，不可直接 `new`/`delete`。
+     * @tparam T 数组元素的类型。
+     * @tparam Policy 引用计数策略。
+     */
+    template <typename T, typename Policy = atomic_count_policy>
+    class inplace_array_control_block : public basic_control_block<Policy> {
+    private:
+        size_t size_; /**< 数组元素个数 */
+
+        /**
+         * @brief 数组相对控制块起始地址的偏移量，按 `T` 的对齐要求向上取整。
+         * @return 偏移字节数。
+         */
+        static constexpr size_t offset() noexcept {
+            return (sizeof(inplace_array_control_block) + alignof(T) - 1) / alignof(T) * alignof(T);
+        }
+
+        /**
+         * @brief 整块内存所需的对齐值。
+         * @return 控制块与元素类型对齐要求中的较大者。
+         */
+        static constexpr size_t alignment() noexcept {
+            return alignof(T) > alignof(inplace_array_control_block)
+                ? alignof(T) : alignof(inplace_array_control_block);
+        }
+
+        /**
+         * @brief 构造函数，仅记录元素个数，元素由 `create` 构造。
+         * @param n 数组元素个数。
+         */
+        explicit inplace_array_control_block(size_t n) : size_(n) {}
+
+
+        /**
+         * @brief 申请容纳控制块与 `n` 个元素的原始内存。
+         * @param n 数组元素个数。
+         * @return 原始内存指针。
+         */
+        static void* allocate(size_t n) {
+            size_t bytes = offset() + n * sizeof(T);
+            if constexpr (alignment() > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+                return ::operator new(bytes, std::align_val_t(alignment()));
+            } else {
+                return ::operator new(bytes);
+            }
+        }
+
+        /**
+         * @brief 释放由 `allocate` 申请的原始内存。
+         * @param p 原始内存指针。
+         */
+        static void deallocate(void* p) noexcept {
+            if constexpr (alignment() > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+                ::operator delete(p, std::align_val_t(alignment()));
+            } else {
+                ::operator delete(p);
+            }
+        }
+
+    public:
+        /**
+         * @brief 一次分配控制块和数组，并对数组元素进行值初始化。
+         * 如果某个元素构造时抛出异常，已构造的元素会被销毁，内存会被释放。
+         * @param n 数组元素个数。
+         * @return 新建的控制块指针。
+         */
+        static inplace_array_control_block* create(size_t n) {
+            void* mem = allocate(n);
+            auto* block = ::new (mem) inplace_array_control_block(0);
+            T* p = block->get();
+            try {
+                for (; block->size_ < n; ++block->size_) {
+                    ::new (static_cast<void*>(p + block->size_)) T();
+                }
+            } catch (...) {
+                block->dispose();
+                block->~inplace_array_control_block();
+                deallocate(mem);
+                throw;
+            }
+            return block;
+        }
+
+        /**
+         * @brief 获取数组首元素指针。
+         * @return 指向数组首元素的指针。
+         */
+        T* get() noexcept {
+            return reinterpret_cast<T*>(reinterpret_cast<unsigned char*>(this) + offset());
+        }
+
+        /**
+         * @brief 获取数组首元素的地址。
+         * @return 数组首元素的地址。
+         */
+        void* get_pointer() noexcept override {
+            return reinterpret_cast<unsigned char*>(this) + offset();
+        }
+
+        /**
+         * @brief 逆序销毁数组元素，内存随控制块一起释放。
+         */
+        void dispose() noexcept override {
+            T* p = get();
+            for (size_t i = size_; i > 0; --i) {
+                p[i - 1].~T();
+            }
+        }
+
+        /**
+         * @brief 释放控制块与数组所在的整块内存。
+         */
+        void destroy() noexcept override {
+            this->~inplace_array_control_block();
+            deallocate(this);
+        }
+    };
+
+    template <typename T, typename Policy = atomic_count_policy>
+    class shared_ptr;
+
+    template <typename T, typename Policy = atomic_count_policy>
+    class weak_ptr;
+
+    template <typename T, typename Policy = atomic_count_policy>
+    class enable_shared_from_this;
+
+    template <typename T>
+    class atomic_shared_ptr;
+
+    /**
+     * @struct __shared_ptr_access
+     * @brief 内部辅助类，供 `make_shared` 使用已构造好的控制块创建 `shared_ptr`。
+     */
+    struct __shared_ptr_access {
+        /**
+         * @brief 由对象指针和控制块构造 `shared_ptr`，不增加引用计数。
+         * @tparam SP 目标 `shared_ptr` 类型。
+         * @tparam U 对象指针指向的类型。
+         * @param ptr 指向管理对象的指针。
+         * @param block 已初始化引用计数为 1 的控制块。
+         * @return 接管控制块的 `shared_ptr`。
+         */
+        template <typename SP, typename U, typename Block>
+        static SP make(U* ptr, Block* block) noexcept {
+            return SP(ptr, block);
+        }
+    };
+
     /**
      * @class shared_ptr
      * @brief 主模板，用于管理单个对象的 `shared_ptr`。
      * 该类实现了引用计数型智能指针，允许多个 `shared_ptr` 共享同一个对象的所有权。
      * @tparam T 管理对象的类型。
+     * @tparam Policy 引用计数策略，默认为原子计数 `atomic_count_policy`。
      */
-    template <typename T>
+    template <typename T, typename Policy>
     class shared_ptr {
     private:
+        using block_type = basic_control_block<Policy>; /**< 控制块类型 */
+
         T* ptr_ = nullptr; /**< 指向管理对象的指针 */
-        control_block* ctrl_block_ = nullptr; /**< 指向控制块的指针 */
+        block_type* ctrl_block_ = nullptr; /**< 指向控制块的指针 */
 
         /**
          * @brief 创建控制块。
@@ -135,24 +539,55 @@ namespace tiny_stl {
          */
         void create_control_block() {
             if (ptr_) {
-                ctrl_block_ = new object_control_block<T>(ptr_);
+                ctrl_block_ = new object_control_block<T, Policy>(ptr_);
+                enable_weak_this(ptr_);
             }
         }
 
+        /**
+         * @brief 若 `T` 继承自 `enable_shared_from_this`，令其内部的弱引用指向本控制块。
+         * @tparam U `enable_shared_from_this` 的模板参数。
+         * @param base 指向 `enable_shared_from_this` 基类子对象的指针。
+         */
+        template <typename U>
+        void enable_weak_this(const enable_shared_from_this<U, Policy>* base) noexcept {
+            if (base && base->weak_this_.expired()) {
+                base->weak_this_.assign(const_cast<std::remove_cv_t<T>*>(ptr_), ctrl_block_);
+            }
+        }
+
+        /**
+         * @brief `T` 未继承 `enable_shared_from_this` 时的空操作重载。
+         */
+        void enable_weak_this(...) noexcept {}
+
         /**
          * @brief 释放资源。
          * 减少引用计数，如果引用计数降为 0，释放控制块和管理的对象。
          */
         void release() noexcept {
             if (ctrl_block_) {
-                if (ctrl_block_->decrement() == 0) {
-                    delete ctrl_block_;
-                }
+                ctrl_block_->release_shared();
                 ctrl_block_ = nullptr;
                 ptr_ = nullptr;
             }
         }
+        /**
+         * @brief 私有构造函数，直接接管已创建的控制块。
+         * @param ptr 指向管理对象的指针。
+         * @param block 控制块指针。
+         */
+        shared_ptr(T* ptr, block_type* block) noexcept : ptr_(ptr), ctrl_block_(block) {
+            enable_weak_this(ptr_);
+        }
+
+        friend struct __shared_ptr_access;
+
+        template <typename U, typename P>
+        friend class weak_ptr;
 
+        template <typename U>
+        friend class atomic_shared_ptr;
     public:
         /**
          * @brief 默认构造函数，初始化指针和控制块为空。
@@ -166,6 +601,19 @@ namespace tiny_stl {
         explicit shared_ptr(T* ptr) : ptr_(ptr) {
             create_control_block();
         }
+
+        /**
+         * @brief 从 `weak_ptr` 构造，共享其观察对象的所有权。
+         * @param other 观察该对象的 `weak_ptr`。
+         * @throws std::bad_weak_ptr 如果对象已被销毁。
+         */
+        explicit shared_ptr(const weak_ptr<T, Policy>& other) {
+            if (!other.ctrl_block_ || !other.ctrl_block_->try_increment()) {
+                throw std::bad_weak_ptr();
+            }
+            ptr_ = other.ptr_;
+            ctrl_block_ = other.ctrl_block_;
+        }
         
         /**
          * @brief 拷贝构造函数，共享同一个对象的所有权。
@@ -254,6 +702,7 @@ namespace tiny_stl {
         
         /**
          * @brief 获取当前引用计数。
+         * 控制块装在 `atomic_shared_ptr` 中时，计数还包含其尚未被领取的预存引用，见 `atomic_shared_ptr`。
          * @return 当前引用计数，如果控制块为空，返回 0。
          */
         size_t use_count() const noexcept {
@@ -285,12 +734,15 @@ namespace tiny_stl {
      * @brief 数组特化版本，用于管理数组的 `shared_ptr`。
      * 该类实现了引用计数型智能指针，允许多个 `shared_ptr` 共享同一个数组的所有权。
      * @tparam T 数组元素的类型。
+     * @tparam Policy 引用计数策略。
      */
-    template <typename T>
-    class shared_ptr<T[]> {
+    template <typename T, typename Policy>
+    class shared_ptr<T[], Policy> {
     private:
+        using block_type = basic_control_block<Policy>; /**< 控制块类型 */
+
         T* ptr_ = nullptr; /**< 指向管理数组的指针 */
-        control_block* ctrl_block_ = nullptr; /**< 指向控制块的指针 */
+        block_type* ctrl_block_ = nullptr; /**< 指向控制块的指针 */
 
         /**
          * @brief 创建控制块。
@@ -298,7 +750,7 @@ namespace tiny_stl {
          */
         void create_control_block() {
             if (ptr_) {
-                ctrl_block_ = new array_control_block<T>(ptr_);
+                ctrl_block_ = new array_control_block<T, Policy>(ptr_);
             }
         }
 
@@ -308,14 +760,25 @@ namespace tiny_stl {
          */
         void release() noexcept {
             if (ctrl_block_) {
-                if (ctrl_block_->decrement() == 0) {
-                    delete ctrl_block_;
-                }
+                ctrl_block_->release_shared();
                 ctrl_block_ = nullptr;
                 ptr_ = nullptr;
             }
         }
+        /**
+         * @brief 私有构造函数，直接接管已创建的控制块。
+         * @param ptr 指向管理数组的指针。
+         * @param block 控制块指针。
+         */
+        shared_ptr(T* ptr, block_type* block) noexcept : ptr_(ptr), ctrl_block_(block) {}
+
+        friend struct __shared_ptr_access;
+
+        template <typename U, typename P>
+        friend class weak_ptr;
 
+        template <typename U>
+        friend class atomic_shared_ptr;
     public:
         /**
          * @brief 默认构造函数，初始化指针和控制块为空。
@@ -329,6 +792,19 @@ namespace tiny_stl {
         explicit shared_ptr(T* ptr) : ptr_(ptr) {
             create_control_block();
         }
+
+        /**
+         * @brief 从 `weak_ptr` 构造，共享其观察数组的所有权。
+         * @param other 观察该数组的 `weak_ptr`。
+         * @throws std::bad_weak_ptr 如果数组已被销毁。
+         */
+        explicit shared_ptr(const weak_ptr<T[], Policy>& other) {
+            if (!other.ctrl_block_ || !other.ctrl_block_->try_increment()) {
+                throw std::bad_weak_ptr();
+            }
+            ptr_ = other.ptr_;
+            ctrl_block_ = other.ctrl_block_;
+        }
         
         /**
          * @brief 析构函数，释放资源。
@@ -394,6 +870,12 @@ namespace tiny_stl {
          */
         T& operator[](size_t index) const { return ptr_[index]; }
 
+        /**
+         * @brief 转换为布尔类型，判断 `shared_ptr` 是否有效。
+         * @return 如果 `ptr_` 不为空，返回 `true`；否则返回 `false`。
+         */
+        explicit operator bool() const noexcept { return ptr_ != nullptr; }
+
         /**
          * @brief 获取管理数组的指针。
          * @return 指向管理数组的指针。
@@ -402,6 +884,7 @@ namespace tiny_stl {
 
         /**
          * @brief 获取当前引用计数。
+         * 控制块装在 `atomic_shared_ptr` 中时，计数还包含其尚未被领取的预存引用，见 `atomic_shared_ptr`。
          * @return 当前引用计数，如果控制块为空，返回 0。
          */
         size_t use_count() const noexcept {
@@ -419,29 +902,344 @@ namespace tiny_stl {
         }
     };
 
+    /**
+     * @class weak_ptr
+     * @brief 弱引用智能指针，观察 `shared_ptr` 管理的对象而不延长其生命周期。
+     * 只持有弱引用计数，可用于打破引用环；通过 `lock` 获取临时的所有权。
+     * @tparam T 被观察对象的类型，也可以是数组类型 `U[]`。
+     * @tparam Policy 引用计数策略，须与对应的 `shared_ptr` 一致。
+     */
+    template <typename T, typename Policy>
+    class weak_ptr {
+    public:
+        using element_type = std::remove_extent_t<T>; /**< 元素类型 */
+
+    private:
+        using block_type = basic_control_block<Policy>; /**< 控制块类型 */
+
+        element_type* ptr_ = nullptr; /**< 指向被观察对象的指针 */
+        block_type* ctrl_block_ = nullptr; /**< 指向控制块的指针 */
+
+        template <typename U, typename P>
+        friend class shared_ptr;
+
+        /**
+         * @brief 释放当前持有的弱引用。
+         */
+        void release() noexcept {
+            if (ctrl_block_) {
+                ctrl_block_->release_weak();
+                ctrl_block_ = nullptr;
+                ptr_ = nullptr;
+            }
+        }
+
+        /**
+         * @brief 改为观察给定控制块管理的对象，供 `enable_shared_from_this` 使用。
+         * @param ptr 指向被观察对象的指针。
+         * @param block 控制块指针。
+         */
+        void assign(element_type* ptr, block_type* block) noexcept {
+            release();
+            ptr_ = ptr;
+            ctrl_block_ = block;
+            if (ctrl_block_) {
+                ctrl_block_->weak_increment();
+            }
+        }
+
+    public:
+        /**
+         * @brief 默认构造函数，不观察任何对象。
+         */
+        weak_ptr() noexcept = default;
+
+        /**
+         * @brief 从 `shared_ptr` 构造，观察其管理的对象。
+         * @param other 被观察的 `shared_ptr`。
+         */
+        weak_ptr(const shared_ptr<T, Policy>& other) noexcept
+            : ptr_(other.ptr_), ctrl_block_(other.ctrl_block_) {
+            if (ctrl_block_) {
+                ctrl_block_->weak_increment();
+            }
+        }
+
+        /**
+         * @brief 拷贝构造函数，观察同一个对象。
+         * @param other 另一个 `weak_ptr` 对象。
+         */
+        weak_ptr(const weak_ptr& other) noexcept
+            : ptr_(other.ptr_), ctrl_block_(other.ctrl_block_) {
+            if (ctrl_block_) {
+                ctrl_block_->weak_increment();
+            }
+        }
+
+        /**
+         * @brief 移动构造函数，转移观察关系。
+         * @param other 另一个 `weak_ptr` 对象。
+         */
+        weak_ptr(weak_ptr&& other) noexcept
+            : ptr_(exchange(other.ptr_, nullptr)),
+            ctrl_block_(exchange(other.ctrl_block_, nullptr)) {}
+
+        /**
+         * @brief 析构函数，释放弱引用。
+         */
+        ~weak_ptr() {
+            release();
+        }
+
+        /**
+         * @brief 拷贝赋值运算符。
+         * @param other 另一个 `weak_ptr` 对象。
+         * @return 引用自身。
+         */
+        weak_ptr& operator=(const weak_ptr& other) noexcept {
+            if (this != &other) {
+                assign(other.ptr_, other.ctrl_block_);
+            }
+            return *this;
+        }
+
+        /**
+         * @brief 从 `shared_ptr` 赋值，改为观察其管理的对象。
+         * @param other 被观察的 `shared_ptr`。
+         * @return 引用自身。
+         */
+        weak_ptr& operator=(const shared_ptr<T, Policy>& other) noexcept {
+            assign(other.ptr_, other.ctrl_block_);
+            return *this;
+        }
+
+        /**
+         * @brief 移动赋值运算符。
+         * @param other 另一个 `weak_ptr` 对象。
+         * @return 引用自身。
+         */
+        weak_ptr& operator=(weak_ptr&& other) noexcept {
+            if (this != &other) {
+                release();
+                ptr_ = exchange(other.ptr_, nullptr);
+                ctrl_block_ = exchange(other.ctrl_block_, nullptr);
+            }
+            return *this;
+        }
+
+        /**
+         * @brief 获取被观察对象的强引用计数。
+         * 控制块装在 `atomic_shared_ptr` 中时，计数还包含其尚未被领取的预存引用，见 `atomic_shared_ptr`。
+         * @return 强引用计数，如果不观察任何对象，返回 0。
+         */
+        size_t use_count() const noexcept {
+            return ctrl_block_ ? ctrl_block_->use_count() : 0;
+        }
+
+        /**
+         * @brief 判断被观察对象是否已被销毁。
+         * @return 如果对象已销毁或不观察任何对象，返回 `true`。
+         */
+        bool expired() const noexcept {
+            return use_count() == 0;
+        }
+
+        /**
+         * @brief 尝试获取被观察对象的所有权。
+         * @return 对象仍存活时返回共享其所有权的 `shared_ptr`，否则返回空的 `shared_ptr`。
+         */
+        shared_ptr<T, Policy> lock() const noexcept {
+            shared_ptr<T, Policy> result;
+            if (ctrl_block_ && ctrl_block_->try_increment()) {
+                result.ptr_ = ptr_;
+                result.ctrl_block_ = ctrl_block_;
+            }
+            return result;
+        }
+
+        /**
+         * @brief 停止观察当前对象。
+         */
+        void reset() noexcept {
+            release();
+        }
+
+        /**
+         * @brief 交换两个 `weak_ptr` 观察的对象。
+         * @param other 另一个 `weak_ptr` 对象。
+         */
+        void swap(weak_ptr& other) noexcept {
+            tiny_stl::swap(ptr_, other.ptr_);
+            tiny_stl::swap(ctrl_block_, other.ctrl_block_);
+        }
+    };
+
+    /**
+     * @class enable_shared_from_this
+     * @brief 允许对象从自身获取指向自己的 `shared_ptr`。
+     * 继承该类的对象在交给 `shared_ptr` 管理（包括 `make_shared`）时会记录一个弱引用，
+     * 之后可以通过 `shared_from_this` 共享同一个控制块，而不会创建新的控制块。
+     * @tparam T 派生类类型。
+     * @tparam Policy 引用计数策略，须与管理该对象的 `shared_ptr` 一致。
+     */
+    template <typename T, typename Policy>
+    class enable_shared_from_this {
+    private:
+        mutable weak_ptr<T, Policy> weak_this_; /**< 指向自身的弱引用 */
+
+        template <typename U, typename P>
+        friend class shared_ptr;
+
+    protected:
+        /**
+         * @brief 默认构造函数。
+         */
+        enable_shared_from_this() noexcept = default;
+
+        /**
+         * @brief 拷贝构造函数，新对象不继承原对象的弱引用。
+         */
+        enable_shared_from_this(const enable_shared_from_this&) noexcept {}
+
+        /**
+         * @brief 拷贝赋值运算符，保留自身的弱引用不变。
+         * @return 引用自身。
+         */
+        enable_shared_from_this& operator=(const enable_shared_from_this&) noexcept {
+            return *this;
+        }
+
+        /**
+         * @brief 析构函数。
+         */
+        ~enable_shared_from_this() = default;
+
+    public:
+        /**
+         * @brief 获取共享自身所有权的 `shared_ptr`。
+         * @return 与管理该对象的 `shared_ptr` 共享控制块的 `shared_ptr`。
+         * @throws std::bad_weak_ptr 如果该对象当前未被 `shared_ptr` 管理。
+         */
+        shared_ptr<T, Policy> shared_from_this() {
+            return shared_ptr<T, Policy>(weak_this_);
+        }
+
+        /**
+         * @brief 获取观察自身的 `weak_ptr`。
+         * @return 观察该对象的 `weak_ptr`，若未被 `shared_ptr` 管理则为空。
+         */
+        weak_ptr<T, Policy> weak_from_this() const noexcept {
+            return weak_this_;
+        }
+    };
+
+    /**
+     * @brief 使用非原子引用计数的 `shared_ptr`，接口与 `shared_ptr` 相同，仅限单线程内共享。
+     * @tparam T 管理对象的类型。
+     */
+    template <typename T>
+    using local_shared_ptr = shared_ptr<T, local_count_policy>;
+
+    /**
+     * @brief 观察 `local_shared_ptr` 的弱引用智能指针。
+     * @tparam T 被观察对象的类型。
+     */
+    template <typename T>
+    using local_weak_ptr = weak_ptr<T, local_count_policy>;
+
+    /**
+     * @brief 与 `local_shared_ptr` 配合使用的 `enable_shared_from_this`。
+     * @tparam T 派生类类型。
+     */
+    template <typename T>
+    using enable_local_shared_from_this = enable_shared_from_this<T, local_count_policy>;
+
+    /**
+     * @brief 以指定的计数策略创建管理单个对象的 `shared_ptr`，对象内联于控制块。
+     * @tparam T 管理对象的类型。
+     * @tparam Policy 引用计数策略。
+     * @tparam Args 构造函数参数的类型包。
+     * @param args 构造函数参数。
+     * @return 管理新对象的 `shared_ptr`。
+     */
+    template <typename T, typename Policy, typename... Args>
+    shared_ptr<T, Policy> __make_shared_object(Args&&... args) {
+        auto* block = new inplace_control_block<T, Policy>(tiny_stl::forward<Args>(args)...);
+        return __shared_ptr_access::make<shared_ptr<T, Policy>>(block->get(), block);
+    }
+
+    /**
+     * @brief 以指定的计数策略创建管理数组的 `shared_ptr`，数组紧随控制块存放。
+     * @tparam T 数组元素的类型。
+     * @tparam Policy 引用计数策略。
+     * @param size 数组的大小。
+     * @return 管理新数组的 `shared_ptr`。
+     */
+    template <typename T, typename Policy>
+    shared_ptr<T[], Policy> __make_shared_array(size_t size) {
+        auto* block = inplace_array_control_block<T, Policy>::create(size);
+        return __shared_ptr_access::make<shared_ptr<T[], Policy>>(block->get(), block);
+    }
+
     /**
      * @brief 创建 `shared_ptr` 的辅助函数，用于管理单个对象。
-     * 使用完美转发传递参数，创建一个新的对象并返回一个 `shared_ptr` 管理该对象。
+     * 使用完美转发传递参数，对象与控制块在同一次堆分配中创建（`inplace_control_block`）。
      * @tparam T 管理对象的类型。
      * @tparam Args 构造函数参数的类型包。
      * @param args 构造函数参数。
      * @return 管理新对象的 `shared_ptr`。
      */
     template <typename T, typename... Args>
-    shared_ptr<T> make_shared(Args&&... args) {
-        return shared_ptr<T>(new T(forward<Args>(args)...));
+    std::enable_if_t<!std::is_array<T>::value, shared_ptr<T>> make_shared(Args&&... args) {
+        return __make_shared_object<T, atomic_count_policy>(tiny_stl::forward<Args>(args)...);
     }
 
     /**
      * @brief 创建 `shared_ptr` 的辅助函数，用于管理数组。
-     * 创建一个指定大小的数组并返回一个 `shared_ptr` 管理该数组。
+     * 数组元素与控制块在同一次堆分配中创建（`inplace_array_control_block`），元素进行值初始化。
      * @tparam T 数组元素的类型。
      * @param size 数组的大小。
      * @return 管理新数组的 `shared_ptr`。
      */
     template <typename T>
     shared_ptr<T[]> make_shared(size_t size) {
-        return shared_ptr<T[]>(new T[size]());
+        return __make_shared_array<T, atomic_count_policy>(size);
+    }
+
+    /**
+     * @brief 创建 `shared_ptr<T[]>` 的辅助函数，与 `std::make_shared<T[]>(n)` 的写法一致。
+     * @tparam T 数组类型，形如 `U[]`。
+     * @param size 数组的大小。
+     * @return 管理新数组的 `shared_ptr`。
+     */
+    template <typename T>
+    std::enable_if_t<std::is_array<T>::value && std::extent<T>::value == 0, shared_ptr<T>>
+    make_shared(size_t size) {
+        return __make_shared_array<std::remove_extent_t<T>, atomic_count_policy>(size);
+    }
+
+    /**
+     * @brief 创建 `local_shared_ptr` 的辅助函数，用于管理单个对象。
+     * @tparam T 管理对象的类型。
+     * @tparam Args 构造函数参数的类型包。
+     * @param args 构造函数参数。
+     * @return 管理新对象的 `local_shared_ptr`。
+     */
+    template <typename T, typename... Args>
+    std::enable_if_t<!std::is_array<T>::value, local_shared_ptr<T>> make_local_shared(Args&&... args) {
+        return __make_shared_object<T, local_count_policy>(tiny_stl::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief 创建 `local_shared_ptr<T[]>` 的辅助函数，用于管理数组，元素进行值初始化。
+     * @tparam T 数组类型，形如 `U[]`。
+     * @param size 数组的大小。
+     * @return 管理新数组的 `local_shared_ptr`。
+     */
+    template <typename T>
+    std::enable_if_t<std::is_array<T>::value && std::extent<T>::value == 0, local_shared_ptr<T>>
+    make_local_shared(size_t size) {
+        return __make_shared_array<std::remove_extent_t<T>, local_count_policy>(size);
     }
 
 }
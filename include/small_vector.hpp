@@ -0,0 +1,364 @@
+/**
+ * @file small_vector.hpp
+ * @brief 此文件定义了 tiny_stl 命名空间下的 small_vector 类，一个带有内联存储（小缓冲区优化）的 vector。
+ * 元素数量不超过 N 时存放在对象内部，不进行任何堆分配；超过 N 后才转移到堆上。
+ */
+
+#pragma once
+
+#ifdef __GNUC__
+#   pragma GCC system_header
+#endif
+#if defined(_MSC_VER) && _MSC_VER >= 1920
+#   pragma system_header
+#endif
+
+#include <vector.hpp>
+#include <initializer_list>
+
+namespace tiny_stl {
+
+    /**
+     * @class __small_vector_allocator
+     * @brief small_vector 使用的分配器，内部带有一块可容纳 N 个元素的内联缓冲区。
+     *
+     * 请求不超过 N 个元素且内联缓冲区空闲时返回内联缓冲区，否则转交给上游分配器。
+     * 内联缓冲区属于分配器所在的对象，因此拷贝、移动或赋值分配器时只传递上游分配器，
+     * 不会传递内联缓冲区的占用状态。
+     *
+     * @tparam T 元素类型。
+     * @tparam N 内联缓冲区可容纳的元素数量。
+     * @tparam Alloc 上游分配器类型。
+     */
+    template <typename T, size_t N, typename Alloc>
+    class __small_vector_allocator {
+    public:
+        using value_type      = T;         /**< 元素类型 */
+        using size_type       = size_t;    /**< 大小类型 */
+        using difference_type = ptrdiff_t; /**< 差值类型 */
+        using pointer         = T*;        /**< 指针类型 */
+        using const_pointer   = const T*;  /**< 常量指针类型 */
+
+        /**
+         * @brief 默认构造函数，内联缓冲区空闲。
+         */
+        __small_vector_allocator() noexcept : _upstream(), _in_use(false) { }
+
+        /**
+         * @brief 拷贝构造函数，只复制上游分配器，内联缓冲区空闲。
+         * @param other 要复制的分配器。
+         */
+        __small_vector_allocator(const __small_vector_allocator& other) noexcept
+            : _upstream(other._upstream), _in_use(false) { }
+
+        /**
+         * @brief 赋值运算符，只复制上游分配器，保留自身内联缓冲区的占用状态。
+         * @param other 要复制的分配器。
+         * @return 引用自身。
+         */
+        __small_vector_allocator& operator=(const __small_vector_allocator& other) noexcept {
+            _upstream = other._upstream;
+            return *this;
+        }
+
+        /**
+         * @brief 分配可容纳 n 个元素的内存。
+         * @param n 元素数量。
+         * @return 指向内存的指针；n 为 0 时返回 nullptr。
+         */
+        pointer allocate(size_type n) {
+            if (n == 0) {
+                return nullptr;
+            }
+            if (!_in_use && n <= N) {
+                _in_use = true;
+                return inline_data();
+            }
+            return _upstream.allocate(n);
+        }
+
+        /**
+         * @brief 释放由 allocate 分配的内存。
+         * @param p 指向内存的指针。
+         * @param n 元素数量。
+         */
+        void deallocate(pointer p, size_type n) {
+            if (p == inline_data()) {
+                _in_use = false;
+            } else {
+                _upstream.deallocate(p, n);
+            }
+        }
+
+        /**
+         * @brief 在已分配的内存上构造对象。
+         * @tparam Args 构造参数的类型包。
+         * @param p 指向已分配内存的指针。
+         * @param args 构造参数。
+         * @return 指向构造好的对象的指针。
+         */
+        template <typename... Args>
+        pointer construct(pointer p, Args&&... args) {
+            return _upstream.construct(p, tiny_stl::forward<Args>(args)...);
+        }
+
+        /**
+         * @brief 销毁对象。
+         * @param p 指向对象的指针。
+         */
+        void destroy(pointer p) {
+            _upstream.destroy(p);
+        }
+
+        /**
+         * @brief 判断指针是否指向内联缓冲区。
+         * @param p 要判断的指针。
+         * @return 指向内联缓冲区时返回 true。
+         */
+        bool is_inline(const_pointer p) const noexcept {
+            return p == inline_data();
+        }
+
+    private:
+        /**
+         * @brief 返回内联缓冲区的起始地址。
+         * @return 指向内联缓冲区的指针。
+         */
+        pointer inline_data() noexcept {
+            return reinterpret_cast<pointer>(_buffer);
+        }
+
+        /**
+         * @brief 返回内联缓冲区的起始地址。
+         * @return 指向内联缓冲区的常量指针。
+         */
+        const_pointer inline_data() const noexcept {
+            return reinterpret_cast<const_pointer>(_buffer);
+        }
+
+        Alloc _upstream; /**< 上游分配器 */
+        bool _in_use; /**< 内联缓冲区是否已被占用 */
+        alignas(T) unsigned char _buffer[N * sizeof(T)]; /**< 内联缓冲区 */
+    };
+
+    /**
+     * @struct __small_vector_growth
+     * @brief small_vector 的增长策略：空容器第一次分配时直接使用整个内联缓冲区，之后按 Growth 增长。
+     * @tparam N 内联缓冲区可容纳的元素数量。
+     * @tparam Growth 溢出到堆之后使用的增长策略。
+     */
+    template <size_t N, typename Growth>
+    struct __small_vector_growth {
+        /**
+         * @brief 计算新容量。
+         * @param capacity 当前容量。
+         * @param required 需要的最小容量。
+         * @param value_size 元素的大小（字节）。
+         * @return 新容量。
+         */
+        static constexpr size_t next_capacity(size_t capacity, size_t required, size_t value_size) noexcept {
+            if (capacity == 0) {
+                return required < N ? N : required;
+            }
+            return Growth::next_capacity(capacity, required, value_size);
+        }
+    };
+
+    /**
+     * @class small_vector
+     * @brief 带有内联存储的动态数组，接口与迭代器类型与 vector 相同。
+     *
+     * 构造时即占用对象内部可容纳 N 个元素的缓冲区，因此容量总是不小于 N；
+     * 超过 N 个元素后整体搬移到由 Alloc 分配的堆内存上，之后 shrink_to_fit 可以把元素搬回内联缓冲区。
+     * 由于元素可能位于对象内部，内联状态下的移动与交换需要逐个移动元素，复杂度为 O(size())。
+     *
+     * @note 不要通过 vector 基类的引用对 small_vector 进行移动、赋值或交换。
+     * @tparam T 元素类型。
+     * @tparam N 内联存储可容纳的元素数量。
+     * @tparam Alloc 溢出到堆上时使用的分配器类型，默认为 allocator<T>。
+     * @tparam Growth 溢出到堆上之后的增长策略，默认为 doubling_growth。
+     */
+    template <typename T, size_t N, typename Alloc = allocator<T>, typename Growth = doubling_growth>
+    class small_vector
+        : public vector<T, __small_vector_allocator<T, N, Alloc>, __small_vector_growth<N, Growth>> {
+        static_assert(N > 0, "small_vector 的内联容量必须大于 0");
+
+        using base = vector<T, __small_vector_allocator<T, N, Alloc>, __small_vector_growth<N, Growth>>;
+
+    public:
+        using typename base::value_type;
+        using typename base::size_type;
+        using typename base::iterator;
+        using typename base::const_iterator;
+
+        /**
+         * @brief 内联存储可容纳的元素数量。
+         */
+        static constexpr size_type inline_capacity = N;
+
+        /**
+         * @brief 默认构造函数，创建一个使用内联存储的空 small_vector，不进行堆分配。
+         */
+        small_vector() : base() {
+            this->reserve(N);
+        }
+
+        /**
+         * @brief 构造一个包含 n 个值为 value 的元素的 small_vector。
+         * @param n 元素数量。
+         * @param value 元素的初始值，默认为 value_type()。
+         */
+        small_vector(size_type n, const value_type& value = value_type()) : small_vector() {
+            this->assign(n, value);
+        }
+
+        /**
+         * @brief 构造一个包含 [first, last) 范围内元素的 small_vector。
+         * @tparam InputIterator 输入迭代器类型。
+         * @param first 范围的起始迭代器。
+         * @param last 范围的结束迭代器。
+         */
+        template <typename InputIterator, __enable_if_input_iterator_t<InputIterator> = 0>
+        small_vector(InputIterator first, InputIterator last) : small_vector() {
+            this->assign(first, last);
+        }
+
+        /**
+         * @brief 构造一个包含 initializer_list 中元素的 small_vector。
+         * @param list 初始化列表。
+         */
+        small_vector(std::initializer_list<value_type> list) : small_vector() {
+            this->assign(list.begin(), list.end());
+        }
+
+        /**
+         * @brief 拷贝构造函数。元素数量不超过 N 时复制到内联存储中。
+         * @param other 要拷贝的 small_vector。
+         */
+        small_vector(const small_vector& other) : small_vector() {
+            this->assign(other.begin(), other.end());
+        }
+
+        /**
+         * @brief 移动构造函数。other 位于堆上时直接接管其内存，否则逐个移动元素。
+         * @param other 要移动的 small_vector，之后为空并重新使用自己的内联存储。
+         */
+        small_vector(small_vector&& other) noexcept(std::is_nothrow_move_constructible<T>::value)
+            : base() {
+            if (other.is_inline()) {
+                this->reserve(N);
+                move_elements_from(other);
+            } else {
+                take_heap_storage(other);
+            }
+        }
+
+        /**
+         * @brief 拷贝赋值运算符。
+         * @param other 要拷贝的 small_vector。
+         * @return 引用自身。
+         */
+        small_vector& operator=(const small_vector& other) {
+            if (this != &other) {
+                this->assign(other.begin(), other.end());
+            }
+            return *this;
+        }
+
+        /**
+         * @brief 移动赋值运算符。other 位于堆上时接管其内存，否则逐个移动元素。
+         * @param other 要移动的 small_vector。
+         * @return 引用自身。
+         */
+        small_vector& operator=(small_vector&& other) noexcept(std::is_nothrow_move_constructible<T>::value) {
+            if (this != &other) {
+                this->clear();
+                if (other.is_inline()) {
+                    move_elements_from(other);
+                } else {
+                    this->deallocate_storage();
+                    this->_begin = this->_end = this->_end_of_storage = nullptr;
+                    take_heap_storage(other);
+                }
+            }
+            return *this;
+        }
+
+        /**
+         * @brief initializer_list 赋值运算符。
+         * @param list 初始化列表。
+         * @return 引用自身。
+         */
+        small_vector& operator=(std::initializer_list<value_type> list) {
+            this->assign(list.begin(), list.end());
+            return *this;
+        }
+
+        /**
+         * @brief 判断元素当前是否位于内联存储中。
+         * @return 位于内联存储中时返回 true。
+         */
+        bool is_inline() const noexcept {
+            return this->_alloc.is_inline(this->_begin);
+        }
+
+        /**
+         * @brief 释放未使用的容量。元素不超过 N 个时搬回内联存储，否则把堆内存缩小到恰好容纳全部元素。
+         */
+        void shrink_to_fit() {
+            if (is_inline()) {
+                return;
+            }
+            if (this->size() <= N) {
+                this->reallocate(N);
+            } else {
+                base::shrink_to_fit();
+            }
+        }
+
+        /**
+         * @brief 交换两个 small_vector 的内容。两者都位于堆上时只交换指针。
+         * @param other 要交换的 small_vector。
+         */
+        void swap(small_vector& other) {
+            if (!is_inline() && !other.is_inline()) {
+                base::swap(other);
+            } else {
+                small_vector tmp(tiny_stl::move(other));
+                other = tiny_stl::move(*this);
+                *this = tiny_stl::move(tmp);
+            }
+        }
+
+        /**
+         * @brief 友元函数，用于交换两个 small_vector 的内容。
+         * @param lhs 第一个 small_vector。
+         * @param rhs 第二个 small_vector。
+         */
+        friend void swap(small_vector& lhs, small_vector& rhs) {
+            lhs.swap(rhs);
+        }
+
+    private:
+        /**
+         * @brief 把 other 中的元素逐个移动到自身末尾，之后清空 other。
+         * @param other 元素的来源，必须位于内联存储中（元素不超过 N 个）。
+         */
+        void move_elements_from(small_vector& other) {
+            for (value_type& value : other) {
+                this->emplace_back(tiny_stl::move(value));
+            }
+            other.clear();
+        }
+
+        /**
+         * @brief 接管 other 的堆内存，other 之后为空并重新使用自己的内联存储。
+         * @param other 元素的来源，必须位于堆上；调用前自身不能持有内存。
+         */
+        void take_heap_storage(small_vector& other) {
+            base::swap(other);
+            other.reserve(N);
+        }
+    };
+
+}
@@ -0,0 +1,658 @@
+/**
+ * @file soa_vector.hpp
+ * @brief 此文件定义了 tiny_stl 命名空间下的 soa_vector 类，一个按列（structure of arrays）存储的动态数组。
+ *
+ * 每个字段单独存放在一段连续内存中：只扫描少数几个热字段的循环不会把其余字段带进缓存，
+ * 每一列也可以直接以指针与长度的形式交给向量化循环。所有列共享同一个大小与容量，
+ * 扩容时一次分配好所有新列，再把各列依次搬过去。
+ */
+
+#pragma once
+
+#ifdef __GNUC__
+#   pragma GCC system_header
+#endif
+#if defined(_MSC_VER) && _MSC_VER >= 1920
+#   pragma system_header
+#endif
+
+#include <memory.hpp>
+#include <iterator.hpp>
+#include <utility.hpp>
+#include <vector.hpp>
+#include <initializer_list>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+
+namespace tiny_stl {
+
+    /**
+     * @class column_span
+     * @brief soa_vector 中一列元素的视图，由起始指针与元素个数组成，不拥有元素。
+     * @tparam T 元素类型，只读的列为 `const T`
+     */
+    template <typename T>
+    class column_span {
+    public:
+        using element_type = T; /**< 元素类型 */
+        using value_type = std::remove_cv_t<T>; /**< 去掉 cv 限定的元素类型 */
+        using size_type = size_t; /**< 大小类型 */
+        using pointer = T*; /**< 指针类型 */
+        using reference = T&; /**< 引用类型 */
+        using iterator = T*; /**< 迭代器类型 */
+
+        /**
+         * @brief 构造一个空视图
+         */
+        constexpr column_span() noexcept : _data(nullptr), _size(0) { }
+
+        /**
+         * @brief 构造一个指向 [data, data + size) 的视图
+         * @param data 起始指针
+         * @param size 元素个数
+         */
+        constexpr column_span(pointer data, size_type size) noexcept : _data(data), _size(size) { }
+
+        /**
+         * @brief 从可写的列视图转换为只读的列视图
+         */
+        template <typename U, typename = std::enable_if_t<std::is_convertible<U (*)[], T (*)[]>::value>>
+        constexpr column_span(const column_span<U>& other) noexcept : _data(other.data()), _size(other.size()) { }
+
+        constexpr pointer data() const noexcept { return _data; }
+        constexpr size_type size() const noexcept { return _size; }
+        constexpr bool empty() const noexcept { return _size == 0; }
+        constexpr iterator begin() const noexcept { return _data; }
+        constexpr iterator end() const noexcept { return _data + _size; }
+        constexpr reference operator[](size_type i) const noexcept { return _data[i]; }
+        constexpr reference front() const noexcept { return _data[0]; }
+        constexpr reference back() const noexcept { return _data[_size - 1]; }
+
+    private:
+        pointer _data; /**< 起始指针 */
+        size_type _size; /**< 元素个数 */
+    };
+
+    /**
+     * @class soa_vector
+     * @brief 按列存储的动态数组：第 I 个字段的所有值连续存放在第 I 列中。
+     *
+     * 一行由每列中相同下标的元素组成，`operator[]` 与迭代器返回由各列元素引用组成的 `std::tuple`；
+     * 需要对单个字段做批量处理时，用 `column<I>()` 或 `data<I>()` 直接取得该列的连续内存。
+     * 每一列通过 `tiny_stl::allocator` 分配。扩容、插入等使列的地址发生变化的操作会使所有迭代器、
+     * 引用与列视图失效。
+     *
+     * @tparam Ts 各列的元素类型
+     */
+    template <typename... Ts>
+    class soa_vector {
+        static_assert(sizeof...(Ts) > 0, "soa_vector 至少需要一列");
+
+        using columns_type = std::tuple<Ts*...>;
+        using const_columns_type = std::tuple<const Ts*...>;
+        using column_indices = std::index_sequence_for<Ts...>;
+
+    public:
+        using value_type = std::tuple<Ts...>; /**< 一行的值类型 */
+        using reference = std::tuple<Ts&...>; /**< 一行的引用类型 */
+        using const_reference = std::tuple<const Ts&...>; /**< 一行的常量引用类型 */
+        using size_type = size_t; /**< 大小类型 */
+        using difference_type = ptrdiff_t; /**< 距离类型 */
+
+        /**
+         * @brief 第 I 列的元素类型
+         */
+        template <size_t I>
+        using column_type = std::tuple_element_t<I, value_type>;
+
+        /**
+         * @brief 列的数量
+         */
+        static constexpr size_t column_count = sizeof...(Ts);
+
+    private:
+        /**
+         * @brief 同时指向一行中所有列的随机访问迭代器
+         * @tparam Const 是否为常量迭代器
+         */
+        template <bool Const>
+        class basic_iterator {
+            friend class soa_vector;
+            template <bool> friend class basic_iterator;
+            using columns = std::conditional_t<Const, const_columns_type, columns_type>;
+        public:
+            using iterator_category = random_access_iterator_tag; /**< 迭代器类别 */
+            using value_type = soa_vector::value_type; /**< 元素类型 */
+            using difference_type = ptrdiff_t; /**< 距离类型 */
+            using reference = std::conditional_t<Const, const_reference, soa_vector::reference>; /**< 引用类型 */
+
+            /**
+             * @brief operator-> 返回的代理，持有一个临时的 reference
+             */
+            struct pointer {
+                reference ref;
+                const reference* operator->() const noexcept { return &ref; }
+            };
+
+            basic_iterator() = default;
+
+            /**
+             * @brief 从非常量迭代器转换
+             */
+            template <bool C = Const, typename = std::enable_if_t<C>>
+            basic_iterator(const basic_iterator<false>& other) : _columns(other._columns), _index(other._index) { }
+
+            reference operator*() const { return row(_index, column_indices()); }
+            pointer operator->() const { return pointer{**this}; }
+            reference operator[](difference_type n) const { return row(_index + n, column_indices()); }
+
+            basic_iterator& operator++() { ++_index; return *this; }
+            basic_iterator operator++(int) { basic_iterator tmp = *this; ++_index; return tmp; }
+            basic_iterator& operator--() { --_index; return *this; }
+            basic_iterator operator--(int) { basic_iterator tmp = *this; --_index; return tmp; }
+            basic_iterator& operator+=(difference_type n) { _index += n; return *this; }
+            basic_iterator& operator-=(difference_type n) { _index -= n; return *this; }
+            basic_iterator operator+(difference_type n) const { basic_iterator tmp = *this; return tmp += n; }
+            basic_iterator operator-(difference_type n) const { basic_iterator tmp = *this; return tmp -= n; }
+            friend basic_iterator operator+(difference_type n, const basic_iterator& it) { return it + n; }
+            difference_type operator-(const basic_iterator& other) const { return _index - other._index; }
+
+            bool operator==(const basic_iterator& other) const { return _index == other._index; }
+            bool operator!=(const basic_iterator& other) const { return _index != other._index; }
+            bool operator<(const basic_iterator& other) const { return _index < other._index; }
+            bool operator>(const basic_iterator& other) const { return _index > other._index; }
+            bool operator<=(const basic_iterator& other) const { return _index <= other._index; }
+            bool operator>=(const basic_iterator& other) const { return _index >= other._index; }
+
+            /**
+             * @brief 返回迭代器在第 I 列中指向的元素的地址
+             */
+            template <size_t I>
+            auto column() const noexcept { return std::get<I>(_columns) + _index; }
+
+        private:
+            columns _columns{}; /**< 各列的起始指针 */
+            difference_type _index = 0; /**< 指向的行号 */
+
+            basic_iterator(const columns& cols, difference_type index) : _columns(cols), _index(index) { }
+
+            template <size_t... Is>
+            reference row(difference_type i, std::index_sequence<Is...>) const {
+                return reference(std::get<Is>(_columns)[i]...);
+            }
+        };
+
+    public:
+        using iterator = basic_iterator<false>; /**< 迭代器类型 */
+        using const_iterator = basic_iterator<true>; /**< 常量迭代器类型 */
+        using reverse_iterator = tiny_stl::reverse_iterator<iterator>; /**< 反向迭代器类型 */
+        using const_reverse_iterator = tiny_stl::reverse_iterator<const_iterator>; /**< 常量反向迭代器类型 */
+
+        /**
+         * @brief 默认构造函数，构造一个空的 soa_vector，不分配内存
+         */
+        soa_vector() noexcept : _columns(), _size(0), _capacity(0) { }
+
+        /**
+         * @brief 构造 n 行，每列元素都值初始化
+         * @param n 行数
+         */
+        explicit soa_vector(size_type n) : soa_vector() {
+            resize(n);
+        }
+
+        /**
+         * @brief 用初始化列表中的行构造
+         * @param il 初始化列表
+         */
+        soa_vector(std::initializer_list<value_type> il) : soa_vector() {
+            reserve(il.size());
+            for (const value_type& row : il) {
+                push_back(row);
+            }
+        }
+
+        /**
+         * @brief 拷贝构造函数，新容量恰好等于 other 的大小
+         * @param other 被拷贝的 soa_vector
+         */
+        soa_vector(const soa_vector& other) : soa_vector() {
+            if (other._size != 0) {
+                columns_type cols = allocate_columns(other._size);
+                try {
+                    copy_columns<0>(other._columns, other._size, cols);
+                } catch (...) {
+                    deallocate_columns(cols, other._size, column_indices());
+                    throw;
+                }
+                _columns = cols;
+                _size = other._size;
+                _capacity = other._size;
+            }
+        }
+
+        /**
+         * @brief 移动构造函数，接管 other 的所有列，other 变为空
+         * @param other 被移动的 soa_vector
+         */
+        soa_vector(soa_vector&& other) noexcept
+            : _columns(other._columns), _size(other._size), _capacity(other._capacity) {
+            other._columns = columns_type();
+            other._size = 0;
+            other._capacity = 0;
+        }
+
+        /**
+         * @brief 析构函数，销毁所有元素并释放所有列
+         */
+        ~soa_vector() {
+            clear();
+            deallocate_columns(_columns, _capacity, column_indices());
+        }
+
+        /**
+         * @brief 拷贝赋值运算符，提供强异常安全保证
+         */
+        soa_vector& operator=(const soa_vector& other) {
+            if (this != &other) {
+                soa_vector tmp(other);
+                swap(tmp);
+            }
+            return *this;
+        }
+
+        /**
+         * @brief 移动赋值运算符
+         */
+        soa_vector& operator=(soa_vector&& other) noexcept {
+            if (this != &other) {
+                soa_vector tmp(tiny_stl::move(other));
+                swap(tmp);
+            }
+            return *this;
+        }
+
+        iterator begin() noexcept { return iterator(_columns, 0); }
+        const_iterator begin() const noexcept { return const_iterator(_columns, 0); }
+        const_iterator cbegin() const noexcept { return begin(); }
+        iterator end() noexcept { return iterator(_columns, static_cast<difference_type>(_size)); }
+        const_iterator end() const noexcept { return const_iterator(_columns, static_cast<difference_type>(_size)); }
+        const_iterator cend() const noexcept { return end(); }
+        reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+        const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+        reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+        const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+        size_type size() const noexcept { return _size; }
+        size_type capacity() const noexcept { return _capacity; }
+        bool empty() const noexcept { return _size == 0; }
+
+        /**
+         * @brief 返回第 n 行，不检查边界
+         * @param n 行号
+         * @return 由各列元素引用组成的 tuple
+         */
+        reference operator[](size_type n) noexcept { return row(_columns, n, column_indices()); }
+        const_reference operator[](size_type n) const noexcept { return row(const_columns(), n, column_indices()); }
+
+        /**
+         * @brief 返回第 n 行，检查边界
+         * @param n 行号
+         * @return 由各列元素引用组成的 tuple
+         * @throw std::out_of_range 如果行号超出范围
+         */
+        reference at(size_type n) {
+            if (n >= _size) {
+                throw std::out_of_range("Index out of range");
+            }
+            return (*this)[n];
+        }
+
+        /**
+         * @brief 返回第 n 行，检查边界
+         * @throw std::out_of_range 如果行号超出范围
+         */
+        const_reference at(size_type n) const {
+            if (n >= _size) {
+                throw std::out_of_range("Index out of range");
+            }
+            return (*this)[n];
+        }
+
+        reference front() noexcept { return (*this)[0]; }
+        const_reference front() const noexcept { return (*this)[0]; }
+        reference back() noexcept { return (*this)[_size - 1]; }
+        const_reference back() const noexcept { return (*this)[_size - 1]; }
+
+        /**
+         * @brief 返回第 I 列的起始指针，该列共有 size() 个元素
+         * @tparam I 列号
+         */
+        template <size_t I>
+        column_type<I>* data() noexcept { return std::get<I>(_columns); }
+
+        /**
+         * @brief 返回第 I 列的只读起始指针
+         * @tparam I 列号
+         */
+        template <size_t I>
+        const column_type<I>* data() const noexcept { return std::get<I>(_columns); }
+
+        /**
+         * @brief 返回第 I 列的视图
+         * @tparam I 列号
+         */
+        template <size_t I>
+        column_span<column_type<I>> column() noexcept { return {data<I>(), _size}; }
+
+        /**
+         * @brief 返回第 I 列的只读视图
+         * @tparam I 列号
+         */
+        template <size_t I>
+        column_span<const column_type<I>> column() const noexcept { return {data<I>(), _size}; }
+
+        /**
+         * @brief 保证容量至少为 n；需要扩容时所有列一起重新分配
+         * @param n 需要的最小容量
+         */
+        void reserve(size_type n) {
+            if (n > _capacity) {
+                reallocate(n);
+            }
+        }
+
+        /**
+         * @brief 把容量缩小到恰好等于大小；为空时释放所有列
+         */
+        void shrink_to_fit() {
+            if (_capacity > _size) {
+                if (_size == 0) {
+                    deallocate_columns(_columns, _capacity, column_indices());
+                    _columns = columns_type();
+                    _capacity = 0;
+                } else {
+                    reallocate(_size);
+                }
+            }
+        }
+
+        /**
+         * @brief 在末尾追加一行
+         * @param row 新行的值
+         */
+        void push_back(const value_type& row) {
+            emplace_row(row);
+        }
+
+        /**
+         * @brief 在末尾追加一行，各列元素从 row 中移动构造
+         * @param row 新行的值
+         */
+        void push_back(value_type&& row) {
+            emplace_row(tiny_stl::move(row));
+        }
+
+        /**
+         * @brief 在末尾追加一行，第 I 个参数用于构造第 I 列的元素
+         * @param args 各列元素的构造参数，数量与列数相同
+         * @return 新行的引用
+         */
+        template <typename... Args, typename = std::enable_if_t<sizeof...(Args) == sizeof...(Ts)>>
+        reference emplace_back(Args&&... args) {
+            emplace_row(std::forward_as_tuple(tiny_stl::forward<Args>(args)...));
+            return back();
+        }
+
+        /**
+         * @brief 删除最后一行
+         */
+        void pop_back() noexcept {
+            --_size;
+            destroy_rows(_size, _size + 1, column_indices());
+        }
+
+        /**
+         * @brief 把大小改为 n，新增的行中每列元素都值初始化
+         * @param n 新的行数
+         */
+        void resize(size_type n) {
+            if (n < _size) {
+                destroy_rows(n, _size, column_indices());
+                _size = n;
+            } else if (n > _size) {
+                if (n > _capacity) {
+                    reallocate(grow_capacity(n));
+                }
+                value_construct_columns<0>(_size, n);
+                _size = n;
+            }
+        }
+
+        /**
+         * @brief 删除所有行，不释放内存
+         */
+        void clear() noexcept {
+            destroy_rows(0, _size, column_indices());
+            _size = 0;
+        }
+
+        /**
+         * @brief 与 other 交换内容
+         */
+        void swap(soa_vector& other) noexcept {
+            tiny_stl::swap(_columns, other._columns);
+            tiny_stl::swap(_size, other._size);
+            tiny_stl::swap(_capacity, other._capacity);
+        }
+
+    private:
+        columns_type _columns; /**< 各列的起始指针 */
+        size_type _size; /**< 行数 */
+        size_type _capacity; /**< 每列的容量 */
+
+        /**
+         * @brief 扩容时各列是否移动元素：所有列都能不抛异常地移动（或不可拷贝）时才移动，
+         * 否则全部拷贝，这样任何一列搬移失败时原有的列都保持不变。
+         */
+        static constexpr bool relocate_by_move =
+            ((std::is_nothrow_move_constructible<Ts>::value || !std::is_copy_constructible<Ts>::value) && ...);
+
+        const_columns_type const_columns() const noexcept { return const_columns_type(_columns); }
+
+        template <typename Columns, size_t... Is>
+        static auto row(const Columns& cols, size_type n, std::index_sequence<Is...>) noexcept {
+            return std::tuple<decltype(*std::get<Is>(cols))...>(std::get<Is>(cols)[n]...);
+        }
+
+        /**
+         * @brief 按增长策略计算容纳至少 min_capacity 行所需的新容量，增长策略按一整行的字节数计算
+         */
+        size_type grow_capacity(size_type min_capacity) const noexcept {
+            return doubling_growth::next_capacity(_capacity, min_capacity, (sizeof(Ts) + ...));
+        }
+
+        /**
+         * @brief 为每一列分配容量为 n 的内存；某一列分配失败时释放已分配的列
+         * @param n 每列的容量
+         * @return 各列的起始指针
+         */
+        static columns_type allocate_columns(size_type n) {
+            columns_type cols;
+            allocate_columns_from<0>(cols, n);
+            return cols;
+        }
+
+        template <size_t I>
+        static void allocate_columns_from(columns_type& cols, size_type n) {
+            if constexpr (I < column_count) {
+                std::get<I>(cols) = allocator<column_type<I>>().allocate(n);
+                try {
+                    allocate_columns_from<I + 1>(cols, n);
+                } catch (...) {
+                    allocator<column_type<I>>().deallocate(std::get<I>(cols), n);
+                    throw;
+                }
+            }
+        }
+
+        template <size_t... Is>
+        static void deallocate_columns(const columns_type& cols, size_type n, std::index_sequence<Is...>) noexcept {
+            if (n != 0) {
+                (allocator<Ts>().deallocate(std::get<Is>(cols), n), ...);
+            }
+        }
+
+        /**
+         * @brief 销毁每一列中 [first, last) 行的元素
+         */
+        template <size_t... Is>
+        void destroy_rows(size_type first, size_type last, std::index_sequence<Is...>) noexcept {
+            (tiny_stl::destroy(std::get<Is>(_columns) + first, std::get<Is>(_columns) + last), ...);
+        }
+
+        /**
+         * @brief 从第 I 列开始，把 src 中每列的前 n 个元素拷贝到 dest；某一列失败时销毁已拷贝的列
+         */
+        template <size_t I, typename Columns>
+        static void copy_columns(const Columns& src, size_type n, const columns_type& dest) {
+            if constexpr (I < column_count) {
+                column_type<I>* first = std::get<I>(dest);
+                tiny_stl::uninitialized_copy(std::get<I>(src), std::get<I>(src) + n, first);
+                try {
+                    copy_columns<I + 1>(src, n, dest);
+                } catch (...) {
+                    tiny_stl::destroy(first, first + n);
+                    throw;
+                }
+            }
+        }
+
+        /**
+         * @brief 从第 I 列开始，把当前每列的元素搬到 dest 中；某一列失败时销毁已搬到 dest 的列。
+         * 按 relocate_by_move 移动或拷贝，失败时原有的列保持不变。
+         */
+        template <size_t I>
+        void relocate_columns(const columns_type& dest) {
+            if constexpr (I < column_count) {
+                column_type<I>* first = std::get<I>(_columns);
+                column_type<I>* out = std::get<I>(dest);
+                if constexpr (relocate_by_move) {
+                    tiny_stl::uninitialized_move(first, first + _size, out);
+                } else {
+                    tiny_stl::uninitialized_copy(first, first + _size, out);
+                }
+                try {
+                    relocate_columns<I + 1>(dest);
+                } catch (...) {
+                    tiny_stl::destroy(out, out + _size);
+                    throw;
+                }
+            }
+        }
+
+        /**
+         * @brief 从第 I 列开始，在每列的 [first, last) 行值初始化元素；某一列失败时销毁已构造的列
+         */
+        template <size_t I>
+        void value_construct_columns(size_type first, size_type last) {
+            if constexpr (I < column_count) {
+                column_type<I>* col = std::get<I>(_columns);
+                tiny_stl::uninitialized_value_construct(col + first, col + last);
+                try {
+                    value_construct_columns<I + 1>(first, last);
+                } catch (...) {
+                    tiny_stl::destroy(col + first, col + last);
+                    throw;
+                }
+            }
+        }
+
+        /**
+         * @brief 从第 I 列开始，用 args 中的第 I 个元素构造 cols 中第 n 行的元素；某一列失败时销毁已构造的列
+         */
+        template <size_t I, typename Tuple>
+        static void construct_row(const columns_type& cols, size_type n, Tuple&& args) {
+            if constexpr (I < column_count) {
+                column_type<I>* p = std::get<I>(cols) + n;
+                tiny_stl::construct_at(p, std::get<I>(tiny_stl::forward<Tuple>(args)));
+                try {
+                    construct_row<I + 1>(cols, n, tiny_stl::forward<Tuple>(args));
+                } catch (...) {
+                    tiny_stl::destroy_at(p);
+                    throw;
+                }
+            }
+        }
+
+        /**
+         * @brief 在末尾构造一行。需要扩容时新行先在新内存中构造，之后才搬移原有的行，
+         * 所以 args 可以引用原有的元素。
+         */
+        template <typename Tuple>
+        void emplace_row(Tuple&& args) {
+            if (_size != _capacity) {
+                construct_row<0>(_columns, _size, tiny_stl::forward<Tuple>(args));
+                ++_size;
+                return;
+            }
+            size_type new_capacity = grow_capacity(_size + 1);
+            columns_type cols = allocate_columns(new_capacity);
+            try {
+                construct_row<0>(cols, _size, tiny_stl::forward<Tuple>(args));
+            } catch (...) {
+                deallocate_columns(cols, new_capacity, column_indices());
+                throw;
+            }
+            try {
+                relocate_columns<0>(cols);
+            } catch (...) {
+                destroy_row_at(cols, _size, column_indices());
+                deallocate_columns(cols, new_capacity, column_indices());
+                throw;
+            }
+            replace_columns(cols, new_capacity);
+            ++_size;
+        }
+
+        template <size_t... Is>
+        static void destroy_row_at(const columns_type& cols, size_type n, std::index_sequence<Is...>) noexcept {
+            (tiny_stl::destroy_at(std::get<Is>(cols) + n), ...);
+        }
+
+        /**
+         * @brief 一次分配好所有容量为 new_capacity 的新列，再把所有列搬过去
+         * @param new_capacity 新容量，不小于当前大小
+         */
+        void reallocate(size_type new_capacity) {
+            columns_type cols = allocate_columns(new_capacity);
+            try {
+                relocate_columns<0>(cols);
+            } catch (...) {
+                deallocate_columns(cols, new_capacity, column_indices());
+                throw;
+            }
+            replace_columns(cols, new_capacity);
+        }
+
+        /**
+         * @brief 销毁并释放原有的列，改用已经搬好元素的 cols
+         */
+        void replace_columns(const columns_type& cols, size_type new_capacity) noexcept {
+            destroy_rows(0, _size, column_indices());
+            deallocate_columns(_columns, _capacity, column_indices());
+            _columns = cols;
+            _capacity = new_capacity;
+        }
+    };
+
+    /**
+     * @brief 交换两个 soa_vector 的内容
+     */
+    template <typename... Ts>
+    void swap(soa_vector<Ts...>& lhs, soa_vector<Ts...>& rhs) noexcept {
+        lhs.swap(rhs);
+    }
+
+}
@@ -0,0 +1,281 @@
+/**
+ * @file thread_pool.hpp
+ * @brief 此文件定义了 tiny_stl 命名空间下的 `thread_pool`，一个基于工作窃取的线程池。
+ *
+ * 每个工作线程拥有一个 `work_stealing_deque`：任务中提交的子任务压入当前线程自己的队列，
+ * 不经过任何共享的锁；自己的队列为空时，先查看外部提交的任务，再从其他线程的队列顶部窃取。
+ * 递归拆分的任务（例如并行处理一棵树）因此主要在本地运行，只有空闲线程才会访问别人的队列。
+ */
+
+#pragma once
+
+#ifdef __GNUC__
+#   pragma GCC system_header
+#endif
+#if defined(_MSC_VER) && _MSC_VER >= 1920
+#   pragma system_header
+#endif
+
+#include <work_stealing_deque.hpp>
+#include <deque.hpp>
+#include <utility.hpp>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+
+namespace tiny_stl {
+
+    /**
+     * @class thread_pool
+     * @brief 工作窃取线程池。
+     *
+     * - 在工作线程中调用 submit 时，任务压入该线程自己的队列；
+     * - 在其他线程中调用 submit 时，任务放入加锁的外部队列，由空闲的工作线程取走；
+     * - 没有任务时工作线程在条件变量上休眠，只有存在休眠线程时 submit 才需要加锁唤醒。
+     *
+     * 等待子任务的任务可以调用 try_run_one 帮忙执行其他任务，而不是阻塞工作线程。
+     * 任务不能抛出异常。析构时先等待所有任务完成，再结束工作线程。
+     */
+    class thread_pool {
+    public:
+        using size_type = size_t; /**< 大小类型 */
+
+        /**
+         * @brief 构造线程池并启动工作线程
+         * @param threads 工作线程的数量，为 0 时使用硬件线程数
+         */
+        explicit thread_pool(size_type threads = 0)
+            : _size(threads ? threads : default_threads()), _workers(new worker[_size]),
+              _pending(0), _epoch(0), _sleepers(0), _stop(false) {
+            for (size_type i = 0; i < _size; ++i) {
+                _workers[i].thread = std::thread([this, i] { worker_loop(i); });
+            }
+        }
+
+        thread_pool(const thread_pool&) = delete;
+        thread_pool& operator=(const thread_pool&) = delete;
+
+        /**
+         * @brief 析构函数，等待所有任务完成后结束并回收工作线程
+         */
+        ~thread_pool() {
+            wait_idle();
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _stop = true;
+            }
+            _wake.notify_all();
+            for (size_type i = 0; i < _size; ++i) {
+                _workers[i].thread.join();
+            }
+            delete[] _workers;
+        }
+
+        /**
+         * @brief 提交一个任务
+         * @tparam Function 可调用对象的类型，以无参数的方式调用
+         * @param f 任务
+         */
+        template <typename Function>
+        void submit(Function&& f) {
+            task* t = new task_impl<std::decay_t<Function>>(tiny_stl::forward<Function>(f));
+            _pending.fetch_add(1, std::memory_order_relaxed);
+            worker_context& ctx = context();
+            if (ctx.pool == this) {
+                _workers[ctx.index].tasks.push(t);
+            } else {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _injected.push_back(t);
+                _injected_count.store(_injected.size(), std::memory_order_relaxed);
+            }
+            notify();
+        }
+
+        /**
+         * @brief 在调用线程上执行一个待执行的任务
+         * 在工作线程上调用时优先执行自己队列中的任务
+         * @return 执行了任务时返回true；没有可执行的任务时返回false
+         */
+        bool try_run_one() {
+            worker_context& ctx = context();
+            task* t = find_task(ctx.pool == this ? ctx.index : _size);
+            if (!t) {
+                return false;
+            }
+            execute(t);
+            return true;
+        }
+
+        /**
+         * @brief 等待所有已提交的任务（包括任务中提交的子任务）完成
+         * @note 不能在本线程池的任务中调用（正在执行的任务自身也算作未完成），
+         * 任务需要等待子任务时，应当自行计数并在等待期间调用 try_run_one
+         */
+        void wait_idle() {
+            assert(context().pool != this);
+            std::unique_lock<std::mutex> lock(_mutex);
+            _idle.wait(lock, [this] { return _pending.load(std::memory_order_acquire) == 0; });
+        }
+
+        /**
+         * @brief 获取工作线程的数量
+         * @return 工作线程的数量
+         */
+        size_type size() const noexcept {
+            return _size;
+        }
+
+    private:
+        /**
+         * @brief 类型擦除的任务
+         */
+        struct task {
+            virtual ~task() = default;
+            virtual void run() = 0;
+        };
+
+        /**
+         * @brief 保存可调用对象的任务
+         * @tparam Function 可调用对象的类型
+         */
+        template <typename Function>
+        struct task_impl : task {
+            Function f; /**< 可调用对象 */
+
+            template <typename F>
+            explicit task_impl(F&& fn) : f(tiny_stl::forward<F>(fn)) { }
+
+            void run() override { f(); }
+        };
+
+        /**
+         * @brief 工作线程：自己的任务队列与线程对象，按缓存行对齐避免相邻线程之间伪共享
+         */
+        struct alignas(__cache_line_size) worker {
+            work_stealing_deque<task*> tasks; /**< 自己的任务队列 */
+            std::thread thread; /**< 线程对象 */
+        };
+
+        /**
+         * @brief 当前线程所属的线程池与编号，不是工作线程时 pool 为空
+         */
+        struct worker_context {
+            thread_pool* pool = nullptr; /**< 所属的线程池 */
+            size_type index = 0; /**< 工作线程的编号 */
+        };
+
+        size_type _size; /**< 工作线程的数量 */
+        worker* _workers; /**< 工作线程 */
+        std::atomic<size_type> _pending; /**< 已提交但尚未完成的任务数量 */
+        std::atomic<size_type> _epoch; /**< 每提交一个任务加一，休眠的线程据此判断是否有新任务 */
+        std::atomic<size_type> _sleepers; /**< 正在或准备休眠的工作线程数量 */
+        std::atomic<size_type> _injected_count{0}; /**< 外部队列中的任务数量，用于不加锁地判断外部队列是否为空 */
+        deque<task*> _injected; /**< 外部线程提交的任务，由 _mutex 保护 */
+        std::mutex _mutex; /**< 保护外部队列与休眠 */
+        std::condition_variable _wake; /**< 唤醒休眠的工作线程 */
+        std::condition_variable _idle; /**< 所有任务完成时通知 wait_idle */
+        bool _stop; /**< 是否结束工作线程，由 _mutex 保护 */
+
+        /**
+         * @brief 获取默认的工作线程数量
+         * @return 硬件线程数，无法获取时为 1
+         */
+        static size_type default_threads() noexcept {
+            unsigned n = std::thread::hardware_concurrency();
+            return n ? n : 1;
+        }
+
+        /**
+         * @brief 获取当前线程的上下文
+         * @return 当前线程的上下文
+         */
+        static worker_context& context() noexcept {
+            static thread_local worker_context ctx;
+            return ctx;
+        }
+
+        /**
+         * @brief 有线程休眠时唤醒一个
+         * 先增加 _epoch 再读取 _sleepers，与 worker_loop 中先增加 _sleepers 再读取 _epoch 配对，二者至少有一方看到对方
+         */
+        void notify() {
+            _epoch.fetch_add(1, std::memory_order_seq_cst);
+            if (_sleepers.load(std::memory_order_seq_cst) != 0) {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _wake.notify_one();
+            }
+        }
+
+        /**
+         * @brief 查找一个任务：自己的队列、外部队列、其他线程的队列
+         * @param self 调用线程的编号，不是工作线程时为 _size
+         * @return 找到的任务，没有时返回 nullptr
+         */
+        task* find_task(size_type self) {
+            task* t = nullptr;
+            if (self < _size && _workers[self].tasks.pop(t)) {
+                return t;
+            }
+            if (_injected_count.load(std::memory_order_relaxed) != 0) {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (!_injected.empty()) {
+                    t = _injected.pop_front_value();
+                    _injected_count.store(_injected.size(), std::memory_order_relaxed);
+                    return t;
+                }
+            }
+            // 从相邻的线程开始依次窃取，不同线程的起点不同，减少对同一个队列的竞争
+            for (size_type i = 1; i <= _size; ++i) {
+                size_type victim = (self + i) % _size;
+                if (victim != self && _workers[victim].tasks.steal(t)) {
+                    return t;
+                }
+            }
+            return nullptr;
+        }
+
+        /**
+         * @brief 执行并释放任务，最后一个任务完成时通知 wait_idle
+         * @param t 要执行的任务
+         */
+        void execute(task* t) noexcept {
+            t->run();
+            delete t;
+            if (_pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _idle.notify_all();
+            }
+        }
+
+        /**
+         * @brief 工作线程的主循环：执行任务，没有任务时休眠，直到线程池析构
+         * @param index 工作线程的编号
+         */
+        void worker_loop(size_type index) {
+            worker_context& ctx = context();
+            ctx.pool = this;
+            ctx.index = index;
+            for (;;) {
+                size_type epoch = _epoch.load(std::memory_order_seq_cst);
+                if (task* t = find_task(index)) {
+                    execute(t);
+                    continue;
+                }
+                std::unique_lock<std::mutex> lock(_mutex);
+                _sleepers.fetch_add(1, std::memory_order_seq_cst);
+                _wake.wait(lock, [&] {
+                    return _stop || _epoch.load(std::memory_order_seq_cst) != epoch;
+                });
+                _sleepers.fetch_sub(1, std::memory_order_relaxed);
+                if (_stop) {
+                    break;
+                }
+            }
+        }
+    };
+
+}
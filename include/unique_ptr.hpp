@@ -217,7 +217,7 @@ namespace tiny_stl {
      */
     template <typename T, typename... Args>
     unique_ptr<T> make_unique(Args&&... args) {
-        return unique_ptr<T>(new T(forward<Args>(args)...));
+        return unique_ptr<T>(new T(tiny_stl::forward<Args>(args)...));
     }
 
     /**
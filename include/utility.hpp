@@ -13,6 +13,7 @@
 #endif
 
 #include <iterator.hpp>
+#include <type_traits>
 
 namespace tiny_stl {
 
@@ -91,6 +92,35 @@ namespace tiny_stl {
         return static_cast<typename remove_reference<T>::type&&>(t);
     }
 
+    /**
+     * @brief 在移动构造不会抛出异常（或对象不可拷贝）时转换为右值引用，否则转换为常量左值引用。
+     * 容器重新分配内存时使用该函数搬移元素，从而在元素移动构造可能抛出异常时仍保证强异常安全。
+     * @tparam T 要处理的类型
+     * @param t 要转换的对象
+     * @return 右值引用或常量左值引用
+     */
+    template <typename T>
+    constexpr std::conditional_t<
+        !std::is_nothrow_move_constructible<T>::value && std::is_copy_constructible<T>::value,
+        const T&, T&&>
+    move_if_noexcept(T& t) noexcept {
+        return tiny_stl::move(t);
+    }
+
+    /**
+     * @brief 判断当前是否在常量求值（编译期计算）中。
+     * 算法在编译期不能调用 memcmp、SIMD 等非 constexpr 的快速路径，据此退回到逐元素的实现。
+     * 不支持该内建函数的编译器总是返回 false，此时快速路径不能用于常量表达式。
+     * @return 在常量求值中时返回 true
+     */
+    constexpr bool __is_constant_evaluated() noexcept {
+#if defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 9) || (defined(_MSC_VER) && _MSC_VER >= 1925)
+        return __builtin_is_constant_evaluated();
+#else
+        return false;
+#endif
+    }
+
     /**
      * @brief 替换对象的值并返回其旧值。
      * 该函数使用移动语义，避免不必要的复制。
@@ -101,9 +131,9 @@ namespace tiny_stl {
      * @return 对象的旧值
      */
     template <typename T, typename U = T>
-    T exchange(T& obj, U&& new_val) {
-        T old_val = move(obj);
-        obj = forward<U>(new_val);
+    constexpr T exchange(T& obj, U&& new_val) {
+        T old_val = tiny_stl::move(obj);
+        obj = tiny_stl::forward<U>(new_val);
         return old_val;
     }
 
@@ -115,12 +145,24 @@ namespace tiny_stl {
      * @param b 第二个对象
      */
     template <typename T>
-    void swap(T& a, T& b) noexcept {
-        T temp = move(a);
-        a = move(b);
-        b = move(temp);
+    constexpr void swap(T& a, T& b) noexcept {
+        T temp = tiny_stl::move(a);
+        a = tiny_stl::move(b);
+        b = tiny_stl::move(temp);
     }
 
+    /**
+     * @brief 标记传入有序关联容器的元素已经按键排好序且没有重复，构造时不再排序
+     */
+    struct sorted_unique_t {
+        explicit sorted_unique_t() = default;
+    };
+
+    /**
+     * @brief `sorted_unique_t` 的实例
+     */
+    inline constexpr sorted_unique_t sorted_unique{};
+
     /**
      * @class pair
      * @brief 存储两个不同类型的值的模板类。
@@ -140,39 +182,63 @@ namespace tiny_stl {
         U second;
         
         /**
-         * @brief 默认构造函数。
+         * @brief 默认构造函数，值初始化两个值（内置类型初始化为 0），从而也能用于常量表达式。
          */
-        pair() = default;
+        constexpr pair() : first(), second() { }
 
         /**
          * @brief 构造函数，使用左值引用初始化两个值。
          * @param f 第一个值的左值引用
          * @param s 第二个值的左值引用
          */
-        pair(const T& f, const U& s) : first(f), second(s) { }
+        constexpr pair(const T& f, const U& s) : first(f), second(s) { }
 
         /**
-         * @brief 构造函数，使用右值引用初始化两个值。
-         * 该构造函数使用完美转发，避免不必要的复制。
-         * @param f 第一个值的右值引用
-         * @param s 第二个值的右值引用
+         * @brief 构造函数，分别用 a 与 b 完美转发构造两个值，右值参数会被移动进来。
+         * 当 `T` 带有 const 时（例如关联容器的 `pair<const Key, Value>`），可以用它把键移动进来；
+         * `T`、`U` 是引用类型时（例如 `flat_map` 迭代器的 `pair<const Key&, T&>`）也可以使用。
+         * @tparam A 第一个参数的类型
+         * @tparam B 第二个参数的类型
+         * @param a 用于构造第一个值的参数
+         * @param b 用于构造第二个值的参数
          */
-        pair(T&& f, U&& s) : first(forward<T>(f)), second(forward<U>(s)) { }
+        template <typename A, typename B,
+                  typename = std::enable_if_t<std::is_constructible<T, A&&>::value && std::is_constructible<U, B&&>::value>>
+        constexpr pair(A&& a, B&& b) : first(tiny_stl::forward<A>(a)), second(tiny_stl::forward<B>(b)) { }
 
         /**
          * @brief 拷贝构造函数。
          */
-        pair(const pair& other) = default;
+        constexpr pair(const pair& other) = default;
 
         /**
          * @brief 移动构造函数。
-         * 该构造函数使用移动语义，将资源从另一个 `pair` 对象转移到当前对象。
-         * @param other 要移动的 `pair` 对象
+         * 逐个移动两个值，被移动的 `pair` 处于值各自的移后状态。`T` 带有 const 时（例如 `pair<const Key, Value>`）
+         * 第一个值会被复制。
          */
-        pair(pair&& other) noexcept : first(move(other.first)), second(move(other.second)) {
-            other.first = T();
-            other.second = U();
-        }
+        constexpr pair(pair&& other) = default;
+
+        /**
+         * @brief 转换构造函数，用另一种 `pair` 的两个值分别构造两个值，
+         * 例如用 `pair<Key, Value>` 构造关联容器的 `pair<const Key, Value>`。
+         * @tparam A 另一种 `pair` 第一个值的类型
+         * @tparam B 另一种 `pair` 第二个值的类型
+         * @param other 用于构造的 `pair` 对象
+         */
+        template <typename A, typename B,
+                  typename = std::enable_if_t<std::is_constructible<T, const A&>::value && std::is_constructible<U, const B&>::value>>
+        constexpr pair(const pair<A, B>& other) : first(other.first), second(other.second) { }
+
+        /**
+         * @brief 转换构造函数，从另一种 `pair` 的两个值分别移动构造两个值。
+         * @tparam A 另一种 `pair` 第一个值的类型
+         * @tparam B 另一种 `pair` 第二个值的类型
+         * @param other 用于构造的 `pair` 对象
+         */
+        template <typename A, typename B,
+                  typename = std::enable_if_t<std::is_constructible<T, A&&>::value && std::is_constructible<U, B&&>::value>>
+        constexpr pair(pair<A, B>&& other)
+            : first(tiny_stl::forward<A>(other.first)), second(tiny_stl::forward<B>(other.second)) { }
 
         /**
          * @brief 拷贝赋值运算符。
@@ -180,20 +246,9 @@ namespace tiny_stl {
         pair& operator=(const pair& other) = default;
 
         /**
-         * @brief 移动赋值运算符。
-         * 该运算符使用移动语义，将资源从另一个 `pair` 对象转移到当前对象。
-         * @param other 要移动的 `pair` 对象
-         * @return 指向当前 `pair` 对象的引用
+         * @brief 移动赋值运算符，逐个移动赋值两个值。
          */
-        pair& operator=(pair&& other) noexcept {
-            if (this != &other) {
-                first = move(other.first);
-                second = move(other.second);
-                other.first = T();
-                other.second = U();
-            }
-            return *this;
-        }
+        pair& operator=(pair&& other) = default;
 
         /**
          * @brief 相等比较运算符。
@@ -201,7 +256,7 @@ namespace tiny_stl {
          * @param other 要比较的 `pair` 对象
          * @return 若两个 `pair` 对象相等则返回 `true`，否则返回 `false`
          */
-        bool operator==(const pair& other) const {
+        constexpr bool operator==(const pair& other) const {
             return first == other.first && second == other.second;
         }
 
@@ -211,14 +266,14 @@ namespace tiny_stl {
          * @param other 要比较的 `pair` 对象
          * @return 若两个 `pair` 对象不相等则返回 `true`，否则返回 `false`
          */
-        bool operator!=(const pair& other) const {
+        constexpr bool operator!=(const pair& other) const {
             return !(*this == other);
         }
     };
 
     /**
      * @brief 创建一个 `pair` 对象。
-     * 该函数使用完美转发，根据传入的参数类型自动推导 `pair` 的类型。
+     * 该函数使用完美转发，`pair` 的类型为参数退化（去掉引用与 cv 限定）后的类型。
      * @tparam T 第一个值的类型
      * @tparam U 第二个值的类型
      * @param first 第一个值
@@ -226,8 +281,8 @@ namespace tiny_stl {
      * @return 一个包含两个值的 `pair` 对象
      */
     template <typename T, typename U>
-    pair<T, U> make_pair(T&& first, U&& second) {
-        return pair<T, U>(forward<T>(first), forward<U>(second));
+    constexpr pair<std::decay_t<T>, std::decay_t<U>> make_pair(T&& first, U&& second) {
+        return pair<std::decay_t<T>, std::decay_t<U>>(tiny_stl::forward<T>(first), tiny_stl::forward<U>(second));
     }
 
 }
@@ -12,13 +12,100 @@
 #   pragma system_header
 #endif
 
+#include <algorithm.hpp>
+#include <container_stats.hpp>
 #include <memory.hpp>
 #include <iterator.hpp>
 #include <utility.hpp>
 #include <initializer_list>
+#include <stdexcept>
+#include <cstring>
+#include <type_traits>
 
 namespace tiny_stl {
 
+    /**
+     * @brief 空 vector 第一次分配内存时至少占用的字节数。
+     * 避免小 vector 经历 1→2→4→8 的连续重新分配。
+     */
+    constexpr size_t vector_min_initial_bytes = 64;
+
+    /**
+     * @brief 计算空 vector 第一次分配内存时的最小容量。
+     * @param value_size 元素的大小（字节）。
+     * @return 至少占用 vector_min_initial_bytes 字节、且不少于 1 的元素个数。
+     */
+    constexpr size_t __vector_min_initial_capacity(size_t value_size) noexcept {
+        return value_size >= vector_min_initial_bytes ? 1 : vector_min_initial_bytes / value_size;
+    }
+
+    /**
+     * @struct doubling_growth
+     * @brief vector 的默认增长策略：容量翻倍。
+     *
+     * 增长策略需要提供静态函数 `next_capacity(capacity, required, value_size)`，
+     * 返回不小于 required 的新容量。
+     */
+    struct doubling_growth {
+        /**
+         * @brief 计算新容量。
+         * @param capacity 当前容量。
+         * @param required 需要的最小容量。
+         * @param value_size 元素的大小（字节）。
+         * @return 新容量。
+         */
+        static constexpr size_t next_capacity(size_t capacity, size_t required, size_t value_size) noexcept {
+            size_t grown = capacity ? capacity * 2 : __vector_min_initial_capacity(value_size);
+            return grown < required ? required : grown;
+        }
+    };
+
+    /**
+     * @struct one_and_half_growth
+     * @brief 容量按 1.5 倍增长的策略。
+     *
+     * 增长因子小于 2 时，之前释放的内存块之和最终能够容纳新的内存块，分配器可以复用它们，
+     * 峰值内存也比翻倍策略低。
+     */
+    struct one_and_half_growth {
+        /**
+         * @brief 计算新容量。
+         * @param capacity 当前容量。
+         * @param required 需要的最小容量。
+         * @param value_size 元素的大小（字节）。
+         * @return 新容量。
+         */
+        static constexpr size_t next_capacity(size_t capacity, size_t required, size_t value_size) noexcept {
+            size_t grown = capacity ? capacity + (capacity + 1) / 2 : __vector_min_initial_capacity(value_size);
+            return grown < required ? required : grown;
+        }
+    };
+
+    /**
+     * @struct fixed_chunk_growth
+     * @brief 每次固定增加 ChunkBytes 字节容量的策略。
+     *
+     * 适用于内存受限、元素数量可预估的场景：多余的容量不超过一个块，
+     * 代价是大量追加时重新分配的次数随大小线性增长。
+     *
+     * @tparam ChunkBytes 每次增加的字节数，默认为 4096。
+     */
+    template <size_t ChunkBytes = 4096>
+    struct fixed_chunk_growth {
+        /**
+         * @brief 计算新容量。
+         * @param capacity 当前容量。
+         * @param required 需要的最小容量。
+         * @param value_size 元素的大小（字节）。
+         * @return 新容量。
+         */
+        static constexpr size_t next_capacity(size_t capacity, size_t required, size_t value_size) noexcept {
+            size_t chunk = value_size >= ChunkBytes ? 1 : ChunkBytes / value_size;
+            size_t grown = capacity + chunk;
+            return grown < required ? required : grown;
+        }
+    };
+
     /**
      * @class vector
      * @brief 动态数组容器，类似于标准库中的 std::vector。
@@ -27,8 +114,9 @@ namespace tiny_stl {
      *
      * @tparam T 容器中存储的元素类型。
      * @tparam Alloc 用于内存分配和释放的分配器类型，默认为 allocator<T>。
+     * @tparam Growth 容量不足时计算新容量的增长策略，默认为 doubling_growth。
      */
-    template <typename T, typename Alloc = allocator<T>>
+    template <typename T, typename Alloc = allocator<T>, typename Growth = doubling_growth>
     class vector {
     public:
         /**
@@ -39,6 +127,10 @@ namespace tiny_stl {
          * @brief 用于内存分配和释放的分配器类型。
          */
         using allocator_type         = Alloc;
+        /**
+         * @brief 容量增长策略类型。
+         */
+        using growth_policy          = Growth;
         /**
          * @brief 表示容器大小的无符号整数类型。
          */
@@ -86,20 +178,28 @@ namespace tiny_stl {
         vector() : _begin(nullptr), _end(nullptr), _end_of_storage(nullptr),
                    _alloc(allocator_type()) { }
 
+        /**
+         * @brief 创建一个使用指定分配器的空 vector。
+         *
+         * @param alloc 分配器。
+         */
+        explicit vector(const allocator_type& alloc)
+            : _begin(nullptr), _end(nullptr), _end_of_storage(nullptr), _alloc(alloc) { }
+
         /**
          * @brief 构造一个包含 n 个元素的 vector，每个元素的值都为 value。
          *
          * @param n 要创建的元素数量。
          * @param value 元素的初始值，默认为 value_type()。
+         * @param alloc 分配器，默认为 allocator_type()。
          */
-        vector(size_type n, const value_type& value = value_type())
-            : _alloc(allocator_type()) {
-            _begin = _alloc.allocate(n);
-            _end = _begin + n;
-            _end_of_storage = _end;
-            for (size_type i = 0; i < n; ++i) {
-                _alloc.construct(_begin + i, value);
-            }
+        vector(size_type n, const value_type& value = value_type(),
+               const allocator_type& alloc = allocator_type())
+            : _alloc(alloc) {
+            _begin = allocate_storage(n);
+            _end = _begin;
+            _end_of_storage = _begin + n;
+            fill_back(n, value);
         }
 
         /**
@@ -110,12 +210,9 @@ namespace tiny_stl {
         vector(const vector& other)
             : _alloc(other._alloc) {
             size_type n = other.size();
-            _begin = _alloc.allocate(n);
-            _end = _begin + n;
-            _end_of_storage = _end;
-            for (size_type i = 0; i < n; ++i) {
-                _alloc.construct(_begin + i, other._begin[i]);
-            }
+            _begin = allocate_storage(n);
+            _end_of_storage = _begin + n;
+            _end = construct_range(other._begin, other._end, _begin);
         }
 
         /**
@@ -125,7 +222,7 @@ namespace tiny_stl {
          */
         vector(vector&& other) noexcept
             : _begin(other._begin), _end(other._end),
-              _end_of_storage(other._end_of_storage), _alloc(move(other._alloc)) {
+              _end_of_storage(other._end_of_storage), _alloc(tiny_stl::move(other._alloc)) {
             other._begin = nullptr;
             other._end = nullptr;
             other._end_of_storage = nullptr;
@@ -137,35 +234,147 @@ namespace tiny_stl {
          * @tparam InputIterator 输入迭代器类型。
          * @param first 范围的起始迭代器。
          * @param last 范围的结束迭代器。
+         * @param alloc 分配器，默认为 allocator_type()。
          */
-        template <typename InputIterator>
-        vector(InputIterator first, InputIterator last) {
-            auto n = distance(first, last);
-            _begin = _alloc.allocate(n);
-            _end = _begin + n;
-            _end_of_storage = _end;
-            for (size_type i = 0; i < n; i++, first++) {
-                _alloc.construct(_begin + i, *first);
-            }
+        template <typename InputIterator, __enable_if_input_iterator_t<InputIterator> = 0>
+        vector(InputIterator first, InputIterator last, const allocator_type& alloc = allocator_type())
+            : _alloc(alloc) {
+            auto n = tiny_stl::distance(first, last);
+            _begin = allocate_storage(n);
+            _end_of_storage = _begin + n;
+            _end = construct_range(first, last, _begin);
         }
 
         /**
          * @brief 构造一个包含 initializer_list 中元素的 vector。
          *
          * @param list 初始化列表。
+         * @param alloc 分配器，默认为 allocator_type()。
          */
-        vector(std::initializer_list<value_type> list) {
-            *this = vector{ list.begin(), list.end() };
-        }
+        vector(std::initializer_list<value_type> list, const allocator_type& alloc = allocator_type())
+            : vector(list.begin(), list.end(), alloc) { }
 
         /**
          * @brief 析构函数，释放 vector 占用的内存。
          */
         ~vector() {
-            for (iterator it = _begin; it != _end; ++it) {
-                _alloc.destroy(it);
+            destroy_range(_begin, _end);
+            deallocate_storage();
+        }
+
+        /**
+         * @brief 拷贝赋值运算符。保留自身的分配器，只复制元素。
+         *
+         * @param other 要拷贝的 vector。
+         * @return 指向当前 vector 的引用。
+         */
+        vector& operator=(const vector& other) {
+            if (this != &other) {
+                assign(other._begin, other._end);
+            }
+            return *this;
+        }
+
+        /**
+         * @brief 移动赋值运算符。保留自身的分配器：
+         * 两者的分配器相等时接管 other 的内存，不移动任何元素；否则逐个移动元素。
+         *
+         * @param other 要移动的 vector。
+         * @return 指向当前 vector 的引用。
+         */
+        vector& operator=(vector&& other) noexcept(__allocator_always_equal<allocator_type>::value) {
+            if (this != &other) {
+                if (__allocator_equal(_alloc, other._alloc)) {
+                    destroy_range(_begin, _end);
+                    deallocate_storage();
+                    _begin = other._begin;
+                    _end = other._end;
+                    _end_of_storage = other._end_of_storage;
+                    other._begin = other._end = other._end_of_storage = nullptr;
+                } else {
+                    assign(tiny_stl::make_move_iterator(other._begin), tiny_stl::make_move_iterator(other._end));
+                }
+            }
+            return *this;
+        }
+
+        /**
+         * @brief initializer_list 赋值运算符。
+         *
+         * @param list 初始化列表。
+         * @return 指向当前 vector 的引用。
+         */
+        vector& operator=(std::initializer_list<value_type> list) {
+            assign(list.begin(), list.end());
+            return *this;
+        }
+
+        /**
+         * @brief 把内容替换为 n 个值为 value 的元素。
+         *
+         * @param n 元素数量。
+         * @param value 元素的值。
+         */
+        void assign(size_type n, const value_type& value) {
+            assign(__repeat_iterator<value_type>(value, 0),
+                   __repeat_iterator<value_type>(value, static_cast<difference_type>(n)));
+        }
+
+        /**
+         * @brief 把内容替换为 [first, last) 范围内的元素。
+         *
+         * 前向迭代器只会遍历一次来计算长度，超出容量时只重新分配一次；
+         * 否则复用已有元素进行赋值，多出的部分原地构造或销毁。
+         *
+         * @tparam InputIterator 输入迭代器类型，不能指向当前 vector。
+         * @param first 范围的起始迭代器。
+         * @param last 范围的结束迭代器。
+         */
+        template <typename InputIterator, __enable_if_input_iterator_t<InputIterator> = 0>
+        void assign(InputIterator first, InputIterator last) {
+            if constexpr (__is_iterator_of<InputIterator, forward_iterator_tag>::value) {
+                size_type n = tiny_stl::distance(first, last);
+                if (n > capacity()) {
+                    pointer new_begin = allocate_storage(n);
+                    pointer new_end;
+                    try {
+                        new_end = construct_range(first, last, new_begin);
+                    } catch (...) {
+                        deallocate_block(new_begin, n);
+                        throw;
+                    }
+                    destroy_range(_begin, _end);
+                    deallocate_storage();
+                    _begin = new_begin;
+                    _end = new_end;
+                    _end_of_storage = new_begin + n;
+                } else {
+                    pointer cur = _begin;
+                    for (; cur != _end && first != last; ++cur, ++first) {
+                        *cur = *first;
+                    }
+                    if (first == last) {
+                        destroy_range(cur, _end);
+                        _end = cur;
+                    } else {
+                        _end = construct_range(first, last, _end);
+                    }
+                }
+            } else {
+                clear();
+                for (; first != last; ++first) {
+                    emplace_back(*first);
+                }
             }
-            _alloc.deallocate(_begin, _end_of_storage - _begin);
+        }
+
+        /**
+         * @brief 把内容替换为初始化列表中的元素。
+         *
+         * @param list 初始化列表。
+         */
+        void assign(std::initializer_list<value_type> list) {
+            assign(list.begin(), list.end());
         }
 
         /**
@@ -199,9 +408,7 @@ namespace tiny_stl {
          * @brief 清空 vector 中的所有元素，但不释放内存。
          */
         void clear() noexcept {
-            for (iterator it = _begin; it != _end; ++it) {
-                _alloc.destroy(it);
-            }
+            destroy_range(_begin, _end);
             _end = _begin;
         }
 
@@ -387,21 +594,40 @@ namespace tiny_stl {
          * @param value 要添加的元素。
          */
         void push_back(const value_type& value) {
+            emplace_back(value);
+        }
+
+        /**
+         * @brief 在 vector 的末尾移入一个元素。
+         *
+         * 如果容量不足，会自动进行扩容。
+         *
+         * @param value 要移入的元素。
+         */
+        void push_back(value_type&& value) {
+            emplace_back(tiny_stl::move(value));
+        }
+
+        /**
+         * @brief 在 vector 的末尾原地构造一个元素。
+         *
+         * 如果容量不足，会先在新内存中构造新元素，再搬移原有元素，
+         * 因此 args 引用 vector 自身的元素时也是安全的。
+         *
+         * @tparam Args 构造参数的类型包。
+         * @param args 转发给元素构造函数的参数。
+         * @return 新元素的引用。
+         */
+        template <typename... Args>
+        reference emplace_back(Args&&... args) {
             if (_end == _end_of_storage) {
-                size_type new_capacity = capacity() ? capacity() * 2 : 1;
-                pointer new_begin = _alloc.allocate(new_capacity);
-                size_type count = size();
-                for (size_type i = 0; i < count; ++i) {
-                    _alloc.construct(new_begin + i, move(_begin[i]));
-                    _alloc.destroy(_begin + i);
-                }
-                _alloc.deallocate(_begin, _end_of_storage - _begin);
-                _begin = new_begin;
-                _end = new_begin + count;
-                _end_of_storage = new_begin + new_capacity;
+                realloc_insert(size(), tiny_stl::forward<Args>(args)...);
+            } else {
+                _alloc.construct(_end, tiny_stl::forward<Args>(args)...);
+                stats_hooks::template on_construct<value_type, Args...>();
+                ++_end;
             }
-            _alloc.construct(_end, value);
-            ++_end;
+            return *(_end - 1);
         }
 
         /**
@@ -426,29 +652,17 @@ namespace tiny_stl {
          */
         void resize(size_type n, const value_type& value = value_type()) {
             if (n < size()) {
-                for (size_type i = n; i < size(); ++i) {
-                    _alloc.destroy(_begin + i);
-                }
+                destroy_range(_begin + n, _end);
                 _end = _begin + n;
             } else if (n > size()) {
                 if (n > capacity()) {
-                    size_type new_capacity = capacity() ? capacity() * 2 : 1;
-                    while (new_capacity < n) {
-                        new_capacity *= 2;
-                    }
-                    pointer new_begin = _alloc.allocate(new_capacity);
-                    for (size_type i = 0; i < size(); ++i) {
-                        _alloc.construct(new_begin + i, move(_begin[i]));
-                        _alloc.destroy(_begin + i);
-                    }
-                    _alloc.deallocate(_begin, _end_of_storage - _begin);
-                    _begin = new_begin;
-                    _end_of_storage = new_begin + new_capacity;
+                    // value 可能引用自身的元素，扩容前先复制一份
+                    value_type tmp(value);
+                    reallocate(grow_capacity(n));
+                    fill_back(n, tmp);
+                } else {
+                    fill_back(n, value);
                 }
-                for (size_type i = size(); i < n; ++i) {
-                    _alloc.construct(_end + i - size(), value);
-                }
-                _end = _begin + n;
             }
         }
 
@@ -461,15 +675,24 @@ namespace tiny_stl {
          */
         void reserve(size_type n) {
             if (n > capacity()) {
-                pointer new_begin = _alloc.allocate(n);
-                for (size_type i = 0; i < size(); ++i) {
-                    _alloc.construct(new_begin + i, move(_begin[i]));
-                    _alloc.destroy(_begin + i);
-                }
-                _alloc.deallocate(_begin, _end_of_storage - _begin);
-                _begin = new_begin;
-                _end_of_storage = new_begin + n;
-                _end = _begin + size();
+                reallocate(n);
+            }
+        }
+
+        /**
+         * @brief 释放未使用的容量，使容量等于大小。
+         *
+         * 元素按 move_if_noexcept 的规则搬移到恰好大小的新内存中；vector 为空时直接释放内存。
+         */
+        void shrink_to_fit() {
+            if (capacity() == size()) {
+                return;
+            }
+            if (empty()) {
+                deallocate_storage();
+                _begin = _end = _end_of_storage = nullptr;
+            } else {
+                reallocate(size());
             }
         }
 
@@ -479,28 +702,22 @@ namespace tiny_stl {
          * @param other 要交换的 vector。
          */
         void swap(vector& other) noexcept {
-            swap(_begin, other._begin);
-            swap(_end, other._end);
-            swap(_end_of_storage, other._end_of_storage);
-            swap(_alloc, other._alloc);
+            tiny_stl::swap(_begin, other._begin);
+            tiny_stl::swap(_end, other._end);
+            tiny_stl::swap(_end_of_storage, other._end_of_storage);
+            tiny_stl::swap(_alloc, other._alloc);
         }
 
         /**
          * @brief 判断两个 vector 是否相等。
          *
+         * 先比较元素数量；整数或指针元素用 memcmp 比较，见 equal。
+         *
          * @param other 要比较的 vector。
          * @return 如果两个 vector 的元素数量和对应元素都相等，返回 true；否则返回 false。
          */
         bool operator==(const vector& other) const {
-            if (size() != other.size()) {
-                return false;
-            }
-            for (size_type i = 0; i < size(); ++i) {
-                if (_begin[i] != other._begin[i]) {
-                    return false;
-                }
-            }
-            return true;
+            return size() == other.size() && tiny_stl::equal(_begin, _end, other._begin);
         }
 
         /**
@@ -517,20 +734,13 @@ namespace tiny_stl {
          * @brief 判断当前 vector 是否小于另一个 vector。
          *
          * 比较规则是按元素逐个比较，直到找到不同的元素或其中一个 vector 结束。
+         * 整数或指针元素用 memcmp 或 SIMD 按字节找到第一个不同的元素，见 lexicographical_compare。
          *
          * @param other 要比较的 vector。
          * @return 如果当前 vector 小于另一个 vector，返回 true；否则返回 false。
          */
         bool operator<(const vector& other) const {
-            size_type min_size = min(size(), other.size());
-            for (size_type i = 0; i < min_size; ++i) {
-                if (_begin[i] < other._begin[i]) {
-                    return true;
-                } else if (_begin[i] > other._begin[i]) {
-                    return false;
-                }
-            }
-            return size() < other.size();
+            return tiny_stl::lexicographical_compare(_begin, _end, other._begin, other._end);
         }
 
         /**
@@ -540,7 +750,7 @@ namespace tiny_stl {
          * @return 如果当前 vector 小于等于另一个 vector，返回 true；否则返回 false。
          */
         bool operator<=(const vector& other) const {
-            return *this < other || *this == other;
+            return !(other < *this);
         }
 
         /**
@@ -550,7 +760,7 @@ namespace tiny_stl {
          * @return 如果当前 vector 大于另一个 vector，返回 true；否则返回 false。
          */
         bool operator>(const vector& other) const {
-            return !(*this <= other);
+            return other < *this;
         }
 
         /**
@@ -592,34 +802,158 @@ namespace tiny_stl {
          * @return 指向插入元素的迭代器。
          */
         iterator insert(const_iterator position, const value_type& value) {
-            difference_type index = position - begin();
+            return emplace(position, value);
+        }
+
+        /**
+         * @brief 在指定位置移入一个元素。
+         *
+         * 如果容量不足，会自动进行扩容。
+         *
+         * @param position 插入位置的常量迭代器。
+         * @param value 要移入的元素。
+         * @return 指向插入元素的迭代器。
+         */
+        iterator insert(const_iterator position, value_type&& value) {
+            return emplace(position, tiny_stl::move(value));
+        }
+
+        /**
+         * @brief 在指定位置原地构造一个元素。
+         *
+         * 容量不足时新元素直接构造在新内存中；否则先用 args 构造一个临时对象，
+         * 再把 [position, end) 向后移动一位，最后把临时对象移入空出的位置。
+         *
+         * @tparam Args 构造参数的类型包。
+         * @param position 插入位置的常量迭代器。
+         * @param args 转发给元素构造函数的参数。
+         * @return 指向插入元素的迭代器。
+         */
+        template <typename... Args>
+        iterator emplace(const_iterator position, Args&&... args) {
+            size_type index = position - begin();
             if (_end == _end_of_storage) {
-                size_type new_capacity = capacity() ? capacity() * 2 : 1;
-                pointer new_begin = _alloc.allocate(new_capacity);
-                for (size_type i = 0; i < index; ++i) {
-                    _alloc.construct(new_begin + i, move(_begin[i]));
-                    _alloc.destroy(_begin + i);
+                realloc_insert(index, tiny_stl::forward<Args>(args)...);
+            } else if (_begin + index == _end) {
+                _alloc.construct(_end, tiny_stl::forward<Args>(args)...);
+                stats_hooks::template on_construct<value_type, Args...>();
+                ++_end;
+            } else {
+                value_type tmp(tiny_stl::forward<Args>(args)...);
+                if constexpr (std::is_trivially_copyable<value_type>::value) {
+                    std::memmove(static_cast<void*>(_begin + index + 1), static_cast<const void*>(_begin + index),
+                                 (size() - index) * sizeof(value_type));
+                    ++_end;
+                } else {
+                    _alloc.construct(_end, tiny_stl::move(*(_end - 1)));
+                    ++_end;
+                    for (iterator it = _end - 2; it != _begin + index; --it) {
+                        *it = tiny_stl::move(*(it - 1));
+                    }
+                }
+                _begin[index] = tiny_stl::move(tmp);
+            }
+            return _begin + index;
+        }
+
+        /**
+         * @brief 在指定位置插入 n 个值为 value 的元素。
+         *
+         * 至多重新分配一次内存，[position, end) 只整体后移一次。
+         *
+         * @param position 插入位置的常量迭代器。
+         * @param n 要插入的元素数量。
+         * @param value 要插入的元素的值，可以引用 vector 自身的元素。
+         * @return 指向第一个插入元素的迭代器。
+         */
+        iterator insert(const_iterator position, size_type n, const value_type& value) {
+            size_type index = position - begin();
+            if (n == 0) {
+                return _begin + index;
+            }
+            if (n > static_cast<size_type>(_end_of_storage - _end)) {
+                realloc_insert_n(index, n, [&](pointer dest) {
+                    pointer last = dest + n;
+                    pointer cur = dest;
+                    try {
+                        for (; cur != last; ++cur) {
+                            _alloc.construct(cur, value);
+                        }
+                    } catch (...) {
+                        destroy_range(dest, cur);
+                        throw;
+                    }
+                    stats_hooks::on_copies(n);
+                });
+            } else {
+                // value 可能引用即将被移动的元素，先复制一份
+                value_type tmp(value);
+                insert_in_place(index, n, __repeat_iterator<value_type>(tmp, 0));
+            }
+            return _begin + index;
+        }
+
+        /**
+         * @brief 在指定位置插入 [first, last) 范围内的元素。
+         *
+         * 对前向迭代器先计算插入数量，至多重新分配一次内存，[position, end) 只整体后移一次；
+         * 单遍输入迭代器会先收集到临时 vector 中再插入。
+         *
+         * @tparam InputIterator 输入迭代器类型，不能指向当前 vector。
+         * @param position 插入位置的常量迭代器。
+         * @param first 范围的起始迭代器。
+         * @param last 范围的结束迭代器。
+         * @return 指向第一个插入元素的迭代器。
+         */
+        template <typename InputIterator, __enable_if_input_iterator_t<InputIterator> = 0>
+        iterator insert(const_iterator position, InputIterator first, InputIterator last) {
+            size_type index = position - begin();
+            if constexpr (__is_iterator_of<InputIterator, forward_iterator_tag>::value) {
+                size_type n = tiny_stl::distance(first, last);
+                if (n == 0) {
+                    return _begin + index;
                 }
-                _alloc.construct(new_begin + index, value);
-                for (size_type i = index; i < size(); ++i) {
-                    _alloc.construct(new_begin + i + 1, move(_begin[i]));
-                    _alloc.destroy(_begin + i);
+                if (n > static_cast<size_type>(_end_of_storage - _end)) {
+                    realloc_insert_n(index, n, [&](pointer dest) {
+                        construct_range(first, last, dest);
+                    });
+                } else {
+                    insert_in_place(index, n, first);
                 }
-                _alloc.deallocate(_begin, _end_of_storage - _begin);
-                _begin = new_begin;
-                _end = new_begin + size() + 1;
-                _end_of_storage = new_begin + new_capacity;
             } else {
-                for (iterator it = _end; it > _begin + index; --it) {
-                    _alloc.construct(it, move(*(it - 1)));
-                    _alloc.destroy(it - 1);
+                vector tmp;
+                for (; first != last; ++first) {
+                    tmp.emplace_back(*first);
                 }
-                _alloc.construct(_begin + index, value);
-                ++_end;
+                insert(position, tmp.begin(), tmp.end());
             }
             return _begin + index;
         }
 
+        /**
+         * @brief 在指定位置插入初始化列表中的元素。
+         *
+         * @param position 插入位置的常量迭代器。
+         * @param list 初始化列表。
+         * @return 指向第一个插入元素的迭代器。
+         */
+        iterator insert(const_iterator position, std::initializer_list<value_type> list) {
+            return insert(position, list.begin(), list.end());
+        }
+
+        /**
+         * @brief 在末尾追加一个范围内的全部元素，至多重新分配一次内存。
+         *
+         * @tparam Range 范围类型，需要支持 begin() 与 end()。
+         * @param range 要追加的范围，不能是当前 vector。
+         */
+        template <typename Range>
+        void append_range(Range&& range) {
+            using std::begin;
+            using std::end;
+            insert(this->end(), begin(range), end(range));
+        }
+
         /**
          * @brief 删除指定位置的元素。
          *
@@ -627,14 +961,7 @@ namespace tiny_stl {
          * @return 指向被删除元素之后位置的迭代器。
          */
         iterator erase(const_iterator position) {
-            difference_type index = position - begin();
-            _alloc.destroy(_begin + index);
-            for (iterator it = _begin + index; it < _end - 1; ++it) {
-                _alloc.construct(it, move(*(it + 1)));
-                _alloc.destroy(it + 1);
-            }
-            --_end;
-            return _begin + index;
+            return erase(position, position + 1);
         }
 
         /**
@@ -647,19 +974,369 @@ namespace tiny_stl {
         iterator erase(const_iterator first, const_iterator last) {
             difference_type start_index = first - begin();
             difference_type end_index = last - begin();
-            difference_type count = end_index - start_index;
-            for (iterator it = _begin + start_index; it < _begin + end_index; ++it) {
-                _alloc.destroy(it);
-            }
-            for (iterator it = _begin + end_index; it < _end; ++it) {
-                _alloc.construct(it - count, move(*it));
-                _alloc.destroy(it);
+            if (start_index != end_index) {
+                pointer new_end;
+                if constexpr (std::is_trivially_copyable<value_type>::value) {
+                    size_type tail = _end - (_begin + end_index);
+                    std::memmove(static_cast<void*>(_begin + start_index), static_cast<const void*>(_begin + end_index),
+                                 tail * sizeof(value_type));
+                    new_end = _begin + start_index + tail;
+                } else {
+                    new_end = _begin + start_index;
+                    for (pointer it = _begin + end_index; it != _end; ++it, ++new_end) {
+                        *new_end = tiny_stl::move(*it);
+                    }
+                }
+                destroy_range(new_end, _end);
+                _end = new_end;
             }
-            _end -= count;
             return _begin + start_index;
         }
 
-    private:
+    protected:
+        /**
+         * @brief 按增长策略计算容纳至少 min_capacity 个元素所需的新容量。
+         *
+         * @param min_capacity 需要的最小容量。
+         * @return 新容量。
+         */
+        size_type grow_capacity(size_type min_capacity) const noexcept {
+            return growth_policy::next_capacity(capacity(), min_capacity, sizeof(value_type));
+        }
+
+        /**
+         * @brief 销毁 [first, last) 范围内的元素。
+         *
+         * @param first 范围的起始指针。
+         * @param last 范围的结束指针。
+         */
+        void destroy_range(pointer first, pointer last) noexcept {
+            if constexpr (!std::is_trivially_destructible<value_type>::value) {
+                for (; first != last; ++first) {
+                    _alloc.destroy(first);
+                }
+            }
+        }
+
+        /**
+         * @brief 销毁已被 relocate 搬走的源元素。
+         *
+         * 元素可平凡重定位时，搬移本身已经结束了源对象的生命周期，不再调用析构函数。
+         *
+         * @param first 范围的起始指针。
+         * @param last 范围的结束指针。
+         */
+        void destroy_relocated(pointer first, pointer last) noexcept {
+            if constexpr (!is_trivially_relocatable<value_type>::value) {
+                destroy_range(first, last);
+            }
+        }
+
+        /**
+         * @brief 在未初始化的内存 dest 中逐个拷贝构造 [first, last) 范围内的元素。
+         *
+         * 源为指向平凡可复制类型的指针时整体使用 `memcpy`；
+         * 构造过程中抛出异常时会销毁已构造的元素。
+         *
+         * @tparam InputIterator 输入迭代器类型。
+         * @param first 源范围的起始迭代器。
+         * @param last 源范围的结束迭代器。
+         * @param dest 目标内存的起始指针。
+         * @return 目标范围的结束指针。
+         */
+        template <typename InputIterator>
+        pointer construct_range(InputIterator first, InputIterator last, pointer dest) {
+            if constexpr (__is_bitwise_copyable<InputIterator, pointer, decltype(*first)>::value) {
+                stats_hooks::on_copies(static_cast<size_type>(last - first));
+                return __bitwise_copy_n(first, static_cast<size_type>(last - first), dest);
+            } else {
+                pointer cur = dest;
+                try {
+                    for (; first != last; ++first, ++cur) {
+                        _alloc.construct(cur, *first);
+                    }
+                } catch (...) {
+                    destroy_range(dest, cur);
+                    throw;
+                }
+                stats_hooks::on_copies(static_cast<size_type>(cur - dest));
+                return cur;
+            }
+        }
+
+        /**
+         * @brief 统计钩子，见 container_stats.hpp。
+         */
+        using stats_hooks = __stats_hooks<vector>;
+
+        /**
+         * @brief 通过分配器分配 n 个元素的内存。
+         *
+         * @param n 元素个数。
+         * @return 内存的起始指针，n 为 0 时为 nullptr。
+         */
+        pointer allocate_storage(size_type n) {
+            pointer p = _alloc.allocate(n);
+            if (p) {
+                stats_hooks::on_allocate(n * sizeof(value_type));
+                stats_hooks::on_capacity(n);
+            }
+            return p;
+        }
+
+        /**
+         * @brief 通过分配器释放 allocate_storage 分配的内存。
+         *
+         * @param p 内存的起始指针。
+         * @param n 分配时的元素个数。
+         */
+        void deallocate_block(pointer p, size_type n) noexcept {
+            stats_hooks::on_deallocate(n * sizeof(value_type));
+            _alloc.deallocate(p, n);
+        }
+
+        /**
+         * @brief 释放当前持有的内存，不销毁元素。
+         */
+        void deallocate_storage() noexcept {
+            if (_begin) {
+                deallocate_block(_begin, _end_of_storage - _begin);
+            }
+        }
+
+        /**
+         * @brief 把 [first, last) 范围内的元素搬移到未初始化的内存 dest 中。
+         *
+         * 元素可平凡重定位时整体使用 `memcpy`，之后源元素只能交给 destroy_relocated；
+         * 否则在元素的移动构造函数为 noexcept（或元素不可拷贝）时移动，否则拷贝，
+         * 搬移过程中抛出异常时会销毁已构造的元素，原范围保持不变。
+         *
+         * @param first 源范围的起始指针。
+         * @param last 源范围的结束指针。
+         * @param dest 目标内存的起始指针。
+         * @return 目标范围的结束指针。
+         */
+        pointer relocate(pointer first, pointer last, pointer dest) {
+            size_type n = last - first;
+            if constexpr (is_trivially_relocatable<value_type>::value ||
+                          std::is_nothrow_move_constructible<value_type>::value ||
+                          !std::is_copy_constructible<value_type>::value) {
+                stats_hooks::on_moves(n);
+            } else {
+                stats_hooks::on_copies(n);
+            }
+            if constexpr (is_trivially_relocatable<value_type>::value) {
+                if (n != 0) {
+                    std::memcpy(static_cast<void*>(dest), static_cast<const void*>(first), n * sizeof(value_type));
+                }
+                return dest + n;
+            } else {
+                pointer cur = dest;
+                try {
+                    for (; first != last; ++first, ++cur) {
+                        _alloc.construct(cur, tiny_stl::move_if_noexcept(*first));
+                    }
+                } catch (...) {
+                    destroy_range(dest, cur);
+                    throw;
+                }
+                return cur;
+            }
+        }
+
+        /**
+         * @brief 重新分配容量为 new_capacity 的内存，并把现有元素搬移过去。
+         *
+         * @param new_capacity 新容量，不小于当前大小。
+         */
+        void reallocate(size_type new_capacity) {
+            pointer new_begin = allocate_storage(new_capacity);
+            pointer new_end;
+            try {
+                new_end = relocate(_begin, _end, new_begin);
+            } catch (...) {
+                deallocate_block(new_begin, new_capacity);
+                throw;
+            }
+            destroy_relocated(_begin, _end);
+            deallocate_storage();
+            stats_hooks::on_reallocate();
+            _begin = new_begin;
+            _end = new_end;
+            _end_of_storage = new_begin + new_capacity;
+        }
+
+        /**
+         * @brief 扩容并在下标 index 处构造一个新元素。
+         *
+         * 新元素先在新内存中构造，之后才搬移原有元素，所以 args 可以引用原有元素。
+         *
+         * @tparam Args 构造参数的类型包。
+         * @param index 新元素的下标。
+         * @param args 转发给元素构造函数的参数。
+         */
+        template <typename... Args>
+        void realloc_insert(size_type index, Args&&... args) {
+            realloc_insert_n(index, 1, [&](pointer dest) {
+                _alloc.construct(dest, tiny_stl::forward<Args>(args)...);
+                stats_hooks::template on_construct<value_type, Args...>();
+            });
+        }
+
+        /**
+         * @brief 扩容并在下标 index 处构造 n 个新元素。
+         *
+         * 新元素先在新内存中构造，之后才搬移原有元素，所以新元素的来源可以引用原有元素。
+         *
+         * @tparam Construct 可调用对象类型。
+         * @param index 第一个新元素的下标。
+         * @param n 新元素的数量。
+         * @param construct_new 形如 `void(pointer dest)` 的可调用对象，在 dest 处构造 n 个元素，
+         *                      抛出异常前需自行销毁已构造的元素。
+         */
+        template <typename Construct>
+        void realloc_insert_n(size_type index, size_type n, Construct construct_new) {
+            size_type new_capacity = grow_capacity(size() + n);
+            pointer new_begin = allocate_storage(new_capacity);
+            pointer new_pos = new_begin + index;
+            pointer new_end;
+            try {
+                construct_new(new_pos);
+            } catch (...) {
+                deallocate_block(new_begin, new_capacity);
+                throw;
+            }
+            try {
+                relocate(_begin, _begin + index, new_begin);
+                try {
+                    new_end = relocate(_begin + index, _end, new_pos + n);
+                } catch (...) {
+                    destroy_range(new_begin, new_pos);
+                    throw;
+                }
+            } catch (...) {
+                destroy_range(new_pos, new_pos + n);
+                deallocate_block(new_begin, new_capacity);
+                throw;
+            }
+            destroy_relocated(_begin, _end);
+            deallocate_storage();
+            stats_hooks::on_reallocate();
+            _begin = new_begin;
+            _end = new_end;
+            _end_of_storage = new_begin + new_capacity;
+        }
+
+        /**
+         * @brief 在容量足够时，于下标 index 处插入从 first 开始的 n 个元素。
+         *
+         * [index, end) 只整体后移一次：元素平凡可复制时使用一次 `memmove`，
+         * 否则按 SGI STL 的做法，落在未初始化区域的部分移动构造，其余部分移动赋值。
+         *
+         * @tparam ForwardIterator 前向迭代器类型。
+         * @param index 插入位置的下标。
+         * @param n 插入的元素数量，不大于剩余容量。
+         * @param first 插入元素的来源。
+         */
+        template <typename ForwardIterator>
+        void insert_in_place(size_type index, size_type n, ForwardIterator first) {
+            pointer pos = _begin + index;
+            pointer old_end = _end;
+            size_type elems_after = old_end - pos;
+            if constexpr (std::is_trivially_copyable<value_type>::value &&
+                          std::is_nothrow_constructible<value_type, decltype(*first)>::value) {
+                std::memmove(static_cast<void*>(pos + n), static_cast<const void*>(pos),
+                             elems_after * sizeof(value_type));
+                for (size_type i = 0; i < n; ++i, ++first) {
+                    _alloc.construct(pos + i, *first);
+                }
+                stats_hooks::on_copies(n);
+                _end += n;
+            } else if (elems_after > n) {
+                _end = move_construct_range(old_end - n, old_end, old_end);
+                for (pointer it = old_end - n; it != pos;) {
+                    --it;
+                    *(it + n) = tiny_stl::move(*it);
+                }
+                for (size_type i = 0; i < n; ++i, ++first) {
+                    pos[i] = *first;
+                }
+            } else {
+                ForwardIterator mid = first;
+                tiny_stl::advance(mid, elems_after);
+                _end = construct_range(mid, first_after(mid, n - elems_after), old_end);
+                try {
+                    _end = move_construct_range(pos, old_end, _end);
+                } catch (...) {
+                    destroy_range(old_end, _end);
+                    _end = old_end;
+                    throw;
+                }
+                for (pointer it = pos; it != old_end; ++it, ++first) {
+                    *it = *first;
+                }
+            }
+        }
+
+        /**
+         * @brief 返回 first 向后移动 n 步后的迭代器。
+         *
+         * @tparam ForwardIterator 前向迭代器类型。
+         * @param first 起始迭代器。
+         * @param n 移动的步数。
+         * @return 移动后的迭代器。
+         */
+        template <typename ForwardIterator>
+        static ForwardIterator first_after(ForwardIterator first, size_type n) {
+            tiny_stl::advance(first, n);
+            return first;
+        }
+
+        /**
+         * @brief 在未初始化的内存 dest 中逐个移动构造 [first, last) 范围内的元素。
+         *
+         * 元素平凡可复制时整体使用 `memcpy`；构造过程中抛出异常时会销毁已构造的元素。
+         *
+         * @param first 源范围的起始指针。
+         * @param last 源范围的结束指针。
+         * @param dest 目标内存的起始指针，不能与源范围重叠。
+         * @return 目标范围的结束指针。
+         */
+        pointer move_construct_range(pointer first, pointer last, pointer dest) {
+            stats_hooks::on_moves(static_cast<size_type>(last - first));
+            if constexpr (std::is_trivially_copyable<value_type>::value) {
+                return __bitwise_copy_n(first, static_cast<size_type>(last - first), dest);
+            } else {
+                pointer cur = dest;
+                try {
+                    for (; first != last; ++first, ++cur) {
+                        _alloc.construct(cur, tiny_stl::move(*first));
+                    }
+                } catch (...) {
+                    destroy_range(dest, cur);
+                    throw;
+                }
+                return cur;
+            }
+        }
+
+        /**
+         * @brief 在末尾构造元素直到大小为 n，容量必须足够。
+         *
+         * @param n 目标大小。
+         * @param value 新元素的初始值。
+         */
+        void fill_back(size_type n, const value_type& value) {
+            stats_hooks::on_copies(static_cast<size_type>(_begin + n - _end));
+            if constexpr (__is_bitwise_copyable<const_pointer, pointer, const value_type&>::value) {
+                _end = __bitwise_fill_n(_end, _begin + n - _end, value);
+            } else {
+                for (pointer target = _begin + n; _end != target; ++_end) {
+                    _alloc.construct(_end, value);
+                }
+            }
+        }
+
         /**
          * @brief 指向 vector 第一个元素的迭代器。
          */
@@ -0,0 +1,214 @@
+/**
+ * @file work_stealing_deque.hpp
+ * @brief 此文件定义了 tiny_stl 命名空间下的 `work_stealing_deque`，一个 Chase-Lev 工作窃取双端队列。
+ *
+ * 拥有者线程在底部无锁地压入、弹出（后进先出，缓存局部性好），其他线程在顶部无锁地窃取（先进先出，
+ * 窃取到的通常是较大的任务）。内存序采用 Lê 等人《Correct and Efficient Work-Stealing for Weak Memory Models》中的做法。
+ */
+
+#pragma once
+
+#ifdef __GNUC__
+#   pragma GCC system_header
+#endif
+#if defined(_MSC_VER) && _MSC_VER >= 1920
+#   pragma system_header
+#endif
+
+#include <deque.hpp>
+#include <memory.hpp>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+namespace tiny_stl {
+
+    /**
+     * @class work_stealing_deque
+     * @brief Chase-Lev 工作窃取双端队列。
+     *
+     * 元素存放在一个容量为 2 的幂的环形数组中，`bottom` 与 `top` 是单调变化的位置。
+     * 数组满时拥有者把元素复制到容量加倍的新数组中；窃取者可能仍在读取旧数组，
+     * 因此旧数组不会立即释放，而是挂在新数组上，到队列析构时统一释放（总量不超过当前数组的大小）。
+     * 初始容量与 deque 的缓冲区相同，约 4 KiB。
+     *
+     * 窃取者需要在不加锁的情况下读取槽位，因此元素必须是平凡可复制的类型，通常是指向任务的指针。
+     *
+     * @tparam T 元素类型，必须是平凡可复制的类型
+     */
+    template <typename T>
+    class work_stealing_deque {
+        static_assert(std::is_trivially_copyable<T>::value, "work_stealing_deque 的元素必须是平凡可复制的类型");
+    public:
+        using value_type = T; /**< 元素类型 */
+        using size_type = size_t; /**< 大小类型 */
+
+        /**
+         * @brief 构造一个空队列
+         * @param capacity 初始容量，会向上取整为 2 的幂
+         */
+        explicit work_stealing_deque(size_type capacity = __deque_buffer_size(0, sizeof(T)))
+            : _top(0), _bottom(0), _array(new ring(round_up(capacity), nullptr)) { }
+
+        work_stealing_deque(const work_stealing_deque&) = delete;
+        work_stealing_deque& operator=(const work_stealing_deque&) = delete;
+
+        /**
+         * @brief 析构函数，释放当前数组与所有被替换下来的旧数组，调用时不能有其他线程访问队列
+         */
+        ~work_stealing_deque() {
+            ring* a = _array.load(std::memory_order_relaxed);
+            while (a) {
+                ring* retired = a->retired;
+                delete a;
+                a = retired;
+            }
+        }
+
+        /**
+         * @brief 在底部压入一个元素，仅限拥有者线程调用
+         * @param value 要压入的元素
+         */
+        void push(const value_type& value) {
+            ptrdiff_t b = _bottom.load(std::memory_order_relaxed);
+            ptrdiff_t t = _top.load(std::memory_order_acquire);
+            ring* a = _array.load(std::memory_order_relaxed);
+            if (b - t > a->mask) {
+                a = grow(a, t, b);
+            }
+            a->store(b, value);
+            // release 使元素（以及它指向的任务）对读到新 bottom 的窃取者可见
+            _bottom.store(b + 1, std::memory_order_release);
+        }
+
+        /**
+         * @brief 从底部弹出最近压入的元素，仅限拥有者线程调用
+         * @param out 接收元素的对象
+         * @return 成功时返回true；队列为空（或最后一个元素被窃取者抢走）时返回false
+         */
+        bool pop(value_type& out) noexcept {
+            ptrdiff_t b = _bottom.load(std::memory_order_relaxed) - 1;
+            ring* a = _array.load(std::memory_order_relaxed);
+            _bottom.store(b, std::memory_order_relaxed);
+            // 先公布新的 bottom，再读取 top，与 steal 中的栅栏配对，保证最后一个元素只被一方取走
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            ptrdiff_t t = _top.load(std::memory_order_relaxed);
+            if (t > b) {
+                _bottom.store(b + 1, std::memory_order_relaxed);
+                return false;
+            }
+            out = a->load(b);
+            if (t == b) {
+                // 只剩一个元素，与窃取者竞争
+                bool won = _top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                        std::memory_order_relaxed);
+                _bottom.store(b + 1, std::memory_order_relaxed);
+                return won;
+            }
+            return true;
+        }
+
+        /**
+         * @brief 从顶部窃取最早压入的元素，可以由任意线程调用
+         * @param out 接收元素的对象
+         * @return 成功时返回true；队列为空或与其他线程竞争失败时返回false
+         */
+        bool steal(value_type& out) noexcept {
+            ptrdiff_t t = _top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            ptrdiff_t b = _bottom.load(std::memory_order_acquire);
+            if (t >= b) {
+                return false;
+            }
+            ring* a = _array.load(std::memory_order_acquire);
+            value_type value = a->load(t);
+            if (!_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                return false;
+            }
+            out = value;
+            return true;
+        }
+
+        /**
+         * @brief 获取队列中元素的数量，其他线程同时操作时只是一个近似值
+         * @return 元素的数量
+         */
+        size_type size() const noexcept {
+            ptrdiff_t b = _bottom.load(std::memory_order_relaxed);
+            ptrdiff_t t = _top.load(std::memory_order_relaxed);
+            return b > t ? size_type(b - t) : 0;
+        }
+
+        /**
+         * @brief 判断队列是否为空，其他线程同时操作时只是一个近似值
+         * @return 为空时返回true
+         */
+        bool empty() const noexcept {
+            return size() == 0;
+        }
+
+        /**
+         * @brief 获取当前数组的容量
+         * @return 容量
+         */
+        size_type capacity() const noexcept {
+            return size_type(_array.load(std::memory_order_relaxed)->mask + 1);
+        }
+
+    private:
+        /**
+         * @brief 环形数组，槽位是原子变量，窃取者可以与拥有者同时读写
+         */
+        struct ring {
+            ptrdiff_t mask; /**< 容量减一 */
+            std::atomic<T>* slots; /**< 槽位 */
+            ring* retired; /**< 被当前数组替换下来的旧数组 */
+
+            ring(size_type capacity, ring* old) : mask(ptrdiff_t(capacity) - 1), slots(new std::atomic<T>[capacity]),
+                                                  retired(old) { }
+            ~ring() { delete[] slots; }
+
+            void store(ptrdiff_t pos, const T& value) noexcept {
+                slots[pos & mask].store(value, std::memory_order_relaxed);
+            }
+
+            T load(ptrdiff_t pos) const noexcept {
+                return slots[pos & mask].load(std::memory_order_relaxed);
+            }
+        };
+
+        alignas(__cache_line_size) std::atomic<ptrdiff_t> _top; /**< 窃取者取走元素的位置 */
+        alignas(__cache_line_size) std::atomic<ptrdiff_t> _bottom; /**< 拥有者下一次压入的位置 */
+        std::atomic<ring*> _array; /**< 当前的环形数组 */
+
+        /**
+         * @brief 把容量向上取整为 2 的幂
+         * @param n 请求的容量
+         * @return 不小于 n 的 2 的幂，至少为 2
+         */
+        static size_type round_up(size_type n) noexcept {
+            size_type capacity = 2;
+            while (capacity < n) {
+                capacity *= 2;
+            }
+            return capacity;
+        }
+
+        /**
+         * @brief 把 [t, b) 中的元素复制到容量加倍的新数组中并发布，旧数组挂在新数组上
+         * @param a 当前数组
+         * @param t 顶部位置
+         * @param b 底部位置
+         * @return 新数组
+         */
+        ring* grow(ring* a, ptrdiff_t t, ptrdiff_t b) {
+            ring* bigger = new ring(size_type(a->mask + 1) * 2, a);
+            for (ptrdiff_t i = t; i < b; ++i) {
+                bigger->store(i, a->load(i));
+            }
+            _array.store(bigger, std::memory_order_release);
+            return bigger;
+        }
+    };
+
+}
@@ -1,10 +1,39 @@
 #include <iostream>
 #include <vector.hpp>
+#include <small_vector.hpp>
 #include <array.hpp>
 #include <memory.hpp>
 #include <list.hpp>
+#include <intrusive_list.hpp>
 #include <deque.hpp>
+#include <algorithm.hpp>
+#include <numeric.hpp>
+#include <pool_allocator.hpp>
+#include <monotonic_arena.hpp>
+#include <ring_buffer.hpp>
+#include <thread_pool.hpp>
+#include <flat_hash_map.hpp>
+#include <flat_map.hpp>
+#include <btree_map.hpp>
+#include <execution.hpp>
+#include <functional.hpp>
+#include <soa_vector.hpp>
+#include <mapped_vector.hpp>
+#include <container_stats.hpp>
+#include <cow_vector.hpp>
+#include <atomic>
+#include <cstdio>
+#include <iterator>
+#include <sstream>
+#include <thread>
 using namespace std;
+constexpr tiny_stl::array<int, 8> make_squares() {
+    tiny_stl::array<int, 8> table;
+    for (int i = 0; i < 8; i++) {
+        table[i] = i * i;
+    }
+    return table;
+}
 int main() {
     // tiny_stl::array<T, n> Tests
     tiny_stl::array<int, 10> arr = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
@@ -17,6 +46,13 @@ int main() {
         cout << i << " ";
     }
     cout << endl;
+    constexpr auto square_table = make_squares();
+    static_assert(square_table[7] == 49, "array 在编译期构造");
+    cout << "Compile-time squares, reversed:" << endl;
+    for (auto it = square_table.rbegin(); it != square_table.rend(); ++it) {
+        cout << *it << " ";
+    }
+    cout << endl;
     // tiny_stl::vector<T, Alloc> Tests
     tiny_stl::vector<int> vec(arr.begin(), arr.end());
     cout << "Vector capacity: " << vec.capacity() << endl;
@@ -44,6 +80,40 @@ int main() {
         cout << i << " ";
     }
     cout << endl;
+    cout << "Emplacing elements..." << endl;
+    vec.emplace_back(11);
+    vec.emplace(vec.begin() + 1, 0);
+    cout << "Vector size: " << vec.size() << endl;
+    cout << "Vector elements:" << endl;
+    for (auto i : vec) {
+        cout << i << " ";
+    }
+    cout << endl;
+    cout << "Inserting a range in the middle..." << endl;
+    vec.insert(vec.begin() + 3, arr.begin(), arr.begin() + 3);
+    vec.append_range(arr);
+    cout << "Vector size: " << vec.size() << endl;
+    cout << "Vector elements:" << endl;
+    for (auto i : vec) {
+        cout << i << " ";
+    }
+    cout << endl;
+    tiny_stl::vector<int> vec_prefix(vec.begin(), vec.end() - 1);
+    tiny_stl::array<int, 10> arr_copy = arr;
+    arr_copy[9] = 100;
+    cout << "Vector compare with prefix, ==: " << (vec == vec_prefix) << ", <: " << (vec_prefix < vec)
+         << ", array <: " << (arr < arr_copy) << endl;
+    // tiny_stl::small_vector<T, N, Alloc> Tests
+    tiny_stl::small_vector<int, 8> svec(arr.begin(), arr.begin() + 8);
+    cout << "Small vector size: " << svec.size() << endl;
+    cout << "Small vector is inline: " << svec.is_inline() << endl;
+    cout << "Pushing past the inline capacity..." << endl;
+    svec.push_back(arr[8]);
+    cout << "Small vector size: " << svec.size() << endl;
+    cout << "Small vector is inline: " << svec.is_inline() << endl;
+    svec.resize(4);
+    svec.shrink_to_fit();
+    cout << "Small vector is inline after shrink_to_fit: " << svec.is_inline() << endl;
     // tiny_stl::list<T, Alloc> Tests
     tiny_stl::list<int> list(arr.begin(), arr.end());
     cout << "List size: " << list.size() << endl;
@@ -54,9 +124,193 @@ int main() {
         }
     }
     cout << endl;
+    cout << "Reversing and sorting the list..." << endl;
+    list.reverse();
+    list.sort();
+    cout << "List size: " << list.size() << endl;
+    for (auto it = list.begin(); it != list.end();) {
+        cout << *it;
+        if (++it != list.end()) {
+            cout << " --> ";
+        }
+    }
+    cout << endl;
+    int sort_calls = 0;
+    try {
+        list.sort([&sort_calls](int a, int b) {
+            if (++sort_calls == 5) {
+                throw std::runtime_error("comparator failed");
+            }
+            return a > b;
+        });
+    } catch (const std::runtime_error&) {
+        int walked = 0;
+        for (auto it = list.begin(); it != list.end(); ++it) {
+            ++walked;
+        }
+        cout << "List sort with throwing comparator kept " << walked << " of " << list.size() << " nodes" << endl;
+    }
+    // tiny_stl::intrusive_list<T, Tag> Tests
+    struct item : tiny_stl::intrusive_list_hook<> {
+        int value;
+        bool operator<(const item& other) const { return value < other.value; }
+    };
+    item items[5] = {};
+    tiny_stl::intrusive_list<item> ilist;
+    for (int i = 0; i < 5; i++) {
+        items[i].value = arr[9 - i];
+        ilist.push_back(items[i]);
+    }
+    ilist.erase(items[2]);
+    ilist.sort();
+    cout << "Intrusive list size: " << ilist.size() << endl;
+    for (auto& it : ilist) {
+        cout << it.value << " ";
+    }
+    cout << endl;
+    ilist.clear();
+    // tiny_stl::pool_allocator<T> / tiny_stl::arena_allocator<T> Tests
+    tiny_stl::pool_resource pool;
+    tiny_stl::list<int, tiny_stl::pool_allocator<int>> pool_list(arr.begin(), arr.end(),
+                                                                 tiny_stl::pool_allocator<int>(pool));
+    cout << "Pool list size: " << pool_list.size() << endl;
+    {
+        auto* shared_list = new tiny_stl::list<int, tiny_stl::pool_allocator<int>>(arr.begin(), arr.end());
+        std::thread destroyer([shared_list] { delete shared_list; });
+        tiny_stl::list<int, tiny_stl::pool_allocator<int>> local_list(arr.begin(), arr.end());
+        destroyer.join();
+        cout << "Default pool list freed on another thread, local size: " << local_list.size() << endl;
+    }
+    tiny_stl::monotonic_arena arena;
+    tiny_stl::vector<int, tiny_stl::arena_allocator<int>> arena_vec(arr.begin(), arr.end(),
+                                                                   tiny_stl::arena_allocator<int>(arena));
+    cout << "Arena vector size: " << arena_vec.size() << endl;
+    try {
+        arena_vec.reserve(arena_vec.get_allocator().max_size());
+    } catch (const std::bad_alloc&) {
+        cout << "Arena huge reserve throws bad_alloc, size: " << arena_vec.size() << endl;
+    }
+    // tiny_stl::spsc_ring_buffer<T, Capacity> / tiny_stl::mpmc_ring_buffer<T, Capacity> Tests
+    tiny_stl::spsc_ring_buffer<int, 8> spsc;
+    cout << "SPSC pushed: " << spsc.try_push_n(arr.begin(), arr.size()) << endl;
+    int ring_out[4];
+    cout << "SPSC popped: " << spsc.try_pop_n(ring_out, 4) << ", first: " << ring_out[0] << endl;
+    tiny_stl::mpmc_ring_buffer<int, 4> mpmc;
+    mpmc.try_push(1);
+    mpmc.try_push(2);
+    int ring_value = 0;
+    mpmc.try_pop(ring_value);
+    cout << "MPMC popped: " << ring_value << ", size: " << mpmc.size() << endl;
+    // tiny_stl::work_stealing_deque<T> / tiny_stl::thread_pool Tests
+    std::atomic<int> pool_sum(0);
+    {
+        tiny_stl::thread_pool workers(2);
+        for (int i : arr) {
+            workers.submit([&pool_sum, i] { pool_sum += i; });
+        }
+        workers.wait_idle();
+    }
+    cout << "Thread pool sum: " << pool_sum << endl;
+    // tiny_stl::function / tiny_stl::unique_function / tiny_stl::function_ref Tests
+    tiny_stl::function<int(int)> add_offset = [offset = arr[3]](int x) { return x + offset; };
+    tiny_stl::function<int(int)> add_offset_copy = add_offset;
+    tiny_stl::unique_function<int()> owned_value = [p = tiny_stl::make_unique<int>(arr[4])] { return *p; };
+    tiny_stl::function_ref<int(int)> offset_ref = add_offset_copy;
+    cout << "Function call: " << add_offset(1) << ", unique function: " << owned_value()
+         << ", function ref: " << offset_ref(2) << endl;
+    // tiny_stl::soa_vector<Ts...> Tests
+    tiny_stl::soa_vector<int, double> particles;
+    for (int i : arr) {
+        particles.emplace_back(i, i * 0.5);
+    }
+    int id_sum = 0;
+    for (int id : particles.column<0>()) {
+        id_sum += id;
+    }
+    cout << "SoA vector rows: " << particles.size() << ", id sum: " << id_sum
+         << ", last weight: " << std::get<1>(particles.back()) << endl;
+    tiny_stl::soa_vector<int, double> reserved_rows;
+    reserved_rows.reserve(100);
+    const double* weights = reserved_rows.data<1>();
+    reserved_rows.resize(10);
+    reserved_rows.resize(5);
+    reserved_rows.resize(100);
+    cout << "SoA vector capacity after resize: " << reserved_rows.capacity()
+         << ", columns kept: " << (reserved_rows.data<1>() == weights) << endl;
+    // tiny_stl::mapped_vector<T> Tests
+    {
+        tiny_stl::mapped_vector<int> mapped("mapped_vector_test.bin", tiny_stl::map_mode::truncate);
+        mapped.append(arr.begin(), arr.end());
+        std::istringstream extra("10 11 12");
+        mapped.append(std::istream_iterator<int>(extra), std::istream_iterator<int>());
+        mapped.flush();
+    }
+    {
+        tiny_stl::mapped_vector<int> mapped("mapped_vector_test.bin", tiny_stl::map_mode::read_only);
+        cout << "Mapped vector size: " << mapped.size() << ", back: " << mapped.back()
+             << ", found 7: " << tiny_stl::binary_search(mapped.begin(), mapped.end(), 7) << endl;
+    }
+    std::remove("mapped_vector_test.bin");
+    // tiny_stl::tracking_allocator<T, Tag, Alloc> Tests
+    {
+        struct demo_tag { };
+        tiny_stl::vector<int, tiny_stl::tracking_allocator<int, demo_tag>> tracked(arr.begin(), arr.end());
+        tracked.push_back(arr[0]);
+        tiny_stl::container_stats stats = tiny_stl::stats_snapshot<demo_tag>();
+        cout << "Tracked allocations: " << stats.allocations << ", live bytes: " << stats.live_bytes
+             << ", element copies: " << stats.element_copies << endl;
+    }
+    // tiny_stl::cow_vector<T> Tests
+    tiny_stl::cow_vector<int> routes(arr.begin(), arr.begin() + 3);
+    tiny_stl::cow_vector<int>::snapshot old_routes = routes.load();
+    routes.update([](tiny_stl::vector<int>& elements) {
+        elements.push_back(100);
+        elements[0] = -1;
+    });
+    tiny_stl::cow_vector<int>::snapshot new_routes = routes.load();
+    cout << "COW vector old size: " << old_routes.size() << ", front: " << old_routes.front()
+         << ", new size: " << new_routes.size() << ", front: " << new_routes.front()
+         << ", version: " << new_routes.version() << endl;
+    // tiny_stl::flat_hash_map<Key, T> / tiny_stl::flat_hash_set<Key> Tests
+    tiny_stl::flat_hash_map<int, int> squares;
+    for (int i : arr) {
+        squares[i] = i * i;
+    }
+    squares.erase(arr[0]);
+    cout << "Flat hash map size: " << squares.size() << ", square of " << arr[3] << ": " << squares.at(arr[3]) << endl;
+    tiny_stl::flat_hash_set<int> evens;
+    for (int i : arr) {
+        evens.insert(i - i % 2);
+    }
+    cout << "Flat hash set size: " << evens.size() << ", contains 4: " << evens.contains(4) << endl;
+    // tiny_stl::flat_map<Key, T> / tiny_stl::flat_set<Key> Tests
+    tiny_stl::flat_map<int, int> sorted_squares{{3, 9}, {1, 1}, {2, 4}, {1, 100}};
+    cout << "Flat map keys:";
+    for (int k : sorted_squares.keys()) {
+        cout << " " << k;
+    }
+    cout << ", value of 1: " << sorted_squares.at(1) << endl;
+    tiny_stl::flat_set<int> sorted_evens(evens.begin(), evens.end());
+    cout << "Flat set first: " << *sorted_evens.begin() << ", lower_bound(3): " << *sorted_evens.lower_bound(3) << endl;
+    // tiny_stl::btree_map<Key, T> / tiny_stl::btree_set<Key> Tests
+    tiny_stl::btree_map<int, int> ordered_cubes;
+    for (int i = 0; i < 1000; ++i) {
+        ordered_cubes[i] = i * i * i;
+    }
+    for (int i = 0; i < 1000; i += 2) {
+        ordered_cubes.erase(i);
+    }
+    cout << "B-tree map size: " << ordered_cubes.size() << ", height: " << ordered_cubes.height()
+         << ", first: " << ordered_cubes.begin()->first << ", last: " << ordered_cubes.rbegin()->first << endl;
+    tiny_stl::pair<long, int> sorted_rows[] = {{1, 10}, {2, 20}, {3, 30}};
+    tiny_stl::btree_map<long, int> bulk_loaded(tiny_stl::sorted_unique, std::begin(sorted_rows), std::end(sorted_rows));
+    cout << "B-tree bulk-loaded size: " << bulk_loaded.size() << ", value of 2: " << bulk_loaded.at(2) << endl;
+    tiny_stl::btree_set<int> ordered_evens(evens.begin(), evens.end());
+    cout << "B-tree set first: " << *ordered_evens.begin() << ", upper_bound(4): " << *ordered_evens.upper_bound(4) << endl;
     // tiny_stl::deque<T, Alloc, buffer> Tests
     tiny_stl::deque<int> deq(arr.begin(), arr.end());
     cout << "Deque size: " << deq.size() << endl;
+    cout << "Deque block size: " << tiny_stl::deque<int>::block_size << endl;
     cout << "Deque Elements:" << endl;
     for (auto i : deq) {
         cout << i << " ";
@@ -78,6 +332,40 @@ int main() {
         cout << i << " ";
     }
     cout << endl;
+    cout << "Inserting 3 copies of 7 in the middle..." << endl;
+    deq.insert(deq.begin() + 5, 3, 7);
+    cout << "Deque size: " << deq.size() << endl;
+    cout << "Deque elements:" << endl;
+    for (auto i : deq) {
+        cout << i << " ";
+    }
+    cout << endl;
+    cout << "Deque sum: " << tiny_stl::accumulate(deq.begin(), deq.end(), 0) << endl;
+    cout << "Deque find 7 at: " << tiny_stl::find(deq.begin(), deq.end(), 7) - deq.begin() << endl;
+    cout << "Deque count of 7: " << tiny_stl::count(deq.begin(), deq.end(), 7) << endl;
+    tiny_stl::sort(deq.begin(), deq.end(), tiny_stl::greater<int>());
+    auto deq_extremes = tiny_stl::minmax_element(deq.begin(), deq.end());
+    cout << "Deque sorted descending, front: " << deq.front() << ", min: " << *deq_extremes.first
+         << ", lower_bound(7) at: " << tiny_stl::lower_bound(deq.begin(), deq.end(), 7, tiny_stl::greater<int>()) - deq.begin() << endl;
+    bool flags[32];
+    tiny_stl::fill(flags, flags + 32, true);
+    flags[20] = false;
+    cout << "Bool min at: " << tiny_stl::min_element(flags, flags + 32) - flags
+         << ", max at: " << tiny_stl::max_element(flags, flags + 32) - flags
+         << ", count true: " << tiny_stl::count(flags, flags + 32, true)
+         << ", find false at: " << tiny_stl::find(flags, flags + 32, false) - flags << endl;
+    deq.emplace_front(-2);
+    deq.emplace_back(11);
+    cout << "Deque popped: " << deq.pop_front_value() << " " << deq.pop_back_value() << endl;
+    tiny_stl::deque<int> moved_deq(tiny_stl::move(deq));
+    deq.push_back(1);
+    cout << "Deque moved size: " << moved_deq.size() << ", source size: " << deq.size() << endl;
+    tiny_stl::vector<int> par_vec(1 << 20);
+    tiny_stl::fill(tiny_stl::execution::par, par_vec.begin(), par_vec.end(), 3);
+    tiny_stl::transform(tiny_stl::execution::par, par_vec.begin(), par_vec.end(), par_vec.begin(), [](int x) { return x * 2; });
+    cout << "Parallel reduce: " << tiny_stl::reduce(tiny_stl::execution::par, par_vec.begin(), par_vec.end(), 0LL) << endl;
+    tiny_stl::sort(tiny_stl::execution::par_unseq, moved_deq.begin(), moved_deq.end());
+    cout << "Parallel sorted deque front: " << moved_deq.front() << ", back: " << moved_deq.back() << endl;
     // tiny_stl::unique_ptr<T> Tests
     tiny_stl::unique_ptr<int> uptr1 = tiny_stl::make_unique<int>(arr[5]);
     cout << "Unique pointer 1 value: " << *uptr1 << endl;
@@ -95,5 +383,39 @@ int main() {
     tiny_stl::shared_ptr<int> sptr2 = sptr1;
     cout << "Shared pointer 2 value: " << *sptr2 << endl;
     cout << "Shared pointer 2 count: " << sptr2.use_count() << endl;
+    tiny_stl::weak_ptr<int> wptr = sptr1;
+    cout << "Weak pointer count: " << wptr.use_count() << endl;
+    sptr1.reset();
+    sptr2.reset();
+    if (wptr.expired()) {
+        cout << "Weak pointer is expired" << endl;
+    } else {
+        cout << "Weak pointer is not expired" << endl;
+    }
+    tiny_stl::local_shared_ptr<int> lptr1 = tiny_stl::make_local_shared<int>(arr[7]);
+    tiny_stl::local_shared_ptr<int> lptr2 = lptr1;
+    cout << "Local shared pointer value: " << *lptr2 << endl;
+    cout << "Local shared pointer count: " << lptr2.use_count() << endl;
+    tiny_stl::atomic_shared_ptr<int> aptr(tiny_stl::make_shared<int>(arr[8]));
+    cout << "Atomic shared pointer value: " << *aptr.load() << endl;
+    aptr.store(tiny_stl::make_shared<int>(arr[9]));
+    cout << "Atomic shared pointer value after store: " << *aptr.load() << endl;
+    tiny_stl::shared_ptr<int> observed = tiny_stl::make_shared<int>(arr[5]);
+    {
+        tiny_stl::atomic_shared_ptr<int> holder(observed);
+        tiny_stl::shared_ptr<int> reader = holder.load();
+        cout << "Use count while installed: " << observed.use_count() << " (2 owners + "
+             << observed.use_count() - 2 << " reserved of " << tiny_stl::atomic_shared_ptr<int>::batch << ")" << endl;
+    }
+    cout << "Use count after release: " << observed.use_count() << endl;
+    tiny_stl::shared_ptr<int[]> sarr = tiny_stl::make_shared<int[]>(arr.size());
+    for (size_t i = 0; i < arr.size(); i++) {
+        sarr[i] = arr[i] * 2;
+    }
+    cout << "Shared array elements:" << endl;
+    for (size_t i = 0; i < arr.size(); i++) {
+        cout << sarr[i] << " ";
+    }
+    cout << endl;
     return 0;
 }